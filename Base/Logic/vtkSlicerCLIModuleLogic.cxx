@@ -28,6 +28,7 @@
 #include <vtkMRMLROIListNode.h>
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
+#include <vtkMRMLTracer.h>
 #include <vtkMRMLTransformNode.h>
 
 // VTK includes
@@ -810,6 +811,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void* clientdata)
   // node was registered when the task was scheduled so take reference to
   // release it when it goes out of scope
   node0.TakeReference(reinterpret_cast<vtkMRMLCommandLineModuleNode*>(clientdata));
+  vtkMRMLTraceScopeWithDetailMacro("CLI", "ApplyTask", node0->GetModuleDescription().GetTitle());
 
   // Check to see if this node/task has been cancelled
   if (node0->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling || //
@@ -0,0 +1,166 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2010 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkCurveSegmentLocator.h"
+
+// VTK includes
+#include <vtkIdTypeArray.h>
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Reference implementation: check all the segments
+double FindClosestDistance2BruteForce(vtkPoints* points, bool closedCurve, const double position[3])
+{
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  vtkIdType numberOfSegments = (closedCurve ? numberOfPoints : numberOfPoints - 1);
+  double closestDistance2 = std::numeric_limits<double>::max();
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    double start[3] = { 0.0, 0.0, 0.0 };
+    double end[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(segmentIndex, start);
+    points->GetPoint((segmentIndex + 1) % numberOfPoints, end);
+    double t = 0.0;
+    double closestPoint[3] = { 0.0, 0.0, 0.0 };
+    closestDistance2 = std::min(closestDistance2, vtkLine::DistanceToLine(position, start, end, t, closestPoint));
+  }
+  return closestDistance2;
+}
+
+//----------------------------------------------------------------------------
+void CreateHelix(vtkPoints* points, int numberOfPoints)
+{
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+  {
+    double angle = i * 0.05;
+    points->SetPoint(i, 30.0 * cos(angle), 30.0 * sin(angle), i * 0.1);
+  }
+}
+
+//----------------------------------------------------------------------------
+int TestClosestPoint(bool closedCurve)
+{
+  vtkNew<vtkPoints> curvePoints;
+  CreateHelix(curvePoints, 2000);
+
+  vtkNew<vtkCurveSegmentLocator> locator;
+  locator->SetPoints(curvePoints);
+  locator->SetClosedCurve(closedCurve);
+  CHECK_BOOL(locator->IsUpToDate(), false);
+  CHECK_INT(locator->GetNumberOfSegments(), closedCurve ? 2000 : 1999);
+  CHECK_BOOL(locator->IsUpToDate(), true);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> queryPoints;
+  for (int i = 0; i < 500; ++i)
+  {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      position[axis] = random->GetNextRangeValue(-50.0, 250.0);
+      random->Next();
+    }
+    queryPoints->InsertNextPoint(position);
+
+    double closestPosition[3] = { 0.0, 0.0, 0.0 };
+    double distance2 = 0.0;
+    vtkIdType segmentIndex = locator->FindClosestPoint(position, closestPosition, distance2);
+    CHECK_BOOL(segmentIndex >= 0, true);
+    CHECK_DOUBLE_TOLERANCE(distance2, FindClosestDistance2BruteForce(curvePoints, closedCurve, position), 1e-9);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, closestPosition), distance2, 1e-9);
+  }
+
+  // Batch query must give the same results as individual queries
+  vtkNew<vtkPoints> closestPoints;
+  vtkNew<vtkIdTypeArray> segmentIndices;
+  CHECK_BOOL(locator->FindClosestPoints(queryPoints, closestPoints, segmentIndices), true);
+  CHECK_INT(closestPoints->GetNumberOfPoints(), queryPoints->GetNumberOfPoints());
+  CHECK_INT(segmentIndices->GetNumberOfTuples(), queryPoints->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < queryPoints->GetNumberOfPoints(); ++i)
+  {
+    double closestPosition[3] = { 0.0, 0.0, 0.0 };
+    double distance2 = 0.0;
+    CHECK_INT(locator->FindClosestPoint(queryPoints->GetPoint(i), closestPosition, distance2), segmentIndices->GetValue(i));
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(closestPosition, closestPoints->GetPoint(i)), 0.0, 1e-12);
+  }
+
+  // Modifying the points invalidates the locator
+  curvePoints->SetPoint(1000, 500.0, 500.0, 500.0);
+  curvePoints->Modified();
+  CHECK_BOOL(locator->IsUpToDate(), false);
+  double position[3] = { 499.0, 500.0, 500.0 };
+  double closestPosition[3] = { 0.0, 0.0, 0.0 };
+  double distance2 = 0.0;
+  vtkIdType segmentIndex = locator->FindClosestPoint(position, closestPosition, distance2);
+  CHECK_BOOL(segmentIndex == 999 || segmentIndex == 1000, true);
+  CHECK_DOUBLE_TOLERANCE(distance2, FindClosestDistance2BruteForce(curvePoints, closedCurve, position), 1e-9);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestDegenerateInputs()
+{
+  vtkNew<vtkCurveSegmentLocator> locator;
+  double position[3] = { 1.0, 2.0, 3.0 };
+  double closestPosition[3] = { 0.0, 0.0, 0.0 };
+  double distance2 = 0.0;
+  CHECK_INT(locator->FindClosestPoint(position, closestPosition, distance2), -1);
+
+  vtkNew<vtkPoints> curvePoints;
+  curvePoints->InsertNextPoint(0.0, 0.0, 0.0);
+  locator->SetPoints(curvePoints);
+  CHECK_INT(locator->GetNumberOfSegments(), 0);
+  CHECK_INT(locator->FindClosestPoint(position, closestPosition, distance2), -1);
+
+  // Zero-length segment
+  curvePoints->InsertNextPoint(0.0, 0.0, 0.0);
+  curvePoints->Modified();
+  CHECK_INT(locator->FindClosestPoint(position, closestPosition, distance2), 0);
+  CHECK_DOUBLE_TOLERANCE(distance2, 14.0, 1e-12);
+
+  // Input and output points may be the same object
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(position);
+  CHECK_BOOL(locator->FindClosestPoints(points, points), true);
+  CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(points->GetPoint(0)), 0.0, 1e-12);
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkCurveSegmentLocatorTest1(int, char*[])
+{
+  CHECK_EXIT_SUCCESS(TestClosestPoint(false));
+  CHECK_EXIT_SUCCESS(TestClosestPoint(true));
+  CHECK_EXIT_SUCCESS(TestDegenerateInputs());
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
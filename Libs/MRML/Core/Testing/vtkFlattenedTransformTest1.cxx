@@ -0,0 +1,147 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkFlattenedTransform.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkGeneralTransform.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPerspectiveTransform.h>
+#include <vtkPoints.h>
+#include <vtkThinPlateSplineTransform.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+const double TestPoints[][3] = { { 0.0, 0.0, 0.0 }, { 12.0, -5.0, 3.0 }, { -20.0, 15.0, 8.0 }, { 30.0, 25.0, -12.0 } };
+
+//----------------------------------------------------------------------------
+/// Compare points and derivatives computed by the flattened transform with the original transform
+int CompareWithTransform(vtkAbstractTransform* transform, vtkFlattenedTransform* flattenedTransform)
+{
+  transform->Update();
+  for (const double* inputPoint : TestPoints)
+  {
+    double expectedPoint[3] = { 0.0, 0.0, 0.0 };
+    double expectedDerivative[3][3] = { { 0.0 } };
+    transform->InternalTransformDerivative(inputPoint, expectedPoint, expectedDerivative);
+
+    double point[3] = { 0.0, 0.0, 0.0 };
+    flattenedTransform->TransformPoint(inputPoint, point);
+    double pointWithDerivative[3] = { 0.0, 0.0, 0.0 };
+    double derivative[3][3] = { { 0.0 } };
+    flattenedTransform->TransformPointDerivative(inputPoint, pointWithDerivative, derivative);
+    for (int row = 0; row < 3; row++)
+    {
+      CHECK_DOUBLE_TOLERANCE(point[row], expectedPoint[row], 1e-6);
+      CHECK_DOUBLE_TOLERANCE(pointWithDerivative[row], expectedPoint[row], 1e-6);
+      for (int col = 0; col < 3; col++)
+      {
+        CHECK_DOUBLE_TOLERANCE(derivative[row][col], expectedDerivative[row][col], 1e-6);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkFlattenedTransformTest1(int, char*[])
+{
+  vtkNew<vtkFlattenedTransform> flattenedTransform;
+  EXERCISE_BASIC_OBJECT_METHODS(flattenedTransform);
+
+  // Empty transform is identity
+  flattenedTransform->SetTransform(nullptr);
+  CHECK_BOOL(flattenedTransform->IsLinear(), true);
+  vtkNew<vtkTransform> identityTransform;
+  CHECK_EXIT_SUCCESS(CompareWithTransform(identityTransform, flattenedTransform));
+
+  vtkNew<vtkTransform> linearTransform1;
+  linearTransform1->RotateX(20.0);
+  linearTransform1->Translate(5.0, -3.0, 10.0);
+  vtkNew<vtkTransform> linearTransform2;
+  linearTransform2->Scale(1.2, 0.9, 1.1);
+  linearTransform2->RotateZ(-15.0);
+
+  vtkNew<vtkPerspectiveTransform> perspectiveTransform;
+  vtkNew<vtkMatrix4x4> perspectiveMatrix;
+  perspectiveMatrix->SetElement(3, 2, 0.002);
+  perspectiveMatrix->SetElement(3, 3, 1.1);
+  perspectiveTransform->SetMatrix(perspectiveMatrix);
+
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  const double landmarks[][3] = { { -40.0, -40.0, -40.0 }, { 40.0, -40.0, -40.0 }, { -40.0, 40.0, -40.0 }, { -40.0, -40.0, 40.0 }, { 40.0, 40.0, 40.0 }, { 0.0, 0.0, 0.0 } };
+  for (const double* landmark : landmarks)
+  {
+    sourceLandmarks->InsertNextPoint(landmark);
+    targetLandmarks->InsertNextPoint(landmark[0] + 0.05 * landmark[1], landmark[1] - 0.03 * landmark[2], landmark[2] + 2.0);
+  }
+  vtkNew<vtkThinPlateSplineTransform> nonLinearTransform;
+  nonLinearTransform->SetBasisToR();
+  nonLinearTransform->SetSourceLandmarks(sourceLandmarks);
+  nonLinearTransform->SetTargetLandmarks(targetLandmarks);
+
+  // Linear transforms, merged into a single matrix
+  vtkNew<vtkGeneralTransform> linearGeneralTransform;
+  linearGeneralTransform->PostMultiply();
+  linearGeneralTransform->Concatenate(linearTransform1);
+  linearGeneralTransform->Concatenate(linearTransform2);
+  flattenedTransform->SetTransform(linearGeneralTransform);
+  CHECK_BOOL(flattenedTransform->IsLinear(), true);
+  CHECK_EXIT_SUCCESS(CompareWithTransform(linearGeneralTransform, flattenedTransform));
+
+  // Perspective transform, alone and merged with linear transforms
+  flattenedTransform->SetTransform(perspectiveTransform);
+  CHECK_EXIT_SUCCESS(CompareWithTransform(perspectiveTransform, flattenedTransform));
+  vtkNew<vtkGeneralTransform> perspectiveGeneralTransform;
+  perspectiveGeneralTransform->PostMultiply();
+  perspectiveGeneralTransform->Concatenate(linearTransform1);
+  perspectiveGeneralTransform->Concatenate(perspectiveTransform);
+  perspectiveGeneralTransform->Concatenate(linearTransform2);
+  flattenedTransform->SetTransform(perspectiveGeneralTransform);
+  CHECK_BOOL(flattenedTransform->IsLinear(), true);
+  CHECK_EXIT_SUCCESS(CompareWithTransform(perspectiveGeneralTransform, flattenedTransform));
+
+  // Non-linear transform between linear and perspective transforms
+  vtkNew<vtkGeneralTransform> compositeTransform;
+  compositeTransform->PostMultiply();
+  compositeTransform->Concatenate(linearTransform1);
+  compositeTransform->Concatenate(nonLinearTransform);
+  compositeTransform->Concatenate(perspectiveTransform);
+  compositeTransform->Concatenate(linearTransform2);
+  flattenedTransform->SetTransform(compositeTransform);
+  CHECK_BOOL(flattenedTransform->IsLinear(), false);
+  CHECK_EXIT_SUCCESS(CompareWithTransform(compositeTransform, flattenedTransform));
+
+  // Modifying the input transform requires setting the transform again
+  linearTransform1->Translate(10.0, 0.0, 0.0);
+  flattenedTransform->SetTransform(compositeTransform);
+  CHECK_EXIT_SUCCESS(CompareWithTransform(compositeTransform, flattenedTransform));
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2010 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkIndexedPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCutter.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double GetTotalLineLength(vtkPolyData* polyData)
+{
+  double totalLength = 0.0;
+  vtkCellArray* lines = polyData->GetLines();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  for (lines->InitTraversal(); lines->GetNextCell(numberOfCellPoints, cellPointIds);)
+  {
+    for (vtkIdType i = 0; i + 1 < numberOfCellPoints; ++i)
+    {
+      totalLength += sqrt(vtkMath::Distance2BetweenPoints(polyData->GetPoint(cellPointIds[i]), polyData->GetPoint(cellPointIds[i + 1])));
+    }
+  }
+  return totalLength;
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if each point is shared by exactly two line segments (cut of a closed surface is a set of closed loops).
+bool IsClosedContour(vtkPolyData* polyData)
+{
+  std::vector<int> pointUseCount(polyData->GetNumberOfPoints(), 0);
+  vtkCellArray* lines = polyData->GetLines();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  for (lines->InitTraversal(); lines->GetNextCell(numberOfCellPoints, cellPointIds);)
+  {
+    for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+    {
+      pointUseCount[cellPointIds[i]]++;
+    }
+  }
+  for (int useCount : pointUseCount)
+  {
+    if (useCount != 2)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestCut(vtkPolyData* surface, vtkIndexedPlaneCutter* indexedCutter, const double origin[3], const double normal[3])
+{
+  indexedCutter->GetPlane()->SetOrigin(origin[0], origin[1], origin[2]);
+  indexedCutter->GetPlane()->SetNormal(normal[0], normal[1], normal[2]);
+  indexedCutter->Update();
+  vtkPolyData* indexedOutput = indexedCutter->GetOutput();
+  CHECK_BOOL(indexedCutter->GetFallbackCutterUsed(), false);
+
+  vtkNew<vtkPlane> referencePlane;
+  referencePlane->SetOrigin(origin[0], origin[1], origin[2]);
+  referencePlane->SetNormal(normal[0], normal[1], normal[2]);
+  vtkNew<vtkPlaneCutter> referenceCutter;
+  referenceCutter->SetInputData(surface);
+  referenceCutter->SetPlane(referencePlane);
+  referenceCutter->BuildTreeOff();
+  referenceCutter->Update();
+  vtkPolyData* referenceOutput = vtkPolyData::SafeDownCast(referenceCutter->GetOutputDataObject(0));
+  CHECK_NOT_NULL(referenceOutput);
+
+  CHECK_DOUBLE_TOLERANCE(GetTotalLineLength(indexedOutput), GetTotalLineLength(referenceOutput), 1e-6);
+  if (indexedOutput->GetNumberOfLines() > 0)
+  {
+    CHECK_BOOL(IsClosedContour(indexedOutput), true);
+  }
+
+  // Point data is interpolated: the test array contains the x coordinate of each point
+  vtkDataArray* xCoordinates = indexedOutput->GetPointData()->GetArray("X");
+  CHECK_NOT_NULL(xCoordinates);
+  for (vtkIdType pointId = 0; pointId < indexedOutput->GetNumberOfPoints(); ++pointId)
+  {
+    CHECK_DOUBLE_TOLERANCE(xCoordinates->GetTuple1(pointId), indexedOutput->GetPoint(pointId)[0], 1e-9);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkIndexedPlaneCutterTest1(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(50.0);
+  sphereSource->SetThetaResolution(400);
+  sphereSource->SetPhiResolution(400);
+  sphereSource->Update();
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(sphereSource->GetOutput());
+  vtkNew<vtkDoubleArray> xCoordinates;
+  xCoordinates->SetName("X");
+  xCoordinates->SetNumberOfValues(surface->GetNumberOfPoints());
+  for (vtkIdType pointId = 0; pointId < surface->GetNumberOfPoints(); ++pointId)
+  {
+    xCoordinates->SetValue(pointId, surface->GetPoint(pointId)[0]);
+  }
+  surface->GetPointData()->AddArray(xCoordinates);
+
+  vtkNew<vtkIndexedPlaneCutter> indexedCutter;
+  indexedCutter->SetInputData(surface);
+  CHECK_INT(indexedCutter->GetNumberOfIndexedCells(), 0);
+
+  // Axis-aligned planes
+  const double center[3] = { 0.0, 0.0, 0.0 };
+  const double axialNormal[3] = { 0.0, 0.0, 1.0 };
+  CHECK_EXIT_SUCCESS(TestCut(surface, indexedCutter, center, axialNormal));
+  vtkIdType numberOfCells = surface->GetNumberOfCells();
+  CHECK_INT(indexedCutter->GetNumberOfIndexedCells(), numberOfCells);
+  std::cout << "Axial cut tested " << indexedCutter->GetNumberOfTestedCells() << " of " << numberOfCells << " cells" << std::endl;
+  CHECK_BOOL(indexedCutter->GetNumberOfTestedCells() < numberOfCells / 10, true);
+
+  const double offsetCenter[3] = { 12.3, 0.0, 0.0 };
+  const double sagittalNormal[3] = { 1.0, 0.0, 0.0 };
+  CHECK_EXIT_SUCCESS(TestCut(surface, indexedCutter, offsetCenter, sagittalNormal));
+
+  // Oblique plane
+  const double obliqueNormal[3] = { 0.3, -0.5, 0.8 };
+  CHECK_EXIT_SUCCESS(TestCut(surface, indexedCutter, offsetCenter, obliqueNormal));
+  std::cout << "Oblique cut tested " << indexedCutter->GetNumberOfTestedCells() << " of " << numberOfCells << " cells" << std::endl;
+  CHECK_BOOL(indexedCutter->GetNumberOfTestedCells() < numberOfCells / 5, true);
+
+  // Plane does not intersect the surface
+  const double outsideCenter[3] = { 0.0, 0.0, 100.0 };
+  CHECK_EXIT_SUCCESS(TestCut(surface, indexedCutter, outsideCenter, axialNormal));
+  CHECK_INT(indexedCutter->GetOutput()->GetNumberOfLines(), 0);
+  CHECK_INT(indexedCutter->GetNumberOfTestedCells(), 0);
+
+  // Modified input is re-indexed
+  vtkNew<vtkPolyData> surface2;
+  surface2->DeepCopy(surface);
+  for (vtkIdType pointId = 0; pointId < surface2->GetNumberOfPoints(); ++pointId)
+  {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    surface2->GetPoint(pointId, point);
+    surface2->GetPoints()->SetPoint(pointId, point[0], point[1], point[2] + 200.0);
+  }
+  surface2->GetPoints()->Modified();
+  const double shiftedCenter[3] = { 0.0, 0.0, 200.0 };
+  indexedCutter->SetInputData(surface2);
+  CHECK_EXIT_SUCCESS(TestCut(surface2, indexedCutter, shiftedCenter, axialNormal));
+  CHECK_BOOL(indexedCutter->GetOutput()->GetNumberOfLines() > 0, true);
+
+  // Timing of moving the slice through the surface
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  const int numberOfSlices = 100;
+  for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+  {
+    indexedCutter->GetPlane()->SetOrigin(0.0, 0.0, 200.0 - 50.0 + sliceIndex);
+    indexedCutter->Update();
+  }
+  timer->StopTimer();
+  std::cout << "Average cut time: " << timer->GetElapsedTime() * 1000.0 / numberOfSlices << " ms" << std::endl;
+
+  // Non-surface input uses fallback cutter
+  vtkNew<vtkPolyData> linesInput;
+  vtkNew<vtkPoints> linePoints;
+  linePoints->InsertNextPoint(0.0, 0.0, -1.0);
+  linePoints->InsertNextPoint(0.0, 0.0, 1.0);
+  vtkNew<vtkCellArray> lines;
+  vtkIdType linePointIds[2] = { 0, 1 };
+  lines->InsertNextCell(2, linePointIds);
+  linesInput->SetPoints(linePoints);
+  linesInput->SetLines(lines);
+  indexedCutter->SetInputData(linesInput);
+  indexedCutter->GetPlane()->SetOrigin(0.0, 0.0, 0.0);
+  indexedCutter->Update();
+  CHECK_BOOL(indexedCutter->GetFallbackCutterUsed(), true);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Add numberOfModels model nodes (each with a display node) to the scene.
+/// Models are distributed under a hierarchy of transform nodes (one transform for every 10 models).
+void PopulateScene(vtkMRMLScene* scene, int numberOfModels, bool undoEnabled = false)
+{
+  std::vector<vtkMRMLTransformNode*> transformNodes;
+  int numberOfTransforms = std::max(1, numberOfModels / 10);
+  for (int transformIndex = 0; transformIndex < numberOfTransforms; ++transformIndex)
+  {
+    vtkNew<vtkMRMLLinearTransformNode> transformNode;
+    transformNode->SetUndoEnabled(undoEnabled);
+    scene->AddNode(transformNode);
+    if (transformIndex > 0)
+    {
+      // Each transform node is the child of a previous one, to have a tree of transforms
+      transformNode->SetAndObserveTransformNodeID(transformNodes[(transformIndex - 1) / 2]->GetID());
+    }
+    transformNodes.push_back(transformNode);
+  }
+  for (int modelIndex = 0; modelIndex < numberOfModels; ++modelIndex)
+  {
+    vtkNew<vtkMRMLModelDisplayNode> displayNode;
+    displayNode->SetUndoEnabled(undoEnabled);
+    scene->AddNode(displayNode);
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetUndoEnabled(undoEnabled);
+    std::ostringstream name;
+    name << "Model " << modelIndex;
+    modelNode->SetName(name.str().c_str());
+    scene->AddNode(modelNode);
+    modelNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+    modelNode->SetAndObserveTransformNodeID(transformNodes[modelIndex % numberOfTransforms]->GetID());
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+/// Headless benchmark of scene operations: add/remove nodes, save/load/import scene, reference updates, undo.
+/// See vtkMRMLCoreTestingUtilities::Benchmark for command-line arguments.
+int vtkMRMLScenePerformanceTest(int argc, char* argv[])
+{
+  vtkMRMLCoreTestingUtilities::Benchmark benchmark("vtkMRMLScenePerformanceTest");
+  CHECK_BOOL(benchmark.ParseArguments(argc, argv), true);
+  const int numberOfModels = benchmark.GetSize(1000);
+
+  vtkNew<vtkMRMLScene> scene;
+
+  benchmark.Measure(
+    "AddNodes", [&]() { PopulateScene(scene, numberOfModels); }, [&]() { scene->Clear(); });
+
+  benchmark.Measure(
+    "AddNodesBatchProcess",
+    [&]()
+    {
+      scene->StartState(vtkMRMLScene::BatchProcessState);
+      PopulateScene(scene, numberOfModels);
+      scene->EndState(vtkMRMLScene::BatchProcessState);
+    },
+    [&]() { scene->Clear(); });
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels);
+
+  benchmark.Measure("UpdateNodeReferences", [&]() { scene->UpdateNodeReferences(); });
+
+  benchmark.Measure(
+    "RemoveNodes",
+    [&]()
+    {
+      std::vector<vtkMRMLNode*> modelNodes;
+      scene->GetNodesByClass("vtkMRMLModelNode", modelNodes);
+      for (vtkMRMLNode* modelNode : modelNodes)
+      {
+        scene->RemoveNode(modelNode);
+      }
+    },
+    [&]()
+    {
+      scene->Clear();
+      PopulateScene(scene, numberOfModels);
+    });
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 0);
+
+  benchmark.Measure(
+    "ClearScene", [&]() { scene->Clear(); }, [&]() { PopulateScene(scene, numberOfModels); });
+
+  // Save scene to XML string
+  std::string sceneXML;
+  scene->Clear();
+  PopulateScene(scene, numberOfModels);
+  scene->SetSaveToXMLString(1);
+  benchmark.Measure("SaveScene",
+                    [&]()
+                    {
+                      scene->Commit();
+                      sceneXML = scene->GetSceneXMLString();
+                    });
+  CHECK_BOOL(sceneXML.empty(), false);
+
+  // Load scene from XML string
+  vtkNew<vtkMRMLScene> loadedScene;
+  loadedScene->SetLoadFromXMLString(1);
+  benchmark.Measure("LoadScene",
+                    [&]()
+                    {
+                      loadedScene->SetSceneXMLString(sceneXML);
+                      loadedScene->Connect();
+                    });
+  CHECK_INT(loadedScene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels);
+
+  // Import scene into a scene that already contains nodes with the same IDs,
+  // therefore all node IDs and references have to be updated.
+  benchmark.Measure(
+    "ImportScene",
+    [&]()
+    {
+      loadedScene->SetSceneXMLString(sceneXML);
+      loadedScene->Import();
+    },
+    [&]()
+    {
+      loadedScene->SetSceneXMLString(sceneXML);
+      loadedScene->Connect();
+    });
+  CHECK_INT(loadedScene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 2 * numberOfModels);
+
+  // Undo
+  vtkNew<vtkMRMLScene> undoScene;
+  undoScene->SetUndoOn();
+  benchmark.Measure(
+    "SaveStateForUndo", [&]() { undoScene->SaveStateForUndo(); },
+    [&]()
+    {
+      undoScene->Clear();
+      undoScene->ClearUndoStack();
+      PopulateScene(undoScene, numberOfModels, true);
+    });
+  benchmark.Measure(
+    "Undo", [&]() { undoScene->Undo(); },
+    [&]()
+    {
+      undoScene->Clear();
+      undoScene->ClearUndoStack();
+      PopulateScene(undoScene, numberOfModels, true);
+      undoScene->SaveStateForUndo();
+      std::vector<vtkMRMLNode*> modelNodes;
+      undoScene->GetNodesByClass("vtkMRMLModelNode", modelNodes);
+      for (vtkMRMLNode* modelNode : modelNodes)
+      {
+        modelNode->SetName("Modified");
+      }
+    });
+  CHECK_INT(undoScene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels);
+
+  return benchmark.Finish();
+}
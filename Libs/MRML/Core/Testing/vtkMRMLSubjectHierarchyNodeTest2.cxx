@@ -0,0 +1,283 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSubjectHierarchyConstants.h"
+#include "vtkMRMLSubjectHierarchyNode.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_PATIENTS = 50;
+const int NUMBER_OF_STUDIES_PER_PATIENT = 10;
+const int NUMBER_OF_SERIES_PER_STUDY = 99;
+const int NUMBER_OF_INSTANCES_PER_SERIES = 3;
+
+//----------------------------------------------------------------------------
+std::string GetUID(const std::string& prefix, int index)
+{
+  std::stringstream ss;
+  ss << "1.2.826.0.1.3680043." << prefix << "." << index;
+  return ss.str();
+}
+
+//----------------------------------------------------------------------------
+std::string GetInstanceUIDList(int seriesIndex)
+{
+  std::string instanceUIDs;
+  for (int instanceIndex = 0; instanceIndex < NUMBER_OF_INSTANCES_PER_SERIES; ++instanceIndex)
+  {
+    if (!instanceUIDs.empty())
+    {
+      instanceUIDs += " ";
+    }
+    instanceUIDs += GetUID("4", seriesIndex * NUMBER_OF_INSTANCES_PER_SERIES + instanceIndex);
+  }
+  return instanceUIDs;
+}
+
+//----------------------------------------------------------------------------
+/// Create a DICOM-like patient/study/series hierarchy. Each series references the instances of the previous series.
+void CreateHierarchy(vtkMRMLSubjectHierarchyNode* shNode, std::vector<vtkIdType>& seriesItemIDs)
+{
+  const char* uidName = vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName();
+  const char* instanceUIDName = vtkMRMLSubjectHierarchyConstants::GetDICOMInstanceUIDName();
+  int studyIndex = 0;
+  int seriesIndex = 0;
+  for (int patientIndex = 0; patientIndex < NUMBER_OF_PATIENTS; ++patientIndex)
+  {
+    vtkIdType patientItemID = shNode->CreateSubjectItem(shNode->GetSceneItemID(), "Patient");
+    shNode->SetItemUID(patientItemID, uidName, GetUID("1", patientIndex));
+    for (int studyInPatientIndex = 0; studyInPatientIndex < NUMBER_OF_STUDIES_PER_PATIENT; ++studyInPatientIndex, ++studyIndex)
+    {
+      vtkIdType studyItemID = shNode->CreateStudyItem(patientItemID, "Study");
+      shNode->SetItemUID(studyItemID, uidName, GetUID("2", studyIndex));
+      for (int seriesInStudyIndex = 0; seriesInStudyIndex < NUMBER_OF_SERIES_PER_STUDY; ++seriesInStudyIndex, ++seriesIndex)
+      {
+        vtkIdType seriesItemID = shNode->CreateHierarchyItem(studyItemID, "Series", "Series");
+        shNode->SetItemUID(seriesItemID, uidName, GetUID("3", seriesIndex));
+        shNode->SetItemUID(seriesItemID, instanceUIDName, GetInstanceUIDList(seriesIndex));
+        if (seriesIndex > 0)
+        {
+          shNode->SetItemAttribute(seriesItemID, vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName(), GetInstanceUIDList(seriesIndex - 1));
+        }
+        seriesItemIDs.push_back(seriesItemID);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+int TestLookupCorrectness(vtkMRMLScene* scene, vtkMRMLSubjectHierarchyNode* shNode)
+{
+  const char* uidName = vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName();
+  const char* instanceUIDName = vtkMRMLSubjectHierarchyConstants::GetDICOMInstanceUIDName();
+
+  vtkIdType folderItemID = shNode->CreateFolderItem(shNode->GetSceneItemID(), "Folder");
+  vtkIdType item1 = shNode->CreateFolderItem(folderItemID, "Item1");
+  vtkIdType item2 = shNode->CreateFolderItem(folderItemID, "Item2");
+  vtkIdType item3 = shNode->CreateFolderItem(item1, "Item3");
+
+  // Exact UID match
+  shNode->SetItemUID(item2, uidName, "9.9.1");
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.1"), item2);
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  // First item in tree order is returned if multiple items have the same UID
+  shNode->SetItemUID(item3, uidName, "9.9.1");
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.1"), item3);
+
+  // Changed and removed UIDs are updated in the index
+  shNode->SetItemUID(item3, uidName, "9.9.2");
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.1"), item2);
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.2"), item3);
+  CHECK_BOOL(shNode->RemoveItemUID(item2, uidName), true);
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.1"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  // UID list lookup
+  shNode->SetItemUID(item1, instanceUIDName, "9.8.1 9.8.2 9.8.3");
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8.2"), item1);
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8.3"), item1);
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8.2 9.8.3"), item1);
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  shNode->SetItemUID(item2, instanceUIDName, "9.8.4");
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8.4"), item2);
+
+  // Attribute lookup
+  vtkNew<vtkIdList> foundItemIDs;
+  shNode->SetItemAttribute(item2, "TestAttribute", "a");
+  shNode->SetItemAttribute(item3, "TestAttribute", "a");
+  shNode->SetItemAttribute(item1, "TestAttribute", "b");
+  shNode->GetItemsByAttribute("TestAttribute", "a", foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), 2);
+  CHECK_INT(foundItemIDs->GetId(0), item3);
+  CHECK_INT(foundItemIDs->GetId(1), item2);
+  shNode->SetItemAttribute(item3, "TestAttribute", "b");
+  shNode->GetItemsByAttribute("TestAttribute", "a", foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), 1);
+  CHECK_INT(foundItemIDs->GetId(0), item2);
+  CHECK_BOOL(shNode->RemoveItemAttribute(item2, "TestAttribute"), true);
+  shNode->GetItemsByAttribute("TestAttribute", "a", foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), 0);
+
+  // Items referencing an item by DICOM instance UID
+  shNode->SetItemAttribute(item2, vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName(), "9.8.3 9.7.1");
+  std::vector<vtkIdType> referencingItemIDs = shNode->GetItemsReferencingItemByDICOM(item1);
+  CHECK_INT(referencingItemIDs.size(), 1);
+  CHECK_INT(referencingItemIDs[0], item2);
+  std::vector<vtkIdType> referencedItemIDs = shNode->GetItemsReferencedFromItemByDICOM(item2);
+  CHECK_INT(referencedItemIDs.size(), 1);
+  CHECK_INT(referencedItemIDs[0], item1);
+
+  // Items in another subject hierarchy are not found
+  vtkNew<vtkMRMLSubjectHierarchyNode> otherShNode;
+  vtkIdType otherItem = otherShNode->CreateFolderItem(otherShNode->GetSceneItemID(), "Other");
+  otherShNode->SetItemUID(otherItem, uidName, "9.9.3");
+  CHECK_INT(otherShNode->GetItemByUID(uidName, "9.9.3"), otherItem);
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.3"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  // Removed items are not found
+  shNode->RemoveItem(item3);
+  CHECK_INT(shNode->GetItemByUID(uidName, "9.9.2"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  shNode->RemoveItem(folderItemID);
+  CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, "9.8.2"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  // Data node lookup
+  vtkNew<vtkMRMLModelNode> dataNode;
+  scene->AddNode(dataNode);
+  vtkIdType dataItemID = shNode->GetItemByDataNode(dataNode);
+  CHECK_BOOL(dataItemID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID, true);
+  CHECK_POINTER(shNode->GetItemDataNode(dataItemID), dataNode.GetPointer());
+  scene->RemoveNode(dataNode);
+  CHECK_INT(shNode->GetItemByDataNode(dataNode), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLargeHierarchy(vtkMRMLSubjectHierarchyNode* shNode)
+{
+  const char* uidName = vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName();
+  const char* instanceUIDName = vtkMRMLSubjectHierarchyConstants::GetDICOMInstanceUIDName();
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  std::vector<vtkIdType> seriesItemIDs;
+  CreateHierarchy(shNode, seriesItemIDs);
+  timer->StopTimer();
+  const int numberOfSeries = static_cast<int>(seriesItemIDs.size());
+  const int numberOfItems = shNode->GetNumberOfItems();
+  std::cout << "Create hierarchy of " << numberOfItems << " items: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_BOOL(numberOfItems >= 50000, true);
+
+  timer->StartTimer();
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+  {
+    CHECK_INT(shNode->GetItemByUID(uidName, GetUID("3", seriesIndex).c_str()), seriesItemIDs[seriesIndex]);
+  }
+  timer->StopTimer();
+  std::cout << "Look up " << numberOfSeries << " items by UID: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  timer->StartTimer();
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+  {
+    std::string instanceUID = GetUID("4", seriesIndex * NUMBER_OF_INSTANCES_PER_SERIES + 1);
+    CHECK_INT(shNode->GetItemByUIDList(instanceUIDName, instanceUID.c_str()), seriesItemIDs[seriesIndex]);
+  }
+  timer->StopTimer();
+  std::cout << "Look up " << numberOfSeries << " items by UID list: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  timer->StartTimer();
+  for (int seriesIndex = 1; seriesIndex < numberOfSeries; ++seriesIndex)
+  {
+    std::vector<vtkIdType> referencedItemIDs = shNode->GetItemsReferencedFromItemByDICOM(seriesItemIDs[seriesIndex]);
+    CHECK_INT(referencedItemIDs.size(), 1);
+    CHECK_INT(referencedItemIDs[0], seriesItemIDs[seriesIndex - 1]);
+  }
+  timer->StopTimer();
+  std::cout << "Get referenced items of " << numberOfSeries - 1 << " items: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  // Referencing items are searched in the whole hierarchy, test only a subset to keep the test fast
+  // in case indexing is not effective.
+  const int numberOfReferencingQueries = 1000;
+  timer->StartTimer();
+  for (int queryIndex = 0; queryIndex < numberOfReferencingQueries; ++queryIndex)
+  {
+    int seriesIndex = queryIndex * (numberOfSeries - 1) / numberOfReferencingQueries;
+    std::vector<vtkIdType> referencingItemIDs = shNode->GetItemsReferencingItemByDICOM(seriesItemIDs[seriesIndex]);
+    CHECK_INT(referencingItemIDs.size(), 1);
+    CHECK_INT(referencingItemIDs[0], seriesItemIDs[seriesIndex + 1]);
+  }
+  timer->StopTimer();
+  std::cout << "Get referencing items of " << numberOfReferencingQueries << " items: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  timer->StartTimer();
+  vtkNew<vtkIdList> foundItemIDs;
+  shNode->GetItemsByAttribute(vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName(), "Series", foundItemIDs);
+  timer->StopTimer();
+  std::cout << "Get " << foundItemIDs->GetNumberOfIds() << " items by attribute: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), numberOfSeries);
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+  {
+    CHECK_INT(foundItemIDs->GetId(seriesIndex), seriesItemIDs[seriesIndex]);
+  }
+
+  timer->StartTimer();
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+  {
+    CHECK_INT(shNode->GetItemParent(seriesItemIDs[seriesIndex]) == vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID, false);
+  }
+  timer->StopTimer();
+  std::cout << "Look up " << numberOfSeries << " items by ID: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  timer->StartTimer();
+  shNode->RemoveAllItems();
+  timer->StopTimer();
+  std::cout << "Remove all items: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(shNode->GetItemByUID(uidName, GetUID("3", 0).c_str()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSubjectHierarchyNodeTest2(int, char*[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSubjectHierarchyNode* shNode = scene->GetSubjectHierarchyNode();
+  CHECK_NOT_NULL(shNode);
+
+  CHECK_EXIT_SUCCESS(TestLookupCorrectness(scene, shNode));
+  CHECK_EXIT_SUCCESS(TestLargeHierarchy(shNode));
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTableNode.h"
+#include "vtkMRMLTableSQLiteStorageNode.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkSQLiteDatabase.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkTimerLog.h>
+#include <vtkTypeInt64Array.h>
+
+// ITKSYS includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateTable(vtkTable* table, int numberOfRows)
+{
+  vtkNew<vtkIntArray> labelColumn;
+  labelColumn->SetName("Label");
+  vtkNew<vtkDoubleArray> volumeColumn;
+  volumeColumn->SetName("Volume mm3");
+  vtkNew<vtkDoubleArray> meanColumn;
+  meanColumn->SetName("Mean \"intensity\"");
+  vtkNew<vtkStringArray> nameColumn;
+  nameColumn->SetName("Segment name");
+  vtkNew<vtkTypeInt64Array> voxelCountColumn;
+  voxelCountColumn->SetName("Voxel count");
+  labelColumn->SetNumberOfValues(numberOfRows);
+  volumeColumn->SetNumberOfValues(numberOfRows);
+  meanColumn->SetNumberOfValues(numberOfRows);
+  nameColumn->SetNumberOfValues(numberOfRows);
+  voxelCountColumn->SetNumberOfValues(numberOfRows);
+  vtkMath::RandomSeed(1);
+  for (int rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+  {
+    labelColumn->SetValue(rowIndex, rowIndex - numberOfRows / 2);
+    // values that cannot be represented exactly in short decimal form
+    volumeColumn->SetValue(rowIndex, vtkMath::Random(0.0, 1.0e6) / 3.0);
+    meanColumn->SetValue(rowIndex, (rowIndex % 100 == 0) ? vtkMath::Nan() : vtkMath::Random(-1.0e-8, 1.0e-8));
+    std::ostringstream name;
+    name << "segment '" << rowIndex << "', \"quoted\"";
+    nameColumn->SetValue(rowIndex, name.str());
+    // values that cannot be represented exactly as double
+    voxelCountColumn->SetValue(rowIndex, (vtkTypeInt64(1) << 62) + 2 * rowIndex + 1);
+  }
+  table->AddColumn(labelColumn);
+  table->AddColumn(volumeColumn);
+  table->AddColumn(meanColumn);
+  table->AddColumn(nameColumn);
+  table->AddColumn(voxelCountColumn);
+}
+
+//----------------------------------------------------------------------------
+int TestWriteRead(vtkMRMLScene* scene, const std::string& fileName, int numberOfRows, int numberOfRowsPerTransaction)
+{
+  vtkNew<vtkTable> table;
+  CreateTable(table, numberOfRows);
+
+  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTableNode"));
+  CHECK_NOT_NULL(tableNode);
+  tableNode->SetAndObserveTable(table);
+
+  vtkNew<vtkMRMLTableSQLiteStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetTableName("Segment statistics");
+  storageNode->SetNumberOfRowsPerTransaction(numberOfRowsPerTransaction);
+  CHECK_INT(storageNode->GetNumberOfRowsPerTransaction(), numberOfRowsPerTransaction);
+  if (itksys::SystemTools::FileExists(fileName))
+  {
+    itksys::SystemTools::RemoveFile(fileName);
+  }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CHECK_INT(storageNode->WriteData(tableNode), 1);
+  timer->StopTimer();
+  double writeTimeSec = timer->GetElapsedTime();
+
+  // Writing again replaces the existing table
+  CHECK_INT(storageNode->WriteData(tableNode), 1);
+
+  vtkMRMLTableNode* readTableNode = vtkMRMLTableNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTableNode"));
+  CHECK_NOT_NULL(readTableNode);
+  timer->StartTimer();
+  CHECK_INT(storageNode->ReadData(readTableNode), 1);
+  timer->StopTimer();
+  double readTimeSec = timer->GetElapsedTime();
+
+  vtkTable* readTable = readTableNode->GetTable();
+  CHECK_NOT_NULL(readTable);
+  CHECK_INT(readTable->GetNumberOfColumns(), 5);
+  CHECK_INT(readTable->GetNumberOfRows(), numberOfRows);
+
+  // Integer columns are read as 64-bit integers
+  vtkTypeInt64Array* labelColumn = vtkTypeInt64Array::SafeDownCast(readTable->GetColumnByName("Label"));
+  vtkDoubleArray* volumeColumn = vtkDoubleArray::SafeDownCast(readTable->GetColumnByName("Volume mm3"));
+  vtkDoubleArray* meanColumn = vtkDoubleArray::SafeDownCast(readTable->GetColumnByName("Mean \"intensity\""));
+  vtkStringArray* nameColumn = vtkStringArray::SafeDownCast(readTable->GetColumnByName("Segment name"));
+  vtkTypeInt64Array* voxelCountColumn = vtkTypeInt64Array::SafeDownCast(readTable->GetColumnByName("Voxel count"));
+  CHECK_NOT_NULL(labelColumn);
+  CHECK_NOT_NULL(volumeColumn);
+  CHECK_NOT_NULL(meanColumn);
+  CHECK_NOT_NULL(nameColumn);
+  CHECK_NOT_NULL(voxelCountColumn);
+
+  vtkIntArray* originalLabelColumn = vtkIntArray::SafeDownCast(table->GetColumn(0));
+  vtkDoubleArray* originalVolumeColumn = vtkDoubleArray::SafeDownCast(table->GetColumn(1));
+  vtkDoubleArray* originalMeanColumn = vtkDoubleArray::SafeDownCast(table->GetColumn(2));
+  vtkStringArray* originalNameColumn = vtkStringArray::SafeDownCast(table->GetColumn(3));
+  vtkTypeInt64Array* originalVoxelCountColumn = vtkTypeInt64Array::SafeDownCast(table->GetColumn(4));
+  for (vtkIdType rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+  {
+    CHECK_INT(labelColumn->GetValue(rowIndex), originalLabelColumn->GetValue(rowIndex));
+    CHECK_BOOL(voxelCountColumn->GetValue(rowIndex) == originalVoxelCountColumn->GetValue(rowIndex), true);
+    // Values are stored in binary form, therefore there is no precision loss
+    CHECK_DOUBLE(volumeColumn->GetValue(rowIndex), originalVolumeColumn->GetValue(rowIndex));
+    if (vtkMath::IsNan(originalMeanColumn->GetValue(rowIndex)))
+    {
+      CHECK_BOOL(vtkMath::IsNan(meanColumn->GetValue(rowIndex)), true);
+    }
+    else
+    {
+      CHECK_DOUBLE(meanColumn->GetValue(rowIndex), originalMeanColumn->GetValue(rowIndex));
+    }
+    CHECK_STD_STRING(nameColumn->GetValue(rowIndex), originalNameColumn->GetValue(rowIndex));
+  }
+
+  // Table name that needs quoting can be dropped
+  std::string dbname = std::string("sqlite://") + fileName;
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
+  CHECK_NOT_NULL(database);
+  CHECK_BOOL(database->Open(nullptr, vtkSQLiteDatabase::USE_EXISTING), true);
+  CHECK_INT(database->GetTables()->GetNumberOfValues(), 1);
+  std::string tableName = "Segment statistics";
+  CHECK_INT(vtkMRMLTableSQLiteStorageNode::DropTable(&tableName[0], database), 1);
+  CHECK_INT(database->GetTables()->GetNumberOfValues(), 0);
+  database->Close();
+
+  std::cout << numberOfRows << " rows (" << numberOfRowsPerTransaction << " rows per transaction):"
+            << " write " << writeTimeSec << " s (" << numberOfRows / std::max(writeTimeSec, 1e-6) << " rows/s),"
+            << " read " << readTimeSec << " s (" << numberOfRows / std::max(readTimeSec, 1e-6) << " rows/s)" << std::endl;
+
+  itksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLTableSQLiteStorageNodeTest2(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string fileName = std::string(argv[1]) + "/vtkMRMLTableSQLiteStorageNodeTest2.sqlite3";
+
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_EXIT_SUCCESS(TestWriteRead(scene, fileName, 0, 100000));
+  CHECK_EXIT_SUCCESS(TestWriteRead(scene, fileName, 10, 3));
+  CHECK_EXIT_SUCCESS(TestWriteRead(scene, fileName, 200000, 50000));
+  CHECK_EXIT_SUCCESS(TestWriteRead(scene, fileName, 200000, 1000000));
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
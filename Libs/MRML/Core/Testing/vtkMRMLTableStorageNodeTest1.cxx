@@ -25,18 +25,24 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 #include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
+#include "vtkTimerLog.h"
 
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char* extension, vtkTable* table, bool schemaExpected);
+int TestReadWriteLargeTable(vtkMRMLScene* scene, const char* extension);
+int TestReadSpecialValues(vtkMRMLScene* scene);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char* argv[])
 {
@@ -55,6 +61,9 @@ int vtkMRMLTableStorageNodeTest1(int argc, char* argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadWriteLargeTable(scene.GetPointer(), ".csv"));
+  CHECK_EXIT_SUCCESS(TestReadWriteLargeTable(scene.GetPointer(), ".tsv"));
+  CHECK_EXIT_SUCCESS(TestReadSpecialValues(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -185,3 +194,146 @@ int TestReadWriteData(vtkMRMLScene* scene, const char* extension, vtkTable* tabl
   }
   return EXIT_SUCCESS;
 }
+
+//---------------------------------------------------------------------------
+int TestReadWriteLargeTable(vtkMRMLScene* scene, const char* extension)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + std::string("/vtkMRMLTableStorageNodeTestLarge") + std::string(extension);
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + std::string("/vtkMRMLTableStorageNodeTestLarge.schema") + std::string(extension);
+
+  const int numberOfRows = 200000;
+  vtkNew<vtkIntArray> labelColumn;
+  labelColumn->SetName("label");
+  labelColumn->SetNumberOfValues(numberOfRows);
+  vtkNew<vtkDoubleArray> positionColumn;
+  positionColumn->SetName("position");
+  positionColumn->SetNumberOfComponents(3);
+  positionColumn->SetComponentName(0, "R");
+  positionColumn->SetComponentName(1, "A");
+  positionColumn->SetComponentName(2, "S");
+  positionColumn->SetNumberOfTuples(numberOfRows);
+  vtkNew<vtkStringArray> nameColumn;
+  nameColumn->SetName("name");
+  nameColumn->SetNumberOfValues(numberOfRows);
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    labelColumn->SetValue(row, row - numberOfRows / 2);
+    // values that cannot be represented exactly in decimal form
+    positionColumn->SetTuple3(row, row / 3.0, -row / 7.0, 1.0e-10 / (row + 1));
+    std::stringstream name;
+    name << "item, " << row;
+    nameColumn->SetValue(row, name.str());
+  }
+  vtkNew<vtkTable> table;
+  table->AddColumn(labelColumn);
+  table->AddColumn(positionColumn);
+  table->AddColumn(nameColumn);
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  tableNode->SetAndObserveTable(table);
+  scene->AddNode(tableNode);
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->WriteData(tableNode), true);
+  timer->StopTimer();
+  double writeTimeSec = timer->GetElapsedTime();
+
+  tableNode->SetAndObserveTable(nullptr);
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->ReadData(tableNode), true);
+  timer->StopTimer();
+  double readTimeSec = timer->GetElapsedTime();
+
+  vtkTable* table2 = tableNode->GetTable();
+  CHECK_NOT_NULL(table2);
+  CHECK_INT(table2->GetNumberOfColumns(), 3);
+  CHECK_INT(table2->GetNumberOfRows(), numberOfRows);
+  vtkIntArray* labelColumn2 = vtkIntArray::SafeDownCast(table2->GetColumn(0));
+  vtkDoubleArray* positionColumn2 = vtkDoubleArray::SafeDownCast(table2->GetColumn(1));
+  vtkStringArray* nameColumn2 = vtkStringArray::SafeDownCast(table2->GetColumn(2));
+  CHECK_NOT_NULL(labelColumn2);
+  CHECK_NOT_NULL(positionColumn2);
+  CHECK_NOT_NULL(nameColumn2);
+  CHECK_INT(positionColumn2->GetNumberOfComponents(), 3);
+  CHECK_STRING(positionColumn2->GetComponentName(2), "S");
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    CHECK_INT(labelColumn2->GetValue(row), labelColumn->GetValue(row));
+    for (int component = 0; component < 3; ++component)
+    {
+      // numbers are written with enough digits to be read back exactly
+      CHECK_BOOL(positionColumn2->GetComponent(row, component) == positionColumn->GetComponent(row, component), true);
+    }
+    CHECK_STD_STRING(nameColumn2->GetValue(row), nameColumn->GetValue(row));
+  }
+
+  std::cout << numberOfRows << " rows " << extension << ": write " << writeTimeSec << " s, read " << readTimeSec << " s" << std::endl;
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(schemaFileName);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadSpecialValues(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + std::string("/vtkMRMLTableStorageNodeTestSpecial.csv");
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + std::string("/vtkMRMLTableStorageNodeTestSpecial.schema.csv");
+
+  // Quoted values with delimiters, quotes, and line breaks; empty and invalid numbers; Windows line endings
+  {
+    std::ofstream file(fileName.c_str(), std::ios_base::binary);
+    file << "\"text\",number\r\n";
+    file << "\"a, \"\"b\"\"\nc\",1.5\r\n";
+    file << "plain,\r\n";
+    file << "\r\n";
+    file << "x,invalid\r\n";
+    file << "\"\", -2e3 ";
+  }
+  {
+    std::ofstream file(schemaFileName.c_str(), std::ios_base::binary);
+    file << "columnName,type,nullValue\n";
+    file << "number,double,-1\n";
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode);
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(tableNode), true);
+
+  vtkTable* table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfRows(), 4);
+  vtkStringArray* textColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("text"));
+  vtkDoubleArray* numberColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("number"));
+  CHECK_NOT_NULL(textColumn);
+  CHECK_NOT_NULL(numberColumn);
+  CHECK_STD_STRING(textColumn->GetValue(0), "a, \"b\"\nc");
+  CHECK_STD_STRING(textColumn->GetValue(1), "plain");
+  CHECK_STD_STRING(textColumn->GetValue(2), "x");
+  CHECK_STD_STRING(textColumn->GetValue(3), "");
+  CHECK_DOUBLE(numberColumn->GetValue(0), 1.5);
+  // empty and invalid values are set to the null value
+  CHECK_DOUBLE(numberColumn->GetValue(1), -1.0);
+  CHECK_DOUBLE(numberColumn->GetValue(2), -1.0);
+  CHECK_DOUBLE(numberColumn->GetValue(3), -2000.0);
+
+  // Quoted values are written so that they are read back the same way
+  CHECK_BOOL(storageNode->WriteData(tableNode), true);
+  tableNode->SetAndObserveTable(nullptr);
+  CHECK_BOOL(storageNode->ReadData(tableNode), true);
+  textColumn = vtkStringArray::SafeDownCast(tableNode->GetTable()->GetColumnByName("text"));
+  CHECK_NOT_NULL(textColumn);
+  CHECK_STD_STRING(textColumn->GetValue(0), "a, \"b\"\nc");
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(schemaFileName);
+  return EXIT_SUCCESS;
+}
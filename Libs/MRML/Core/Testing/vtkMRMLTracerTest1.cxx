@@ -0,0 +1,154 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLJsonElement.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTracer.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void TracedFunction(const std::string& detail)
+{
+  vtkMRMLTraceScopeWithDetailMacro("Test", "TracedFunction", detail);
+  vtkMRMLTraceScopeMacro("Test", "NestedScope");
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLTracerTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string traceFilePath = std::string(argv[1]) + "/vtkMRMLTracerTest1.json";
+
+  vtkMRMLTracer* tracer = vtkMRMLTracer::GetInstance();
+  CHECK_NOT_NULL(tracer);
+  tracer->Stop();
+  tracer->ClearEvents();
+  // Make sure running the test does not leave a trace file behind
+  tracer->SetOutputFilePath("");
+
+  // Nothing is recorded when tracing is disabled
+  CHECK_BOOL(vtkMRMLTracer::IsEnabled(), false);
+  TracedFunction("disabled");
+  CHECK_INT(tracer->GetNumberOfEvents(), 0);
+
+  // Scoped events
+  tracer->Start();
+  CHECK_BOOL(vtkMRMLTracer::IsEnabled(), true);
+  TracedFunction("enabled");
+  CHECK_INT(tracer->GetNumberOfEvents(), 2);
+
+  // Events from multiple threads
+  const int numberOfThreads = 4;
+  const int numberOfCallsPerThread = 50;
+  std::vector<std::thread> threads;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+  {
+    threads.emplace_back(
+      [numberOfCallsPerThread]()
+      {
+        for (int callIndex = 0; callIndex < numberOfCallsPerThread; ++callIndex)
+        {
+          TracedFunction("thread");
+        }
+      });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  CHECK_INT(tracer->GetNumberOfEvents(), 2 + numberOfThreads * numberOfCallsPerThread * 2);
+
+  // Instrumented scene operations
+  vtkNew<vtkMRMLScene> scene;
+  scene->AddNewNodeByClass("vtkMRMLModelNode");
+  scene->SetSaveToXMLString(1);
+  CHECK_INT(scene->Commit(), 1);
+  scene->Clear(0);
+  int numberOfEventsBeforeStop = tracer->GetNumberOfEvents();
+  CHECK_BOOL(numberOfEventsBeforeStop >= 2 + numberOfThreads * numberOfCallsPerThread * 2 + 2, true);
+
+  tracer->Stop();
+  TracedFunction("stopped");
+  CHECK_INT(tracer->GetNumberOfEvents(), numberOfEventsBeforeStop);
+
+  // Write trace and read it back
+  CHECK_BOOL(tracer->WriteChromeTrace(traceFilePath.c_str()), true);
+  vtkNew<vtkMRMLJsonReader> reader;
+  vtkSmartPointer<vtkMRMLJsonElement> trace = vtkSmartPointer<vtkMRMLJsonElement>::Take(reader->ReadFromFile(traceFilePath.c_str()));
+  CHECK_NOT_NULL(trace);
+  vtkSmartPointer<vtkMRMLJsonElement> traceEvents = vtkSmartPointer<vtkMRMLJsonElement>::Take(trace->GetArrayProperty("traceEvents"));
+  CHECK_NOT_NULL(traceEvents);
+  int numberOfCompleteEvents = 0;
+  std::set<int> threadIds;
+  std::set<std::string> eventNames;
+  for (int eventIndex = 0; eventIndex < traceEvents->GetArraySize(); ++eventIndex)
+  {
+    vtkSmartPointer<vtkMRMLJsonElement> event = vtkSmartPointer<vtkMRMLJsonElement>::Take(traceEvents->GetArrayItem(eventIndex));
+    CHECK_NOT_NULL(event);
+    if (event->GetStringProperty("ph") != "X")
+    {
+      continue;
+    }
+    numberOfCompleteEvents++;
+    CHECK_BOOL(event->GetDoubleProperty("ts") >= 0.0, true);
+    CHECK_BOOL(event->GetDoubleProperty("dur") >= 0.0, true);
+    threadIds.insert(event->GetIntProperty("tid"));
+    eventNames.insert(event->GetStringProperty("cat") + "/" + event->GetStringProperty("name"));
+  }
+  CHECK_INT(numberOfCompleteEvents, numberOfEventsBeforeStop);
+  CHECK_INT(static_cast<int>(threadIds.size()), numberOfThreads + 1);
+  CHECK_BOOL(eventNames.count("Test/TracedFunction") > 0, true);
+  CHECK_BOOL(eventNames.count("Test/NestedScope") > 0, true);
+  CHECK_BOOL(eventNames.count("Scene/Commit") > 0, true);
+  CHECK_BOOL(eventNames.count("Scene/Clear") > 0, true);
+
+  // Number of events is limited
+  tracer->ClearEvents();
+  tracer->SetMaximumNumberOfEvents(3);
+  tracer->Start();
+  TracedFunction("limited");
+  TracedFunction("limited");
+  tracer->Stop();
+  CHECK_INT(tracer->GetNumberOfEvents(), 3);
+  CHECK_INT(tracer->GetNumberOfDroppedEvents(), 1);
+  tracer->SetMaximumNumberOfEvents(1000000);
+  tracer->ClearEvents();
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
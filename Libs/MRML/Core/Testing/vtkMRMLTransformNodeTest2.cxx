@@ -0,0 +1,189 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLGridTransformNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkOrientedGridTransform.h"
+
+// VTK includes
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Fill the grid with a smooth, invertible displacement field.
+void SetDisplacements(vtkImageData* grid, double amplitude)
+{
+  int* dims = grid->GetDimensions();
+  double* displacements = static_cast<double*>(grid->GetScalarPointer());
+  for (int k = 0; k < dims[2]; k++)
+  {
+    for (int j = 0; j < dims[1]; j++)
+    {
+      for (int i = 0; i < dims[0]; i++, displacements += 3)
+      {
+        displacements[0] = amplitude * sin(0.2 * j) * cos(0.1 * k);
+        displacements[1] = amplitude * cos(0.15 * i);
+        displacements[2] = amplitude * sin(0.1 * i + 0.1 * j);
+      }
+    }
+  }
+  grid->Modified();
+}
+
+//----------------------------------------------------------------------------
+/// Compute maximum distance between cached and iterative inverse at points inside the grid.
+double GetMaximumInverseDifference(vtkGeneralTransform* cachedInverse, vtkAbstractTransform* iterativeInverse, vtkPoints* points)
+{
+  double maximumDifference = 0.0;
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); pointIndex++)
+  {
+    double* point = points->GetPoint(pointIndex);
+    double cachedInversePoint[3] = { 0.0, 0.0, 0.0 };
+    double iterativeInversePoint[3] = { 0.0, 0.0, 0.0 };
+    cachedInverse->TransformPoint(point, cachedInversePoint);
+    iterativeInverse->TransformPoint(point, iterativeInversePoint);
+    maximumDifference = std::max(maximumDifference, sqrt(vtkMath::Distance2BetweenPoints(cachedInversePoint, iterativeInversePoint)));
+  }
+  return maximumDifference;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLTransformNodeTest2(int, char*[])
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Displacement field with non-trivial direction
+  vtkNew<vtkImageData> grid;
+  grid->SetDimensions(40, 40, 30);
+  grid->SetOrigin(-50.0, -40.0, -30.0);
+  grid->SetSpacing(2.5, 2.0, 2.0);
+  grid->AllocateScalars(VTK_DOUBLE, 3);
+  SetDisplacements(grid, 3.0);
+  vtkNew<vtkMatrix4x4> gridDirection;
+  gridDirection->SetElement(0, 0, 0.0);
+  gridDirection->SetElement(0, 1, -1.0);
+  gridDirection->SetElement(1, 0, 1.0);
+  gridDirection->SetElement(1, 1, 0.0);
+
+  vtkNew<vtkOrientedGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(grid);
+  gridTransform->SetGridDirectionMatrix(gridDirection);
+  gridTransform->SetInterpolationModeToLinear();
+
+  vtkMRMLGridTransformNode* transformNode = vtkMRMLGridTransformNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLGridTransformNode"));
+  CHECK_NOT_NULL(transformNode);
+  transformNode->SetAndObserveTransformFromParent(gridTransform);
+
+  // Disabled by default
+  CHECK_BOOL(transformNode->GetCacheInverseDisplacementField(), false);
+  CHECK_NULL(transformNode->GetCachedInverseDisplacementField());
+
+  // Test points, well inside the grid
+  vtkNew<vtkPoints> points;
+  vtkMath::RandomSeed(1);
+  for (int pointIndex = 0; pointIndex < 20000; pointIndex++)
+  {
+    points->InsertNextPoint(vtkMath::Random(-25.0, 25.0), vtkMath::Random(-30.0, 30.0), vtkMath::Random(-20.0, 20.0));
+  }
+
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  transformNode->GetTransformToWorld(transformToWorld);
+  vtkNew<vtkPoints> transformedPoints;
+  transformToWorld->TransformPoints(points, transformedPoints);
+  timer->StopTimer();
+  double iterativeTimeSec = timer->GetElapsedTime();
+
+  // Enable caching
+  transformNode->SetInverseDisplacementFieldTolerance(0.001);
+  transformNode->CacheInverseDisplacementFieldOn();
+  vtkAbstractTransform* cachedInverse = transformNode->GetCachedInverseDisplacementField();
+  CHECK_NOT_NULL(cachedInverse);
+  CHECK_INT(transformNode->GetInverseDisplacementFieldNumberOfInvalidPoints(), 0);
+  CHECK_BOOL(transformNode->GetInverseDisplacementFieldMaximumError() <= 0.001, true);
+  // Computed only once
+  CHECK_POINTER(transformNode->GetCachedInverseDisplacementField(), cachedInverse);
+
+  // Transform to parent that is stored in the node is not changed
+  CHECK_POINTER(transformNode->GetTransformFromParent(), gridTransform.GetPointer());
+  CHECK_BOOL(transformNode->GetTransformToParent() != cachedInverse, true);
+
+  vtkNew<vtkGeneralTransform> cachedTransformToWorld;
+  timer->StartTimer();
+  transformNode->GetTransformToWorld(cachedTransformToWorld);
+  cachedTransformToWorld->TransformPoints(points, transformedPoints);
+  timer->StopTimer();
+  double cachedTimeSec = timer->GetElapsedTime();
+  std::cout << "Transform " << points->GetNumberOfPoints() << " points to world: iterative inverse " << iterativeTimeSec << " s,"
+            << " cached inverse (including computing the inverse field) " << cachedTimeSec << " s" << std::endl;
+
+  // Trilinear interpolation of the inverse introduces a small error
+  double maximumDifference = GetMaximumInverseDifference(cachedTransformToWorld, gridTransform->GetInverse(), points);
+  std::cout << "Maximum difference between cached and iterative inverse: " << maximumDifference << " mm" << std::endl;
+  CHECK_BOOL(maximumDifference < 0.2, true);
+
+  // Transform from world is not affected by caching
+  vtkNew<vtkGeneralTransform> transformFromWorld;
+  transformNode->GetTransformFromWorld(transformFromWorld);
+  double testPoint[3] = { 1.0, 2.0, 3.0 };
+  double transformedTestPoint[3] = { 0.0, 0.0, 0.0 };
+  double expectedTestPoint[3] = { 0.0, 0.0, 0.0 };
+  transformFromWorld->TransformPoint(testPoint, transformedTestPoint);
+  gridTransform->TransformPoint(testPoint, expectedTestPoint);
+  CHECK_DOUBLE_TOLERANCE(transformedTestPoint[0], expectedTestPoint[0], 1e-9);
+  CHECK_DOUBLE_TOLERANCE(transformedTestPoint[1], expectedTestPoint[1], 1e-9);
+  CHECK_DOUBLE_TOLERANCE(transformedTestPoint[2], expectedTestPoint[2], 1e-9);
+
+  // Modifying the forward transform invalidates the cache
+  SetDisplacements(grid, 5.0);
+  gridTransform->Modified();
+  transformNode->GetTransformToWorld(cachedTransformToWorld);
+  maximumDifference = GetMaximumInverseDifference(cachedTransformToWorld, gridTransform->GetInverse(), points);
+  std::cout << "Maximum difference after modifying the transform: " << maximumDifference << " mm" << std::endl;
+  CHECK_BOOL(maximumDifference < 0.2, true);
+
+  // Parameters are copied
+  vtkNew<vtkMRMLGridTransformNode> transformNodeCopy;
+  transformNodeCopy->Copy(transformNode);
+  CHECK_BOOL(transformNodeCopy->GetCacheInverseDisplacementField(), true);
+  CHECK_DOUBLE(transformNodeCopy->GetInverseDisplacementFieldTolerance(), 0.001);
+
+  // Disabling releases the cache
+  transformNode->CacheInverseDisplacementFieldOff();
+  CHECK_NULL(transformNode->GetCachedInverseDisplacementField());
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
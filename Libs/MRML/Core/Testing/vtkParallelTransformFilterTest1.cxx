@@ -0,0 +1,187 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkOrientedGridTransform.h"
+#include "vtkParallelTransformFilter.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPerspectiveTransform.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+#include <vtkTransformFilter.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int CompareArrays(vtkDataArray* actual, vtkDataArray* expected, double tolerance)
+{
+  CHECK_NOT_NULL(actual);
+  CHECK_NOT_NULL(expected);
+  CHECK_INT(actual->GetNumberOfTuples(), expected->GetNumberOfTuples());
+  CHECK_INT(actual->GetNumberOfComponents(), expected->GetNumberOfComponents());
+  for (vtkIdType tupleIndex = 0; tupleIndex < expected->GetNumberOfTuples(); tupleIndex++)
+  {
+    for (int component = 0; component < expected->GetNumberOfComponents(); component++)
+    {
+      CHECK_DOUBLE_TOLERANCE(actual->GetComponent(tupleIndex, component), expected->GetComponent(tupleIndex, component), tolerance);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkParallelTransformFilterTest1(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(40.0);
+  sphereSource->SetThetaResolution(500);
+  sphereSource->SetPhiResolution(500);
+  vtkNew<vtkPolyDataNormals> normalsFilter;
+  normalsFilter->SetInputConnection(sphereSource->GetOutputPort());
+  normalsFilter->SplittingOff();
+  normalsFilter->Update();
+  vtkPointSet* input = normalsFilter->GetOutput();
+  CHECK_NOT_NULL(input->GetPointData()->GetNormals());
+
+  // Smooth displacement field
+  vtkNew<vtkImageData> grid;
+  grid->SetDimensions(30, 30, 30);
+  grid->SetOrigin(-75.0, -75.0, -75.0);
+  grid->SetSpacing(5.0, 5.0, 5.0);
+  grid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(grid->GetScalarPointer());
+  for (int k = 0; k < 30; k++)
+  {
+    for (int j = 0; j < 30; j++)
+    {
+      for (int i = 0; i < 30; i++, displacements += 3)
+      {
+        displacements[0] = 4.0 * sin(0.2 * j);
+        displacements[1] = 3.0 * cos(0.15 * k);
+        displacements[2] = 2.0 * sin(0.1 * i);
+      }
+    }
+  }
+  vtkNew<vtkOrientedGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(grid);
+  gridTransform->SetInterpolationModeToCubic();
+
+  // Composite transform: linear, grid, two linear (merged), inverse grid
+  vtkNew<vtkTransform> linearTransform1;
+  linearTransform1->RotateZ(15.0);
+  linearTransform1->Translate(3.0, -2.0, 1.0);
+  vtkNew<vtkTransform> linearTransform2;
+  linearTransform2->Scale(1.1, 0.9, 1.0);
+  vtkNew<vtkTransform> linearTransform3;
+  linearTransform3->RotateX(-10.0);
+  vtkNew<vtkGeneralTransform> transform;
+  transform->PostMultiply();
+  transform->Concatenate(linearTransform1);
+  transform->Concatenate(gridTransform);
+  transform->Concatenate(linearTransform2);
+  transform->Concatenate(linearTransform3);
+  transform->Concatenate(gridTransform->GetInverse());
+
+  vtkNew<vtkTransformFilter> referenceFilter;
+  referenceFilter->SetInputData(input);
+  referenceFilter->SetTransform(transform);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  referenceFilter->Update();
+  timer->StopTimer();
+  double referenceTimeSec = timer->GetElapsedTime();
+
+  vtkNew<vtkParallelTransformFilter> parallelFilter;
+  parallelFilter->SetInputData(input);
+  parallelFilter->SetTransform(transform);
+  timer->StartTimer();
+  parallelFilter->Update();
+  timer->StopTimer();
+  double parallelTimeSec = timer->GetElapsedTime();
+  CHECK_BOOL(parallelFilter->GetParallelExecution(), true);
+
+  std::cout << "Transform " << input->GetNumberOfPoints() << " points with normals:"
+            << " vtkTransformFilter " << referenceTimeSec << " s, vtkParallelTransformFilter " << parallelTimeSec << " s" << std::endl;
+
+  vtkPointSet* referenceOutput = vtkPointSet::SafeDownCast(referenceFilter->GetOutput());
+  vtkPointSet* parallelOutput = vtkPointSet::SafeDownCast(parallelFilter->GetOutput());
+  CHECK_NOT_NULL(referenceOutput);
+  CHECK_NOT_NULL(parallelOutput);
+  CHECK_INT(parallelOutput->GetNumberOfCells(), referenceOutput->GetNumberOfCells());
+  CHECK_EXIT_SUCCESS(CompareArrays(parallelOutput->GetPoints()->GetData(), referenceOutput->GetPoints()->GetData(), 1e-4));
+  CHECK_EXIT_SUCCESS(CompareArrays(parallelOutput->GetPointData()->GetNormals(), referenceOutput->GetPointData()->GetNormals(), 1e-4));
+
+  // Without normals, only points are transformed
+  vtkNew<vtkPolyData> inputWithoutNormals;
+  inputWithoutNormals->DeepCopy(input);
+  inputWithoutNormals->GetPointData()->SetNormals(nullptr);
+  referenceFilter->SetInputData(inputWithoutNormals);
+  referenceFilter->Update();
+  parallelFilter->SetInputData(inputWithoutNormals);
+  timer->StartTimer();
+  parallelFilter->Update();
+  timer->StopTimer();
+  std::cout << "Transform points without normals: vtkParallelTransformFilter " << timer->GetElapsedTime() << " s" << std::endl;
+  parallelOutput = vtkPointSet::SafeDownCast(parallelFilter->GetOutput());
+  referenceOutput = vtkPointSet::SafeDownCast(referenceFilter->GetOutput());
+  CHECK_NULL(parallelOutput->GetPointData()->GetNormals());
+  CHECK_EXIT_SUCCESS(CompareArrays(parallelOutput->GetPoints()->GetData(), referenceOutput->GetPoints()->GetData(), 1e-4));
+
+  // Perspective transforms are processed in parallel as well
+  vtkNew<vtkPerspectiveTransform> perspectiveTransform;
+  vtkNew<vtkMatrix4x4> perspectiveMatrix;
+  perspectiveMatrix->SetElement(3, 2, 0.002);
+  perspectiveTransform->SetMatrix(perspectiveMatrix);
+  transform->Concatenate(perspectiveTransform);
+  referenceFilter->SetInputData(input);
+  referenceFilter->Update();
+  parallelFilter->SetInputData(input);
+  parallelFilter->Update();
+  CHECK_BOOL(parallelFilter->GetParallelExecution(), true);
+  parallelOutput = vtkPointSet::SafeDownCast(parallelFilter->GetOutput());
+  referenceOutput = vtkPointSet::SafeDownCast(referenceFilter->GetOutput());
+  CHECK_EXIT_SUCCESS(CompareArrays(parallelOutput->GetPoints()->GetData(), referenceOutput->GetPoints()->GetData(), 1e-4));
+  CHECK_EXIT_SUCCESS(CompareArrays(parallelOutput->GetPointData()->GetNormals(), referenceOutput->GetPointData()->GetNormals(), 1e-4));
+
+  // Linear transforms are processed by vtkTransformFilter
+  parallelFilter->SetTransform(linearTransform1);
+  parallelFilter->Update();
+  CHECK_BOOL(parallelFilter->GetParallelExecution(), false);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2010 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkSurfaceGeodesicPathCalculator.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create a flat triangulated grid with unit spacing.
+/// Each grid cell is split into two triangles along the (i,j)-(i+1,j+1) diagonal.
+void CreateGridSurface(vtkPolyData* surface, int size)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < size; ++j)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.0);
+    }
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j + 1 < size; ++j)
+  {
+    for (int i = 0; i + 1 < size; ++i)
+    {
+      vtkIdType p00 = j * size + i;
+      vtkIdType p10 = p00 + 1;
+      vtkIdType p01 = p00 + size;
+      vtkIdType p11 = p01 + 1;
+      vtkIdType triangle1[3] = { p00, p10, p11 };
+      vtkIdType triangle2[3] = { p00, p11, p01 };
+      polys->InsertNextCell(3, triangle1);
+      polys->InsertNextCell(3, triangle2);
+    }
+  }
+  surface->SetPoints(points);
+  surface->SetPolys(polys);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSurfaceGeodesicPathCalculatorTest1(int, char*[])
+{
+  const int gridSize = 200;
+  vtkNew<vtkPolyData> surface;
+  CreateGridSurface(surface, gridSize);
+
+  vtkNew<vtkSurfaceGeodesicPathCalculator> calculator;
+  calculator->SetSurface(surface);
+  CHECK_BOOL(calculator->IsGraphUpToDate(), false);
+  CHECK_INT(calculator->GetNumberOfVertices(), gridSize * gridSize);
+  // horizontal + vertical + diagonal edges
+  CHECK_INT(calculator->GetNumberOfEdges(), 2 * gridSize * (gridSize - 1) + (gridSize - 1) * (gridSize - 1));
+  CHECK_BOOL(calculator->IsGraphUpToDate(), true);
+
+  double startPosition[3] = { 0.1, -0.2, 1.0 };
+  double endPosition[3] = { gridSize - 1.0, 10.0, 0.0 };
+  vtkIdType startVertexId = calculator->FindClosestVertex(startPosition);
+  vtkIdType endVertexId = calculator->FindClosestVertex(endPosition);
+  CHECK_INT(startVertexId, 0);
+  CHECK_INT(endVertexId, 10 * gridSize + gridSize - 1);
+
+  // A* search and Dijkstra's algorithm must find equally short paths
+  vtkNew<vtkIdList> path;
+  double pathLength = 0.0;
+  CHECK_BOOL(calculator->ComputePath(startVertexId, endVertexId, path, &pathLength), true);
+  CHECK_INT(path->GetId(0), startVertexId);
+  CHECK_INT(path->GetId(path->GetNumberOfIds() - 1), endVertexId);
+  CHECK_DOUBLE_TOLERANCE(pathLength, (gridSize - 1 - 10) + 10 * sqrt(2.0), 1e-9);
+  vtkIdType numberOfVisitedVerticesAStar = calculator->GetNumberOfVisitedVertices();
+
+  calculator->UseDistanceHeuristicOff();
+  double dijkstraPathLength = 0.0;
+  CHECK_BOOL(calculator->ComputePath(startVertexId, endVertexId, path, &dijkstraPathLength), true);
+  CHECK_DOUBLE_TOLERANCE(dijkstraPathLength, pathLength, 1e-9);
+  vtkIdType numberOfVisitedVerticesDijkstra = calculator->GetNumberOfVisitedVertices();
+  std::cout << "Visited vertices: A* " << numberOfVisitedVerticesAStar << ", Dijkstra " << numberOfVisitedVerticesDijkstra << std::endl;
+  CHECK_BOOL(numberOfVisitedVerticesAStar < numberOfVisitedVerticesDijkstra, true);
+  calculator->UseDistanceHeuristicOn();
+
+  // Changing search options must not invalidate the graph
+  CHECK_BOOL(calculator->IsGraphUpToDate(), true);
+
+  // Path through points
+  vtkNew<vtkPoints> controlPoints;
+  controlPoints->InsertNextPoint(0.0, 0.0, 0.0);
+  controlPoints->InsertNextPoint(50.0, 0.0, 0.0);
+  controlPoints->InsertNextPoint(50.0, 50.0, 0.0);
+  vtkNew<vtkPoints> pathPoints;
+  vtkNew<vtkDoubleArray> pedigreeIds;
+  CHECK_BOOL(calculator->ComputePathThroughPoints(controlPoints, false, pathPoints, pedigreeIds), true);
+  CHECK_INT(pathPoints->GetNumberOfPoints(), 101);
+  CHECK_INT(pedigreeIds->GetNumberOfTuples(), 101);
+  CHECK_DOUBLE_TOLERANCE(pedigreeIds->GetValue(0), 0.0, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(pedigreeIds->GetValue(50), 1.0, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(pedigreeIds->GetValue(100), 2.0, 1e-9);
+  for (vtkIdType i = 1; i < pedigreeIds->GetNumberOfTuples(); ++i)
+  {
+    CHECK_BOOL(pedigreeIds->GetValue(i) > pedigreeIds->GetValue(i - 1), true);
+  }
+  CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(pathPoints->GetPoint(100), controlPoints->GetPoint(2)), 0.0, 1e-12);
+
+  // Closed path: segment from the last point to the first point is added, last point is not repeated
+  CHECK_BOOL(calculator->ComputePathThroughPoints(controlPoints, true, pathPoints, pedigreeIds), true);
+  CHECK_INT(pathPoints->GetNumberOfPoints(), 150);
+  CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(pathPoints->GetPoint(0), controlPoints->GetPoint(0)), 0.0, 1e-12);
+
+  // Modifying the surface invalidates the graph
+  surface->GetPoints()->SetPoint(1, 0.5, 0.0, 0.0);
+  surface->GetPoints()->Modified();
+  CHECK_BOOL(calculator->IsGraphUpToDate(), false);
+  CHECK_BOOL(calculator->ComputePath(0, 2, path, &pathLength), true);
+  CHECK_DOUBLE_TOLERANCE(pathLength, 2.0, 1e-9);
+
+  // Disconnected vertices
+  vtkIdType isolatedVertexId = surface->GetPoints()->InsertNextPoint(-10.0, -10.0, 0.0);
+  surface->GetPoints()->Modified();
+  CHECK_BOOL(calculator->ComputePath(0, isolatedVertexId, path), false);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
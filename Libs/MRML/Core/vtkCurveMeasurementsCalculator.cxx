@@ -34,8 +34,12 @@
 #include <vtkParallelTransportFrame.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkTrivialProducer.h>
 #include <vtkTriangleFilter.h>
 
+// STD includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveMeasurementsCalculator);
 
@@ -86,6 +90,7 @@ void vtkCurveMeasurementsCalculator::PrintSelf(std::ostream& os, vtkIndent inden
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "CalculateCurvature: " << this->CalculateCurvature << std::endl;
+  os << indent << "IncrementalUpdate: " << this->IncrementalUpdate << std::endl;
 }
 
 //----------------------------------------------------------------------------------
@@ -140,10 +145,18 @@ int vtkCurveMeasurementsCalculator::RequestData(vtkInformation* vtkNotUsed(reque
   outputPolyData->GetCellData()->PassData(inputPolyData->GetCellData());
   outputPolyData->GetFieldData()->PassData(inputPolyData->GetFieldData());
 
+  // Results of the previous execution can only be reused if the curve node reported all the changes
+  // since then, which is not the case if any algorithm in the input pipeline has been modified.
+  vtkMTimeType pipelineMTime = this->GetPipelineMTime();
+  bool incremental = this->IncrementalUpdate                                          //
+                     && !this->AllCurvePointsModified                                 //
+                     && pipelineMTime == this->LastExecutionPipelineMTime             //
+                     && inputPolyData->GetNumberOfPoints() == this->LastExecutionNumberOfPoints;
+
   int returnValue = 1;
   if (this->CalculateCurvature)
   {
-    if (!this->CalculatePolyDataCurvature(outputPolyData))
+    if (!this->CalculatePolyDataCurvature(outputPolyData, incremental))
     {
       vtkErrorMacro("Failed to calculate curve markup curvature");
       returnValue = 0;
@@ -152,6 +165,9 @@ int vtkCurveMeasurementsCalculator::RequestData(vtkInformation* vtkNotUsed(reque
   else
   {
     outputPolyData->GetPointData()->RemoveArray(this->GetCurvatureArrayName());
+    // Cached curvature is not updated, therefore it cannot be used in the next execution
+    this->CachedCurvatures.clear();
+    this->CachedCurvatureWeights.clear();
   }
 
   if (this->CalculateTorsion)
@@ -168,14 +184,82 @@ int vtkCurveMeasurementsCalculator::RequestData(vtkInformation* vtkNotUsed(reque
   }
 
   // Go through measurements, and interpolate those that contain control point data and are enabled
-  this->InterpolateControlPointMeasurementToPolyData(outputPolyData);
+  this->InterpolateControlPointMeasurementToPolyData(outputPolyData, incremental);
+
+  this->ModifiedCurvePointRange[0] = 0;
+  this->ModifiedCurvePointRange[1] = -1;
+  this->AllCurvePointsModified = false;
+  this->LastExecutionPipelineMTime = pipelineMTime;
+  this->LastExecutionNumberOfPoints = inputPolyData->GetNumberOfPoints();
 
   outputPolyData->Squeeze();
   return returnValue;
 }
 
 //------------------------------------------------------------------------------
-bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* polyData)
+void vtkCurveMeasurementsCalculator::AddModifiedCurvePointRange(vtkIdType firstIndex, vtkIdType lastIndex)
+{
+  if (firstIndex > lastIndex)
+  {
+    return;
+  }
+  if (this->ModifiedCurvePointRange[0] > this->ModifiedCurvePointRange[1])
+  {
+    this->ModifiedCurvePointRange[0] = firstIndex;
+    this->ModifiedCurvePointRange[1] = lastIndex;
+  }
+  else
+  {
+    this->ModifiedCurvePointRange[0] = std::min(this->ModifiedCurvePointRange[0], firstIndex);
+    this->ModifiedCurvePointRange[1] = std::max(this->ModifiedCurvePointRange[1], lastIndex);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkCurveMeasurementsCalculator::SetAllCurvePointsModified()
+{
+  this->AllCurvePointsModified = true;
+}
+
+//------------------------------------------------------------------------------
+vtkMTimeType vtkCurveMeasurementsCalculator::GetPipelineMTime()
+{
+  // Superclass modified time is used because measurements are modified during execution
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  std::vector<vtkAlgorithm*> algorithms = { this };
+  while (!algorithms.empty())
+  {
+    vtkAlgorithm* algorithm = algorithms.back();
+    algorithms.pop_back();
+    for (int port = 0; port < algorithm->GetNumberOfInputPorts(); ++port)
+    {
+      for (int connection = 0; connection < algorithm->GetNumberOfInputConnections(port); ++connection)
+      {
+        vtkAlgorithm* inputAlgorithm = algorithm->GetInputAlgorithm(port, connection);
+        if (!inputAlgorithm || vtkTrivialProducer::SafeDownCast(inputAlgorithm))
+        {
+          // Input data changes are reported by the curve node
+          continue;
+        }
+        mTime = std::max(mTime, inputAlgorithm->GetMTime());
+        algorithms.push_back(inputAlgorithm);
+      }
+    }
+  }
+  return mTime;
+}
+
+//------------------------------------------------------------------------------
+void vtkCurveMeasurementsCalculator::ResetCache()
+{
+  this->CachedCurvatures.clear();
+  this->CachedCurvatureWeights.clear();
+  this->CachedInterpolatedMeasurements.clear();
+  this->AllCurvePointsModified = true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* polyData, bool incremental /*=false*/)
 {
   if (polyData == nullptr)
   {
@@ -202,6 +286,61 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
     return false;
   }
 
+  // Get the range of curve points that moved since the last execution
+  vtkIdType firstModifiedIndex = 0;
+  vtkIdType lastModifiedIndex = numberOfPoints - 1;
+  if (incremental && this->CachedCurvatures.size() == static_cast<size_t>(numberOfPoints))
+  {
+    firstModifiedIndex = std::max<vtkIdType>(0, this->ModifiedCurvePointRange[0]);
+    lastModifiedIndex = std::min<vtkIdType>(numberOfPoints - 1, this->ModifiedCurvePointRange[1]);
+  }
+  else
+  {
+    this->CachedCurvatures.assign(numberOfPoints, 0.0);
+    this->CachedCurvatureWeights.assign(numberOfPoints, 0.0);
+  }
+
+  // Curvature and length weight of a point depends on the point and its two neighbors
+  vtkIdType recomputeStartIndex = std::max<vtkIdType>(1, firstModifiedIndex - 1);
+  vtkIdType recomputeEndIndex = std::min<vtkIdType>(numberOfPoints - 2, lastModifiedIndex + 1);
+  this->NumberOfRecomputedCurvaturePoints = std::max<vtkIdType>(0, recomputeEndIndex - recomputeStartIndex + 1);
+  for (vtkIdType idx = recomputeStartIndex; idx <= recomputeEndIndex; ++idx)
+  {
+    double prevPoint[3] = { 0.0, 0.0, 0.0 }; // pp
+    double currPoint[3] = { 0.0, 0.0, 0.0 }; // p
+    double nextPoint[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(linePoints->GetId(idx - 1), prevPoint);
+    points->GetPoint(linePoints->GetId(idx), currPoint);
+    points->GetPoint(linePoints->GetId(idx + 1), nextPoint);
+
+    double prevDiffVector[3] = { currPoint[0] - prevPoint[0], currPoint[1] - prevPoint[1], currPoint[2] - prevPoint[2] };
+    double prevDiffNorm = sqrt(prevDiffVector[0] * prevDiffVector[0] + prevDiffVector[1] * prevDiffVector[1] + prevDiffVector[2] * prevDiffVector[2]);
+    double prevNormDiffVector[3] = { prevDiffVector[0] / prevDiffNorm, prevDiffVector[1] / prevDiffNorm, prevDiffVector[2] / prevDiffNorm }; // pT
+
+    double diffVector[3] = { nextPoint[0] - currPoint[0], nextPoint[1] - currPoint[1], nextPoint[2] - currPoint[2] };
+    double diffNorm = sqrt(diffVector[0] * diffVector[0] + diffVector[1] * diffVector[1] + diffVector[2] * diffVector[2]); // ds
+    double normDiffVector[3] = { diffVector[0] / diffNorm, diffVector[1] / diffNorm, diffVector[2] / diffNorm };          // T
+
+    // Local curvature
+    this->CachedCurvatures[idx] = sqrt((normDiffVector[0] - prevNormDiffVector[0]) * (normDiffVector[0] - prevNormDiffVector[0])   //
+                                       + (normDiffVector[1] - prevNormDiffVector[1]) * (normDiffVector[1] - prevNormDiffVector[1]) //
+                                       + (normDiffVector[2] - prevNormDiffVector[2]) * (normDiffVector[2] - prevNormDiffVector[2]))
+                                  / diffNorm;
+
+    // Length of the curve section that belongs to this point (between the midpoints of the adjacent segments)
+    double meanPoint[3] = { (nextPoint[0] + currPoint[0]) / 2.0, (nextPoint[1] + currPoint[1]) / 2.0, (nextPoint[2] + currPoint[2]) / 2.0 }; // m
+    double prevMeanPoint[3] = { currPoint[0], currPoint[1], currPoint[2] };                                                                  // pm (Skip first point)
+    if (idx > 1)
+    {
+      prevMeanPoint[0] = (currPoint[0] + prevPoint[0]) / 2.0;
+      prevMeanPoint[1] = (currPoint[1] + prevPoint[1]) / 2.0;
+      prevMeanPoint[2] = (currPoint[2] + prevPoint[2]) / 2.0;
+    }
+    this->CachedCurvatureWeights[idx] = sqrt((meanPoint[0] - prevMeanPoint[0]) * (meanPoint[0] - prevMeanPoint[0])   //
+                                             + (meanPoint[1] - prevMeanPoint[1]) * (meanPoint[1] - prevMeanPoint[1]) //
+                                             + (meanPoint[2] - prevMeanPoint[2]) * (meanPoint[2] - prevMeanPoint[2]));
+  }
+
   // Initialize curvature array
   vtkSmartPointer<vtkDoubleArray> curvatureValues = vtkDoubleArray::SafeDownCast(polyData->GetPointData()->GetArray(this->GetCurvatureArrayName()));
   if (curvatureValues == nullptr)
@@ -212,61 +351,17 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   curvatureValues->SetName(this->GetCurvatureArrayName());
   curvatureValues->SetNumberOfComponents(1);
   curvatureValues->SetNumberOfTuples(numberOfPoints);
-  curvatureValues->Reset();
   curvatureValues->FillComponent(0, 0.0);
 
-  // Initialize curvature variables
+  // Statistics
   double minKappa = 0.0;
   double maxKappa = 0.0;
   double meanKappa = 0.0; // Mean is weighted by the length of each segment
-
-  // Get values for first point
-  double prevPoint[3] = { points->GetPoint(linePoints->GetId(0))[0], points->GetPoint(linePoints->GetId(0))[1], points->GetPoint(linePoints->GetId(0))[2] }; // pp
-  double* currPoint = points->GetPoint(linePoints->GetId(1));                                                                                                // p
-  double diffVector[3] = { currPoint[0] - prevPoint[0], currPoint[1] - prevPoint[1], currPoint[2] - prevPoint[2] };
-  double diffNorm = sqrt(diffVector[0] * diffVector[0] + diffVector[1] * diffVector[1] + diffVector[2] * diffVector[2]); // ds
-  double normDiffVector[3] = { 0.0, 0.0, 0.0 };                                                                          // T
-  double prevNormDiffVector[3] = { diffVector[0] / diffNorm, diffVector[1] / diffNorm, diffVector[2] / diffNorm };       // pT
-  double meanPoint[3] = { 0.0, 0.0, 0.0 };                                                                               // m
-  double prevMeanPoint[3] = { currPoint[0], currPoint[1], currPoint[2] };                                                // pm (Skip first point)
-  double kappa = 0.0;
-  double currentLength = 0.0;
   double length = 0.0;
-
-  // The curvature for the first cell is 0.0 for open curves
-  curvatureValues->InsertValue(linePoints->GetId(0), 0.0);
-
-  prevPoint[0] = currPoint[0];
-  prevPoint[1] = currPoint[1];
-  prevPoint[2] = currPoint[2];
   for (vtkIdType idx = 1; idx < numberOfPoints - 1; ++idx)
   {
-    currPoint = points->GetPoint(linePoints->GetId(idx + 1));
-
-    diffVector[0] = currPoint[0] - prevPoint[0];
-    diffVector[1] = currPoint[1] - prevPoint[1];
-    diffVector[2] = currPoint[2] - prevPoint[2];
-    diffNorm = sqrt(diffVector[0] * diffVector[0] + diffVector[1] * diffVector[1] + diffVector[2] * diffVector[2]);
-
-    normDiffVector[0] = diffVector[0] / diffNorm;
-    normDiffVector[1] = diffVector[1] / diffNorm;
-    normDiffVector[2] = diffVector[2] / diffNorm;
-
-    // Local curvature
-    kappa = sqrt((normDiffVector[0] - prevNormDiffVector[0]) * (normDiffVector[0] - prevNormDiffVector[0])   //
-                 + (normDiffVector[1] - prevNormDiffVector[1]) * (normDiffVector[1] - prevNormDiffVector[1]) //
-                 + (normDiffVector[2] - prevNormDiffVector[2]) * (normDiffVector[2] - prevNormDiffVector[2]))
-            / diffNorm;
-    curvatureValues->InsertValue(linePoints->GetId(idx), kappa);
-
-    // Statistics
-    meanPoint[0] = (currPoint[0] + prevPoint[0]) / 2.0;
-    meanPoint[1] = (currPoint[1] + prevPoint[1]) / 2.0;
-    meanPoint[2] = (currPoint[2] + prevPoint[2]) / 2.0;
-
-    currentLength = sqrt((meanPoint[0] - prevMeanPoint[0]) * (meanPoint[0] - prevMeanPoint[0])   //
-                         + (meanPoint[1] - prevMeanPoint[1]) * (meanPoint[1] - prevMeanPoint[1]) //
-                         + (meanPoint[2] - prevMeanPoint[2]) * (meanPoint[2] - prevMeanPoint[2]));
+    double kappa = this->CachedCurvatures[idx];
+    curvatureValues->SetValue(linePoints->GetId(idx), kappa);
     if (kappa < minKappa)
     {
       minKappa = kappa;
@@ -275,33 +370,32 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
     {
       maxKappa = kappa;
     }
-    meanKappa += kappa * currentLength; // weighted mean
-    length += currentLength;
-
-    // Propagate current values to previous
-    for (int i = 0; i < 3; ++i)
-    {
-      prevPoint[i] = currPoint[i];
-      prevMeanPoint[i] = meanPoint[i];
-      prevNormDiffVector[i] = normDiffVector[i];
-    }
+    meanKappa += kappa * this->CachedCurvatureWeights[idx]; // weighted mean
+    length += this->CachedCurvatureWeights[idx];
   } // For each line point
 
   if (!this->CurveIsClosed)
   {
-    // The curvature for the last cell by definition is 0.0 for open curves
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints - 1), 0.0);
+    // The curvature for the first and last cell by definition is 0.0 for open curves
+    curvatureValues->SetValue(linePoints->GetId(0), 0.0);
+    curvatureValues->SetValue(linePoints->GetId(numberOfPoints - 1), 0.0);
   }
   else
   {
     // Use the adjacent values for closed curve instead of the singular values
-    curvatureValues->SetComponent(linePoints->GetId(0), 0, curvatureValues->GetValue(linePoints->GetId(1)));
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints - 1), curvatureValues->GetValue(linePoints->GetId(numberOfPoints - 2)));
-  }
-
-  currentLength = sqrt((prevPoint[0] - prevMeanPoint[0]) * (prevPoint[0] - prevMeanPoint[0])   //
-                       + (prevPoint[1] - prevMeanPoint[1]) * (prevPoint[1] - prevMeanPoint[1]) //
-                       + (prevPoint[2] - prevMeanPoint[2]) * (prevPoint[2] - prevMeanPoint[2]));
+    curvatureValues->SetValue(linePoints->GetId(0), curvatureValues->GetValue(linePoints->GetId(1)));
+    curvatureValues->SetValue(linePoints->GetId(numberOfPoints - 1), curvatureValues->GetValue(linePoints->GetId(numberOfPoints - 2)));
+  }
+
+  // Length of the last half segment
+  double lastPoint[3] = { 0.0, 0.0, 0.0 };
+  double beforeLastPoint[3] = { 0.0, 0.0, 0.0 };
+  points->GetPoint(linePoints->GetId(numberOfPoints - 1), lastPoint);
+  points->GetPoint(linePoints->GetId(numberOfPoints - 2), beforeLastPoint);
+  double lastMeanPoint[3] = { (lastPoint[0] + beforeLastPoint[0]) / 2.0, (lastPoint[1] + beforeLastPoint[1]) / 2.0, (lastPoint[2] + beforeLastPoint[2]) / 2.0 };
+  double currentLength = sqrt((lastPoint[0] - lastMeanPoint[0]) * (lastPoint[0] - lastMeanPoint[0])   //
+                              + (lastPoint[1] - lastMeanPoint[1]) * (lastPoint[1] - lastMeanPoint[1]) //
+                              + (lastPoint[2] - lastMeanPoint[2]) * (lastPoint[2] - lastMeanPoint[2]));
   length += currentLength;
   if (length > 0.0)
   {
@@ -525,7 +619,7 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataTorsion(vtkPolyData* polyD
 }
 
 //------------------------------------------------------------------------------
-bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData)
+bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData, bool incremental /*=false*/)
 {
   if (!this->InputMarkupsMRMLNode)
   {
@@ -553,6 +647,11 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
     return false;
   }
 
+  // Interpolated values only depend on the control point values and the pedigree IDs,
+  // therefore they can be reused when only the curve point positions changed.
+  this->NumberOfRecomputedInterpolatedMeasurements = 0;
+  std::map<std::string, InterpolatedMeasurementCacheItem> interpolatedMeasurements;
+
   // Calculate and set interpolated control point measurements in poly data
   for (int index = 0; index < this->InputMarkupsMRMLNode->GetNumberOfMeasurements(); ++index)
   {
@@ -574,12 +673,27 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
     }
 
     // Observe control point data array. If it is modified, then interpolation needs to be re-run
-    controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
-    vtkWeakPointer<vtkDoubleArray> controlPointArrayWeakPointer(controlPointValues);
-    this->ObservedControlPointArrays->AddItem(controlPointArrayWeakPointer);
+    if (!this->ObservedControlPointArrays->IsItemPresent(controlPointValues))
+    {
+      controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
+      this->ObservedControlPointArrays->AddItem(controlPointValues);
+    }
 
-    vtkNew<vtkDoubleArray> interpolatedMeasurement;
     std::string arrayName = !currentMeasurement->GetName().empty() ? currentMeasurement->GetName() : "Unnamed";
+
+    auto cachedItemIt = this->CachedInterpolatedMeasurements.find(arrayName);
+    if (incremental                                                                       //
+        && cachedItemIt != this->CachedInterpolatedMeasurements.end()                     //
+        && cachedItemIt->second.ControlPointValues.GetPointer() == controlPointValues     //
+        && cachedItemIt->second.ControlPointValuesMTime == controlPointValues->GetMTime() //
+        && cachedItemIt->second.InterpolatedValues)
+    {
+      outputPolyData->GetPointData()->AddArray(cachedItemIt->second.InterpolatedValues);
+      interpolatedMeasurements[arrayName] = cachedItemIt->second;
+      continue;
+    }
+
+    vtkNew<vtkDoubleArray> interpolatedMeasurement;
     interpolatedMeasurement->SetName(arrayName.c_str());
 
     if (!vtkCurveMeasurementsCalculator::InterpolateArray(controlPointValues, this->CurveIsClosed, interpolatedMeasurement, pedigreeIdsArray, 1.0))
@@ -587,10 +701,19 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
       vtkErrorMacro("Failed to add " + arrayName + " measurement array to curve");
       continue;
     }
+    ++this->NumberOfRecomputedInterpolatedMeasurements;
 
     outputPolyData->GetPointData()->AddArray(interpolatedMeasurement);
+
+    InterpolatedMeasurementCacheItem& cacheItem = interpolatedMeasurements[arrayName];
+    cacheItem.ControlPointValues = controlPointValues;
+    cacheItem.ControlPointValuesMTime = controlPointValues->GetMTime();
+    cacheItem.InterpolatedValues = interpolatedMeasurement;
   }
 
+  // Only keep cache items of the measurements that are still interpolated
+  this->CachedInterpolatedMeasurements.swap(interpolatedMeasurements);
+
   return true;
 }
 
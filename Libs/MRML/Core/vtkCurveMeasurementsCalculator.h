@@ -23,6 +23,7 @@
 #include <vtkPolyData.h>
 #include <vtkPolyDataAlgorithm.h>
 #include <vtkSetGet.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
 // Markups MRML includes
@@ -31,12 +32,23 @@
 // Export
 #include "vtkMRMLExport.h"
 
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
 class vtkCallbackCommand;
 
 /// Filter that calculates per-curve-point measurements for markups curves.
 /// - Interpolate control point measurements into curve point data
 /// - Calculate per-curve-point curvature (disabled by default)
 /// - Calculate per-curve-point torsion (disabled by default)
+///
+/// When IncrementalUpdate is enabled (default) and the curve node reported which curve points moved
+/// since the last execution (see AddModifiedCurvePointRange), results of the previous execution are reused:
+/// curvature is only recomputed around the moved curve points, and interpolated control point measurements
+/// are only recomputed if the control point values changed. This keeps the update cost low
+/// when a few control points of a long curve are moved interactively.
 class VTK_MRML_EXPORT vtkCurveMeasurementsCalculator : public vtkPolyDataAlgorithm
 {
 public:
@@ -94,6 +106,37 @@ public:
   vtkGetMacro(TorsionUnits, std::string);
   vtkSetMacro(TorsionUnits, std::string);
 
+  //@{
+  /// Set/Get flag determining whether results of the previous execution may be reused
+  /// for curve points and measurements that have not changed (enabled by default).
+  /// Results are the same as with full recomputation.
+  vtkSetMacro(IncrementalUpdate, bool);
+  vtkGetMacro(IncrementalUpdate, bool);
+  vtkBooleanMacro(IncrementalUpdate, bool);
+  //@}
+
+  /// Get the number of curve points whose curvature was recomputed in the last execution.
+  /// It is smaller than the number of curve points if the update could be performed incrementally.
+  vtkGetMacro(NumberOfRecomputedCurvaturePoints, vtkIdType);
+
+  /// Get the number of interpolated control point measurement arrays that were recomputed
+  /// in the last execution (measurements that were not modified are reused).
+  vtkGetMacro(NumberOfRecomputedInterpolatedMeasurements, int);
+
+  /// Report that since the last execution only the positions of the curve points in the specified range
+  /// (indices in line order) have changed, and the number of points and the point data are the same.
+  /// Ranges that are reported before the next execution are merged.
+  /// If no range is reported, or the input pipeline (any upstream algorithm) is modified,
+  /// then the next execution recomputes everything.
+  void AddModifiedCurvePointRange(vtkIdType firstIndex, vtkIdType lastIndex);
+
+  /// Report that the curve has changed in a way that cannot be described by a modified curve point range.
+  /// The next execution recomputes everything.
+  void SetAllCurvePointsModified();
+
+  /// Discard all cached results. The next execution recomputes everything.
+  void ResetCache();
+
   vtkMTimeType GetMTime() override;
 
   /// Store interpolated values of inputValues in interpolatedValues,
@@ -107,9 +150,15 @@ public:
                                double pedigreeIdsValueScale = 1.0);
 
 protected:
-  bool CalculatePolyDataCurvature(vtkPolyData* polyData);
+  /// If incremental is true then only the curvature around ModifiedCurvePointRange is recomputed.
+  bool CalculatePolyDataCurvature(vtkPolyData* polyData, bool incremental = false);
   bool CalculatePolyDataTorsion(vtkPolyData* polyData);
-  bool InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData);
+  /// If incremental is true then interpolated values of unmodified control point measurements are reused.
+  bool InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData, bool incremental = false);
+
+  /// Get the latest modified time of this filter and all algorithms upstream of it.
+  /// Data objects that are set as input data (such as the curve control points) are not included.
+  vtkMTimeType GetPipelineMTime();
 
   /// Callback function observing data array modified events.
   /// If a data array to interpolate is modified, then the interpolation needs to be re-run.
@@ -136,6 +185,34 @@ protected:
   std::string CurvatureUnits{ "mm-1" };
   std::string TorsionUnits{ "mm-1" };
 
+  /// Flag determining whether results of the previous execution may be reused
+  bool IncrementalUpdate{ true };
+
+  vtkIdType NumberOfRecomputedCurvaturePoints{ 0 };
+  int NumberOfRecomputedInterpolatedMeasurements{ 0 };
+
+  /// Range of curve points (in line order) that were reported as moved since the last execution
+  vtkIdType ModifiedCurvePointRange[2]{ 0, -1 };
+  /// Set if the curve may have changed since the last execution in a way that is not described by ModifiedCurvePointRange
+  bool AllCurvePointsModified{ true };
+  /// Pipeline modified time and number of curve points at the last execution
+  vtkMTimeType LastExecutionPipelineMTime{ 0 };
+  vtkIdType LastExecutionNumberOfPoints{ 0 };
+
+  /// Curvature at each curve point (in line order) computed in the last execution
+  std::vector<double> CachedCurvatures;
+  /// Curve length associated with each curve point (in line order), used for weighting the mean curvature
+  std::vector<double> CachedCurvatureWeights;
+
+  struct InterpolatedMeasurementCacheItem
+  {
+    vtkWeakPointer<vtkDoubleArray> ControlPointValues;
+    vtkMTimeType ControlPointValuesMTime{ 0 };
+    vtkSmartPointer<vtkDoubleArray> InterpolatedValues;
+  };
+  /// Interpolated control point measurements computed in the last execution, indexed by measurement name
+  std::map<std::string, InterpolatedMeasurementCacheItem> CachedInterpolatedMeasurements;
+
 protected:
   int FillInputPortInformation(int port, vtkInformation* info) override;
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
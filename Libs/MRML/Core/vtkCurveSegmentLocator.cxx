@@ -0,0 +1,373 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkCurveSegmentLocator.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCurveSegmentLocator);
+
+//----------------------------------------------------------------------------
+class vtkCurveSegmentLocator::vtkInternal
+{
+public:
+  struct Node
+  {
+    double Bounds[6];
+    vtkIdType FirstSegment;
+    vtkIdType NumberOfSegments;
+    int Children[2]; // -1 for leaf nodes
+  };
+
+  // Maximum depth of the traversal stack. The tree is balanced, therefore this is
+  // enough for any number of segments that can be indexed by vtkIdType.
+  static const int MAXIMUM_STACK_SIZE = 128;
+
+  void Clear()
+  {
+    this->Coordinates.clear();
+    this->Nodes.clear();
+    this->NumberOfPoints = 0;
+    this->NumberOfSegments = 0;
+    this->Built = false;
+  }
+
+  void GetSegmentEndPoints(vtkIdType segmentIndex, const double*& start, const double*& end) const
+  {
+    start = &this->Coordinates[3 * segmentIndex];
+    vtkIdType endPointIndex = (segmentIndex + 1 < this->NumberOfPoints ? segmentIndex + 1 : 0);
+    end = &this->Coordinates[3 * endPointIndex];
+  }
+
+  //----------------------------------------------------------------------------
+  int BuildNode(vtkIdType firstSegment, vtkIdType numberOfSegments, int maximumNumberOfSegmentsPerLeaf)
+  {
+    // Nodes vector may be reallocated while the children are built, so the node is always accessed by index
+    int nodeIndex = static_cast<int>(this->Nodes.size());
+    this->Nodes.emplace_back();
+    this->Nodes[nodeIndex].FirstSegment = firstSegment;
+    this->Nodes[nodeIndex].NumberOfSegments = numberOfSegments;
+    double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    if (numberOfSegments <= maximumNumberOfSegmentsPerLeaf)
+    {
+      for (vtkIdType segmentIndex = firstSegment; segmentIndex < firstSegment + numberOfSegments; ++segmentIndex)
+      {
+        const double* start = nullptr;
+        const double* end = nullptr;
+        this->GetSegmentEndPoints(segmentIndex, start, end);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          bounds[axis * 2] = std::min(bounds[axis * 2], std::min(start[axis], end[axis]));
+          bounds[axis * 2 + 1] = std::max(bounds[axis * 2 + 1], std::max(start[axis], end[axis]));
+        }
+      }
+      this->Nodes[nodeIndex].Children[0] = -1;
+      this->Nodes[nodeIndex].Children[1] = -1;
+    }
+    else
+    {
+      // Consecutive segments are spatially close, therefore splitting the index range in half
+      // gives good bounding boxes without the need for sorting.
+      vtkIdType numberOfLeftSegments = numberOfSegments / 2;
+      int leftChild = this->BuildNode(firstSegment, numberOfLeftSegments, maximumNumberOfSegmentsPerLeaf);
+      int rightChild = this->BuildNode(firstSegment + numberOfLeftSegments, numberOfSegments - numberOfLeftSegments, maximumNumberOfSegmentsPerLeaf);
+      const double* leftBounds = this->Nodes[leftChild].Bounds;
+      const double* rightBounds = this->Nodes[rightChild].Bounds;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        bounds[axis * 2] = std::min(leftBounds[axis * 2], rightBounds[axis * 2]);
+        bounds[axis * 2 + 1] = std::max(leftBounds[axis * 2 + 1], rightBounds[axis * 2 + 1]);
+      }
+      this->Nodes[nodeIndex].Children[0] = leftChild;
+      this->Nodes[nodeIndex].Children[1] = rightChild;
+    }
+    std::copy(bounds, bounds + 6, this->Nodes[nodeIndex].Bounds);
+    return nodeIndex;
+  }
+
+  //----------------------------------------------------------------------------
+  static double GetDistance2ToBounds(const double position[3], const double bounds[6])
+  {
+    double distance2 = 0.0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      double delta = 0.0;
+      if (position[axis] < bounds[axis * 2])
+      {
+        delta = bounds[axis * 2] - position[axis];
+      }
+      else if (position[axis] > bounds[axis * 2 + 1])
+      {
+        delta = position[axis] - bounds[axis * 2 + 1];
+      }
+      distance2 += delta * delta;
+    }
+    return distance2;
+  }
+
+  //----------------------------------------------------------------------------
+  static double GetClosestPointOnSegment(const double position[3], const double start[3], const double end[3], double closestPosition[3])
+  {
+    double direction[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+    double length2 = vtkMath::Dot(direction, direction);
+    double t = 0.0;
+    if (length2 > 0.0)
+    {
+      double startToPosition[3] = { position[0] - start[0], position[1] - start[1], position[2] - start[2] };
+      t = std::max(0.0, std::min(1.0, vtkMath::Dot(startToPosition, direction) / length2));
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      closestPosition[axis] = start[axis] + t * direction[axis];
+    }
+    return vtkMath::Distance2BetweenPoints(position, closestPosition);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Thread-safe query, the hierarchy must be already built.
+  vtkIdType FindClosestPoint(const double position[3], double closestPosition[3], double& closestDistance2) const
+  {
+    closestDistance2 = std::numeric_limits<double>::max();
+    if (this->Nodes.empty())
+    {
+      return -1;
+    }
+    vtkIdType closestSegmentIndex = -1;
+    int nodeStack[MAXIMUM_STACK_SIZE];
+    double nodeDistance2Stack[MAXIMUM_STACK_SIZE];
+    int stackSize = 0;
+    nodeStack[stackSize] = 0;
+    nodeDistance2Stack[stackSize] = GetDistance2ToBounds(position, this->Nodes[0].Bounds);
+    ++stackSize;
+    double segmentClosestPosition[3] = { 0.0, 0.0, 0.0 };
+    while (stackSize > 0)
+    {
+      --stackSize;
+      if (nodeDistance2Stack[stackSize] >= closestDistance2)
+      {
+        // this node cannot contain a closer point
+        continue;
+      }
+      const Node& node = this->Nodes[nodeStack[stackSize]];
+      if (node.Children[0] < 0)
+      {
+        for (vtkIdType segmentIndex = node.FirstSegment; segmentIndex < node.FirstSegment + node.NumberOfSegments; ++segmentIndex)
+        {
+          const double* start = nullptr;
+          const double* end = nullptr;
+          this->GetSegmentEndPoints(segmentIndex, start, end);
+          double distance2 = GetClosestPointOnSegment(position, start, end, segmentClosestPosition);
+          if (distance2 < closestDistance2)
+          {
+            closestDistance2 = distance2;
+            closestSegmentIndex = segmentIndex;
+            std::copy(segmentClosestPosition, segmentClosestPosition + 3, closestPosition);
+          }
+        }
+        continue;
+      }
+      // Push the farther child first so that the closer child is visited first,
+      // which makes it more likely that the farther child can be skipped.
+      double leftDistance2 = GetDistance2ToBounds(position, this->Nodes[node.Children[0]].Bounds);
+      double rightDistance2 = GetDistance2ToBounds(position, this->Nodes[node.Children[1]].Bounds);
+      int closerChild = (leftDistance2 <= rightDistance2 ? 0 : 1);
+      nodeStack[stackSize] = node.Children[1 - closerChild];
+      nodeDistance2Stack[stackSize] = (closerChild == 0 ? rightDistance2 : leftDistance2);
+      ++stackSize;
+      nodeStack[stackSize] = node.Children[closerChild];
+      nodeDistance2Stack[stackSize] = (closerChild == 0 ? leftDistance2 : rightDistance2);
+      ++stackSize;
+    }
+    return closestSegmentIndex;
+  }
+
+  std::vector<double> Coordinates;
+  std::vector<Node> Nodes;
+  vtkIdType NumberOfPoints{ 0 };
+  vtkIdType NumberOfSegments{ 0 };
+  bool Built{ false };
+  vtkTimeStamp BuildTime;
+};
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::vtkCurveSegmentLocator()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::~vtkCurveSegmentLocator()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ClosedCurve: " << this->ClosedCurve << "\n";
+  os << indent << "MaximumNumberOfSegmentsPerLeaf: " << this->MaximumNumberOfSegmentsPerLeaf << "\n";
+  os << indent << "NumberOfPoints: " << (this->Points ? this->Points->GetNumberOfPoints() : 0) << "\n";
+  os << indent << "NumberOfNodes: " << this->Internal->Nodes.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::SetPoints(vtkPoints* points)
+{
+  if (this->Points == points)
+  {
+    return;
+  }
+  this->Points = points;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPoints* vtkCurveSegmentLocator::GetPoints()
+{
+  return this->Points;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::Reset()
+{
+  this->Internal->Clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCurveSegmentLocator::IsUpToDate()
+{
+  if (!this->Internal->Built || !this->Points)
+  {
+    return false;
+  }
+  vtkMTimeType buildTime = this->Internal->BuildTime.GetMTime();
+  return buildTime > this->GetMTime() && buildTime > this->Points->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::BuildLocator()
+{
+  if (this->IsUpToDate())
+  {
+    return;
+  }
+  this->Internal->Clear();
+  vtkIdType numberOfPoints = (this->Points ? this->Points->GetNumberOfPoints() : 0);
+  if (numberOfPoints >= 2)
+  {
+    this->Internal->NumberOfPoints = numberOfPoints;
+    this->Internal->NumberOfSegments = (this->ClosedCurve ? numberOfPoints : numberOfPoints - 1);
+    this->Internal->Coordinates.resize(3 * numberOfPoints);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+      this->Points->GetPoint(pointIndex, &this->Internal->Coordinates[3 * pointIndex]);
+    }
+    // A balanced binary tree has less than twice as many nodes as leaves
+    this->Internal->Nodes.reserve(2 * (this->Internal->NumberOfSegments / this->MaximumNumberOfSegmentsPerLeaf + 1));
+    this->Internal->BuildNode(0, this->Internal->NumberOfSegments, this->MaximumNumberOfSegmentsPerLeaf);
+  }
+  this->Internal->Built = true;
+  this->Internal->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::GetNumberOfSegments()
+{
+  this->BuildLocator();
+  return this->Internal->NumberOfSegments;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindClosestPoint(const double position[3], double closestPosition[3], double& distance2)
+{
+  this->BuildLocator();
+  return this->Internal->FindClosestPoint(position, closestPosition, distance2);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCurveSegmentLocator::FindClosestPoints(vtkPoints* positions, vtkPoints* closestPositions, vtkIdTypeArray* segmentIndices /*=nullptr*/)
+{
+  if (!positions || !closestPositions)
+  {
+    vtkErrorMacro("FindClosestPoints failed: invalid input or output points");
+    return false;
+  }
+  this->BuildLocator();
+  if (this->Internal->NumberOfSegments < 1)
+  {
+    return false;
+  }
+
+  vtkSmartPointer<vtkPoints> inputPositions = positions;
+  if (positions == closestPositions)
+  {
+    // Output would overwrite the input, make a copy
+    inputPositions = vtkSmartPointer<vtkPoints>::New();
+    inputPositions->DeepCopy(positions);
+  }
+
+  vtkIdType numberOfPositions = inputPositions->GetNumberOfPoints();
+  closestPositions->SetDataTypeToDouble();
+  closestPositions->SetNumberOfPoints(numberOfPositions);
+  double* closestPositionsPtr = static_cast<double*>(closestPositions->GetVoidPointer(0));
+  vtkIdType* segmentIndicesPtr = nullptr;
+  if (segmentIndices)
+  {
+    segmentIndices->SetNumberOfComponents(1);
+    segmentIndices->SetNumberOfTuples(numberOfPositions);
+    segmentIndicesPtr = segmentIndices->GetPointer(0);
+  }
+
+  const vtkInternal* internal = this->Internal;
+  vtkSMPTools::For(0,
+                   numberOfPositions,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     double position[3] = { 0.0, 0.0, 0.0 };
+                     double distance2 = 0.0;
+                     for (vtkIdType positionIndex = begin; positionIndex < end; ++positionIndex)
+                     {
+                       inputPositions->GetPoint(positionIndex, position);
+                       vtkIdType segmentIndex = internal->FindClosestPoint(position, closestPositionsPtr + 3 * positionIndex, distance2);
+                       if (segmentIndicesPtr)
+                       {
+                         segmentIndicesPtr[positionIndex] = segmentIndex;
+                       }
+                     }
+                   });
+
+  closestPositions->Modified();
+  if (segmentIndices)
+  {
+    segmentIndices->Modified();
+  }
+  return true;
+}
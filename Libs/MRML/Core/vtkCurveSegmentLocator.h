@@ -0,0 +1,126 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkCurveSegmentLocator_h
+#define __vtkCurveSegmentLocator_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// Export
+#include "vtkMRMLExport.h"
+
+class vtkIdTypeArray;
+class vtkPoints;
+
+/// \brief Locator for finding the closest point on a polyline (such as a markups curve).
+///
+/// Segments of the polyline (point i to point i+1, and the closing segment from the last
+/// point to the first point for closed curves) are stored in a bounding volume hierarchy.
+/// Since consecutive curve segments are spatially coherent, the hierarchy is built by
+/// recursively splitting the segment index range, which makes building linear in the
+/// number of segments. Closest point queries then only need to visit a few leaves
+/// instead of all the segments.
+///
+/// The hierarchy is built on first query and only rebuilt if the points or the closed
+/// curve flag are changed. Queries are exact (the returned point is the closest point on
+/// the polyline, not just the closest vertex).
+///
+/// \code
+/// vtkNew<vtkCurveSegmentLocator> locator;
+/// locator->SetPoints(curvePoints);
+/// locator->SetClosedCurve(false);
+/// double closestPosition[3];
+/// double distance2 = 0.0;
+/// vtkIdType segmentIndex = locator->FindClosestPoint(position, closestPosition, distance2);
+/// \endcode
+class VTK_MRML_EXPORT vtkCurveSegmentLocator : public vtkObject
+{
+public:
+  static vtkCurveSegmentLocator* New();
+  vtkTypeMacro(vtkCurveSegmentLocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /// Set/Get the polyline points.
+  /// The locator is rebuilt if the points object or its content is modified.
+  void SetPoints(vtkPoints* points);
+  vtkPoints* GetPoints();
+  //@}
+
+  //@{
+  /// If enabled then a segment connecting the last point to the first point is added.
+  /// Disabled by default.
+  vtkSetMacro(ClosedCurve, bool);
+  vtkGetMacro(ClosedCurve, bool);
+  vtkBooleanMacro(ClosedCurve, bool);
+  //@}
+
+  //@{
+  /// Maximum number of segments stored in a leaf of the hierarchy.
+  /// Default is 8.
+  vtkSetClampMacro(MaximumNumberOfSegmentsPerLeaf, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfSegmentsPerLeaf, int);
+  //@}
+
+  /// Build the hierarchy if it is not up-to-date with the input points.
+  /// It is not necessary to call this method explicitly, queries build the hierarchy when needed.
+  void BuildLocator();
+
+  /// Discard the hierarchy. Next query rebuilds it.
+  void Reset();
+
+  /// Returns true if the hierarchy is built and up-to-date with the input points.
+  bool IsUpToDate();
+
+  /// Get number of segments (0 if there are less than 2 points).
+  vtkIdType GetNumberOfSegments();
+
+  /// Find the closest point on the polyline.
+  /// \param position input position
+  /// \param closestPosition output closest position on the polyline
+  /// \param distance2 squared distance between position and closestPosition
+  /// \return Index of the segment that contains the closest point (index of the segment start point).
+  ///   -1 if there are no segments.
+  vtkIdType FindClosestPoint(const double position[3], double closestPosition[3], double& distance2);
+
+  /// Find the closest point on the polyline for many positions at once.
+  /// The queries are processed in parallel.
+  /// \param positions input positions
+  /// \param closestPositions output closest positions on the polyline (same number of points as positions)
+  /// \param segmentIndices optional output array containing index of the segment of each closest position
+  /// \return false if there are no segments.
+  bool FindClosestPoints(vtkPoints* positions, vtkPoints* closestPositions, vtkIdTypeArray* segmentIndices = nullptr);
+
+protected:
+  vtkCurveSegmentLocator();
+  ~vtkCurveSegmentLocator() override;
+
+  vtkSmartPointer<vtkPoints> Points;
+  bool ClosedCurve{ false };
+  int MaximumNumberOfSegmentsPerLeaf{ 8 };
+
+private:
+  vtkCurveSegmentLocator(const vtkCurveSegmentLocator&) = delete;
+  void operator=(const vtkCurveSegmentLocator&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
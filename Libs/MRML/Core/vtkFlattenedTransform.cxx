@@ -0,0 +1,201 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkFlattenedTransform.h"
+
+// MRML includes
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkHomogeneousTransform.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkFlattenedTransform);
+
+//----------------------------------------------------------------------------
+vtkFlattenedTransform::vtkFlattenedTransform() = default;
+
+//----------------------------------------------------------------------------
+vtkFlattenedTransform::~vtkFlattenedTransform() = default;
+
+//----------------------------------------------------------------------------
+void vtkFlattenedTransform::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Steps: " << this->Steps.size() << "\n";
+  for (const Step& step : this->Steps)
+  {
+    if (step.NonLinearTransform)
+    {
+      os << indent.GetNextIndent() << step.NonLinearTransform->GetClassName() << "\n";
+    }
+    else
+    {
+      os << indent.GetNextIndent() << (step.Perspective ? "Perspective matrix" : "Linear matrix") << "\n";
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkFlattenedTransform::SetTransform(vtkAbstractTransform* transform)
+{
+  this->Steps.clear();
+  this->Modified();
+  if (!transform)
+  {
+    return;
+  }
+  vtkNew<vtkCollection> transformList;
+  vtkMRMLTransformNode::FlattenGeneralTransform(transformList, transform);
+  vtkCollectionSimpleIterator it;
+  vtkAbstractTransform* simpleTransform = nullptr;
+  for (transformList->InitTraversal(it); (simpleTransform = vtkAbstractTransform::SafeDownCast(transformList->GetNextItemAsObject(it)));)
+  {
+    // All transforms must be up-to-date before InternalTransformPoint is called from multiple threads
+    simpleTransform->Update();
+    vtkHomogeneousTransform* linearTransform = vtkHomogeneousTransform::SafeDownCast(simpleTransform);
+    if (!linearTransform)
+    {
+      Step step;
+      step.NonLinearTransform = simpleTransform;
+      this->Steps.push_back(step);
+      continue;
+    }
+    vtkNew<vtkMatrix4x4> matrix;
+    linearTransform->GetMatrix(matrix);
+    if (matrix->IsIdentity())
+    {
+      continue;
+    }
+    if (this->Steps.empty() || this->Steps.back().NonLinearTransform)
+    {
+      Step step;
+      vtkMatrix4x4::DeepCopy(step.Matrix, matrix);
+      this->Steps.push_back(step);
+    }
+    else
+    {
+      // Merge with the previous linear transform (the product of perspective transforms is a perspective transform)
+      vtkMatrix4x4::Multiply4x4(matrix->GetData(), this->Steps.back().Matrix, this->Steps.back().Matrix);
+    }
+  }
+  for (Step& step : this->Steps)
+  {
+    step.Perspective = !step.NonLinearTransform //
+                       && (step.Matrix[12] != 0.0 || step.Matrix[13] != 0.0 || step.Matrix[14] != 0.0 || step.Matrix[15] != 1.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkFlattenedTransform::IsLinear() const
+{
+  for (const Step& step : this->Steps)
+  {
+    if (step.NonLinearTransform)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkFlattenedTransform::TransformPointLinear(const Step& step, double point[3])
+{
+  const double* m = step.Matrix;
+  double transformedPoint[3] = {
+    m[0] * point[0] + m[1] * point[1] + m[2] * point[2] + m[3],
+    m[4] * point[0] + m[5] * point[1] + m[6] * point[2] + m[7],
+    m[8] * point[0] + m[9] * point[1] + m[10] * point[2] + m[11],
+  };
+  double w = 1.0;
+  if (step.Perspective)
+  {
+    w = m[12] * point[0] + m[13] * point[1] + m[14] * point[2] + m[15];
+    if (w != 0.0)
+    {
+      transformedPoint[0] /= w;
+      transformedPoint[1] /= w;
+      transformedPoint[2] /= w;
+    }
+  }
+  point[0] = transformedPoint[0];
+  point[1] = transformedPoint[1];
+  point[2] = transformedPoint[2];
+  return w;
+}
+
+//----------------------------------------------------------------------------
+void vtkFlattenedTransform::TransformPoint(const double input[3], double output[3]) const
+{
+  double point[3] = { input[0], input[1], input[2] };
+  for (const Step& step : this->Steps)
+  {
+    if (step.NonLinearTransform)
+    {
+      step.NonLinearTransform->InternalTransformPoint(point, point);
+    }
+    else
+    {
+      vtkFlattenedTransform::TransformPointLinear(step, point);
+    }
+  }
+  output[0] = point[0];
+  output[1] = point[1];
+  output[2] = point[2];
+}
+
+//----------------------------------------------------------------------------
+void vtkFlattenedTransform::TransformPointDerivative(const double input[3], double output[3], double derivative[3][3]) const
+{
+  double point[3] = { input[0], input[1], input[2] };
+  vtkMath::Identity3x3(derivative);
+  double stepDerivative[3][3] = { { 0.0 } };
+  for (const Step& step : this->Steps)
+  {
+    if (step.NonLinearTransform)
+    {
+      step.NonLinearTransform->InternalTransformDerivative(point, point, stepDerivative);
+    }
+    else
+    {
+      double w = vtkFlattenedTransform::TransformPointLinear(step, point);
+      const double* m = step.Matrix;
+      for (int row = 0; row < 3; row++)
+      {
+        for (int col = 0; col < 3; col++)
+        {
+          stepDerivative[row][col] = m[row * 4 + col];
+          if (step.Perspective && w != 0.0)
+          {
+            // Derivative of the homogeneous division: (m_rc - p_r * m_3c) / w, where p is the transformed point
+            stepDerivative[row][col] = (stepDerivative[row][col] - point[row] * m[12 + col]) / w;
+          }
+        }
+      }
+    }
+    vtkMath::Multiply3x3(stepDerivative, derivative, derivative);
+  }
+  output[0] = point[0];
+  output[1] = point[1];
+  output[2] = point[2];
+}
@@ -0,0 +1,85 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkFlattenedTransform_h
+#define __vtkFlattenedTransform_h
+
+// VTK includes
+#include <vtkAbstractTransform.h>
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// MRML includes
+#include "vtkMRML.h"
+
+// STD includes
+#include <vector>
+
+/// \brief Evaluate a composite transform at many points, from multiple threads.
+///
+/// The transform hierarchy is flattened into a list of simple transforms once (using
+/// vtkMRMLTransformNode::FlattenGeneralTransform) and consecutive linear transforms are merged into
+/// a single matrix, therefore evaluating a point does not require traversing nested general transforms.
+/// All transforms are updated in SetTransform, therefore TransformPoint and TransformPointDerivative
+/// can be called from multiple threads (for example, from vtkSMPTools).
+///
+/// Linear transforms may be perspective transforms: the homogeneous coordinate is divided out
+/// after each linear step, the same way as in vtkPerspectiveTransform.
+///
+/// The flattened transform is not updated when the input transform is modified, SetTransform must be called again.
+class VTK_MRML_EXPORT vtkFlattenedTransform : public vtkObject
+{
+public:
+  static vtkFlattenedTransform* New();
+  vtkTypeMacro(vtkFlattenedTransform, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Flatten the transform. Identity is used if the transform is nullptr.
+  void SetTransform(vtkAbstractTransform* transform);
+
+  /// Returns true if the flattened transform only contains linear transforms.
+  bool IsLinear() const;
+
+  /// Transform a point. Thread-safe.
+  void TransformPoint(const double input[3], double output[3]) const;
+
+  /// Transform a point and compute the derivative of the transform at the input position. Thread-safe.
+  void TransformPointDerivative(const double input[3], double output[3], double derivative[3][3]) const;
+
+protected:
+  vtkFlattenedTransform();
+  ~vtkFlattenedTransform() override;
+
+  struct Step
+  {
+    /// If not set then the step is a linear transform, specified by Matrix
+    vtkSmartPointer<vtkAbstractTransform> NonLinearTransform;
+    double Matrix[16] = { 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 };
+    bool Perspective{ false };
+  };
+
+  /// Transform point by a linear step, returns the homogeneous coordinate.
+  static double TransformPointLinear(const Step& step, double point[3]);
+
+  std::vector<Step> Steps;
+
+private:
+  vtkFlattenedTransform(const vtkFlattenedTransform&) = delete;
+  void operator=(const vtkFlattenedTransform&) = delete;
+};
+
+#endif
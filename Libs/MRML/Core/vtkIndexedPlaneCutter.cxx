@@ -0,0 +1,735 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkIndexedPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCutter.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkIndexedPlaneCutter);
+
+//----------------------------------------------------------------------------
+class vtkIndexedPlaneCutter::vtkInternal
+{
+public:
+  struct Node
+  {
+    double Bounds[6];
+    vtkIdType FirstCell; // index of the first cell in OrderedCellIds
+    vtkIdType NumberOfCells;
+    vtkIdType Children[2]; // -1 for leaf nodes
+  };
+
+  struct AxisIndex
+  {
+    bool Built{ false };
+    double Origin{ 0.0 };
+    double BucketSize{ 1.0 };
+    vtkIdType NumberOfBuckets{ 0 };
+    std::vector<vtkIdType> BucketOffsets; // start of each bucket in BucketCellIds, contains NumberOfBuckets+1 values
+    std::vector<vtkIdType> BucketCellIds;
+  };
+
+  void Clear();
+  void Build(vtkPolyData* input, int maximumNumberOfCellsPerLeaf);
+  void BuildAxisIndex(int axis);
+  vtkIdType GetBucketIndex(const AxisIndex& axisIndex, double position);
+  bool IsBoxCutByPlane(const double bounds[6], const double origin[3], const double normal[3]);
+  void FindCells(const double origin[3], const double normal[3], std::vector<vtkIdType>& cellIds);
+  void FindCellsAlongAxis(int axis, double minimumPosition, double maximumPosition, const double origin[3], const double normal[3], std::vector<vtkIdType>& cellIds);
+  void FindCellsInHierarchy(const double origin[3], const double normal[3], std::vector<vtkIdType>& cellIds);
+
+  // Indexed cells (polygons and triangles of triangle strips), stored in compressed row format.
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<vtkIdType> CellPointIds;
+  std::vector<vtkIdType> SourceCellIds; // cell ID in the input mesh
+  std::vector<double> CellBounds;       // 6 values per cell
+  double Bounds[6]{ 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+
+  // Bounding volume hierarchy, used for cutting with oblique planes
+  std::vector<Node> Nodes;
+  std::vector<vtkIdType> OrderedCellIds;
+
+  // Bucket index of cell extents along each axis, used for cutting with axis-aligned planes
+  AxisIndex AxisIndices[3];
+
+  // Input that the index was built for. Only used for comparison, never dereferenced.
+  vtkPolyData* IndexedInput{ nullptr };
+  vtkMTimeType IndexedInputMTime{ 0 };
+  int IndexedMaximumNumberOfCellsPerLeaf{ 0 };
+
+  vtkIdType NumberOfTestedCells{ 0 };
+};
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::Clear()
+{
+  this->CellOffsets.clear();
+  this->CellPointIds.clear();
+  this->SourceCellIds.clear();
+  this->CellBounds.clear();
+  vtkMath::UninitializeBounds(this->Bounds);
+  this->Nodes.clear();
+  this->OrderedCellIds.clear();
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    this->AxisIndices[axis] = AxisIndex();
+  }
+  this->IndexedInput = nullptr;
+  this->IndexedInputMTime = 0;
+  this->IndexedMaximumNumberOfCellsPerLeaf = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::Build(vtkPolyData* input, int maximumNumberOfCellsPerLeaf)
+{
+  this->Clear();
+  this->IndexedInput = input;
+  this->IndexedInputMTime = input->GetMTime();
+  this->IndexedMaximumNumberOfCellsPerLeaf = maximumNumberOfCellsPerLeaf;
+
+  vtkPoints* points = input->GetPoints();
+  vtkIdType numberOfPoints = (points ? points->GetNumberOfPoints() : 0);
+
+  // Collect cells. Cells that cannot be cut into a line segment or refer to invalid points are skipped.
+  this->CellOffsets.push_back(0);
+  vtkIdType cellId = input->GetNumberOfVerts() + input->GetNumberOfLines();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPointIds = nullptr;
+  auto isValidCell = [numberOfPoints](vtkIdType numberOfCellPoints, const vtkIdType* cellPointIds)
+  {
+    for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+    {
+      if (cellPointIds[i] < 0 || cellPointIds[i] >= numberOfPoints)
+      {
+        return false;
+      }
+    }
+    return numberOfCellPoints >= 3;
+  };
+  vtkCellArray* polys = input->GetPolys();
+  if (polys)
+  {
+    for (polys->InitTraversal(); polys->GetNextCell(numberOfCellPoints, cellPointIds); ++cellId)
+    {
+      if (!isValidCell(numberOfCellPoints, cellPointIds))
+      {
+        continue;
+      }
+      this->CellPointIds.insert(this->CellPointIds.end(), cellPointIds, cellPointIds + numberOfCellPoints);
+      this->CellOffsets.push_back(static_cast<vtkIdType>(this->CellPointIds.size()));
+      this->SourceCellIds.push_back(cellId);
+    }
+  }
+  vtkCellArray* strips = input->GetStrips();
+  if (strips)
+  {
+    for (strips->InitTraversal(); strips->GetNextCell(numberOfCellPoints, cellPointIds); ++cellId)
+    {
+      for (vtkIdType i = 0; i + 2 < numberOfCellPoints; ++i)
+      {
+        if (!isValidCell(3, cellPointIds + i))
+        {
+          continue;
+        }
+        this->CellPointIds.insert(this->CellPointIds.end(), cellPointIds + i, cellPointIds + i + 3);
+        this->CellOffsets.push_back(static_cast<vtkIdType>(this->CellPointIds.size()));
+        this->SourceCellIds.push_back(cellId);
+      }
+    }
+  }
+
+  // Compute cell bounds and centers
+  vtkIdType numberOfCells = static_cast<vtkIdType>(this->SourceCellIds.size());
+  this->CellBounds.resize(6 * numberOfCells);
+  std::vector<double> cellCenters(3 * numberOfCells);
+  for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; ++cellIndex)
+  {
+    double* cellBounds = &this->CellBounds[6 * cellIndex];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      cellBounds[2 * axis] = VTK_DOUBLE_MAX;
+      cellBounds[2 * axis + 1] = VTK_DOUBLE_MIN;
+    }
+    for (vtkIdType i = this->CellOffsets[cellIndex]; i < this->CellOffsets[cellIndex + 1]; ++i)
+    {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      points->GetPoint(this->CellPointIds[i], point);
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        cellBounds[2 * axis] = std::min(cellBounds[2 * axis], point[axis]);
+        cellBounds[2 * axis + 1] = std::max(cellBounds[2 * axis + 1], point[axis]);
+      }
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      cellCenters[3 * cellIndex + axis] = 0.5 * (cellBounds[2 * axis] + cellBounds[2 * axis + 1]);
+      if (cellIndex == 0 || cellBounds[2 * axis] < this->Bounds[2 * axis])
+      {
+        this->Bounds[2 * axis] = cellBounds[2 * axis];
+      }
+      if (cellIndex == 0 || cellBounds[2 * axis + 1] > this->Bounds[2 * axis + 1])
+      {
+        this->Bounds[2 * axis + 1] = cellBounds[2 * axis + 1];
+      }
+    }
+  }
+
+  if (numberOfCells == 0)
+  {
+    return;
+  }
+
+  // Build bounding volume hierarchy by recursively splitting cells at the median
+  // of cell centers along the longest axis.
+  this->OrderedCellIds.resize(numberOfCells);
+  std::iota(this->OrderedCellIds.begin(), this->OrderedCellIds.end(), 0);
+  this->Nodes.reserve(2 * (numberOfCells / maximumNumberOfCellsPerLeaf + 1));
+  Node rootNode;
+  rootNode.FirstCell = 0;
+  rootNode.NumberOfCells = numberOfCells;
+  this->Nodes.push_back(rootNode);
+  std::vector<vtkIdType> nodesToSplit;
+  nodesToSplit.push_back(0);
+  while (!nodesToSplit.empty())
+  {
+    vtkIdType nodeIndex = nodesToSplit.back();
+    nodesToSplit.pop_back();
+    vtkIdType firstCell = this->Nodes[nodeIndex].FirstCell;
+    vtkIdType nodeNumberOfCells = this->Nodes[nodeIndex].NumberOfCells;
+
+    double nodeBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    double centerBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (vtkIdType i = firstCell; i < firstCell + nodeNumberOfCells; ++i)
+    {
+      vtkIdType cellIndex = this->OrderedCellIds[i];
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        nodeBounds[2 * axis] = std::min(nodeBounds[2 * axis], this->CellBounds[6 * cellIndex + 2 * axis]);
+        nodeBounds[2 * axis + 1] = std::max(nodeBounds[2 * axis + 1], this->CellBounds[6 * cellIndex + 2 * axis + 1]);
+        centerBounds[2 * axis] = std::min(centerBounds[2 * axis], cellCenters[3 * cellIndex + axis]);
+        centerBounds[2 * axis + 1] = std::max(centerBounds[2 * axis + 1], cellCenters[3 * cellIndex + axis]);
+      }
+    }
+    std::copy(nodeBounds, nodeBounds + 6, this->Nodes[nodeIndex].Bounds);
+    this->Nodes[nodeIndex].Children[0] = -1;
+    this->Nodes[nodeIndex].Children[1] = -1;
+    if (nodeNumberOfCells <= maximumNumberOfCellsPerLeaf)
+    {
+      continue;
+    }
+
+    int splitAxis = 0;
+    for (int axis = 1; axis < 3; ++axis)
+    {
+      if (centerBounds[2 * axis + 1] - centerBounds[2 * axis] > centerBounds[2 * splitAxis + 1] - centerBounds[2 * splitAxis])
+      {
+        splitAxis = axis;
+      }
+    }
+    // Always split at the middle index, which keeps the tree balanced even if many cell centers coincide
+    vtkIdType numberOfCellsLeft = nodeNumberOfCells / 2;
+    std::nth_element(this->OrderedCellIds.begin() + firstCell,
+                     this->OrderedCellIds.begin() + firstCell + numberOfCellsLeft,
+                     this->OrderedCellIds.begin() + firstCell + nodeNumberOfCells,
+                     [&cellCenters, splitAxis](vtkIdType a, vtkIdType b) { return cellCenters[3 * a + splitAxis] < cellCenters[3 * b + splitAxis]; });
+
+    Node leftNode;
+    leftNode.FirstCell = firstCell;
+    leftNode.NumberOfCells = numberOfCellsLeft;
+    Node rightNode;
+    rightNode.FirstCell = firstCell + numberOfCellsLeft;
+    rightNode.NumberOfCells = nodeNumberOfCells - numberOfCellsLeft;
+    vtkIdType leftNodeIndex = static_cast<vtkIdType>(this->Nodes.size());
+    this->Nodes.push_back(leftNode);
+    this->Nodes.push_back(rightNode);
+    this->Nodes[nodeIndex].Children[0] = leftNodeIndex;
+    this->Nodes[nodeIndex].Children[1] = leftNodeIndex + 1;
+    nodesToSplit.push_back(leftNodeIndex);
+    nodesToSplit.push_back(leftNodeIndex + 1);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkIndexedPlaneCutter::vtkInternal::GetBucketIndex(const AxisIndex& axisIndex, double position)
+{
+  double bucketPosition = std::floor((position - axisIndex.Origin) / axisIndex.BucketSize);
+  if (bucketPosition < 0.0)
+  {
+    return 0;
+  }
+  if (bucketPosition >= static_cast<double>(axisIndex.NumberOfBuckets - 1))
+  {
+    return axisIndex.NumberOfBuckets - 1;
+  }
+  return static_cast<vtkIdType>(bucketPosition);
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::BuildAxisIndex(int axis)
+{
+  AxisIndex& axisIndex = this->AxisIndices[axis];
+  axisIndex = AxisIndex();
+  axisIndex.Built = true;
+  vtkIdType numberOfCells = static_cast<vtkIdType>(this->SourceCellIds.size());
+  if (numberOfCells == 0)
+  {
+    return;
+  }
+
+  // Number of buckets is chosen so that both the number of buckets and
+  // the number of cells in a bucket grow with the square root of the number of cells.
+  double extent = this->Bounds[2 * axis + 1] - this->Bounds[2 * axis];
+  axisIndex.NumberOfBuckets = (extent > 0.0 ? std::max<vtkIdType>(1, static_cast<vtkIdType>(2.0 * std::sqrt(static_cast<double>(numberOfCells)))) : 1);
+  axisIndex.Origin = this->Bounds[2 * axis];
+  axisIndex.BucketSize = (extent > 0.0 ? extent / axisIndex.NumberOfBuckets : 1.0);
+
+  // Counting sort of cells into all the buckets that their extent overlaps
+  axisIndex.BucketOffsets.assign(axisIndex.NumberOfBuckets + 1, 0);
+  for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; ++cellIndex)
+  {
+    vtkIdType firstBucket = this->GetBucketIndex(axisIndex, this->CellBounds[6 * cellIndex + 2 * axis]);
+    vtkIdType lastBucket = this->GetBucketIndex(axisIndex, this->CellBounds[6 * cellIndex + 2 * axis + 1]);
+    for (vtkIdType bucket = firstBucket; bucket <= lastBucket; ++bucket)
+    {
+      ++axisIndex.BucketOffsets[bucket + 1];
+    }
+  }
+  std::partial_sum(axisIndex.BucketOffsets.begin(), axisIndex.BucketOffsets.end(), axisIndex.BucketOffsets.begin());
+  axisIndex.BucketCellIds.resize(axisIndex.BucketOffsets.back());
+  std::vector<vtkIdType> insertPositions(axisIndex.BucketOffsets.begin(), axisIndex.BucketOffsets.end() - 1);
+  for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; ++cellIndex)
+  {
+    vtkIdType firstBucket = this->GetBucketIndex(axisIndex, this->CellBounds[6 * cellIndex + 2 * axis]);
+    vtkIdType lastBucket = this->GetBucketIndex(axisIndex, this->CellBounds[6 * cellIndex + 2 * axis + 1]);
+    for (vtkIdType bucket = firstBucket; bucket <= lastBucket; ++bucket)
+    {
+      axisIndex.BucketCellIds[insertPositions[bucket]++] = cellIndex;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkIndexedPlaneCutter::vtkInternal::IsBoxCutByPlane(const double bounds[6], const double origin[3], const double normal[3])
+{
+  double centerDistance = 0.0;
+  double radius = 0.0;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    centerDistance += normal[axis] * (0.5 * (bounds[2 * axis] + bounds[2 * axis + 1]) - origin[axis]);
+    radius += std::abs(normal[axis]) * 0.5 * (bounds[2 * axis + 1] - bounds[2 * axis]);
+  }
+  return std::abs(centerDistance) <= radius;
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::FindCells(const double origin[3], const double normal[3], std::vector<vtkIdType>& cellIds)
+{
+  cellIds.clear();
+  if (this->SourceCellIds.empty() || !this->IsBoxCutByPlane(this->Bounds, origin, normal))
+  {
+    return;
+  }
+
+  // Get the range of positions along the dominant axis of the plane normal where the plane
+  // intersects the bounding box of the mesh. For axis-aligned planes this is a single position.
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+  {
+    if (std::abs(normal[i]) > std::abs(normal[axis]))
+    {
+      axis = i;
+    }
+  }
+  int otherAxis1 = (axis + 1) % 3;
+  int otherAxis2 = (axis + 2) % 3;
+  double minimumPosition = VTK_DOUBLE_MAX;
+  double maximumPosition = VTK_DOUBLE_MIN;
+  for (int corner = 0; corner < 4; ++corner)
+  {
+    double position1 = this->Bounds[2 * otherAxis1 + (corner & 1)];
+    double position2 = this->Bounds[2 * otherAxis2 + ((corner >> 1) & 1)];
+    double position = origin[axis] - (normal[otherAxis1] * (position1 - origin[otherAxis1]) + normal[otherAxis2] * (position2 - origin[otherAxis2])) / normal[axis];
+    minimumPosition = std::min(minimumPosition, position);
+    maximumPosition = std::max(maximumPosition, position);
+  }
+
+  // Use the axis index if the plane is (nearly) perpendicular to the axis, so that only a few buckets are visited.
+  double extent = this->Bounds[2 * axis + 1] - this->Bounds[2 * axis];
+  double bucketSize = (this->AxisIndices[axis].Built ? this->AxisIndices[axis].BucketSize //
+                                                      : extent / std::max(1.0, 2.0 * std::sqrt(static_cast<double>(this->SourceCellIds.size()))));
+  if (maximumPosition - minimumPosition <= 2.0 * bucketSize)
+  {
+    if (!this->AxisIndices[axis].Built)
+    {
+      this->BuildAxisIndex(axis);
+    }
+    this->FindCellsAlongAxis(axis, minimumPosition, maximumPosition, origin, normal, cellIds);
+  }
+  else
+  {
+    this->FindCellsInHierarchy(origin, normal, cellIds);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::FindCellsAlongAxis(int axis,
+                                                             double minimumPosition,
+                                                             double maximumPosition,
+                                                             const double origin[3],
+                                                             const double normal[3],
+                                                             std::vector<vtkIdType>& cellIds)
+{
+  const AxisIndex& axisIndex = this->AxisIndices[axis];
+  if (axisIndex.NumberOfBuckets == 0)
+  {
+    return;
+  }
+  vtkIdType firstBucket = this->GetBucketIndex(axisIndex, minimumPosition);
+  vtkIdType lastBucket = this->GetBucketIndex(axisIndex, maximumPosition);
+  for (vtkIdType bucket = firstBucket; bucket <= lastBucket; ++bucket)
+  {
+    for (vtkIdType i = axisIndex.BucketOffsets[bucket]; i < axisIndex.BucketOffsets[bucket + 1]; ++i)
+    {
+      vtkIdType cellIndex = axisIndex.BucketCellIds[i];
+      // A cell is stored in all the buckets that it overlaps, only report it from the first visited one
+      vtkIdType cellFirstBucket = this->GetBucketIndex(axisIndex, this->CellBounds[6 * cellIndex + 2 * axis]);
+      if (std::max(cellFirstBucket, firstBucket) != bucket)
+      {
+        continue;
+      }
+      if (this->IsBoxCutByPlane(&this->CellBounds[6 * cellIndex], origin, normal))
+      {
+        cellIds.push_back(cellIndex);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::vtkInternal::FindCellsInHierarchy(const double origin[3], const double normal[3], std::vector<vtkIdType>& cellIds)
+{
+  if (this->Nodes.empty())
+  {
+    return;
+  }
+  std::vector<vtkIdType> nodesToVisit;
+  nodesToVisit.push_back(0);
+  while (!nodesToVisit.empty())
+  {
+    const Node& node = this->Nodes[nodesToVisit.back()];
+    nodesToVisit.pop_back();
+    if (!this->IsBoxCutByPlane(node.Bounds, origin, normal))
+    {
+      continue;
+    }
+    if (node.Children[0] >= 0)
+    {
+      nodesToVisit.push_back(node.Children[0]);
+      nodesToVisit.push_back(node.Children[1]);
+      continue;
+    }
+    for (vtkIdType i = node.FirstCell; i < node.FirstCell + node.NumberOfCells; ++i)
+    {
+      vtkIdType cellIndex = this->OrderedCellIds[i];
+      if (this->IsBoxCutByPlane(&this->CellBounds[6 * cellIndex], origin, normal))
+      {
+        cellIds.push_back(cellIndex);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIndexedPlaneCutter::vtkIndexedPlaneCutter()
+{
+  this->Internal = new vtkInternal;
+  this->Plane = vtkSmartPointer<vtkPlane>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkIndexedPlaneCutter::~vtkIndexedPlaneCutter()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Plane: " << this->Plane.GetPointer() << "\n";
+  os << indent << "MaximumNumberOfCellsPerLeaf: " << this->MaximumNumberOfCellsPerLeaf << "\n";
+  os << indent << "NumberOfIndexedCells: " << this->GetNumberOfIndexedCells() << "\n";
+  os << indent << "NumberOfTestedCells: " << this->GetNumberOfTestedCells() << "\n";
+  os << indent << "FallbackCutterUsed: " << (this->FallbackCutterUsed ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPlaneCutter::SetPlane(vtkPlane* plane)
+{
+  if (this->Plane == plane)
+  {
+    return;
+  }
+  this->Plane = plane;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPlane* vtkIndexedPlaneCutter::GetPlane()
+{
+  return this->Plane;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkIndexedPlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Plane)
+  {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkIndexedPlaneCutter::GetNumberOfIndexedCells()
+{
+  return static_cast<vtkIdType>(this->Internal->SourceCellIds.size());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkIndexedPlaneCutter::GetNumberOfTestedCells()
+{
+  return this->Internal->NumberOfTestedCells;
+}
+
+//----------------------------------------------------------------------------
+int vtkIndexedPlaneCutter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkIndexedPlaneCutter::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkDataSet* input = vtkDataSet::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+  if (!input || !output)
+  {
+    return 0;
+  }
+  if (!this->Plane)
+  {
+    vtkErrorMacro("RequestData failed: cut plane is not specified");
+    return 0;
+  }
+  this->Internal->NumberOfTestedCells = 0;
+  this->FallbackCutterUsed = false;
+
+  vtkPolyData* polyInput = vtkPolyData::SafeDownCast(input);
+  if (!polyInput || polyInput->GetNumberOfVerts() > 0 || polyInput->GetNumberOfLines() > 0 || this->Plane->GetTransform())
+  {
+    // Input is not a surface mesh, use the general-purpose cutter
+    this->FallbackCutterUsed = true;
+    this->Internal->Clear();
+    if (!this->FallbackCutter)
+    {
+      this->FallbackCutter = vtkSmartPointer<vtkPlaneCutter>::New();
+      this->FallbackCutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
+    }
+    this->FallbackCutter->SetPlane(this->Plane);
+    this->FallbackCutter->SetInputData(input);
+    this->FallbackCutter->Update();
+    vtkPolyData* cutOutput = vtkPolyData::SafeDownCast(this->FallbackCutter->GetOutputDataObject(0));
+    if (cutOutput)
+    {
+      output->ShallowCopy(cutOutput);
+    }
+    this->FallbackCutter->SetInputData(nullptr);
+    return 1;
+  }
+
+  vtkPoints* inputPoints = polyInput->GetPoints();
+  if (!inputPoints || inputPoints->GetNumberOfPoints() == 0)
+  {
+    return 1;
+  }
+
+  if (this->Internal->IndexedInput != polyInput || this->Internal->IndexedInputMTime < polyInput->GetMTime()
+      || this->Internal->IndexedMaximumNumberOfCellsPerLeaf != this->MaximumNumberOfCellsPerLeaf)
+  {
+    this->Internal->Build(polyInput, this->MaximumNumberOfCellsPerLeaf);
+  }
+
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double normal[3] = { 0.0, 0.0, 1.0 };
+  this->Plane->GetOrigin(origin);
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+  {
+    vtkErrorMacro("RequestData failed: invalid plane normal");
+    return 0;
+  }
+
+  std::vector<vtkIdType> cellIndices;
+  this->Internal->FindCells(origin, normal, cellIndices);
+  this->Internal->NumberOfTestedCells = static_cast<vtkIdType>(cellIndices.size());
+  // Process cells in their original order to make the output independent from the index structure
+  std::sort(cellIndices.begin(), cellIndices.end());
+
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  vtkNew<vtkCellArray> outputLines;
+  vtkPointData* inputPointData = polyInput->GetPointData();
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkCellData* inputCellData = polyInput->GetCellData();
+  vtkCellData* outputCellData = output->GetCellData();
+  vtkIdType estimatedSize = 2 * static_cast<vtkIdType>(cellIndices.size()) + 1;
+  outputPoints->Allocate(estimatedSize);
+  outputPointData->InterpolateAllocate(inputPointData, estimatedSize);
+  outputCellData->CopyAllocate(inputCellData, estimatedSize);
+
+  // Each edge is cut at most once, and the output point is shared by all the cells that contain the edge.
+  // Point classification (point on the plane is considered to be above) and cut positions only depend
+  // on the edge, therefore neighbor cells always produce connected line segments, even for degenerate geometries.
+  const std::uint64_t numberOfInputPoints = static_cast<std::uint64_t>(inputPoints->GetNumberOfPoints());
+  std::unordered_map<std::uint64_t, vtkIdType> edgeCutPointIds;
+  edgeCutPointIds.reserve(2 * cellIndices.size());
+  std::vector<double> pointDistances;
+  std::vector<std::pair<double, vtkIdType>> cutPoints;
+  for (vtkIdType cellIndex : cellIndices)
+  {
+    const vtkIdType* cellPointIds = &this->Internal->CellPointIds[this->Internal->CellOffsets[cellIndex]];
+    vtkIdType numberOfCellPoints = this->Internal->CellOffsets[cellIndex + 1] - this->Internal->CellOffsets[cellIndex];
+    pointDistances.resize(numberOfCellPoints);
+    for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+    {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      inputPoints->GetPoint(cellPointIds[i], point);
+      pointDistances[i] = normal[0] * (point[0] - origin[0]) + normal[1] * (point[1] - origin[1]) + normal[2] * (point[2] - origin[2]);
+    }
+
+    cutPoints.clear();
+    for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+    {
+      vtkIdType j = (i + 1) % numberOfCellPoints;
+      if ((pointDistances[i] >= 0.0) == (pointDistances[j] >= 0.0))
+      {
+        continue;
+      }
+      vtkIdType edgeStartPointId = cellPointIds[i];
+      vtkIdType edgeEndPointId = cellPointIds[j];
+      double edgeStartDistance = pointDistances[i];
+      double edgeEndDistance = pointDistances[j];
+      if (edgeStartPointId > edgeEndPointId)
+      {
+        std::swap(edgeStartPointId, edgeEndPointId);
+        std::swap(edgeStartDistance, edgeEndDistance);
+      }
+      std::uint64_t edgeKey = static_cast<std::uint64_t>(edgeStartPointId) * numberOfInputPoints + static_cast<std::uint64_t>(edgeEndPointId);
+      auto edgeCutPointIt = edgeCutPointIds.find(edgeKey);
+      vtkIdType cutPointId = -1;
+      if (edgeCutPointIt != edgeCutPointIds.end())
+      {
+        cutPointId = edgeCutPointIt->second;
+      }
+      else
+      {
+        double t = edgeStartDistance / (edgeStartDistance - edgeEndDistance);
+        double edgeStart[3] = { 0.0, 0.0, 0.0 };
+        double edgeEnd[3] = { 0.0, 0.0, 0.0 };
+        inputPoints->GetPoint(edgeStartPointId, edgeStart);
+        inputPoints->GetPoint(edgeEndPointId, edgeEnd);
+        double cutPoint[3] = { edgeStart[0] + t * (edgeEnd[0] - edgeStart[0]), //
+                               edgeStart[1] + t * (edgeEnd[1] - edgeStart[1]),
+                               edgeStart[2] + t * (edgeEnd[2] - edgeStart[2]) };
+        cutPointId = outputPoints->InsertNextPoint(cutPoint);
+        outputPointData->InterpolateEdge(inputPointData, cutPointId, edgeStartPointId, edgeEndPointId, t);
+        edgeCutPointIds[edgeKey] = cutPointId;
+      }
+      cutPoints.emplace_back(0.0, cutPointId);
+    }
+    if (cutPoints.size() < 2)
+    {
+      continue;
+    }
+
+    if (cutPoints.size() > 2)
+    {
+      // Non-convex polygon: all cut points are on the same line, order them along the line and
+      // connect them pairwise (segments between the pairs are outside of the polygon).
+      double firstPoint[3] = { 0.0, 0.0, 0.0 };
+      outputPoints->GetPoint(cutPoints[0].second, firstPoint);
+      double direction[3] = { 0.0, 0.0, 0.0 };
+      double maximumDistance2 = -1.0;
+      for (const auto& cutPoint : cutPoints)
+      {
+        double point[3] = { 0.0, 0.0, 0.0 };
+        outputPoints->GetPoint(cutPoint.second, point);
+        double distance2 = vtkMath::Distance2BetweenPoints(firstPoint, point);
+        if (distance2 > maximumDistance2)
+        {
+          maximumDistance2 = distance2;
+          vtkMath::Subtract(point, firstPoint, direction);
+        }
+      }
+      for (auto& cutPoint : cutPoints)
+      {
+        double point[3] = { 0.0, 0.0, 0.0 };
+        outputPoints->GetPoint(cutPoint.second, point);
+        vtkMath::Subtract(point, firstPoint, point);
+        cutPoint.first = vtkMath::Dot(point, direction);
+      }
+      std::sort(cutPoints.begin(), cutPoints.end());
+    }
+
+    for (size_t i = 0; i + 1 < cutPoints.size(); i += 2)
+    {
+      vtkIdType linePointIds[2] = { cutPoints[i].second, cutPoints[i + 1].second };
+      vtkIdType lineId = outputLines->InsertNextCell(2, linePointIds);
+      outputCellData->CopyData(inputCellData, this->Internal->SourceCellIds[cellIndex], lineId);
+    }
+  }
+
+  output->SetPoints(outputPoints);
+  output->SetLines(outputLines);
+  output->Squeeze();
+  return 1;
+}
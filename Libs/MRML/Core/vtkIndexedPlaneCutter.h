@@ -0,0 +1,105 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkIndexedPlaneCutter_h
+#define __vtkIndexedPlaneCutter_h
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// MRML includes
+#include "vtkMRML.h"
+
+class vtkPlane;
+class vtkPlaneCutter;
+
+/// \brief Cut a surface mesh with a plane, using a spatial index that is kept between executions.
+///
+/// The filter is intended for computing slice intersections of models, where the same mesh
+/// is cut with many different planes (each time the slice is moved).
+/// At the first execution a spatial index is built from the bounding boxes of the cells
+/// of the input mesh. The index is only rebuilt when the input is modified, therefore
+/// subsequent executions only visit cells near the plane and the cost of a cut is
+/// proportional to the number of cells that are actually cut, not to the size of the mesh.
+///
+/// Two indices are used:
+/// - Axis-aligned planes (e.g., axial, sagittal, coronal slices without rotation) are cut using
+///   a bucket index of cell extents along the plane normal axis, built for each axis when first needed.
+/// - Oblique planes are cut using a bounding volume hierarchy of the cells.
+///
+/// Output contains line segments (cells of the input that are cut by the plane) with merged points,
+/// so the segments form connected polylines. Point data is interpolated and cell data is copied
+/// from the input, similarly to vtkPlaneCutter.
+///
+/// Only polygon and triangle strip cells are indexed. If the input is not a vtkPolyData
+/// or it contains vertex or line cells then the filter falls back to using vtkPlaneCutter.
+class VTK_MRML_EXPORT vtkIndexedPlaneCutter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkIndexedPlaneCutter* New();
+  vtkTypeMacro(vtkIndexedPlaneCutter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /// Set/Get the plane to cut the input with.
+  void SetPlane(vtkPlane* plane);
+  vtkPlane* GetPlane();
+  //@}
+
+  //@{
+  /// Maximum number of cells in a leaf node of the bounding volume hierarchy.
+  /// Default is 16.
+  vtkSetClampMacro(MaximumNumberOfCellsPerLeaf, int, 1, 1024);
+  vtkGetMacro(MaximumNumberOfCellsPerLeaf, int);
+  //@}
+
+  /// Return the mtime also considering the plane.
+  vtkMTimeType GetMTime() override;
+
+  /// Get number of cells in the spatial index (polygons and triangles of triangle strips).
+  /// Returns 0 if the index has not been built yet or the fallback cutter was used.
+  vtkIdType GetNumberOfIndexedCells();
+
+  /// Get number of cells that were tested for intersection with the plane in the last execution.
+  /// Useful for measuring the efficiency of the index.
+  vtkIdType GetNumberOfTestedCells();
+
+  /// Returns true if the last execution used the fallback vtkPlaneCutter instead of the spatial index.
+  vtkGetMacro(FallbackCutterUsed, bool);
+
+protected:
+  vtkIndexedPlaneCutter();
+  ~vtkIndexedPlaneCutter() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  vtkSmartPointer<vtkPlane> Plane;
+  int MaximumNumberOfCellsPerLeaf{ 16 };
+  bool FallbackCutterUsed{ false };
+  vtkSmartPointer<vtkPlaneCutter> FallbackCutter;
+
+private:
+  vtkIndexedPlaneCutter(const vtkIndexedPlaneCutter&) = delete;
+  void operator=(const vtkIndexedPlaneCutter&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
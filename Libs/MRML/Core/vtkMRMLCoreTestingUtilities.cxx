@@ -23,6 +23,7 @@
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLDisplayableNode.h"
 #include "vtkMRMLDisplayNode.h"
+#include "vtkMRMLJsonElement.h"
 #include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLNode.h"
 #include "vtkMRMLScene.h"
@@ -38,12 +39,18 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkGeneralTransform.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtkTestErrorObserver.h>
+#include <vtkTimerLog.h>
 #include <vtkURIHandler.h>
 #include <vtkXMLDataParser.h>
 
 // STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 namespace vtkMRMLCoreTestingUtilities
@@ -755,4 +762,208 @@ int vtkMRMLNodeCallback::CheckStatus()
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+Benchmark::Benchmark(const std::string& suiteName)
+  : SuiteName(suiteName)
+{
+}
+
+//---------------------------------------------------------------------------
+bool Benchmark::ParseArguments(int argc, char* argv[])
+{
+  for (int argIndex = 1; argIndex < argc; ++argIndex)
+  {
+    const char* arg = argv[argIndex];
+    if (argIndex + 1 >= argc)
+    {
+      std::cerr << this->SuiteName << ": missing value for argument " << arg << std::endl;
+      return false;
+    }
+    const char* value = argv[++argIndex];
+    if (!strcmp(arg, "--size"))
+    {
+      this->Size = atoi(value);
+    }
+    else if (!strcmp(arg, "--repeat"))
+    {
+      this->NumberOfRepetitions = std::max(1, atoi(value));
+    }
+    else if (!strcmp(arg, "--output"))
+    {
+      this->OutputFilePath = value;
+    }
+    else if (!strcmp(arg, "--baseline"))
+    {
+      this->BaselineFilePath = value;
+    }
+    else if (!strcmp(arg, "--tolerance"))
+    {
+      this->Tolerance = atof(value);
+    }
+    else
+    {
+      std::cerr << this->SuiteName << ": unknown argument " << arg << std::endl;
+      std::cerr << "Usage: " << argv[0] << " [--size N] [--repeat N] [--output results.json] [--baseline baseline.json] [--tolerance factor]" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+int Benchmark::GetSize(int defaultSize) const
+{
+  return (this->Size > 0 ? this->Size : defaultSize);
+}
+
+//---------------------------------------------------------------------------
+double Benchmark::Measure(const std::string& name, const std::function<void()>& function, const std::function<void()>& setup /*=nullptr*/)
+{
+  vtkNew<vtkTimerLog> timer;
+  double shortestTimeSec = -1.0;
+  for (int repetition = 0; repetition < this->NumberOfRepetitions; ++repetition)
+  {
+    if (setup)
+    {
+      setup();
+    }
+    timer->StartTimer();
+    function();
+    timer->StopTimer();
+    double timeSec = timer->GetElapsedTime();
+    if (shortestTimeSec < 0 || timeSec < shortestTimeSec)
+    {
+      shortestTimeSec = timeSec;
+    }
+  }
+  this->AddResult(name, shortestTimeSec);
+  return shortestTimeSec;
+}
+
+//---------------------------------------------------------------------------
+void Benchmark::AddResult(const std::string& name, double timeSec)
+{
+  for (auto& result : this->Results)
+  {
+    if (result.first == name)
+    {
+      result.second = timeSec;
+      return;
+    }
+  }
+  this->Results.emplace_back(name, timeSec);
+}
+
+//---------------------------------------------------------------------------
+double Benchmark::GetResult(const std::string& name) const
+{
+  for (const auto& result : this->Results)
+  {
+    if (result.first == name)
+    {
+      return result.second;
+    }
+  }
+  return -1.0;
+}
+
+//---------------------------------------------------------------------------
+bool Benchmark::WriteResults(const std::string& filePath) const
+{
+  vtkNew<vtkMRMLJsonWriter> writer;
+  if (!writer->WriteToFileBegin(filePath.c_str(), nullptr))
+  {
+    return false;
+  }
+  writer->WriteStringProperty("suite", this->SuiteName);
+  writer->WriteIntProperty("size", this->Size);
+  writer->WriteIntProperty("repeat", this->NumberOfRepetitions);
+  writer->WriteArrayPropertyStart("results");
+  for (const auto& result : this->Results)
+  {
+    writer->WriteObjectStart();
+    writer->WriteStringProperty("name", result.first);
+    writer->WriteDoubleProperty("time", result.second);
+    writer->WriteObjectEnd();
+  }
+  writer->WriteArrayPropertyEnd();
+  return writer->WriteToFileEnd();
+}
+
+//---------------------------------------------------------------------------
+bool Benchmark::ReadResults(const std::string& filePath, std::vector<std::pair<std::string, double>>& results)
+{
+  results.clear();
+  vtkNew<vtkMRMLJsonReader> reader;
+  vtkSmartPointer<vtkMRMLJsonElement> root = vtkSmartPointer<vtkMRMLJsonElement>::Take(reader->ReadFromFile(filePath.c_str()));
+  if (!root)
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkMRMLJsonElement> resultsArray = vtkSmartPointer<vtkMRMLJsonElement>::Take(root->GetArrayProperty("results"));
+  if (!resultsArray)
+  {
+    return false;
+  }
+  for (int resultIndex = 0; resultIndex < resultsArray->GetArraySize(); ++resultIndex)
+  {
+    vtkSmartPointer<vtkMRMLJsonElement> resultItem = vtkSmartPointer<vtkMRMLJsonElement>::Take(resultsArray->GetArrayItem(resultIndex));
+    std::string name;
+    double timeSec = 0.0;
+    if (!resultItem || !resultItem->GetStringProperty("name", name) || !resultItem->GetDoubleProperty("time", timeSec))
+    {
+      return false;
+    }
+    results.emplace_back(name, timeSec);
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+int Benchmark::Finish() const
+{
+  std::cout << this->SuiteName << " (size: " << this->Size << ", repeat: " << this->NumberOfRepetitions << ")" << std::endl;
+  for (const auto& result : this->Results)
+  {
+    std::cout << "  " << result.first << ": " << result.second * 1000.0 << " ms" << std::endl;
+  }
+
+  int status = EXIT_SUCCESS;
+  if (!this->OutputFilePath.empty())
+  {
+    if (!this->WriteResults(this->OutputFilePath))
+    {
+      std::cerr << this->SuiteName << ": failed to write results to " << this->OutputFilePath << std::endl;
+      status = EXIT_FAILURE;
+    }
+  }
+
+  if (!this->BaselineFilePath.empty())
+  {
+    std::vector<std::pair<std::string, double>> baselineResults;
+    if (!Benchmark::ReadResults(this->BaselineFilePath, baselineResults))
+    {
+      std::cerr << this->SuiteName << ": failed to read baseline results from " << this->BaselineFilePath << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (const auto& baselineResult : baselineResults)
+    {
+      double timeSec = this->GetResult(baselineResult.first);
+      if (timeSec < 0)
+      {
+        std::cerr << this->SuiteName << ": baseline result " << baselineResult.first << " was not measured" << std::endl;
+        continue;
+      }
+      double allowedTimeSec = std::max(baselineResult.second * this->Tolerance, baselineResult.second + this->MinimumTimeDifference);
+      if (timeSec > allowedTimeSec)
+      {
+        std::cerr << this->SuiteName << ": performance regression in " << baselineResult.first << ": " << timeSec * 1000.0 << " ms"
+                  << " (baseline: " << baselineResult.second * 1000.0 << " ms, tolerance: " << this->Tolerance << ")" << std::endl;
+        status = EXIT_FAILURE;
+      }
+    }
+  }
+  return status;
+}
+
 } // namespace vtkMRMLCoreTestingUtilities
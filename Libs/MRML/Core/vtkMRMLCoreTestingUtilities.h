@@ -28,7 +28,10 @@
 #include <vtkCallbackCommand.h>
 
 // STD includes
+#include <functional>
 #include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -148,6 +151,75 @@ protected:
   std::map<unsigned long, unsigned int> ReceivedEvents;
 };
 
+//---------------------------------------------------------------------------
+/// \brief Helper for writing headless performance benchmark tests.
+///
+/// Measures execution time of operations, writes the results to a JSON file,
+/// and compares them to baseline results that were written by a previous run.
+///
+/// Benchmark tests accept these optional command-line arguments:
+/// - `--size N`: problem size (for example, number of nodes in the synthetic scene).
+/// - `--repeat N`: number of times each operation is executed (minimum time is reported). Default: 3.
+/// - `--output results.json`: write results to this file.
+/// - `--baseline baseline.json`: compare results to this file (written by `--output` in a previous run).
+/// - `--tolerance factor`: the benchmark fails if an operation takes more than factor*baseline time. Default: 1.5.
+///
+/// Example:
+///
+/// \code
+/// int vtkMRMLSomethingPerformanceTest(int argc, char* argv[])
+/// {
+///   vtkMRMLCoreTestingUtilities::Benchmark benchmark("vtkMRMLSomethingPerformanceTest");
+///   CHECK_BOOL(benchmark.ParseArguments(argc, argv), true);
+///   int size = benchmark.GetSize(1000);
+///   benchmark.Measure("AddNodes", [&]() { ... });
+///   return benchmark.Finish();
+/// }
+/// \endcode
+class VTK_MRML_EXPORT Benchmark
+{
+public:
+  Benchmark(const std::string& suiteName);
+
+  /// Parse benchmark arguments. Returns false if an argument is invalid.
+  bool ParseArguments(int argc, char* argv[]);
+
+  /// Problem size specified by --size argument or the default size if not specified.
+  int GetSize(int defaultSize) const;
+
+  /// Execute the function (NumberOfRepetitions times) and record the shortest execution time.
+  /// If setup function is specified then it is called before each execution, it is not included in the measured time.
+  /// Returns the recorded time in seconds.
+  double Measure(const std::string& name, const std::function<void()>& function, const std::function<void()>& setup = nullptr);
+
+  /// Record an externally measured execution time.
+  void AddResult(const std::string& name, double timeSec);
+
+  /// Get recorded time in seconds. Returns -1.0 if there is no such result.
+  double GetResult(const std::string& name) const;
+
+  /// Write results to a JSON file.
+  bool WriteResults(const std::string& filePath) const;
+
+  /// Read results from a JSON file that was written by WriteResults.
+  static bool ReadResults(const std::string& filePath, std::vector<std::pair<std::string, double>>& results);
+
+  /// Print results, write them to the output file, and compare to the baseline (if specified by arguments).
+  /// Returns EXIT_FAILURE if the output cannot be written or any operation is slower than the baseline allows.
+  int Finish() const;
+
+protected:
+  std::string SuiteName;
+  int Size{ -1 };
+  int NumberOfRepetitions{ 3 };
+  std::string OutputFilePath;
+  std::string BaselineFilePath;
+  double Tolerance{ 1.5 };
+  /// Differences below this value (in seconds) are considered measurement noise
+  double MinimumTimeDifference{ 0.005 };
+  std::vector<std::pair<std::string, double>> Results;
+};
+
 } // namespace vtkMRMLCoreTestingUtilities
 
 #include "vtkMRMLCoreTestingUtilities.hxx"
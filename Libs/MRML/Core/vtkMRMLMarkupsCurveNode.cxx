@@ -21,6 +21,7 @@
 #include "vtkMRMLI18N.h"
 #include "vtkCurveGenerator.h"
 #include "vtkCurveMeasurementsCalculator.h"
+#include "vtkCurveSegmentLocator.h"
 #include "vtkEventBroker.h"
 #include "vtkMRMLMarkupsDisplayNode.h"
 #include "vtkMRMLMeasurementLength.h"
@@ -30,6 +31,8 @@
 #include "vtkMRMLUnitNode.h"
 #include "vtkProjectMarkupsCurvePointsFilter.h"
 #include "vtkSlicerDijkstraGraphGeodesicPath.h"
+#include "vtkSurfaceGeodesicPathCalculator.h"
+#include "vtkSurfaceGeodesicPathFilter.h"
 
 // VTK includes
 #include <vtkArrayCalculator.h>
@@ -43,6 +46,7 @@
 #include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGenericCell.h>
+#include <vtkIdTypeArray.h>
 #include <vtkLine.h>
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
@@ -103,6 +107,11 @@ vtkMRMLMarkupsCurveNode::vtkMRMLMarkupsCurveNode()
   this->CurveGenerator->SetNumberOfPointsPerInterpolatingSegment(10);
   this->CurveGenerator->SetSurfaceCostFunctionType(vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE);
 
+  // Replaces the curve generator for ShortestDistanceOnSurface curves that use distance cost function (see UpdateCurveSource)
+  this->SurfaceGeodesicPathFilter = vtkSmartPointer<vtkSurfaceGeodesicPathFilter>::New();
+  this->SurfaceGeodesicPathFilter->SetInputData(this->CurveInputPoly);
+  this->SurfaceGeodesicPathFilter->SetSurfaceConnection(this->SurfaceToLocalTransformer->GetOutputPort());
+
   this->CurvePolyToWorldTransformer->SetInputConnection(this->CurveGenerator->GetOutputPort());
 
   this->ProjectPointsFilter = vtkSmartPointer<vtkProjectMarkupsCurvePointsFilter>::New();
@@ -125,6 +134,8 @@ vtkMRMLMarkupsCurveNode::vtkMRMLMarkupsCurveNode()
   this->WorldOutput = vtkSmartPointer<vtkPassThrough>::New();
   this->WorldOutput->SetInputConnection(this->CurveMeasurementsCalculator->GetOutputPort());
 
+  this->CurveSegmentLocatorWorld = vtkSmartPointer<vtkCurveSegmentLocator>::New();
+
   this->ScalarDisplayAssignAttribute = vtkSmartPointer<vtkAssignAttribute>::New();
 
   this->ShortestDistanceSurfaceActiveScalar = "";
@@ -272,6 +283,28 @@ void vtkMRMLMarkupsCurveNode::PrintSelf(ostream& os, vtkIndent indent)
   vtkMRMLPrintEndMacro();
 }
 
+//---------------------------------------------------------------------------
+vtkPoints* vtkMRMLMarkupsCurveNode::GetCurvePoints()
+{
+  vtkPolyData* curvePoly = this->GetCurve();
+  if (!curvePoly)
+  {
+    return nullptr;
+  }
+  return curvePoly->GetPoints();
+}
+
+//---------------------------------------------------------------------------
+vtkPolyData* vtkMRMLMarkupsCurveNode::GetCurve()
+{
+  if (!this->IsSurfaceGeodesicPathFilterUsed())
+  {
+    return Superclass::GetCurve();
+  }
+  this->SurfaceGeodesicPathFilter->Update();
+  return this->SurfaceGeodesicPathFilter->GetOutput();
+}
+
 //---------------------------------------------------------------------------
 vtkPoints* vtkMRMLMarkupsCurveNode::GetCurvePointsWorld()
 {
@@ -1060,7 +1093,34 @@ void vtkMRMLMarkupsCurveNode::SetNumberOfPointsPerInterpolatingSegment(int point
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurveWorld(const double posWorld[3], double closestPos[3])
 {
-  return vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurve(this->GetCurvePointsWorld(), posWorld, closestPos, this->TransformedCurvePolyLocator);
+  vtkPoints* curvePointsWorld = this->GetCurvePointsWorld();
+  if (!curvePointsWorld || curvePointsWorld->GetNumberOfPoints() < 2)
+  {
+    return vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurve(curvePointsWorld, posWorld, closestPos);
+  }
+  // The locator is only rebuilt if the curve points have changed since the last query
+  this->CurveSegmentLocatorWorld->SetPoints(curvePointsWorld);
+  this->CurveSegmentLocatorWorld->SetClosedCurve(this->CurveClosed);
+  double distance2 = 0.0;
+  return this->CurveSegmentLocatorWorld->FindClosestPoint(posWorld, closestPos, distance2);
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsCurveNode::GetClosestPointPositionsAlongCurveWorld(vtkPoints* posWorld, vtkPoints* closestPosWorld, vtkIdTypeArray* lineIndices /*=nullptr*/)
+{
+  if (!posWorld || !closestPosWorld)
+  {
+    vtkErrorMacro("vtkMRMLMarkupsCurveNode::GetClosestPointPositionsAlongCurveWorld failed: invalid input or output points");
+    return false;
+  }
+  vtkPoints* curvePointsWorld = this->GetCurvePointsWorld();
+  if (!curvePointsWorld || curvePointsWorld->GetNumberOfPoints() < 2)
+  {
+    return false;
+  }
+  this->CurveSegmentLocatorWorld->SetPoints(curvePointsWorld);
+  this->CurveSegmentLocatorWorld->SetClosedCurve(this->CurveClosed);
+  return this->CurveSegmentLocatorWorld->FindClosestPoints(posWorld, closestPosWorld, lineIndices);
 }
 
 //---------------------------------------------------------------------------
@@ -1088,7 +1148,7 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurve(vtkPoints*
       return -1;
     }
     points->GetPoint(closestCurvePointIndex, closestCurvePoint);
-    closestDistance2 = vtkMath::Distance2BetweenPoints(pos, closestPos);
+    closestDistance2 = vtkMath::Distance2BetweenPoints(pos, closestCurvePoint);
   }
   else
   {
@@ -1191,6 +1251,7 @@ void vtkMRMLMarkupsCurveNode::ProcessMRMLEvents(vtkObject* caller, unsigned long
   }
   else if (caller == this->CurveGenerator.GetPointer())
   {
+    this->UpdateCurveSource();
     int surfaceCostFunctionType = this->CurveGenerator->GetSurfaceCostFunctionType();
     // Change the pass through filter input depending on if we need the scalar values.
     // Trying to run SurfaceScalarCalculator without an active scalar will result in an error message.
@@ -1315,6 +1376,151 @@ void vtkMRMLMarkupsCurveNode::SetSurfaceDistanceWeightingFunction(const char* fu
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsCurveNode::GetShortestDistanceOnSurfacePathWorld(vtkPoints* pathPointsWorld, vtkDoubleArray* pedigreeIds /*=nullptr*/)
+{
+  if (!pathPointsWorld)
+  {
+    vtkErrorMacro("vtkMRMLMarkupsCurveNode::GetShortestDistanceOnSurfacePathWorld failed: invalid output points");
+    return false;
+  }
+  pathPointsWorld->Reset();
+  if (!this->GetSurfaceConstraintNode() || !this->GetSurfaceConstraintNode()->GetPolyData())
+  {
+    return false;
+  }
+  vtkPoints* controlPointsLocal = this->CurveInputPoly->GetPoints();
+  if (!controlPointsLocal || controlPointsLocal->GetNumberOfPoints() < 1)
+  {
+    return false;
+  }
+
+  // The output of the surface pipeline is only modified if the surface mesh or its transform is changed,
+  // therefore the graph in the calculator (shared with the curve generation) is reused between calls.
+  this->SurfaceToLocalTransformer->Update();
+  vtkSurfaceGeodesicPathCalculator* pathCalculator = this->GetSurfaceGeodesicPathCalculator();
+  pathCalculator->SetSurface(this->SurfaceToLocalTransformer->GetOutput());
+
+  vtkNew<vtkPoints> pathPointsLocal;
+  bool success = pathCalculator->ComputePathThroughPoints(controlPointsLocal, this->CurveClosed, pathPointsLocal, pedigreeIds);
+
+  vtkNew<vtkGeneralTransform> localToWorldTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, localToWorldTransform);
+  localToWorldTransform->TransformPoints(pathPointsLocal, pathPointsWorld);
+  return success;
+}
+
+//---------------------------------------------------------------------------
+vtkSurfaceGeodesicPathCalculator* vtkMRMLMarkupsCurveNode::GetSurfaceGeodesicPathCalculator()
+{
+  return this->SurfaceGeodesicPathFilter->GetPathCalculator();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsCurveNode::IsSurfaceGeodesicPathFilterUsed()
+{
+  return this->CurvePolyToWorldTransformer->GetInputConnection(0, 0) == this->SurfaceGeodesicPathFilter->GetOutputPort();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsCurveNode::UpdateCurveSource()
+{
+  // Only the distance cost function is supported by the surface geodesic path filter,
+  // the curve generator is used for other cost functions.
+  bool useSurfaceGeodesicPathFilter = this->CurveGenerator->GetCurveType() == vtkCurveGenerator::CURVE_TYPE_SHORTEST_DISTANCE_ON_SURFACE
+                                      && this->CurveGenerator->GetSurfaceCostFunctionType() == vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE
+                                      && this->GetSurfaceConstraintNode() != nullptr;
+  this->SurfaceGeodesicPathFilter->SetCurveIsClosed(this->CurveClosed);
+  vtkAlgorithmOutput* curveConnection = useSurfaceGeodesicPathFilter ? this->SurfaceGeodesicPathFilter->GetOutputPort() : this->CurveGenerator->GetOutputPort();
+  if (this->CurvePolyToWorldTransformer->GetInputConnection(0, 0) != curveConnection)
+  {
+    this->CurvePolyToWorldTransformer->SetInputConnection(curveConnection);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsCurveNode::InvokeCustomModifiedEvent(int eventId, void* callData /*=nullptr*/)
+{
+  if (this->CurveMeasurementsCalculator)
+  {
+    if (eventId == vtkMRMLMarkupsNode::PointModifiedEvent && callData && !this->GetDisableModifiedEvent())
+    {
+      this->AddModifiedControlPointToMeasurementsCalculator(*static_cast<int*>(callData));
+    }
+    else if (eventId == vtkMRMLMarkupsNode::PointModifiedEvent            //
+             || eventId == vtkMRMLMarkupsNode::PointAddedEvent             //
+             || eventId == vtkMRMLMarkupsNode::PointRemovedEvent           //
+             || eventId == vtkMRMLMarkupsNode::PointPositionDefinedEvent   //
+             || eventId == vtkMRMLMarkupsNode::PointPositionUndefinedEvent //
+             || eventId == vtkMRMLMarkupsNode::PointPositionMissingEvent   //
+             || eventId == vtkMRMLMarkupsNode::PointPositionNonMissingEvent)
+    {
+      // Modified control points are not known (batch modification) or the number of curve points may change
+      this->CurveMeasurementsCalculator->SetAllCurvePointsModified();
+    }
+  }
+  this->Superclass::InvokeCustomModifiedEvent(eventId, callData);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsCurveNode::AddModifiedControlPointToMeasurementsCalculator(int controlPointIndex)
+{
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  if (controlPointIndex < 0 || controlPointIndex >= numberOfControlPoints    //
+      || this->GetNumberOfDefinedControlPoints(true) != numberOfControlPoints //
+      || !this->CurveGenerator->IsInterpolatingCurve()                        //
+      || this->GetSurfaceConstraintNode())
+  {
+    // Curve point indices cannot be computed from the control point index
+    // or curve points are projected to a surface that may have changed, too.
+    this->CurveMeasurementsCalculator->SetAllCurvePointsModified();
+    return;
+  }
+
+  // Number of neighbor control points on each side that influence the curve between two control points
+  int numberOfInfluencingControlPoints = numberOfControlPoints;
+  if (this->CurveGenerator->GetCurveType() == vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE)
+  {
+    numberOfInfluencingControlPoints = 1;
+  }
+  else if (this->CurveGenerator->GetCurveType() == vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE)
+  {
+    numberOfInfluencingControlPoints = 2;
+  }
+  // Cardinal spline is computed from all control points
+
+  int firstControlPointIndex = controlPointIndex - numberOfInfluencingControlPoints;
+  int lastControlPointIndex = controlPointIndex + numberOfInfluencingControlPoints;
+  vtkIdType pointsPerSegment = this->CurveGenerator->GetNumberOfPointsPerInterpolatingSegment();
+  if (this->CurveClosed && (firstControlPointIndex < 0 || lastControlPointIndex >= numberOfControlPoints))
+  {
+    // Modified region wraps around the start point of the closed curve
+    this->CurveMeasurementsCalculator->AddModifiedCurvePointRange(0, static_cast<vtkIdType>(numberOfControlPoints) * pointsPerSegment);
+    return;
+  }
+  // Curve points at the neighbor control points that are not moved are excluded from the range
+  vtkIdType firstCurvePointIndex = (firstControlPointIndex < 0 ? 0 : firstControlPointIndex * pointsPerSegment + 1);
+  vtkIdType lastCurvePointIndex = (lastControlPointIndex >= numberOfControlPoints ? static_cast<vtkIdType>(numberOfControlPoints - 1) * pointsPerSegment
+                                                                                 : lastControlPointIndex * pointsPerSegment - 1);
+  this->CurveMeasurementsCalculator->AddModifiedCurvePointRange(firstCurvePointIndex, lastCurvePointIndex);
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsCurveNode::GetControlPointIndexFromInterpolatedPointIndex(vtkIdType interpolatedPointIndex)
+{
+  if (!this->IsSurfaceGeodesicPathFilterUsed())
+  {
+    return Superclass::GetControlPointIndexFromInterpolatedPointIndex(interpolatedPointIndex);
+  }
+  this->SurfaceGeodesicPathFilter->Update();
+  vtkIdType controlPointId = this->SurfaceGeodesicPathFilter->GetControlPointIdFromInterpolatedPointId(interpolatedPointIndex);
+  if (controlPointId < 0)
+  {
+    controlPointId = this->GetNumberOfControlPoints();
+  }
+  return controlPointId;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsCurveNode::OnSurfaceModelNodeChanged()
 {
@@ -1331,6 +1537,7 @@ void vtkMRMLMarkupsCurveNode::OnSurfaceModelNodeChanged()
     this->CleanFilter->RemoveAllInputs();
     this->CurveGenerator->RemoveInputConnection(1, this->SurfaceScalarPassThroughFilter->GetOutputPort());
   }
+  this->UpdateCurveSource();
 }
 
 //---------------------------------------------------------------------------
@@ -38,9 +38,14 @@ class vtkAssignAttribute;
 class vtkCallbackCommand;
 class vtkCleanPolyData;
 class vtkCurveMeasurementsCalculator;
+class vtkCurveSegmentLocator;
+class vtkDoubleArray;
+class vtkIdTypeArray;
 class vtkPassThrough;
 class vtkPlane;
 class vtkProjectMarkupsCurvePointsFilter;
+class vtkSurfaceGeodesicPathCalculator;
+class vtkSurfaceGeodesicPathFilter;
 class vtkTransformPolyDataFilter;
 class vtkTriangleFilter;
 
@@ -85,6 +90,9 @@ class vtkTriangleFilter;
 ///                          |        +-----------------+                                                  |
 ///                          +-----------------------------------------------------------------------------+
 ///
+/// For ShortestDistanceOnSurface curve type with distance cost function, vtkSurfaceGeodesicPathFilter
+/// generates the curve instead of vtkCurveGenerator.
+///
 class VTK_MRML_EXPORT vtkMRMLMarkupsCurveNode : public vtkMRMLMarkupsNode
 {
 public:
@@ -120,7 +128,9 @@ public:
 
   ///@{
   /// Get curve points positions in world coordinate system.
+  vtkPoints* GetCurvePoints() override;
   vtkPoints* GetCurvePointsWorld() override;
+  vtkPolyData* GetCurve() override;
   vtkPolyData* GetCurveWorld() override;
   vtkAlgorithmOutput* GetCurveWorldConnection() override;
   ///@}
@@ -183,8 +193,19 @@ public:
   /// Returns index of the found line segment. -1 if failed.
   /// \param posWorld: input position
   /// \param closestPosWorld: output found closest position
+  /// The query uses a cached spatial index of the curve segments, which is only rebuilt when the curve changes.
   vtkIdType GetClosestPointPositionAlongCurveWorld(const double posWorld[3], double closestPosWorld[3]);
 
+  /// Get positions of the closest points along the curve in world coordinates for many positions at once.
+  /// This is much faster than calling GetClosestPointPositionAlongCurveWorld for each position
+  /// (for example, when projecting a large number of points onto a centerline), as the queries
+  /// are processed in parallel.
+  /// Returns false if failed (for example, the curve has less than 2 points).
+  /// \param posWorld: input positions
+  /// \param closestPosWorld: output found closest positions
+  /// \param lineIndices: optional output array containing index of the found line segment for each position
+  bool GetClosestPointPositionsAlongCurveWorld(vtkPoints* posWorld, vtkPoints* closestPosWorld, vtkIdTypeArray* lineIndices = nullptr);
+
   /// Get position of the closest point along the curve in any coordinate system.
   /// The found position may be between two curve points.
   /// Returns index of the found line segment. -1 if failed.
@@ -310,6 +331,25 @@ public:
   const char* GetSurfaceDistanceWeightingFunction();
   void SetSurfaceDistanceWeightingFunction(const char* function);
 
+  /// Compute the shortest path on the surface constraint model through the control points, in world coordinates.
+  /// The vertex graph of the surface is cached (it is only rebuilt when the surface or its transform changes),
+  /// paths are found by A* search, and paths between consecutive control points are computed in parallel.
+  /// Path length is used as cost (other surface cost functions are not taken into account).
+  /// Returns false if there is no surface constraint node or a path segment could not be found.
+  /// \param pathPointsWorld output path points
+  /// \param pedigreeIds optional output, contains for each path point the fractional control point index
+  bool GetShortestDistanceOnSurfacePathWorld(vtkPoints* pathPointsWorld, vtkDoubleArray* pedigreeIds = nullptr);
+
+  /// The internal instance of the shortest path calculator, which caches the vertex graph of the surface constraint model.
+  vtkSurfaceGeodesicPathCalculator* GetSurfaceGeodesicPathCalculator();
+
+  /// Returns true if the curve is generated by the surface geodesic path filter instead of the curve generator.
+  /// The filter is used for ShortestDistanceOnSurface curve type with distance cost function,
+  /// other cost functions are computed by the curve generator.
+  bool IsSurfaceGeodesicPathFilterUsed();
+
+  int GetControlPointIndexFromInterpolatedPointIndex(vtkIdType interpolatedPointIndex) override;
+
   //@{
   /// Get/set how many curve points are inserted between control points.
   /// Higher values are recommended if distance between control points is large.
@@ -320,6 +360,14 @@ public:
   /// Update scalar range and update markups pipeline when the active scalar array is changed
   virtual void UpdateAssignedAttribute() override;
 
+  /// The internal instance of the curve measurements calculator.
+  /// Can be used for changing calculation options, such as incremental update.
+  vtkCurveMeasurementsCalculator* GetCurveMeasurementsCalculator() { return this->CurveMeasurementsCalculator.GetPointer(); };
+
+  /// Reimplemented to let the curve measurements calculator know which curve points
+  /// may have moved, so that curve measurements can be updated incrementally.
+  void InvokeCustomModifiedEvent(int eventId, void* callData = nullptr) override;
+
 protected:
   vtkSmartPointer<vtkCleanPolyData> CleanFilter;
   vtkSmartPointer<vtkTriangleFilter> TriangleFilter;
@@ -328,6 +376,10 @@ protected:
   vtkSmartPointer<vtkPassThrough> SurfaceScalarPassThroughFilter;
   vtkSmartPointer<vtkCurveMeasurementsCalculator> CurveMeasurementsCalculator;
   vtkSmartPointer<vtkPassThrough> WorldOutput;
+  /// Spatial index of the world curve segments for closest point queries
+  vtkSmartPointer<vtkCurveSegmentLocator> CurveSegmentLocatorWorld;
+  /// Generates the ShortestDistanceOnSurface curve on the surface constraint model (in local coordinates)
+  vtkSmartPointer<vtkSurfaceGeodesicPathFilter> SurfaceGeodesicPathFilter;
   const char* ShortestDistanceSurfaceActiveScalar;
 
   /// Filter that changes the active scalar of the input mesh using the ActiveScalarName
@@ -350,6 +402,14 @@ protected:
   virtual void OnSurfaceModelNodeChanged();
   virtual void OnSurfaceModelTransformChanged();
 
+  /// Connect the curve generator or the surface geodesic path filter to the curve pipeline,
+  /// depending on the curve type, surface cost function, and surface constraint node.
+  void UpdateCurveSource();
+
+  /// Report the curve points that may be moved by modifying the position of a control point
+  /// to the curve measurements calculator.
+  void AddModifiedControlPointToMeasurementsCalculator(int controlPointIndex);
+
   vtkMRMLMarkupsCurveNode();
   ~vtkMRMLMarkupsCurveNode() override;
   vtkMRMLMarkupsCurveNode(const vtkMRMLMarkupsCurveNode&);
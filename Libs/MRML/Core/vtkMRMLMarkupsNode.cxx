@@ -2593,40 +2593,139 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points, bool s
     return;
   }
 
+  vtkMRMLTransformNode* transformNode = this->GetParentTransformNode();
+  if (!transformNode)
+  {
+    this->SetControlPointPositions(points, setUndefinedPoints);
+    return;
+  }
+
+  // Get the transform only once for all the points
+  vtkNew<vtkGeneralTransform> worldToLocalTransform;
+  transformNode->GetTransformFromWorld(worldToLocalTransform);
+  vtkNew<vtkPoints> pointsLocal;
+  pointsLocal->SetDataTypeToDouble();
+  worldToLocalTransform->TransformPoints(points, pointsLocal);
+  this->SetControlPointPositions(pointsLocal, setUndefinedPoints);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+{
+  if (!points)
+  {
+    return;
+  }
+  vtkMRMLTransformNode* transformNode = this->GetParentTransformNode();
+  if (!transformNode)
+  {
+    this->GetControlPointPositions(points);
+    return;
+  }
+  vtkNew<vtkPoints> pointsLocal;
+  this->GetControlPointPositions(pointsLocal);
+  vtkNew<vtkGeneralTransform> localToWorldTransform;
+  transformNode->GetTransformToWorld(localToWorldTransform);
+  points->Reset();
+  localToWorldTransform->TransformPoints(pointsLocal, points);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::SetControlPointPositions(vtkPoints* points, bool setUndefinedPoints /*=true*/)
+{
+  if (!points)
+  {
+    this->RemoveAllControlPoints();
+    return;
+  }
+
+  int numberOfPoints = static_cast<int>(points->GetNumberOfPoints());
+  int numberOfExistingControlPoints = this->GetNumberOfControlPoints();
+  if (this->GetFixedNumberOfControlPoints() && numberOfPoints != numberOfExistingControlPoints)
+  {
+    vtkErrorMacro("SetControlPointPositions: Markup node control point number is locked, only positions of existing control points are updated.");
+    numberOfPoints = std::min(numberOfPoints, numberOfExistingControlPoints);
+  }
+  if (this->MaximumNumberOfControlPoints >= 0 && numberOfPoints > this->MaximumNumberOfControlPoints)
+  {
+    vtkErrorMacro("SetControlPointPositions: number of points (" << numberOfPoints << ") is more than maximum number of control points allowed ("
+                                                                 << this->MaximumNumberOfControlPoints << ")");
+    numberOfPoints = std::max(this->MaximumNumberOfControlPoints, std::min(numberOfPoints, numberOfExistingControlPoints));
+  }
+
   int wasModified = this->StartModify();
   this->IsUpdatingPoints = true;
 
-  vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  // Update existing control points
+  bool pointModified = false;
+  bool positionDefined = false;
+  bool positionNonMissing = false;
+  int numberOfControlPointsToUpdate = std::min(numberOfPoints, numberOfExistingControlPoints);
+  for (int pointIndex = 0; pointIndex < numberOfControlPointsToUpdate; pointIndex++)
   {
-    double* posWorld = points->GetPoint(pointIndex);
-    if (pointIndex < this->GetNumberOfControlPoints())
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    if (!setUndefinedPoints && controlPoint->PositionStatus != PositionDefined)
     {
-      // point already exists, just update it
-      if (setUndefinedPoints || this->GetNthControlPointPositionStatus(pointIndex) == PositionDefined)
-      {
-        this->SetNthControlPointPositionWorld(pointIndex, posWorld);
-      }
+      continue;
     }
-    else
+    points->GetPoint(pointIndex, controlPoint->Position);
+    positionDefined |= (controlPoint->PositionStatus != PositionDefined);
+    positionNonMissing |= (controlPoint->PositionStatus == PositionMissing);
+    controlPoint->PositionStatus = PositionDefined;
+    pointModified = true;
+  }
+
+  // Add new control points
+  if (numberOfPoints > numberOfExistingControlPoints)
+  {
+    this->ControlPoints.reserve(numberOfPoints);
+    for (int pointIndex = numberOfExistingControlPoints; pointIndex < numberOfPoints; pointIndex++)
     {
-      // need to add a new point
-      vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      ControlPoint* controlPoint = new ControlPoint;
+      points->GetPoint(pointIndex, controlPoint->Position);
+      controlPoint->PositionStatus = PositionDefined;
+      controlPoint->ID = this->GenerateUniqueControlPointID();
+      controlPoint->Label = this->GenerateControlPointLabel(this->LastUsedControlPointNumber);
+      this->ControlPoints.push_back(controlPoint);
     }
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent);
+    pointModified = true;
+    positionDefined = true;
   }
-  while (this->GetNumberOfControlPoints() > numberOfPoints)
+
+  // Remove extra control points
+  while (!this->GetFixedNumberOfControlPoints() && this->GetNumberOfControlPoints() > numberOfPoints)
   {
     this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
   }
 
+  if (pointModified)
+  {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent);
+  }
+  if (positionDefined)
+  {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent);
+  }
+  if (positionNonMissing)
+  {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionNonMissingEvent);
+  }
+  this->StorableModifiedTime.Modified();
+
   this->IsUpdatingPoints = false;
   // No need to call UpdateAllMeasurements(), because it is automatically
   // called in EndModify().
   this->EndModify(wasModified);
+
+  if (pointModified && this->GetDisplayNode())
+  {
+    this->GetDisplayNode()->UpdateScalarRange();
+  }
 }
 
 //---------------------------------------------------------------------------
-void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+void vtkMRMLMarkupsNode::GetControlPointPositions(vtkPoints* points)
 {
   if (!points)
   {
@@ -2634,12 +2733,11 @@ void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
   }
   int numberOfControlPoints = this->GetNumberOfControlPoints();
   points->SetNumberOfPoints(numberOfControlPoints);
-  double posWorld[3] = { 0.0, 0.0, 0.0 };
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
   {
-    this->GetNthControlPointPositionWorld(controlPointIndex, posWorld);
-    points->SetPoint(controlPointIndex, posWorld);
+    points->SetPoint(controlPointIndex, this->ControlPoints[controlPointIndex]->Position);
   }
+  points->Modified();
 }
 
 //---------------------------------------------------------------------------
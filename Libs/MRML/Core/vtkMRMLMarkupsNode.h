@@ -316,11 +316,22 @@ public:
   /// New control points are added if needed.
   /// Existing control points are updated with the new positions.
   /// Any extra existing control points are removed.
+  /// Points are transformed to local coordinate system at once and then set using SetControlPointPositions.
   void SetControlPointPositionsWorld(vtkPoints* points, bool setUndefinedPoints = true);
 
   /// Get a copy of all control point positions in world coordinate system
   void GetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Set all control point positions from a point list in local coordinate system.
+  /// Works the same way as SetControlPointPositionsWorld, but all control points are updated in a single batch:
+  /// curve and measurements are updated once and each point event is invoked only once (with nullptr as call data).
+  /// This is much faster than setting positions point by point when there are many control points.
+  /// \param setUndefinedPoints if false then only the position of the existing defined points are updated.
+  void SetControlPointPositions(vtkPoints* points, bool setUndefinedPoints = true);
+
+  /// Get a copy of all control point positions in local coordinate system
+  void GetControlPointPositions(vtkPoints* points);
+
   ///@{
   /// Add a new control point, returning the point index, -1 on failure.
   int AddControlPoint(vtkVector3d point, std::string label = std::string());
@@ -674,7 +685,7 @@ public:
   ///@}
 
   /// Converts curve point index to control point index.
-  int GetControlPointIndexFromInterpolatedPointIndex(vtkIdType interpolatedPointIndex);
+  virtual int GetControlPointIndexFromInterpolatedPointIndex(vtkIdType interpolatedPointIndex);
 
   /// Compute evenly-spaced direction marker positions and unit tangents along a curve.
   /// Markers are placed starting at half the spacing from the first point so they are
@@ -19,6 +19,7 @@ Version:   $Revision: 1.3 $
 #include <vtkMRMLProceduralColorNode.h>
 #include "vtkMRMLTransformNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkParallelTransformFilter.h"
 
 // VTK includes
 #include <vtkAlgorithmOutput.h>
@@ -711,7 +712,7 @@ void vtkMRMLModelNode::ApplyTransform(vtkAbstractTransform* transform)
     return;
   }
 
-  vtkTransformFilter* transformFilter = vtkTransformFilter::New();
+  vtkTransformFilter* transformFilter = vtkParallelTransformFilter::New();
   transformFilter->SetInputConnection(this->MeshConnection);
   transformFilter->SetTransform(transform);
 
@@ -1000,7 +1001,7 @@ vtkImplicitFunction* vtkMRMLModelNode::GetImplicitFunctionWorld()
 
   if (!this->PolyDataLocalToWorldTransformFilter)
   {
-    this->PolyDataLocalToWorldTransformFilter = vtkSmartPointer<vtkTransformFilter>::New();
+    this->PolyDataLocalToWorldTransformFilter = vtkSmartPointer<vtkParallelTransformFilter>::New();
   }
 
   if (!this->ImplicitPolyDataDistanceWorld)
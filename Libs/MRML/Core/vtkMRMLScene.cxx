@@ -86,6 +86,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLTableViewNode.h"
 #include "vtkMRMLTextNode.h"
 #include "vtkMRMLTextStorageNode.h"
+#include "vtkMRMLTracer.h"
 #include "vtkMRMLTransformDisplayNode.h"
 #include "vtkMRMLTransformNode.h"
 #include "vtkMRMLTransformStorageNode.h"
@@ -348,6 +349,7 @@ void vtkMRMLScene::SceneCallback(vtkObject* vtkNotUsed(caller), unsigned long vt
 //------------------------------------------------------------------------------
 void vtkMRMLScene::Clear(int removeSingletons)
 {
+  vtkMRMLTraceScopeMacro("Scene", "Clear");
 #ifdef MRMLSCENE_VERBOSE
   vtkTimerLog* timer = vtkTimerLog::New();
   timer->StartTimer();
@@ -788,6 +790,7 @@ void vtkMRMLScene::ProgressState(unsigned long state, int progress)
 //------------------------------------------------------------------------------
 int vtkMRMLScene::Connect(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*/)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Scene", "Connect", this->GetURL());
   if (this->IsClosing())
   {
     vtkWarningMacro("vtkMRMLScene::Connect(): scene is in closing state");
@@ -826,6 +829,7 @@ int vtkMRMLScene::Connect(vtkMRMLMessageCollection* userMessagesInput /*=nullptr
 //------------------------------------------------------------------------------
 int vtkMRMLScene::Import(vtkMRMLMessageCollection* userMessagesInput /*=nullptr*/)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Scene", "Import", this->GetURL());
   bool wasSceneModified = this->GetModifiedSinceRead();
 
   // We use userMessages for collecting error information, so make sure we have it, even if the caller does not need it.
@@ -1070,6 +1074,7 @@ int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection, vtkMRMLMessageCol
 //------------------------------------------------------------------------------
 int vtkMRMLScene::Commit(const char* url, vtkMRMLMessageCollection* userMessagesInput /*=nullptr*/)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Scene", "Commit", url ? url : this->GetURL());
   // We use userMessages for collecting error information, so make sure we have it, even if the caller does not need it.
   vtkSmartPointer<vtkMRMLMessageCollection> userMessages = userMessagesInput;
   if (!userMessages)
@@ -2825,6 +2830,7 @@ void vtkMRMLScene::SaveStateForUndo(vtkCollection* nodes)
 //------------------------------------------------------------------------------
 void vtkMRMLScene::SaveStateForUndo()
 {
+  vtkMRMLTraceScopeMacro("Scene", "SaveStateForUndo");
   if (!this->UndoFlag)
   {
     return;
@@ -2960,6 +2966,7 @@ void vtkMRMLScene::CopyNodeInRedoStack(vtkMRMLNode* copyNode)
 // -- move the current scene on the redo stack
 void vtkMRMLScene::Undo()
 {
+  vtkMRMLTraceScopeMacro("Scene", "Undo");
   if (!this->UndoFlag)
   {
     return;
@@ -3090,6 +3097,7 @@ void vtkMRMLScene::Undo()
 //------------------------------------------------------------------------------
 void vtkMRMLScene::Redo()
 {
+  vtkMRMLTraceScopeMacro("Scene", "Redo");
   if (!this->UndoFlag)
   {
     return;
@@ -3975,6 +3983,7 @@ std::string vtkMRMLScene::GetTemporaryBundleDirectory()
 //----------------------------------------------------------------------------
 bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail /*=nullptr*/, vtkMRMLMessageCollection* userMessages /*=nullptr*/)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Scene", "WriteToMRB", filename);
   //
   // make a temp directory to save the scene into - this will
   // be a uniquely named directory that contains a directory
@@ -4060,6 +4069,7 @@ bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail /*=n
 //-----------------------------------------------------------------------------
 bool vtkMRMLScene::ReadFromMRB(const char* fullName, bool clear /*=false*/, vtkMRMLMessageCollection* userMessagesInput /*=nullptr*/)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Scene", "ReadFromMRB", fullName);
   // We use userMessages for collecting error information, so make sure we have it, even if the caller does not need it.
   vtkSmartPointer<vtkMRMLMessageCollection> userMessages = userMessagesInput;
   if (!userMessages)
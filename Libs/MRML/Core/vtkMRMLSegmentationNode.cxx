@@ -34,6 +34,7 @@
 #include <vtkMRMLTransformNode.h>
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLSubjectHierarchyNode.h>
+#include <vtkMRMLTracer.h>
 #include <vtkMRMLScalarVolumeNode.h>
 
 // VTK includes
@@ -475,6 +476,7 @@ void vtkMRMLSegmentationNode::ApplyTransform(vtkAbstractTransform* transform)
   // Restore original representations
   for (const std::string& representationName : containedRepresentationNames)
   {
+    vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", representationName);
     this->Segmentation->CreateRepresentation(representationName);
   }
 
@@ -857,6 +859,7 @@ bool vtkMRMLSegmentationNode::CreateBinaryLabelmapRepresentation()
     vtkErrorMacro("CreateBinaryLabelmapRepresentation: Invalid segmentation");
     return false;
   }
+  vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
   return this->Segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
 }
 
@@ -931,6 +934,7 @@ bool vtkMRMLSegmentationNode::CreateClosedSurfaceRepresentation()
     vtkErrorMacro("CreateClosedSurfaceRepresentation: Invalid segmentation");
     return false;
   }
+  vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
   return this->Segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
 }
 
@@ -1076,24 +1080,16 @@ double* vtkMRMLSegmentationNode::GetSegmentCenter(const std::string& segmentID)
 
     vtkNew<vtkITKIslandMath> islandMath;
     islandMath->SetInputConnection(castToUint->GetOutputPort());
+    islandMath->Update();
 
-    vtkNew<vtkImageThreshold> largestIslandFilter;
-    largestIslandFilter->SetInputConnection(islandMath->GetOutputPort());
-    largestIslandFilter->ThresholdBetween(1.0, 1.0);
-    largestIslandFilter->SetInValue(1.0);
-    largestIslandFilter->SetOutValue(0.0);
-    largestIslandFilter->Update();
-
-    vtkNew<vtkOrientedImageData> largestResampledIsland;
-    largestResampledIsland->ShallowCopy(largestIslandFilter->GetOutput());
-    largestResampledIsland->CopyDirections(resampledLabelmap);
-
+    // Islands are sorted by size, therefore the extent of the largest island is the extent of the first island
     int resampledLabelEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-    if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(largestResampledIsland, resampledLabelEffectiveExtent))
+    if (islandMath->GetNumberOfIslands() == 0)
     {
       vtkWarningMacro("GetSegmentCenter: segment " << segmentID << " is empty");
       return nullptr;
     }
+    islandMath->GetIslandExtent(0, resampledLabelEffectiveExtent);
 
     // segmentCenter_Image is floored to put the center exactly in the center of a voxel
     // (otherwise center position would be set at the boundary between two voxels when extent size is an even number)
@@ -32,6 +32,7 @@
 #include <vtkMRMLScene.h>
 #include "vtkMRMLSegmentationNode.h"
 #include "vtkMRMLSegmentationDisplayNode.h"
+#include "vtkMRMLTracer.h"
 
 // VTK includes
 #include <vtkDataObject.h>
@@ -1721,6 +1722,7 @@ void vtkMRMLSegmentationStorageNode::CreateRepresentationsBySerializedNames(vtkS
     // Only create non-source representations
     if (representationName.compare(sourceRepresentation))
     {
+      vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", representationName);
       segmentation->CreateRepresentation(representationName);
     }
   }
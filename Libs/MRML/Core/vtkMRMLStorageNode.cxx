@@ -20,6 +20,7 @@ Version:   $Revision: 1.1.1.1 $
 #include "vtkMRMLScene.h"
 #include "vtkMRMLStorableNode.h"
 #include "vtkMRMLStorageNode.h"
+#include "vtkMRMLTracer.h"
 
 // VTK includes
 #include <vtkCollection.h>
@@ -1163,6 +1164,7 @@ bool vtkMRMLStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* refNode)
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Storage", "ReadData", std::string(this->GetClassName()) + ": " + (this->GetFileName() ? this->GetFileName() : ""));
   if (refNode == nullptr)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLStorageNode::ReadData", "Cannot read data into a null node.");
@@ -1257,6 +1259,7 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
 {
+  vtkMRMLTraceScopeWithDetailMacro("Storage", "WriteData", std::string(this->GetClassName()) + ": " + (this->GetFileName() ? this->GetFileName() : ""));
   this->WriteState = this->Idle;
   if (refNode == nullptr)
   {
@@ -41,6 +41,7 @@
 #include <sstream>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 
 //----------------------------------------------------------------------------
@@ -105,8 +106,25 @@ public:
 
   /// Item and data node cache to speed up lookups that are needed many times.
   /// It can be static as the item IDs are unique in one application session.
-  static std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>> ItemCache;
-  static std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem>> DataNodeCache;
+  static std::unordered_map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>> ItemCache;
+  static std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem>> DataNodeCache;
+
+  /// Map from a UID or attribute value to the items that have that value
+  typedef std::unordered_multimap<std::string, vtkSubjectHierarchyItem*> ValueIndex;
+  /// Map from a UID or attribute name to the value index of that name
+  typedef std::unordered_map<std::string, ValueIndex> NameValueIndex;
+
+  /// Indices of UID and attribute values to speed up lookups by value.
+  /// All existing items are indexed (including items that are not in a subject hierarchy tree),
+  /// so lookups must check if the found items are in the queried branch.
+  /// The index is maintained incrementally whenever a UID or attribute of an item changes.
+  static NameValueIndex UIDIndex;
+  static NameValueIndex AttributeIndex;
+  /// Indices of the individual values of space-separated lists (such as DICOM instance UID lists).
+  /// Only values that contain more than one list element are added to these indices,
+  /// single values can be found in \sa UIDIndex and \sa AttributeIndex.
+  static NameValueIndex UIDListIndex;
+  static NameValueIndex AttributeListIndex;
 
   // Get/set functions
 public:
@@ -184,6 +202,15 @@ public:
   /// \param recursive Flag whether to find only direct children (false) or in the whole branch (true). True by default
   /// \return Item if found, nullptr otherwise
   vtkSubjectHierarchyItem* FindChildByUIDList(std::string uidName, std::string uidValue, bool recursive = true);
+  /// Find children by attribute value (exact match)
+  /// \param foundItems List of found items in the order they appear in the tree
+  /// \param recursive Flag whether to find only direct children (false) or in the whole branch (true). True by default
+  void FindChildrenByAttribute(std::string attributeName, std::string attributeValue, std::vector<vtkSubjectHierarchyItem*>& foundItems, bool recursive = true);
+  /// Find children by attribute that contains the given value in its space-separated list of values.
+  /// For example find items referencing a DICOM instance UID.
+  /// \param foundItems List of found items in the order they appear in the tree
+  /// \param recursive Flag whether to find only direct children (false) or in the whole branch (true). True by default
+  void FindChildrenByAttributeList(std::string attributeName, std::string attributeValue, std::vector<vtkSubjectHierarchyItem*>& foundItems, bool recursive = true);
   /// Find children by name
   /// \param name Name (or part of a name) to find
   /// \param foundItemIDs List of found item IDs. Needs to be empty when passing as argument!
@@ -238,6 +265,9 @@ public:
   /// Get ancestor subject hierarchy item at a certain level
   /// \param level Level of the ancestor node we start searching.
   vtkSubjectHierarchyItem* GetAncestorAtLevel(std::string level);
+  /// Sort items by their position in the tree (depth-first order, same as the order of recursive lookups).
+  /// Duplicate items are removed.
+  static void SortInTreeOrder(std::vector<vtkSubjectHierarchyItem*>& items);
 
 public:
   vtkSubjectHierarchyItem();
@@ -247,6 +277,17 @@ private:
   /// Incremental ID used to uniquely identify subject hierarchy items
   static vtkIdType NextSubjectHierarchyItemID;
 
+  /// Add/remove a name-value pair of this item to/from the value index and the list index
+  void AddToIndex(NameValueIndex& index, NameValueIndex& listIndex, const std::string& name, const std::string& value);
+  void RemoveFromIndex(NameValueIndex& index, NameValueIndex& listIndex, const std::string& name, const std::string& value);
+  /// Add/remove all UIDs and attributes of this item to/from the indices
+  void AddAllToIndex();
+  void RemoveAllFromIndex();
+  /// Get items from the index that match the name and value and are in the branch of this item
+  void GetIndexedChildren(NameValueIndex& index, const std::string& name, const std::string& value, std::vector<vtkSubjectHierarchyItem*>& foundItems, bool recursive);
+  /// Determine whether the item is in the tree under this item
+  bool IsInBranch(vtkSubjectHierarchyItem* item, bool recursive);
+
   vtkSubjectHierarchyItem(const vtkSubjectHierarchyItem&) = delete;
   void operator=(const vtkSubjectHierarchyItem&) = delete;
 };
@@ -256,8 +297,41 @@ vtkStandardNewMacro(vtkSubjectHierarchyItem);
 
 vtkIdType vtkSubjectHierarchyItem::NextSubjectHierarchyItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
 
-std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>> vtkSubjectHierarchyItem::ItemCache = std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>>();
-std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem>> vtkSubjectHierarchyItem::DataNodeCache = std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem>>();
+std::unordered_map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>> vtkSubjectHierarchyItem::ItemCache;
+std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem>> vtkSubjectHierarchyItem::DataNodeCache;
+vtkSubjectHierarchyItem::NameValueIndex vtkSubjectHierarchyItem::UIDIndex;
+vtkSubjectHierarchyItem::NameValueIndex vtkSubjectHierarchyItem::AttributeIndex;
+vtkSubjectHierarchyItem::NameValueIndex vtkSubjectHierarchyItem::UIDListIndex;
+vtkSubjectHierarchyItem::NameValueIndex vtkSubjectHierarchyItem::AttributeListIndex;
+
+namespace
+{
+//---------------------------------------------------------------------------
+/// Get elements of a space-separated list. Returns empty list if the value contains only one element.
+std::vector<std::string> GetListElements(const std::string& value)
+{
+  std::vector<std::string> elements;
+  if (value.find(' ') == std::string::npos)
+  {
+    return elements;
+  }
+  size_t start = 0;
+  while (start < value.size())
+  {
+    size_t end = value.find(' ', start);
+    if (end == std::string::npos)
+    {
+      end = value.size();
+    }
+    if (end > start)
+    {
+      elements.push_back(value.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return elements;
+}
+} // namespace
 
 //---------------------------------------------------------------------------
 // vtkSubjectHierarchyItem methods
@@ -282,6 +356,7 @@ vtkSubjectHierarchyItem::~vtkSubjectHierarchyItem()
 {
   this->RemoveAllChildren();
 
+  this->RemoveAllFromIndex();
   this->Attributes.clear();
   this->UIDs.clear();
 }
@@ -341,7 +416,14 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
   // Set basic properties
   this->DataNode = nullptr;
   this->Name = name;
-  this->Attributes[vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName()] = level;
+  const std::string levelAttributeName = vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName();
+  auto levelIt = this->Attributes.find(levelAttributeName);
+  if (levelIt != this->Attributes.end())
+  {
+    this->RemoveFromIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, levelAttributeName, levelIt->second);
+  }
+  this->Attributes[levelAttributeName] = level;
+  this->AddToIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, levelAttributeName, level);
 
   this->Parent = parent;
   if (parent)
@@ -477,6 +559,10 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
       ss << attValue;
       std::string valueStr = ss.str();
 
+      for (const auto& uid : this->UIDs)
+      {
+        this->RemoveFromIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uid.first, uid.second);
+      }
       this->UIDs.clear();
       size_t itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
       while (itemSeparatorPosition != std::string::npos)
@@ -500,6 +586,10 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
         this->UIDs[name] = value;
       }
+      for (const auto& uid : this->UIDs)
+      {
+        this->AddToIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uid.first, uid.second);
+      }
     }
     else if (!strcmp(attName, "attributes"))
     {
@@ -507,6 +597,10 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
       ss << attValue;
       std::string valueStr = ss.str();
 
+      for (const auto& attribute : this->Attributes)
+      {
+        this->RemoveFromIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attribute.first, attribute.second);
+      }
       this->Attributes.clear();
       size_t itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
       while (itemSeparatorPosition != std::string::npos)
@@ -530,6 +624,10 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
         this->Attributes[name] = value;
       }
+      for (const auto& attribute : this->Attributes)
+      {
+        this->AddToIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attribute.first, attribute.second);
+      }
     }
   }
 }
@@ -642,8 +740,10 @@ void vtkSubjectHierarchyItem::DeepCopy(vtkSubjectHierarchyItem* item, bool copyC
   this->Name = item->Name;
   this->OwnerPluginName = item->OwnerPluginName;
   this->Expanded = item->Expanded;
+  this->RemoveAllFromIndex();
   this->UIDs = item->UIDs;
   this->Attributes = item->Attributes;
+  this->AddAllToIndex();
 
   // Copy temporary members if they are valid, otherwise save from live members
   if (item->TemporaryID)
@@ -688,6 +788,171 @@ void vtkSubjectHierarchyItem::DeepCopy(vtkSubjectHierarchyItem* item, bool copyC
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddToIndex(NameValueIndex& index, NameValueIndex& listIndex, const std::string& name, const std::string& value)
+{
+  index[name].emplace(value, this);
+  for (const std::string& element : GetListElements(value))
+  {
+    listIndex[name].emplace(element, this);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveFromIndex(NameValueIndex& index, NameValueIndex& listIndex, const std::string& name, const std::string& value)
+{
+  auto removeItem = [this](NameValueIndex& nameValueIndex, const std::string& indexName, const std::string& indexValue)
+  {
+    auto valueIndexIt = nameValueIndex.find(indexName);
+    if (valueIndexIt == nameValueIndex.end())
+    {
+      return;
+    }
+    ValueIndex& valueIndex = valueIndexIt->second;
+    auto range = valueIndex.equal_range(indexValue);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second == this)
+      {
+        valueIndex.erase(it);
+        break;
+      }
+    }
+    if (valueIndex.empty())
+    {
+      nameValueIndex.erase(valueIndexIt);
+    }
+  };
+  removeItem(index, name, value);
+  for (const std::string& element : GetListElements(value))
+  {
+    removeItem(listIndex, name, element);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddAllToIndex()
+{
+  for (const auto& uid : this->UIDs)
+  {
+    this->AddToIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uid.first, uid.second);
+  }
+  for (const auto& attribute : this->Attributes)
+  {
+    this->AddToIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attribute.first, attribute.second);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveAllFromIndex()
+{
+  for (const auto& uid : this->UIDs)
+  {
+    this->RemoveFromIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uid.first, uid.second);
+  }
+  for (const auto& attribute : this->Attributes)
+  {
+    this->RemoveFromIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attribute.first, attribute.second);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::GetIndexedChildren(NameValueIndex& index,
+                                                 const std::string& name,
+                                                 const std::string& value,
+                                                 std::vector<vtkSubjectHierarchyItem*>& foundItems,
+                                                 bool recursive)
+{
+  auto valueIndexIt = index.find(name);
+  if (valueIndexIt == index.end())
+  {
+    return;
+  }
+  size_t numberOfPreviouslyFoundItems = foundItems.size();
+  auto range = valueIndexIt->second.equal_range(value);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (this->IsInBranch(it->second, recursive))
+    {
+      foundItems.push_back(it->second);
+    }
+  }
+  if (foundItems.size() - numberOfPreviouslyFoundItems > 1)
+  {
+    // Return items in the same order as they would be found by traversing the tree
+    vtkSubjectHierarchyItem::SortInTreeOrder(foundItems);
+  }
+}
+
+//---------------------------------------------------------------------------
+bool vtkSubjectHierarchyItem::IsInBranch(vtkSubjectHierarchyItem* item, bool recursive)
+{
+  if (!item || item == this)
+  {
+    return false;
+  }
+  // Items that are removed from the tree (but not deleted yet) or not added yet are not in the item cache
+  auto itemIt = vtkSubjectHierarchyItem::ItemCache.find(item->ID);
+  if (itemIt == vtkSubjectHierarchyItem::ItemCache.end() || itemIt->second.GetPointer() != item)
+  {
+    return false;
+  }
+  if (!recursive)
+  {
+    return (item->Parent == this);
+  }
+  for (vtkSubjectHierarchyItem* ancestor = item->Parent; ancestor; ancestor = ancestor->Parent)
+  {
+    if (ancestor == this)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::SortInTreeOrder(std::vector<vtkSubjectHierarchyItem*>& items)
+{
+  if (items.size() < 2)
+  {
+    return;
+  }
+  // Compute path of each item from the root as a list of positions under parent.
+  // Lexicographic order of the paths is the depth-first traversal order.
+  // Positions of all children of a parent are cached when first needed, so that the cost
+  // does not become quadratic when many items under the same parent are sorted.
+  std::unordered_map<vtkSubjectHierarchyItem*, int> positionCache;
+  std::vector<std::pair<std::vector<int>, vtkSubjectHierarchyItem*>> itemPaths;
+  for (vtkSubjectHierarchyItem* item : items)
+  {
+    std::vector<int> path;
+    for (vtkSubjectHierarchyItem* currentItem = item; currentItem->Parent; currentItem = currentItem->Parent)
+    {
+      auto positionIt = positionCache.find(currentItem);
+      if (positionIt == positionCache.end())
+      {
+        int position = 0;
+        for (const auto& sibling : currentItem->Parent->Children)
+        {
+          positionCache[sibling.GetPointer()] = position++;
+        }
+        positionIt = positionCache.find(currentItem);
+      }
+      path.push_back(positionIt != positionCache.end() ? positionIt->second : -1);
+    }
+    std::reverse(path.begin(), path.end());
+    itemPaths.emplace_back(path, item);
+  }
+  std::sort(itemPaths.begin(), itemPaths.end());
+  itemPaths.erase(std::unique(itemPaths.begin(), itemPaths.end()), itemPaths.end());
+  items.clear();
+  for (const auto& itemPath : itemPaths)
+  {
+    items.push_back(itemPath.second);
+  }
+}
+
 //---------------------------------------------------------------------------
 std::string vtkSubjectHierarchyItem::GetName()
 {
@@ -720,7 +985,7 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
   }
 
   // Try to find item in cache
-  std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem>>::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
+  auto itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
   if (itemIt != vtkSubjectHierarchyItem::ItemCache.end())
   {
     if (itemIt->second != nullptr)
@@ -754,7 +1019,7 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
   }
   if (foundItem)
   {
-    vtkSubjectHierarchyItem::ItemCache[itemID] = this;
+    vtkSubjectHierarchyItem::ItemCache[itemID] = foundItem;
   }
 
   return foundItem;
@@ -795,24 +1060,9 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
   {
     return nullptr;
   }
-  ChildVector::iterator childIt;
-  for (childIt = this->Children.begin(); childIt != this->Children.end(); ++childIt)
-  {
-    vtkSubjectHierarchyItem* currentItem = childIt->GetPointer();
-    if (!currentItem->GetUID(uidName).compare(uidValue))
-    {
-      return currentItem;
-    }
-    if (recursive)
-    {
-      vtkSubjectHierarchyItem* foundItemInBranch = currentItem->FindChildByUID(uidName, uidValue);
-      if (foundItemInBranch)
-      {
-        return foundItemInBranch;
-      }
-    }
-  }
-  return nullptr;
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->GetIndexedChildren(vtkSubjectHierarchyItem::UIDIndex, uidName, uidValue, foundItems, recursive);
+  return (foundItems.empty() ? nullptr : foundItems[0]);
 }
 
 //---------------------------------------------------------------------------
@@ -822,6 +1072,21 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUIDList(std::string
   {
     return nullptr;
   }
+
+  if (uidValue.find(' ') == std::string::npos)
+  {
+    // Single UID: look up items where the UID is the whole value or an element of the UID list
+    std::vector<vtkSubjectHierarchyItem*> foundItems;
+    this->GetIndexedChildren(vtkSubjectHierarchyItem::UIDIndex, uidName, uidValue, foundItems, recursive);
+    this->GetIndexedChildren(vtkSubjectHierarchyItem::UIDListIndex, uidName, uidValue, foundItems, recursive);
+    if (foundItems.size() > 1)
+    {
+      vtkSubjectHierarchyItem::SortInTreeOrder(foundItems);
+    }
+    return (foundItems.empty() ? nullptr : foundItems[0]);
+  }
+
+  // Part of a UID list is searched, which is not indexed, therefore traverse the tree
   ChildVector::iterator childIt;
   for (childIt = this->Children.begin(); childIt != this->Children.end(); ++childIt)
   {
@@ -842,6 +1107,36 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUIDList(std::string
   return nullptr;
 }
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::FindChildrenByAttribute(std::string attributeName,
+                                                      std::string attributeValue,
+                                                      std::vector<vtkSubjectHierarchyItem*>& foundItems,
+                                                      bool recursive /*=true*/)
+{
+  foundItems.clear();
+  if (attributeName.empty())
+  {
+    return;
+  }
+  this->GetIndexedChildren(vtkSubjectHierarchyItem::AttributeIndex, attributeName, attributeValue, foundItems, recursive);
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::FindChildrenByAttributeList(std::string attributeName,
+                                                          std::string attributeValue,
+                                                          std::vector<vtkSubjectHierarchyItem*>& foundItems,
+                                                          bool recursive /*=true*/)
+{
+  foundItems.clear();
+  if (attributeName.empty() || attributeValue.empty())
+  {
+    return;
+  }
+  this->GetIndexedChildren(vtkSubjectHierarchyItem::AttributeIndex, attributeName, attributeValue, foundItems, recursive);
+  this->GetIndexedChildren(vtkSubjectHierarchyItem::AttributeListIndex, attributeName, attributeValue, foundItems, recursive);
+  vtkSubjectHierarchyItem::SortInTreeOrder(foundItems);
+}
+
 //---------------------------------------------------------------------------
 void vtkSubjectHierarchyItem::FindChildrenByName(std::string name, std::vector<vtkIdType>& foundItemIDs, bool contains /*=false*/, bool recursive /*=true*/)
 {
@@ -1295,7 +1590,12 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
                                                 << "'. Replacing it with value '" << uidValue << "'");
     }
   }
+  if (it != this->UIDs.end())
+  {
+    this->RemoveFromIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uidName, it->second);
+  }
   this->UIDs[uidName] = uidValue;
+  this->AddToIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uidName, uidValue);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, this);
   this->Modified();
 }
@@ -1311,6 +1611,7 @@ bool vtkSubjectHierarchyItem::RemoveUID(std::string uidName)
   }
 
   // Use the find function to prevent adding an empty UID to the map
+  this->RemoveFromIndex(vtkSubjectHierarchyItem::UIDIndex, vtkSubjectHierarchyItem::UIDListIndex, uidName, it->second);
   this->UIDs.erase(it);
   this->Modified();
   return true;
@@ -1362,7 +1663,12 @@ void vtkSubjectHierarchyItem::SetAttribute(std::string attributeName, std::strin
     // Attribute to set is same as original value, nothing to do
     return;
   }
+  if (it != this->Attributes.end())
+  {
+    this->RemoveFromIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attributeName, it->second);
+  }
   this->Attributes[attributeName] = attributeValue;
+  this->AddToIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attributeName, attributeValue);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
 }
@@ -1378,6 +1684,7 @@ bool vtkSubjectHierarchyItem::RemoveAttribute(std::string attributeName)
   }
 
   // Use the find function to prevent adding an empty attribute to the map
+  this->RemoveFromIndex(vtkSubjectHierarchyItem::AttributeIndex, vtkSubjectHierarchyItem::AttributeListIndex, attributeName, it->second);
   this->Attributes.erase(it);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
@@ -3128,6 +3435,29 @@ void vtkMRMLSubjectHierarchyNode::GetItemsByName(std::string name, vtkIdList* fo
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::GetItemsByAttribute(std::string attributeName, std::string attributeValue, vtkIdList* foundItemIds)
+{
+  if (!foundItemIds)
+  {
+    vtkErrorMacro("GetItemsByAttribute: Invalid output ID list");
+    return;
+  }
+  foundItemIds->Reset();
+  if (attributeName.empty())
+  {
+    vtkErrorMacro("GetItemsByAttribute: Empty attribute name given, returning empty list");
+    return;
+  }
+
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->SceneItem->FindChildrenByAttribute(attributeName, attributeValue, foundItems);
+  for (vtkSubjectHierarchyItem* item : foundItems)
+  {
+    foundItemIds->InsertNextId(item->ID);
+  }
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::GetItemChildWithName(vtkIdType parentItemID, std::string name, bool recursive /*=false*/)
 {
@@ -3522,27 +3852,19 @@ std::vector<vtkIdType> vtkMRMLSubjectHierarchyNode::GetItemsReferencingItemByDIC
   std::vector<std::string> uidVector;
   this->DeserializeUIDList(uidsString, uidVector);
 
-  // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute
-  std::vector<vtkIdType> allItemIDs;
-  this->Internal->SceneItem->GetAllChildren(allItemIDs);
-  for (std::vector<vtkIdType>::iterator itemIt = allItemIDs.begin(); itemIt != allItemIDs.end(); ++itemIt)
+  // Find subject hierarchy items containing any of the SOP instance UIDs in referenced UIDs attribute
+  std::vector<vtkSubjectHierarchyItem*> referencingItems;
+  for (std::vector<std::string>::iterator uidIt = uidVector.begin(); uidIt != uidVector.end(); ++uidIt)
   {
-    vtkSubjectHierarchyItem* currentItem = this->Internal->SceneItem->FindChildByID(*itemIt);
-    std::string referencedUids = currentItem->GetAttribute(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName());
-    bool referencesUid = false;
-    for (std::vector<std::string>::iterator uidIt = uidVector.begin(); uidIt != uidVector.end(); ++uidIt)
-    {
-      if (referencedUids.find(*uidIt) != std::string::npos)
-      {
-        referencesUid = true;
-        break;
-      }
-    }
-    if (referencesUid)
-    {
-      // UID is referenced, add referencing item to the list
-      referencingItemIDs.push_back(*itemIt);
-    }
+    std::vector<vtkSubjectHierarchyItem*> foundItems;
+    this->Internal->SceneItem->FindChildrenByAttributeList(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName(), (*uidIt), foundItems);
+    referencingItems.insert(referencingItems.end(), foundItems.begin(), foundItems.end());
+  }
+  // Return each referencing item once, in the order of the items in the hierarchy
+  vtkSubjectHierarchyItem::SortInTreeOrder(referencingItems);
+  for (vtkSubjectHierarchyItem* referencingItem : referencingItems)
+  {
+    referencingItemIDs.push_back(referencingItem->ID);
   }
 
   return referencingItemIDs;
@@ -300,7 +300,9 @@ public:
 
   /// Find subject hierarchy item according to a UID (by containing). For example find UID in instance UID list
   /// \param uidName UID string to lookup
-  /// \param uidValue UID string that needs to be _contained_ in the UID string of the subject hierarchy item
+  /// \param uidValue UID string that needs to be _contained_ in the UID string of the subject hierarchy item.
+  ///   If it is a single UID (does not contain space) then it needs to match one of the space-separated UIDs
+  ///   in the UID list, which is looked up using an index. Otherwise the hierarchy is searched for the substring.
   /// \return First match
   /// \sa GetUID()
   vtkIdType GetItemByUIDList(const char* uidName, const char* uidValue);
@@ -323,6 +325,13 @@ public:
   /// \return Item ID of the first item found by name using exact match. Warning is logged if more than one found
   void GetItemsByName(std::string name, vtkIdList* foundItemIds, bool contains = false);
 
+  /// Get items in whole subject hierarchy that have an attribute with the given value (exact match).
+  /// Attribute values are indexed, therefore the lookup time does not depend on the number of items in the hierarchy.
+  /// \param attributeName Name of the attribute
+  /// \param attributeValue Value of the attribute
+  /// \param foundItemIds List of found items, in the order they appear in the hierarchy
+  void GetItemsByAttribute(std::string attributeName, std::string attributeValue, vtkIdList* foundItemIds);
+
   /// Get child subject hierarchy item with specific name
   /// \param parent Parent subject hierarchy item to start from
   /// \param name Name to find
@@ -31,9 +31,12 @@
 #include <vtkTable.h>
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkVariant.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkSQLQuery.h>
-#include <vtkRowQueryToTable.h>
 #include <vtkSQLDatabase.h>
 #include <vtkSQLiteDatabase.h>
 #include <vtkSQLiteQuery.h>
@@ -42,7 +45,102 @@
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <iostream>
+#include <vector>
+
+namespace
+{
+enum ColumnStorageType
+{
+  IntegerColumn,
+  RealColumn,
+  TextColumn
+};
+
+//----------------------------------------------------------------------------
+/// Quote a table or column name so that it can contain any characters (spaces, quotes, keywords).
+std::string QuoteIdentifier(const std::string& identifier)
+{
+  std::string quoted = "\"";
+  for (char c : identifier)
+  {
+    quoted += c;
+    if (c == '"')
+    {
+      quoted += '"';
+    }
+  }
+  quoted += "\"";
+  return quoted;
+}
+
+//----------------------------------------------------------------------------
+ColumnStorageType GetColumnStorageType(vtkAbstractArray* column)
+{
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(column);
+  if (!dataArray || dataArray->GetNumberOfComponents() != 1)
+  {
+    // strings, variants, and multi-component arrays are stored as text
+    return TextColumn;
+  }
+  int dataType = dataArray->GetDataType();
+  if (dataType == VTK_FLOAT || dataType == VTK_DOUBLE)
+  {
+    return RealColumn;
+  }
+  return IntegerColumn;
+}
+
+//----------------------------------------------------------------------------
+/// Get storage type from declared column type, following SQLite type affinity rules.
+/// Returns false if the type cannot be determined from the declaration (e.g., no declared type).
+bool GetColumnStorageTypeFromDeclaration(std::string declaredType, ColumnStorageType& storageType)
+{
+  std::transform(declaredType.begin(), declaredType.end(), declaredType.begin(), [](unsigned char c) { return std::toupper(c); });
+  if (declaredType.find("INT") != std::string::npos)
+  {
+    storageType = IntegerColumn;
+    return true;
+  }
+  if (declaredType.find("CHAR") != std::string::npos || declaredType.find("CLOB") != std::string::npos || declaredType.find("TEXT") != std::string::npos)
+  {
+    storageType = TextColumn;
+    return true;
+  }
+  if (declaredType.find("REAL") != std::string::npos || declaredType.find("FLOA") != std::string::npos || declaredType.find("DOUB") != std::string::npos)
+  {
+    storageType = RealColumn;
+    return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+/// Get 64-bit integer from a value that is read from the database as text.
+/// Non-integer values stored in an integer column are truncated, missing values are set to 0.
+vtkTypeInt64 GetInt64FromText(const vtkVariant& value)
+{
+  if (!value.IsValid())
+  {
+    return 0;
+  }
+  bool valid = false;
+  vtkTypeInt64 intValue = value.ToTypeInt64(&valid);
+  if (valid)
+  {
+    return intValue;
+  }
+  double doubleValue = value.ToDouble(&valid);
+  if (!valid || !(std::abs(doubleValue) < static_cast<double>(VTK_TYPE_INT64_MAX)))
+  {
+    return 0;
+  }
+  return static_cast<vtkTypeInt64>(doubleValue);
+}
+} // namespace
 
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableSQLiteStorageNode);
@@ -64,6 +162,7 @@ vtkMRMLTableSQLiteStorageNode::~vtkMRMLTableSQLiteStorageNode() = default;
 void vtkMRMLTableSQLiteStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os, indent);
+  os << indent << "NumberOfRowsPerTransaction: " << this->NumberOfRowsPerTransaction << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -105,17 +204,12 @@ int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
-  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
-  std::string queryString("select * from ");
-  queryString += std::string(this->TableName);
-  query->SetQuery(queryString.c_str());
-  query->Execute();
-
-  vtkSmartPointer<vtkRowQueryToTable> queryToTable = vtkSmartPointer<vtkRowQueryToTable>::New();
-  queryToTable->SetQuery(query);
-  queryToTable->Update();
-
-  vtkSmartPointer<vtkTable> table = queryToTable->GetOutput();
+  vtkNew<vtkTable> table;
+  if (!vtkMRMLTableSQLiteStorageNode::ReadTable(database, this->TableName, table))
+  {
+    vtkErrorMacro("ReadData: failed to read table '" << (this->TableName ? this->TableName : "") << "' from database file '" << fullName << "'");
+    return 0;
+  }
 
   tableNode->SetAndObserveTable(table);
 
@@ -153,152 +247,354 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
 
   std::string dbname = std::string("sqlite://") + fullName;
 
-  // vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
-  vtkSQLiteDatabase* database = vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str()));
-
-  if (!database || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
+  vtkTable* table = tableNode->GetTable();
+  if (!table)
   {
-    vtkErrorMacro("ReadData: database file '" << fullName << "cannot be opened");
+    vtkErrorMacro("WriteData: no table to write for the node '" << std::string(tableNode->GetName()));
     return 0;
   }
 
-  vtkTable* table = tableNode->GetTable();
-  if (!table)
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast(vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
+  if (!database.GetPointer() || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
   {
-    vtkErrorMacro("ReadData: no table to write for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: database file '" << fullName << "cannot be opened");
     return 0;
   }
 
-  if (!this->TableName || std::string(this->TableName).empty())
+  bool success = vtkMRMLTableSQLiteStorageNode::WriteTable(table, this->TableName, database, this->NumberOfRowsPerTransaction);
+  database->Close();
+  if (!success)
   {
-    vtkErrorMacro("ReadData: no table name for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: failed to write table '" << this->TableName << "' to database file '" << fullName << "'");
     return 0;
   }
 
-  // first try to drop the table
-  this->DropTable(this->TableName, database);
-
-  // converting this table to SQLite will require two queries: one to create
-  // the table, and another to populate its rows with data.
-  std::string createTableQuery = "CREATE TABLE IF NOT EXISTS ";
-  createTableQuery += this->TableName;
-  createTableQuery += "(";
+  vtkDebugMacro("WriteData: successfully wrote table to database: " << fullName);
+  return 1;
+}
 
-  std::string insertPreamble = "INSERT into ";
-  insertPreamble += this->TableName;
-  insertPreamble += "(";
+//----------------------------------------------------------------------------
+int vtkMRMLTableSQLiteStorageNode::DropTable(char* tableName, vtkSQLiteDatabase* database)
+{
+  if (!tableName || std::string(tableName).empty())
+  {
+    std::cerr << "No table name specified!";
+    return 0;
+  }
 
-  // get the columns from the vtkTable to finish the query
-  vtkIdType numColumns = table->GetNumberOfColumns();
-  for (vtkIdType i = 0; i < numColumns; i++)
+  if (!database)
   {
-    // get this column's name
-    std::string columnName = table->GetColumn(i)->GetName();
-    createTableQuery += columnName;
-    insertPreamble += "'" + columnName + "'";
+    std::cerr << "No database specified!";
+    return 0;
+  }
 
-    // figure out what type of data is stored in this column
-    std::string columnType = table->GetColumn(i)->GetClassName();
+  vtkStringArray* tables = database->GetTables();
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
 
-    if ((columnType.find("String") != std::string::npos) || //
-        (columnType.find("Data") != std::string::npos) ||   //
-        (columnType.find("Variant") != std::string::npos))
-    {
-      createTableQuery += " TEXT";
-    }
-    else if ((columnType.find("Double") != std::string::npos) || //
-             (columnType.find("Float") != std::string::npos))
-    {
-      createTableQuery += " REAL";
-    }
-    else
+  for (int i = 0; i < tables->GetNumberOfValues(); i++)
+  {
+    if (!tables->GetValue(i).compare(tableName))
     {
-      createTableQuery += " INTEGER";
+      std::string dropTableQuery = "DROP TABLE " + QuoteIdentifier(tableName);
+      query->SetQuery(dropTableQuery.c_str());
+      query->Execute();
+      break;
     }
-    if (i == numColumns - 1)
+  }
+
+  // database->Close();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableSQLiteStorageNode::WriteTable(vtkTable* table, const char* tableName, vtkSQLiteDatabase* database, int numberOfRowsPerTransaction)
+{
+  if (!table || !database || !tableName || std::string(tableName).empty())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: invalid inputs");
+    return false;
+  }
+  vtkIdType numberOfColumns = table->GetNumberOfColumns();
+  if (numberOfColumns == 0)
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: table has no columns");
+    return false;
+  }
+  numberOfRowsPerTransaction = std::max(1, numberOfRowsPerTransaction);
+  const std::string quotedTableName = QuoteIdentifier(tableName);
+
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
+
+  query->SetQuery(("DROP TABLE IF EXISTS " + quotedTableName + ";").c_str());
+  if (!query->Execute())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot drop existing table: " << query->GetLastErrorText());
+    return false;
+  }
+
+  std::vector<ColumnStorageType> columnStorageTypes(numberOfColumns);
+  std::vector<vtkDataArray*> dataColumns(numberOfColumns, nullptr);
+  std::vector<vtkStringArray*> stringColumns(numberOfColumns, nullptr);
+  std::string createTableQuery = "CREATE TABLE " + quotedTableName + " (";
+  std::string insertQuery = "INSERT INTO " + quotedTableName + " VALUES (";
+  for (vtkIdType columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+  {
+    vtkAbstractArray* column = table->GetColumn(columnIndex);
+    const char* columnName = column->GetName();
+    columnStorageTypes[columnIndex] = GetColumnStorageType(column);
+    dataColumns[columnIndex] = vtkDataArray::SafeDownCast(column);
+    stringColumns[columnIndex] = vtkStringArray::SafeDownCast(column);
+    if (columnIndex > 0)
     {
-      createTableQuery += ");";
-      insertPreamble += ") VALUES (";
+      createTableQuery += ", ";
+      insertQuery += ", ";
     }
-    else
+    createTableQuery += QuoteIdentifier(columnName ? columnName : "");
+    switch (columnStorageTypes[columnIndex])
     {
-      createTableQuery += ", ";
-      insertPreamble += ", ";
+      case IntegerColumn: createTableQuery += " INTEGER"; break;
+      case RealColumn: createTableQuery += " REAL"; break;
+      default: createTableQuery += " TEXT"; break;
     }
+    insertQuery += "?";
   }
-
-  // perform the create table query
-  vtkSQLiteQuery* query = static_cast<vtkSQLiteQuery*>(database->GetQueryInstance());
+  createTableQuery += ");";
+  insertQuery += ");";
 
   query->SetQuery(createTableQuery.c_str());
-  std::cout << "creating the table" << std::endl;
   if (!query->Execute())
   {
-    vtkErrorMacro(<< "Error performing 'create table' query");
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: error performing 'create table' query: " << query->GetLastErrorText());
+    return false;
   }
 
-  // iterate over the rows of the vtkTable to complete the insert query
-  vtkIdType numRows = table->GetNumberOfRows();
-  for (vtkIdType i = 0; i < numRows; i++)
+  // Transactions are controlled by a separate query object, because committing a transaction
+  // finalizes the statement of the query, while the insert statement must be prepared only once.
+  vtkSmartPointer<vtkSQLiteQuery> transactionQuery = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
+  // Rows committed in previous batches cannot be rolled back, therefore the incomplete table is dropped on failure
+  auto removeIncompleteTable = [&](bool transactionInProgress)
   {
-    std::string insertQuery = insertPreamble;
-    for (vtkIdType j = 0; j < numColumns; j++)
+    if (transactionInProgress)
     {
-      insertQuery += "'" + table->GetValue(i, j).ToString() + "'";
-      if (j < numColumns - 1)
+      transactionQuery->RollbackTransaction();
+    }
+    query->SetQuery(("DROP TABLE IF EXISTS " + quotedTableName + ";").c_str());
+    query->Execute();
+  };
+  if (!transactionQuery->BeginTransaction())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot begin transaction: " << transactionQuery->GetLastErrorText());
+    removeIncompleteTable(false);
+    return false;
+  }
+  // The statement is prepared once, only the bound values change from row to row
+  if (!query->SetQuery(insertQuery.c_str()))
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot prepare 'insert' query: " << query->GetLastErrorText());
+    removeIncompleteTable(true);
+    return false;
+  }
+
+  vtkIdType numberOfRows = table->GetNumberOfRows();
+  for (vtkIdType rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+  {
+    for (vtkIdType columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+    {
+      int parameterIndex = static_cast<int>(columnIndex);
+      switch (columnStorageTypes[columnIndex])
       {
-        insertQuery += ", ";
+        case IntegerColumn:
+          // Variant keeps the original value type, so 64-bit integers are not rounded by converting to double
+          query->BindParameter(parameterIndex, dataColumns[columnIndex]->GetVariantValue(rowIndex).ToTypeInt64());
+          break;
+        case RealColumn:
+          // NaN is stored as NULL by SQLite
+          query->BindParameter(parameterIndex, dataColumns[columnIndex]->GetComponent(rowIndex, 0));
+          break;
+        default:
+          if (stringColumns[columnIndex])
+          {
+            query->BindParameter(parameterIndex, stringColumns[columnIndex]->GetValue(rowIndex));
+          }
+          else
+          {
+            query->BindParameter(parameterIndex, table->GetValue(rowIndex, columnIndex).ToString());
+          }
+          break;
       }
     }
-    insertQuery += ");";
-    // perform the insert query for this row
-    query->SetQuery(insertQuery.c_str());
     if (!query->Execute())
     {
-      vtkErrorMacro(<< "Error performing 'insert' query");
+      vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: error performing 'insert' query at row " << rowIndex << ": " << query->GetLastErrorText());
+      removeIncompleteTable(true);
+      return false;
+    }
+    if ((rowIndex + 1) % numberOfRowsPerTransaction == 0 && rowIndex + 1 < numberOfRows)
+    {
+      // Commit in batches to limit the size of the journal
+      if (!transactionQuery->CommitTransaction())
+      {
+        vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot commit transaction: " << transactionQuery->GetLastErrorText());
+        removeIncompleteTable(true);
+        return false;
+      }
+      if (!transactionQuery->BeginTransaction())
+      {
+        vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot begin transaction: " << transactionQuery->GetLastErrorText());
+        removeIncompleteTable(false);
+        return false;
+      }
     }
   }
 
-  // cleanup and return
-  query->Delete();
-  database->Close();
-  database->Delete();
-
-  vtkDebugMacro("WriteData: successfully wrote table to database: " << fullName);
-  return 1;
+  if (!transactionQuery->CommitTransaction())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::WriteTable failed: cannot commit transaction: " << transactionQuery->GetLastErrorText());
+    removeIncompleteTable(true);
+    return false;
+  }
+  return true;
 }
 
-int vtkMRMLTableSQLiteStorageNode::DropTable(char* tableName, vtkSQLiteDatabase* database)
+//----------------------------------------------------------------------------
+bool vtkMRMLTableSQLiteStorageNode::ReadTable(vtkSQLiteDatabase* database, const char* tableName, vtkTable* table)
 {
-  if (!tableName || std::string(tableName).empty())
+  if (!table || !database || !tableName || std::string(tableName).empty())
   {
-    std::cerr << "No table name specified!";
-    return 0;
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: invalid inputs");
+    return false;
   }
+  const std::string quotedTableName = QuoteIdentifier(tableName);
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
 
-  if (!database)
+  // Get column names and declared types
+  std::vector<std::string> columnNames;
+  std::vector<std::string> declaredTypes;
+  query->SetQuery(("PRAGMA table_info(" + quotedTableName + ");").c_str());
+  if (!query->Execute())
   {
-    std::cerr << "No database specified!";
-    return 0;
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: cannot get columns of table " << tableName << ": " << query->GetLastErrorText());
+    return false;
+  }
+  while (query->NextRow())
+  {
+    // columns of the result: cid, name, type, notnull, dflt_value, pk
+    columnNames.push_back(query->DataValue(1).ToString());
+    declaredTypes.push_back(query->DataValue(2).ToString());
   }
+  if (columnNames.empty())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: table " << tableName << " not found");
+    return false;
+  }
+  int numberOfColumns = static_cast<int>(columnNames.size());
 
-  vtkStringArray* tables = database->GetTables();
-  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(vtkSQLiteQuery::SafeDownCast(database->GetQueryInstance()));
+  // Get number of rows to allocate arrays only once
+  vtkIdType numberOfRows = 0;
+  query->SetQuery(("SELECT COUNT(*) FROM " + quotedTableName + ";").c_str());
+  if (query->Execute() && query->NextRow())
+  {
+    numberOfRows = query->DataValue(0).ToTypeInt64();
+  }
 
-  for (int i = 0; i < tables->GetNumberOfValues(); i++)
+  // Get column storage types. If there is no declared type then the type of the value in the first row is used.
+  std::vector<ColumnStorageType> columnStorageTypes(numberOfColumns, TextColumn);
+  bool firstRowRead = false;
+  for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
   {
-    if (!tables->GetValue(i).compare(tableName))
+    if (GetColumnStorageTypeFromDeclaration(declaredTypes[columnIndex], columnStorageTypes[columnIndex]) || numberOfRows == 0)
     {
-      std::string dropTableQuery = "DROP TABLE ";
-      dropTableQuery += tableName;
-      query->SetQuery(dropTableQuery.c_str());
-      query->Execute();
-      break;
+      continue;
+    }
+    if (!firstRowRead)
+    {
+      query->SetQuery(("SELECT * FROM " + quotedTableName + " LIMIT 1;").c_str());
+      if (!query->Execute() || !query->NextRow())
+      {
+        vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: cannot read table " << tableName << ": " << query->GetLastErrorText());
+        return false;
+      }
+      firstRowRead = true;
+    }
+    int fieldType = query->GetFieldType(columnIndex);
+    if (fieldType == VTK_INT)
+    {
+      columnStorageTypes[columnIndex] = IntegerColumn;
+    }
+    else if (fieldType == VTK_FLOAT || fieldType == VTK_DOUBLE)
+    {
+      columnStorageTypes[columnIndex] = RealColumn;
     }
   }
 
-  // database->Close();
-  return 1;
+  // vtkSQLiteQuery reads integer values as 32-bit int, therefore integer columns are read as text
+  // and converted to 64-bit integer to keep all values exact.
+  std::string selectQuery = "SELECT ";
+  for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+  {
+    if (columnIndex > 0)
+    {
+      selectQuery += ", ";
+    }
+    const std::string quotedColumnName = QuoteIdentifier(columnNames[columnIndex]);
+    selectQuery += (columnStorageTypes[columnIndex] == IntegerColumn ? "CAST(" + quotedColumnName + " AS TEXT)" : quotedColumnName);
+  }
+  selectQuery += " FROM " + quotedTableName + ";";
+  query->SetQuery(selectQuery.c_str());
+  if (!query->Execute())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: cannot read table " << tableName << ": " << query->GetLastErrorText());
+    return false;
+  }
+
+  // Create typed column arrays
+  std::vector<vtkTypeInt64Array*> intColumns(numberOfColumns, nullptr);
+  std::vector<vtkDoubleArray*> doubleColumns(numberOfColumns, nullptr);
+  std::vector<vtkStringArray*> stringColumns(numberOfColumns, nullptr);
+  table->Initialize();
+  for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+  {
+    vtkSmartPointer<vtkAbstractArray> column;
+    switch (columnStorageTypes[columnIndex])
+    {
+      case IntegerColumn:
+        intColumns[columnIndex] = vtkTypeInt64Array::New();
+        column.TakeReference(intColumns[columnIndex]);
+        break;
+      case RealColumn:
+        doubleColumns[columnIndex] = vtkDoubleArray::New();
+        column.TakeReference(doubleColumns[columnIndex]);
+        break;
+      default:
+        stringColumns[columnIndex] = vtkStringArray::New();
+        column.TakeReference(stringColumns[columnIndex]);
+        break;
+    }
+    column->SetName(columnNames[columnIndex].c_str());
+    column->Allocate(numberOfRows);
+    table->AddColumn(column);
+  }
+
+  // Append values row by row, directly into the typed arrays
+  while (query->NextRow())
+  {
+    for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+    {
+      vtkVariant value = query->DataValue(columnIndex);
+      switch (columnStorageTypes[columnIndex])
+      {
+        case IntegerColumn: intColumns[columnIndex]->InsertNextValue(GetInt64FromText(value)); break;
+        case RealColumn: doubleColumns[columnIndex]->InsertNextValue(value.IsValid() ? value.ToDouble() : vtkMath::Nan()); break;
+        default: stringColumns[columnIndex]->InsertNextValue(value.IsValid() ? value.ToString() : std::string()); break;
+      }
+    }
+  }
+  if (query->HasError())
+  {
+    vtkGenericWarningMacro("vtkMRMLTableSQLiteStorageNode::ReadTable failed: error while reading table " << tableName << ": " << query->GetLastErrorText());
+    return false;
+  }
+  return true;
 }
 
 //----------------------------------------------------------------------------
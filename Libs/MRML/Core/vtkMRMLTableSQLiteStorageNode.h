@@ -30,9 +30,15 @@
 /// vtkMRMLTableSQLiteStorageNode allows reading/writing of table node from
 /// SQLite database.
 ///
+/// Rows are written using a single prepared insert statement with typed parameter
+/// bindings (numeric values are stored at full precision), inside transactions
+/// that are committed after every NumberOfRowsPerTransaction rows.
+/// Rows are read by stepping through the query result and appending values
+/// directly to typed column arrays.
 ///
 
 class vtkSQLiteDatabase;
+class vtkTable;
 
 class VTK_MRML_EXPORT vtkMRMLTableSQLiteStorageNode : public vtkMRMLStorageNode
 {
@@ -57,9 +63,27 @@ public:
   vtkSetStringMacro(TableName);
   vtkGetStringMacro(TableName);
 
+  /// Number of rows inserted in a transaction before it is committed.
+  /// Larger values make writing faster. Default is 100000.
+  vtkSetClampMacro(NumberOfRowsPerTransaction, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfRowsPerTransaction, int);
+
   /// Drop a specified table from the database
   static int DropTable(char* tableName, vtkSQLiteDatabase* database);
 
+  /// Write all rows of the table into a newly created database table.
+  /// An existing table with the same name is replaced.
+  /// Rows are committed in batches of numberOfRowsPerTransaction rows. Committed batches cannot be rolled back,
+  /// therefore on failure the incomplete table is dropped from the database.
+  /// Returns false on failure.
+  static bool WriteTable(vtkTable* table, const char* tableName, vtkSQLiteDatabase* database, int numberOfRowsPerTransaction = 100000);
+
+  /// Read all rows of a database table into the table.
+  /// INTEGER columns are read into vtkTypeInt64Array, REAL columns into vtkDoubleArray,
+  /// all other columns into vtkStringArray. Missing (NULL) real values are read as NaN.
+  /// Returns false on failure.
+  static bool ReadTable(vtkSQLiteDatabase* database, const char* tableName, vtkTable* table);
+
 protected:
   vtkMRMLTableSQLiteStorageNode();
   ~vtkMRMLTableSQLiteStorageNode() override;
@@ -80,6 +104,7 @@ protected:
 
   char* TableName;
   char* Password;
+  int NumberOfRowsPerTransaction{ 100000 };
 };
 
 #endif
@@ -33,13 +33,23 @@
 #include <vtkDelimitedTextWriter.h>
 #include <vtkErrorSink.h>
 #include <vtkNew.h>
+#include <vtkNumberToString.h>
 #include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
 #include <vtkStringArray.h>
 #include <vtkTable.h>
+#include <vtkValueFromString.h>
 #include <vtksys/SystemTools.hxx>
 
 // STL includes
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
 #include <set>
+#include <type_traits>
 
 //------------------------------------------------------------------------------
 // Helper class to be able to read tables that have "\" characters in them.
@@ -69,6 +79,319 @@ protected:
 
 vtkStandardNewMacro(vtkNoEscapeDelimitedTextReader);
 
+//------------------------------------------------------------------------------
+// Helper functions for reading and writing delimited text files.
+//
+// Tables are read in two steps: first the record (line) boundaries are found,
+// then the records are parsed in parallel, each cell directly converted to the
+// value type of its column and stored in the output array. Writing is done
+// similarly, by formatting blocks of rows in parallel and writing them in order.
+//
+// Quoting follows RFC 4180: a field that starts with a quotation mark may contain
+// delimiters and line breaks, and quotation marks in it are escaped by doubling them.
+// Quotation marks that are not at the beginning of a field are kept as is.
+namespace
+{
+const char QUOTE_CHARACTER = '"';
+
+/// Number of rows that are parsed or formatted by a thread at once
+const vtkIdType ROWS_PER_BLOCK = 4096;
+
+using RecordRange = std::pair<const char*, const char*>;
+
+//------------------------------------------------------------------------------
+/// Find begin and end of each non-empty record. Line terminator ("\n" or "\r\n") is not included in the range.
+void FindRecords(const char* begin, const char* end, char delimiter, std::vector<RecordRange>& records)
+{
+  auto addRecord = [&records](const char* recordBegin, const char* recordEnd)
+  {
+    if (recordEnd > recordBegin && recordEnd[-1] == '\r')
+    {
+      --recordEnd;
+    }
+    if (recordEnd > recordBegin)
+    {
+      records.emplace_back(recordBegin, recordEnd);
+    }
+  };
+
+  if (memchr(begin, QUOTE_CHARACTER, end - begin) == nullptr)
+  {
+    // No quoted fields, each line is a record
+    const char* recordBegin = begin;
+    while (recordBegin < end)
+    {
+      const char* lineEnd = static_cast<const char*>(memchr(recordBegin, '\n', end - recordBegin));
+      if (!lineEnd)
+      {
+        lineEnd = end;
+      }
+      addRecord(recordBegin, lineEnd);
+      recordBegin = lineEnd + 1;
+    }
+    return;
+  }
+
+  // Line breaks within quoted fields do not terminate the record
+  const char* recordBegin = begin;
+  bool withinQuotes = false;
+  bool atFieldStart = true;
+  for (const char* p = begin; p < end; ++p)
+  {
+    const char c = *p;
+    if (withinQuotes)
+    {
+      if (c == QUOTE_CHARACTER)
+      {
+        if (p + 1 < end && p[1] == QUOTE_CHARACTER)
+        {
+          ++p; // escaped quote
+        }
+        else
+        {
+          withinQuotes = false;
+        }
+      }
+    }
+    else if (c == QUOTE_CHARACTER && atFieldStart)
+    {
+      withinQuotes = true;
+      atFieldStart = false;
+    }
+    else if (c == delimiter)
+    {
+      atFieldStart = true;
+    }
+    else if (c == '\n')
+    {
+      addRecord(recordBegin, p);
+      recordBegin = p + 1;
+      atFieldStart = true;
+    }
+    else
+    {
+      atFieldStart = false;
+    }
+  }
+  addRecord(recordBegin, end);
+}
+
+//------------------------------------------------------------------------------
+/// Split a record into fields and call fieldCallback(fieldIndex, fieldBegin, fieldEnd) for each.
+/// Quoted fields are unquoted into the provided buffer.
+template <typename FieldCallback>
+void ParseRecord(const char* p, const char* end, char delimiter, std::string& buffer, FieldCallback&& fieldCallback)
+{
+  int fieldIndex = 0;
+  while (true)
+  {
+    if (p < end && *p == QUOTE_CHARACTER)
+    {
+      buffer.clear();
+      bool withinQuotes = true;
+      for (++p; p < end; ++p)
+      {
+        const char c = *p;
+        if (withinQuotes && c == QUOTE_CHARACTER)
+        {
+          if (p + 1 < end && p[1] == QUOTE_CHARACTER)
+          {
+            buffer += QUOTE_CHARACTER;
+            ++p;
+          }
+          else
+          {
+            withinQuotes = false;
+          }
+        }
+        else if (!withinQuotes && c == delimiter)
+        {
+          break;
+        }
+        else
+        {
+          buffer += c;
+        }
+      }
+      fieldCallback(fieldIndex, buffer.data(), buffer.data() + buffer.size());
+    }
+    else
+    {
+      const char* fieldEnd = static_cast<const char*>(memchr(p, delimiter, end - p));
+      if (!fieldEnd)
+      {
+        fieldEnd = end;
+      }
+      fieldCallback(fieldIndex, p, fieldEnd);
+      p = fieldEnd;
+    }
+    if (p >= end)
+    {
+      break;
+    }
+    ++p; // skip delimiter
+    ++fieldIndex;
+  }
+}
+
+//------------------------------------------------------------------------------
+/// Convert text to a number. Leading and trailing whitespace and leading "+" sign is allowed,
+/// any other character makes the conversion fail.
+template <typename T>
+bool ParseNumber(const char* begin, const char* end, T& value)
+{
+  while (begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+  {
+    ++begin;
+  }
+  while (end > begin && std::isspace(static_cast<unsigned char>(end[-1])))
+  {
+    --end;
+  }
+  if (begin < end && *begin == '+')
+  {
+    ++begin;
+  }
+  if (begin == end)
+  {
+    return false;
+  }
+  return vtkValueFromString(begin, end, value) == static_cast<std::size_t>(end - begin);
+}
+
+//------------------------------------------------------------------------------
+/// Character types are stored in files as integer numbers
+template <typename T>
+bool ParseCharacterNumber(const char* begin, const char* end, T& value)
+{
+  int intValue = 0;
+  if (!ParseNumber(begin, end, intValue))
+  {
+    return false;
+  }
+  value = static_cast<T>(intValue);
+  return true;
+}
+template <>
+bool ParseNumber<char>(const char* begin, const char* end, char& value)
+{
+  return ParseCharacterNumber(begin, end, value);
+}
+template <>
+bool ParseNumber<signed char>(const char* begin, const char* end, signed char& value)
+{
+  return ParseCharacterNumber(begin, end, value);
+}
+template <>
+bool ParseNumber<unsigned char>(const char* begin, const char* end, unsigned char& value)
+{
+  return ParseCharacterNumber(begin, end, value);
+}
+
+//------------------------------------------------------------------------------
+using CellParser = bool (*)(const char* begin, const char* end, void* data, vtkIdType valueIndex);
+
+template <typename T>
+bool ParseCell(const char* begin, const char* end, void* data, vtkIdType valueIndex)
+{
+  T value;
+  if (!ParseNumber(begin, end, value))
+  {
+    return false;
+  }
+  static_cast<T*>(data)[valueIndex] = value;
+  return true;
+}
+
+/// Bit values are parsed into an unsigned char buffer and copied into the bit array after parsing
+bool ParseBitCell(const char* begin, const char* end, void* data, vtkIdType valueIndex)
+{
+  int value = 0;
+  if (!ParseNumber(begin, end, value))
+  {
+    return false;
+  }
+  static_cast<unsigned char*>(data)[valueIndex] = (value != 0 ? 1 : 0);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+/// Describes where values of a column of the file are stored
+struct FileColumnTarget
+{
+  vtkStdString* StringValues{ nullptr };
+  void* Data{ nullptr };
+  CellParser Parser{ nullptr };
+  int NumberOfComponents{ 1 };
+  int Component{ 0 };
+  std::string ColumnName;
+};
+
+//------------------------------------------------------------------------------
+/// Append text to the output, quoted if needed.
+void AppendText(std::string& output, const std::string& text, bool quote)
+{
+  if (!quote)
+  {
+    output += text;
+    return;
+  }
+  output += QUOTE_CHARACTER;
+  for (char c : text)
+  {
+    if (c == QUOTE_CHARACTER)
+    {
+      output += QUOTE_CHARACTER;
+    }
+    output += c;
+  }
+  output += QUOTE_CHARACTER;
+}
+
+//------------------------------------------------------------------------------
+using CellFormatter = void (*)(std::string& output, vtkAbstractArray* array, const void* data, vtkIdType valueIndex, vtkNumberToString& numberToString);
+
+template <typename T>
+void FormatNumberCell(std::string& output, vtkAbstractArray* vtkNotUsed(array), const void* data, vtkIdType valueIndex, vtkNumberToString& numberToString)
+{
+  const T value = static_cast<const T*>(data)[valueIndex];
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    // Shortest representation that is read back as the same value
+    output += numberToString.Convert(value);
+  }
+  else
+  {
+    // Character types are written as numbers
+    using IntegerType = std::conditional_t<(sizeof(T) < sizeof(int)), int, T>;
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<IntegerType>(value));
+    output.append(buffer, result.ptr);
+  }
+}
+
+/// Used for data arrays that do not store values in a contiguous array (such as bit arrays)
+void FormatDataArrayCell(std::string& output, vtkAbstractArray* array, const void* vtkNotUsed(data), vtkIdType valueIndex, vtkNumberToString& numberToString)
+{
+  vtkDataArray* dataArray = static_cast<vtkDataArray*>(array);
+  int numberOfComponents = dataArray->GetNumberOfComponents();
+  output += numberToString.Convert(dataArray->GetComponent(valueIndex / numberOfComponents, valueIndex % numberOfComponents));
+}
+
+//------------------------------------------------------------------------------
+/// Describes how to write a column of the file
+struct FileColumnSource
+{
+  vtkAbstractArray* Array{ nullptr };
+  vtkStringArray* StringArray{ nullptr };
+  const void* Data{ nullptr };
+  CellFormatter Formatter{ nullptr };
+  int NumberOfComponents{ 1 };
+  int Component{ 0 };
+};
+
+} // namespace
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
@@ -473,179 +796,6 @@ std::vector<vtkMRMLTableStorageNode::ColumnInfo> vtkMRMLTableStorageNode::GetCol
   return columnDetails;
 }
 
-//----------------------------------------------------------------------------
-void vtkMRMLTableStorageNode::FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* typedComponentArray, std::string nullValueString)
-{
-  if (!stringComponentArray || !typedComponentArray)
-  {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::FillTypedComponentArray", "Invalid input.");
-    return;
-  }
-
-  if (stringComponentArray->GetNumberOfValues() != typedComponentArray->GetNumberOfValues())
-  {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(),
-                                     "vtkMRMLTableStorageNode::FillTypedComponentArray",
-                                     "Mismatched number of tuples in string (" << stringComponentArray->GetNumberOfValues() << ")"
-                                                                               << " and typed (" << stringComponentArray->GetNumberOfValues() << ") arrays.");
-    return;
-  }
-
-  int numberOfTuples = stringComponentArray->GetNumberOfTuples();
-
-  // Initialize with null value
-  if (typedComponentArray->IsNumeric())
-  {
-    // numeric arrays can be initialized in one batch
-    double nullValue = 0.0;
-    if (!nullValueString.empty())
-    {
-      nullValue = vtkVariant(nullValueString).ToDouble();
-    }
-    typedComponentArray->FillComponent(0, nullValue);
-  }
-  else
-  {
-    vtkVariant nullValue(nullValueString);
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-    {
-      typedComponentArray->SetVariantValue(row, nullValue);
-    }
-  }
-
-  // Set values
-  vtkIdType scalarTypeId = typedComponentArray->GetDataType();
-  if (scalarTypeId == VTK_CHAR || scalarTypeId == VTK_SIGNED_CHAR || scalarTypeId == VTK_UNSIGNED_CHAR)
-  {
-    bool valid = false;
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-    {
-      if (stringComponentArray->GetValue(row).empty())
-      {
-        // empty cell, leave the null value
-        continue;
-      }
-      int value = stringComponentArray->GetVariantValue(row).ToInt(&valid);
-      if (!valid)
-      {
-        continue;
-      }
-      typedComponentArray->SetVariantValue(row, vtkVariant(value));
-    }
-  }
-  else
-  {
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-    {
-      if (stringComponentArray->GetValue(row).empty())
-      {
-        // empty cell, leave the null value
-        continue;
-      }
-      typedComponentArray->SetVariantValue(row, stringComponentArray->GetVariantValue(row));
-    }
-  }
-}
-
-//----------------------------------------------------------------------------
-void vtkMRMLTableStorageNode::AddColumnToTable(vtkTable* table, vtkMRMLTableStorageNode::ColumnInfo columnInfo)
-{
-  std::string columnName = columnInfo.ColumnName;
-  int valueTypeId = columnInfo.ScalarType;
-  std::vector<vtkAbstractArray*> rawComponentArrays = columnInfo.RawComponentArrays;
-  std::string nullValueString = columnInfo.NullValueString;
-
-  if (valueTypeId == VTK_VOID)
-  {
-    // schema is not defined or no valid column type is defined for column
-    valueTypeId = VTK_STRING;
-  }
-  if (valueTypeId != VTK_STRING //
-      && vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId)) == nullptr)
-  {
-    // Some value types (such as 'variant' or 'object') cannot be represented by a vtkDataArray,
-    // so vtkDataArray::CreateDataArray() returns nullptr for them. Fall back to reading the column
-    // as string instead of dereferencing the null array (which would crash the application).
-    vtkWarningToMessageCollectionMacro(this->GetUserMessages(),
-                                       "vtkMRMLTableStorageNode::AddColumnToTable",
-                                       "Column '" << columnName << "' has unsupported value type '" //
-                                                  << vtkMRMLTableNode::GetValueTypeAsString(valueTypeId) << "'. The column is read as string.");
-    valueTypeId = VTK_STRING;
-  }
-  if (valueTypeId == VTK_STRING)
-  {
-    if (rawComponentArrays.size() > 0)
-    {
-      vtkAbstractArray* columnArray = rawComponentArrays[0];
-      if (columnArray)
-      {
-        columnArray->SetName(columnName.c_str());
-        table->AddColumn(columnArray);
-      }
-    }
-  }
-  else
-  {
-    // Output column. Can be multi-component
-    vtkSmartPointer<vtkDataArray> typedColumn = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-    typedColumn->SetName(columnName.c_str());
-    typedColumn->SetNumberOfComponents(rawComponentArrays.size());
-    vtkIdType numberOfTuples = 0;
-    for (vtkAbstractArray* rawComponentArray : rawComponentArrays)
-    {
-      if (rawComponentArray == nullptr)
-      {
-        continue;
-      }
-      numberOfTuples = std::max(numberOfTuples, rawComponentArray->GetNumberOfTuples());
-    }
-    typedColumn->SetNumberOfTuples(numberOfTuples);
-
-    vtkIdType componentIndex = 0;
-    for (vtkAbstractArray* componentArray : rawComponentArrays)
-    {
-      vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
-      if (rawComponentArray == nullptr)
-      {
-        vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable", "Failed to read component for column '" << columnName << "'.");
-        // Add an empty default array for components that are not found
-        rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
-        rawComponentArray->SetName(columnName.c_str());
-        rawComponentArray->SetNumberOfComponents(1);
-        rawComponentArray->SetNumberOfTuples(numberOfTuples);
-      }
-
-      // Single-component array for a potentially multi-component column
-      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-      typedComponentArray->SetName(rawComponentArray->GetName());
-      typedComponentArray->SetNumberOfComponents(1);
-      typedComponentArray->SetNumberOfTuples(numberOfTuples);
-
-      /// Fill the component array with the correct values of the correct type
-      this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
-
-      if (rawComponentArrays.size() > 1)
-      {
-        // Multi-component column. Copy the contents of the single component column into the output.
-        typedColumn->CopyComponent(componentIndex, typedComponentArray, 0);
-      }
-      else
-      {
-        // Single-component column. Add the column directly to the output.
-        typedColumn = typedComponentArray;
-      }
-
-      if (componentIndex < static_cast<vtkIdType>(columnInfo.ComponentNames.size()))
-      {
-        std::string componentName = columnInfo.ComponentNames[componentIndex];
-        typedColumn->SetComponentName(componentIndex, componentName.c_str());
-      }
-      ++componentIndex;
-    }
-    table->AddColumn(typedColumn);
-  }
-}
-
 //----------------------------------------------------------------------------
 bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode* tableNode)
 {
@@ -721,112 +871,388 @@ bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode*
 //----------------------------------------------------------------------------
 bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  vtkNew<vtkNoEscapeDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
+  std::string delimiterCharacters = this->GetFieldDelimiterCharacters(filename);
+  if (delimiterCharacters.size() != 1)
+  {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable", "Failed to read table file: '" << filename << "'.");
+    return false;
+  }
+  const char delimiter = delimiterCharacters[0];
 
-  // Read table
-  vtkTable* rawTable = nullptr;
-  try
+  // Read the whole file with a single read operation
+  std::string fileContent;
+  std::ifstream inputFile(filename.c_str(), std::ios_base::binary);
+  if (inputFile)
   {
-    reader->Update();
-    rawTable = reader->GetOutput();
+    inputFile.seekg(0, std::ios_base::end);
+    std::streamoff fileSize = inputFile.tellg();
+    inputFile.seekg(0, std::ios_base::beg);
+    if (fileSize > 0)
+    {
+      fileContent.resize(static_cast<size_t>(fileSize));
+      inputFile.read(&fileContent[0], fileSize);
+    }
   }
-  catch (...)
+  if (!inputFile)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable", "Failed to read table file: '" << filename << "'.");
     return false;
   }
+  const char* contentBegin = fileContent.data();
+  const char* contentEnd = contentBegin + fileContent.size();
+  // Skip UTF-8 byte order mark
+  if (fileContent.size() >= 3 && fileContent.compare(0, 3, "\xEF\xBB\xBF") == 0)
+  {
+    contentBegin += 3;
+  }
+
+  std::vector<RecordRange> records;
+  FindRecords(contentBegin, contentEnd, delimiter, records);
+
+  // Column names are read from the first record. The header table contains an empty array for each column
+  // of the file, which is used for determining the output columns (based on the schema).
+  vtkNew<vtkTable> headerTable;
+  std::map<vtkAbstractArray*, int> fileColumnIndices;
+  if (!records.empty())
+  {
+    std::string buffer;
+    ParseRecord(records[0].first,
+                records[0].second,
+                delimiter,
+                buffer,
+                [&](int fieldIndex, const char* begin, const char* end)
+                {
+                  vtkNew<vtkStringArray> headerColumn;
+                  headerColumn->SetName(std::string(begin, end).c_str());
+                  headerTable->AddColumn(headerColumn);
+                  fileColumnIndices[headerColumn.GetPointer()] = fieldIndex;
+                });
+  }
+  const int numberOfFileColumns = headerTable->GetNumberOfColumns();
+  const vtkIdType numberOfRows = records.empty() ? 0 : static_cast<vtkIdType>(records.size()) - 1;
 
   /// Get the info for the columns defined in the schema (Column name, component arrays, component names, scalar type)
-  /// If the schema does not exist, then the raw table is used to generate the table info.
-  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails = this->GetColumnInfo(tableNode, rawTable);
+  /// If the schema does not exist, then the header is used to generate the table info.
+  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails = this->GetColumnInfo(tableNode, headerTable);
 
+  // Create output columns and determine where the values of each column of the file must be stored
   vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
-  for (vtkMRMLTableStorageNode::ColumnInfo columnInfo : columnDetails)
+  std::vector<FileColumnTarget> fileColumnTargets(numberOfFileColumns);
+  // Values of bit arrays are parsed into a temporary buffer
+  std::vector<std::pair<vtkBitArray*, std::vector<unsigned char>>> bitArrayBuffers;
+  bitArrayBuffers.reserve(columnDetails.size());
+  for (const vtkMRMLTableStorageNode::ColumnInfo& columnInfo : columnDetails)
   {
-    this->AddColumnToTable(table, columnInfo);
-  }
+    int valueTypeId = columnInfo.ScalarType;
+    if (valueTypeId == VTK_VOID)
+    {
+      // schema is not defined or no valid column type is defined for column
+      valueTypeId = VTK_STRING;
+    }
+    if (valueTypeId != VTK_STRING //
+        && vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId)) == nullptr)
+    {
+      // Some value types (such as 'variant' or 'object') cannot be represented by a vtkDataArray,
+      // so vtkDataArray::CreateDataArray() returns nullptr for them. Fall back to reading the column as string.
+      vtkWarningToMessageCollectionMacro(this->GetUserMessages(),
+                                         "vtkMRMLTableStorageNode::ReadTable",
+                                         "Column '" << columnInfo.ColumnName << "' has unsupported value type '" //
+                                                    << vtkMRMLTableNode::GetValueTypeAsString(valueTypeId) << "'. The column is read as string.");
+      valueTypeId = VTK_STRING;
+    }
 
-  tableNode->SetAndObserveTable(table);
-  return true;
-}
+    if (valueTypeId == VTK_STRING)
+    {
+      // Only the first component of string columns is read
+      if (columnInfo.RawComponentArrays.empty() || columnInfo.RawComponentArrays[0] == nullptr)
+      {
+        continue;
+      }
+      vtkNew<vtkStringArray> stringColumn;
+      stringColumn->SetName(columnInfo.ColumnName.c_str());
+      stringColumn->SetNumberOfValues(numberOfRows);
+      table->AddColumn(stringColumn);
+      FileColumnTarget& target = fileColumnTargets[fileColumnIndices[columnInfo.RawComponentArrays[0]]];
+      target.StringValues = numberOfRows > 0 ? stringColumn->GetPointer(0) : nullptr;
+      target.ColumnName = columnInfo.ColumnName;
+      continue;
+    }
 
-//----------------------------------------------------------------------------
-bool vtkMRMLTableStorageNode::WriteTable(std::string filename, vtkTable* table, std::string delimiter, std::map<vtkIdType, std::vector<std::string>> componentNamesMap)
-{
-  vtkTable* originalTable = table;
+    // Output column. Can be multi-component.
+    int numberOfComponents = static_cast<int>(columnInfo.RawComponentArrays.size());
+    vtkSmartPointer<vtkDataArray> typedColumn = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
+    std::string typedColumnName = columnInfo.ColumnName;
+    if (numberOfComponents == 1 && columnInfo.RawComponentArrays[0] != nullptr && columnInfo.RawComponentArrays[0]->GetName())
+    {
+      // Single-component columns are named after the column of the file (for consistency with previous versions)
+      typedColumnName = columnInfo.RawComponentArrays[0]->GetName();
+    }
+    typedColumn->SetName(typedColumnName.c_str());
+    typedColumn->SetNumberOfComponents(numberOfComponents);
+    typedColumn->SetNumberOfTuples(numberOfRows);
 
-  vtkNew<vtkTable> newTable;
-  for (int i = 0; i < originalTable->GetNumberOfColumns(); ++i)
-  {
-    vtkAbstractArray* oldColumn = originalTable->GetColumn(i);
-    vtkDataArray* oldDataArray = vtkDataArray::SafeDownCast(oldColumn);
-    int numberOfComponents = oldColumn->GetNumberOfComponents();
+    // Initialize with null value, which is kept for empty and invalid cells
+    double nullValue = 0.0;
+    if (!columnInfo.NullValueString.empty())
+    {
+      nullValue = vtkVariant(columnInfo.NullValueString).ToDouble();
+    }
+    for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+    {
+      typedColumn->FillComponent(componentIndex, nullValue);
+      if (componentIndex < static_cast<int>(columnInfo.ComponentNames.size()))
+      {
+        typedColumn->SetComponentName(componentIndex, columnInfo.ComponentNames[componentIndex].c_str());
+      }
+    }
 
-    // Component names are only valid for vtkDataArray
-    // If we cannot cast to a vtkDataArray, then add to table as is.
-    // Otherwise, separate to individual components
-    if (!oldDataArray)
+    void* data = nullptr;
+    CellParser parser = nullptr;
+    if (valueTypeId == VTK_BIT)
     {
-      newTable->AddColumn(oldColumn);
+      bitArrayBuffers.emplace_back(vtkBitArray::SafeDownCast(typedColumn), std::vector<unsigned char>(numberOfRows * numberOfComponents, nullValue != 0.0 ? 1 : 0));
+      data = bitArrayBuffers.back().second.data();
+      parser = ParseBitCell;
     }
     else
     {
-      std::string columnName;
-      if (oldColumn->GetName())
+      data = typedColumn->GetVoidPointer(0);
+      switch (valueTypeId)
       {
-        columnName = oldColumn->GetName();
+        vtkTemplateMacro(parser = ParseCell<VTK_TT>);
       }
+    }
 
-      std::vector<std::string> componentNames = componentNamesMap[i];
-      for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+    for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+    {
+      vtkAbstractArray* rawComponentArray = columnInfo.RawComponentArrays[componentIndex];
+      if (rawComponentArray == nullptr)
       {
-        std::string newColumnName = columnName;
-        if (static_cast<int>(componentNames.size()) > componentIndex)
-        {
-          std::stringstream newColumnNameSS;
-          newColumnNameSS << columnName << COMPONENT_SEPERATOR << componentNames[componentIndex];
-          newColumnName = newColumnNameSS.str();
-        }
-        vtkSmartPointer<vtkDataArray> newColumn = vtkSmartPointer<vtkDataArray>::Take(oldDataArray->NewInstance());
-        newColumn->SetNumberOfComponents(1);
-        newColumn->SetNumberOfTuples(oldColumn->GetNumberOfTuples());
-        newColumn->SetName(newColumnName.c_str());
-        newColumn->CopyComponent(0, oldDataArray, componentIndex);
-        newTable->AddColumn(newColumn);
+        vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable", "Failed to read component for column '" << columnInfo.ColumnName << "'.");
+        continue;
       }
+      FileColumnTarget& target = fileColumnTargets[fileColumnIndices[rawComponentArray]];
+      target.Data = data;
+      target.Parser = parser;
+      target.NumberOfComponents = numberOfComponents;
+      target.Component = componentIndex;
+      target.ColumnName = columnInfo.ColumnName;
     }
+    table->AddColumn(typedColumn);
   }
 
-  vtkNew<vtkDelimitedTextWriter> writer;
-  writer->SetFileName(filename.c_str());
-  writer->SetInputData(newTable);
-  writer->SetFieldDelimiter(delimiter.c_str());
+  // Parse all the data records. Records are processed in parallel, each cell is converted
+  // directly into the value type of the output column.
+  std::vector<std::atomic<vtkIdType>> numberOfInvalidValues(numberOfFileColumns);
+  std::atomic<vtkIdType> numberOfRowsWithExtraFields{ 0 };
+  vtkSMPTools::For(0,
+                   numberOfRows,
+                   ROWS_PER_BLOCK,
+                   [&](vtkIdType firstRow, vtkIdType lastRow)
+                   {
+                     std::string buffer;
+                     std::vector<vtkIdType> blockNumberOfInvalidValues(numberOfFileColumns, 0);
+                     vtkIdType blockNumberOfRowsWithExtraFields = 0;
+                     for (vtkIdType row = firstRow; row < lastRow; ++row)
+                     {
+                       const RecordRange& record = records[row + 1];
+                       bool extraFields = false;
+                       ParseRecord(record.first,
+                                   record.second,
+                                   delimiter,
+                                   buffer,
+                                   [&](int fieldIndex, const char* begin, const char* end)
+                                   {
+                                     if (fieldIndex >= numberOfFileColumns)
+                                     {
+                                       extraFields = true;
+                                       return;
+                                     }
+                                     const FileColumnTarget& target = fileColumnTargets[fieldIndex];
+                                     if (target.StringValues)
+                                     {
+                                       target.StringValues[row].assign(begin, end);
+                                     }
+                                     else if (target.Parser && begin != end)
+                                     {
+                                       // empty cells keep the null value
+                                       if (!target.Parser(begin, end, target.Data, row * target.NumberOfComponents + target.Component))
+                                       {
+                                         ++blockNumberOfInvalidValues[fieldIndex];
+                                       }
+                                     }
+                                   });
+                       if (extraFields)
+                       {
+                         ++blockNumberOfRowsWithExtraFields;
+                       }
+                     }
+                     for (int fileColumnIndex = 0; fileColumnIndex < numberOfFileColumns; ++fileColumnIndex)
+                     {
+                       numberOfInvalidValues[fileColumnIndex] += blockNumberOfInvalidValues[fileColumnIndex];
+                     }
+                     numberOfRowsWithExtraFields += blockNumberOfRowsWithExtraFields;
+                   });
+
+  for (auto& bitArrayBuffer : bitArrayBuffers)
+  {
+    vtkBitArray* bitArray = bitArrayBuffer.first;
+    const std::vector<unsigned char>& values = bitArrayBuffer.second;
+    for (vtkIdType valueIndex = 0; valueIndex < static_cast<vtkIdType>(values.size()); ++valueIndex)
+    {
+      bitArray->SetValue(valueIndex, values[valueIndex]);
+    }
+  }
+
+  for (int fileColumnIndex = 0; fileColumnIndex < numberOfFileColumns; ++fileColumnIndex)
+  {
+    if (numberOfInvalidValues[fileColumnIndex] > 0)
+    {
+      vtkWarningToMessageCollectionMacro(this->GetUserMessages(),
+                                         "vtkMRMLTableStorageNode::ReadTable",
+                                         numberOfInvalidValues[fileColumnIndex].load() << " values of column '" << fileColumnTargets[fileColumnIndex].ColumnName
+                                                                                << "' could not be converted to the column type, they are set to the null value.");
+    }
+  }
+  if (numberOfRowsWithExtraFields > 0)
+  {
+    vtkWarningToMessageCollectionMacro(this->GetUserMessages(),
+                                       "vtkMRMLTableStorageNode::ReadTable",
+                                       numberOfRowsWithExtraFields.load() << " rows in file '" << filename << "' contain more values than the number of columns, extra values are ignored.");
+  }
+
+  tableNode->SetAndObserveTable(table);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableStorageNode::WriteTable(std::string filename, vtkTable* table, std::string delimiter, std::map<vtkIdType, std::vector<std::string>> componentNamesMap)
+{
+  if (!table || delimiter.size() != 1)
+  {
+    vtkGenericWarningMacro("vtkMRMLTableStorageNode::WriteTable: Failed to write file: '" << filename << "'. Invalid table or delimiter.");
+    return false;
+  }
 
   // SetUseStringDelimiter(true) causes writing each value in double-quotes, which is not very nice,
   // but if the delimiter character is the comma then we have to use this mode, as commas occur in
   // string values quite often.
-  writer->SetUseStringDelimiter(delimiter == ",");
+  const bool quoteStrings = (delimiter == ",");
 
-  vtkNew<vtkErrorSink> errorWarningObserver;
-  errorWarningObserver->SetObservedObject(writer);
-  try
+  // Each component of data arrays is written into a separate column of the file
+  std::vector<FileColumnSource> fileColumnSources;
+  std::string header;
+  for (int i = 0; i < table->GetNumberOfColumns(); ++i)
   {
-    writer->Write();
+    vtkAbstractArray* column = table->GetColumn(i);
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(column);
+    std::string columnName;
+    if (column->GetName())
+    {
+      columnName = column->GetName();
+    }
+
+    FileColumnSource source;
+    source.Array = column;
+    source.NumberOfComponents = column->GetNumberOfComponents();
+    if (!dataArray)
+    {
+      // Component names are only valid for vtkDataArray, other arrays are written as a single column
+      source.StringArray = vtkStringArray::SafeDownCast(column);
+      header += (fileColumnSources.empty() ? "" : delimiter);
+      AppendText(header, columnName, quoteStrings);
+      fileColumnSources.push_back(source);
+      continue;
+    }
+
+    source.Formatter = FormatDataArrayCell;
+    if (dataArray->HasStandardMemoryLayout())
+    {
+      source.Data = dataArray->GetVoidPointer(0);
+      switch (dataArray->GetDataType())
+      {
+        vtkTemplateMacro(source.Formatter = FormatNumberCell<VTK_TT>);
+      }
+    }
+    const std::vector<std::string>& componentNames = componentNamesMap[i];
+    for (int componentIndex = 0; componentIndex < source.NumberOfComponents; ++componentIndex)
+    {
+      std::string fileColumnName = columnName;
+      if (static_cast<int>(componentNames.size()) > componentIndex)
+      {
+        fileColumnName += COMPONENT_SEPERATOR + componentNames[componentIndex];
+      }
+      header += (fileColumnSources.empty() ? "" : delimiter);
+      AppendText(header, fileColumnName, quoteStrings);
+      source.Component = componentIndex;
+      fileColumnSources.push_back(source);
+    }
   }
-  catch (...)
+  header += "\n";
+
+  std::ofstream outputFile(filename.c_str(), std::ios_base::binary);
+  if (!outputFile)
   {
     vtkErrorWithObjectMacro(table, "vtkMRMLTableStorageNode::WriteTable: Failed to write file: '" << filename << "'.");
     return false;
   }
-  errorWarningObserver->DisplayMessages();
-  if (errorWarningObserver->HasErrors())
+  outputFile << header;
+
+  // Rows are formatted in blocks, in parallel. Blocks are written to file in order.
+  // Only a limited number of blocks are kept in memory at once.
+  const vtkIdType numberOfRows = table->GetNumberOfRows();
+  const vtkIdType numberOfBlocks = (numberOfRows + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+  const vtkIdType maximumNumberOfBlocksInMemory = 64;
+  std::vector<std::string> blockTexts(std::min(numberOfBlocks, maximumNumberOfBlocksInMemory));
+  for (vtkIdType firstBlock = 0; firstBlock < numberOfBlocks && outputFile; firstBlock += maximumNumberOfBlocksInMemory)
+  {
+    vtkIdType lastBlock = std::min(firstBlock + maximumNumberOfBlocksInMemory, numberOfBlocks);
+    vtkSMPTools::For(firstBlock,
+                     lastBlock,
+                     1,
+                     [&](vtkIdType beginBlock, vtkIdType endBlock)
+                     {
+                       vtkNumberToString numberToString;
+                       for (vtkIdType block = beginBlock; block < endBlock; ++block)
+                       {
+                         std::string& text = blockTexts[block - firstBlock];
+                         text.clear();
+                         vtkIdType lastRow = std::min((block + 1) * ROWS_PER_BLOCK, numberOfRows);
+                         for (vtkIdType row = block * ROWS_PER_BLOCK; row < lastRow; ++row)
+                         {
+                           for (size_t fileColumnIndex = 0; fileColumnIndex < fileColumnSources.size(); ++fileColumnIndex)
+                           {
+                             if (fileColumnIndex > 0)
+                             {
+                               text += delimiter[0];
+                             }
+                             const FileColumnSource& source = fileColumnSources[fileColumnIndex];
+                             vtkIdType valueIndex = row * source.NumberOfComponents + source.Component;
+                             if (source.Formatter)
+                             {
+                               source.Formatter(text, source.Array, source.Data, valueIndex, numberToString);
+                             }
+                             else if (source.StringArray)
+                             {
+                               AppendText(text, source.StringArray->GetValue(valueIndex), quoteStrings);
+                             }
+                             else
+                             {
+                               AppendText(text, source.Array->GetVariantValue(valueIndex).ToString(), quoteStrings);
+                             }
+                           }
+                           text += '\n';
+                         }
+                       }
+                     });
+    for (vtkIdType block = firstBlock; block < lastBlock; ++block)
+    {
+      outputFile << blockTexts[block - firstBlock];
+    }
+  }
+
+  outputFile.close();
+  if (outputFile.fail())
   {
     vtkErrorWithObjectMacro(table, "vtkMRMLTableStorageNode::WriteTable: Failed to write file: '" << filename << "'.");
     return false;
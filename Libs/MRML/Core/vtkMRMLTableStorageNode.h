@@ -38,8 +38,11 @@ class vtkTable;
 /// characters (including commas and quotation marks).
 ///
 /// If the file extension is .csv then it is assumed to be comma-separated.
-/// Values in comma-separated files may not contain quotation marks but may contain
-/// any other characters (including commas and tabs).
+/// String values in comma-separated files are written in quotation marks, therefore they
+/// may contain any characters (quotation marks in values are escaped by doubling them).
+///
+/// Files are parsed in a single pass: values are converted directly to the column type
+/// specified in the schema, using multiple threads for large files.
 ///
 class VTK_MRML_EXPORT vtkMRMLTableStorageNode : public vtkMRMLStorageNode
 {
@@ -119,13 +122,6 @@ protected:
   /// and the names of the components.
   std::vector<ColumnInfo> GetColumnInfo(vtkMRMLTableNode* tableNode, vtkTable* rawTable);
 
-  /// Casts the data in the string array to the correct type and stores it in the data array
-  void FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* dataArray, std::string nullValueString = "");
-
-  /// Adds the column specified by the given columnInfo to the table.
-  /// Handles both single and multi-component columns
-  void AddColumnToTable(vtkTable* table, ColumnInfo columnInfo);
-
   bool ReadSchema(std::string filename, vtkMRMLTableNode* tableNode);
   bool ReadTable(std::string filename, vtkMRMLTableNode* tableNode);
 
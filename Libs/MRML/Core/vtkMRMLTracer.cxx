@@ -0,0 +1,344 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLTracer.h"
+#include "vtkMRMLJsonElement.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// The tracer singleton.
+// This MUST be default initialized to zero by the compiler and is
+// therefore not initialized here.  The ClassInitialize and
+// ClassFinalize methods handle this instance.
+static vtkMRMLTracer* vtkMRMLTracerInstance;
+
+//----------------------------------------------------------------------------
+// Must NOT be initialized.  Default initialization to zero is necessary.
+unsigned int vtkMRMLTracerInitialize::Count;
+
+std::atomic<bool> vtkMRMLTracer::Enabled(false);
+
+namespace
+{
+const std::chrono::steady_clock::time_point TracerTimeOrigin = std::chrono::steady_clock::now();
+}
+
+//----------------------------------------------------------------------------
+class vtkMRMLTracer::vtkInternal
+{
+public:
+  struct Event
+  {
+    const char* Category;
+    const char* Name;
+    std::string Detail;
+    double StartTime;
+    double Duration;
+    int ThreadIndex;
+  };
+
+  /// Return a small integer that identifies the thread in the trace. Must be called with Mutex locked.
+  int GetThreadIndex(std::thread::id threadId)
+  {
+    auto threadIt = this->ThreadIndices.find(threadId);
+    if (threadIt != this->ThreadIndices.end())
+    {
+      return threadIt->second;
+    }
+    int threadIndex = static_cast<int>(this->ThreadIndices.size()) + 1;
+    this->ThreadIndices[threadId] = threadIndex;
+    return threadIndex;
+  }
+
+  std::mutex Mutex;
+  std::vector<Event> Events;
+  std::map<std::thread::id, int> ThreadIndices;
+  std::thread::id MainThreadId{ std::this_thread::get_id() };
+  int MaximumNumberOfEvents{ 1000000 };
+  int NumberOfDroppedEvents{ 0 };
+  std::string OutputFilePath;
+};
+
+//----------------------------------------------------------------------------
+// Implementation of vtkMRMLTracerInitialize class.
+//----------------------------------------------------------------------------
+vtkMRMLTracerInitialize::vtkMRMLTracerInitialize()
+{
+  if (++Self::Count == 1)
+  {
+    vtkMRMLTracer::classInitialize();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracerInitialize::~vtkMRMLTracerInitialize()
+{
+  if (--Self::Count == 0)
+  {
+    vtkMRMLTracer::classFinalize();
+  }
+}
+
+//----------------------------------------------------------------------------
+// Up the reference count so it behaves like New
+vtkMRMLTracer* vtkMRMLTracer::New()
+{
+  vtkMRMLTracer* ret = vtkMRMLTracer::GetInstance();
+  ret->Register(nullptr);
+  return ret;
+}
+
+//----------------------------------------------------------------------------
+// Return the single instance of the vtkMRMLTracer
+vtkMRMLTracer* vtkMRMLTracer::GetInstance()
+{
+  if (!vtkMRMLTracerInstance)
+  {
+    // Try the factory first
+    vtkMRMLTracerInstance = (vtkMRMLTracer*)vtkObjectFactory::CreateInstance("vtkMRMLTracer");
+    // if the factory did not provide one, then create it here
+    if (!vtkMRMLTracerInstance)
+    {
+      vtkMRMLTracerInstance = new vtkMRMLTracer;
+#ifdef VTK_HAS_INITIALIZE_OBJECT_BASE
+      vtkMRMLTracerInstance->InitializeObjectBase();
+#endif
+    }
+  }
+  // return the instance
+  return vtkMRMLTracerInstance;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracer::vtkMRMLTracer()
+{
+  this->Internal = new vtkInternal;
+  const char* outputFilePath = vtksys::SystemTools::GetEnv(MRML_APPLICATION_TRACE_FILE_ENV);
+  if (outputFilePath && strlen(outputFilePath) > 0 && strlen(MRML_APPLICATION_TRACE_FILE_ENV) > 0)
+  {
+    this->Internal->OutputFilePath = outputFilePath;
+    this->Start();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracer::~vtkMRMLTracer()
+{
+  this->Stop();
+  if (!this->Internal->OutputFilePath.empty())
+  {
+    this->WriteChromeTrace(this->Internal->OutputFilePath.c_str());
+  }
+  delete this->Internal;
+  this->Internal = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->vtkObject::PrintSelf(os, indent);
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  os << indent << "Enabled: " << (vtkMRMLTracer::IsEnabled() ? "true" : "false") << "\n";
+  os << indent << "NumberOfEvents: " << this->Internal->Events.size() << "\n";
+  os << indent << "NumberOfDroppedEvents: " << this->Internal->NumberOfDroppedEvents << "\n";
+  os << indent << "MaximumNumberOfEvents: " << this->Internal->MaximumNumberOfEvents << "\n";
+  os << indent << "OutputFilePath: " << this->Internal->OutputFilePath << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::classInitialize()
+{
+  // Allocate the singleton
+  vtkMRMLTracerInstance = vtkMRMLTracer::GetInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::classFinalize()
+{
+  vtkMRMLTracerInstance->Delete();
+  vtkMRMLTracerInstance = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::Start()
+{
+  vtkMRMLTracer::Enabled.store(true);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::Stop()
+{
+  vtkMRMLTracer::Enabled.store(false);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::ClearEvents()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->Events.clear();
+  this->Internal->NumberOfDroppedEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTracer::GetNumberOfEvents()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->Events.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTracer::GetNumberOfDroppedEvents()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->NumberOfDroppedEvents;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::SetMaximumNumberOfEvents(int maximumNumberOfEvents)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->MaximumNumberOfEvents = std::max(0, maximumNumberOfEvents);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTracer::GetMaximumNumberOfEvents()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->MaximumNumberOfEvents;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::SetOutputFilePath(const std::string& filePath)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->OutputFilePath = filePath;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLTracer::GetOutputFilePath()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->OutputFilePath;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTracer::GetTimestamp()
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - TracerTimeOrigin).count();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::AddCompleteEvent(const char* category, const char* name, const std::string& detail, double startTime, double duration)
+{
+  std::thread::id threadId = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  if (static_cast<int>(this->Internal->Events.size()) >= this->Internal->MaximumNumberOfEvents)
+  {
+    this->Internal->NumberOfDroppedEvents++;
+    return;
+  }
+  vtkInternal::Event event{ category, name, detail, startTime, duration, this->Internal->GetThreadIndex(threadId) };
+  this->Internal->Events.push_back(std::move(event));
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTracer::WriteChromeTrace(const char* filePath)
+{
+  if (!filePath || strlen(filePath) == 0)
+  {
+    vtkErrorMacro("WriteChromeTrace failed: invalid file path");
+    return false;
+  }
+
+  // Copy the events so that recording is not blocked while the file is written
+  std::vector<vtkInternal::Event> events;
+  std::map<std::thread::id, int> threadIndices;
+  int numberOfDroppedEvents = 0;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    events = this->Internal->Events;
+    threadIndices = this->Internal->ThreadIndices;
+    numberOfDroppedEvents = this->Internal->NumberOfDroppedEvents;
+  }
+
+  vtkNew<vtkMRMLJsonWriter> writer;
+  if (!writer->WriteToFileBegin(filePath, nullptr))
+  {
+    vtkErrorMacro("WriteChromeTrace failed: cannot write file " << filePath);
+    return false;
+  }
+  writer->WriteStringProperty("displayTimeUnit", "ms");
+  writer->WriteArrayPropertyStart("traceEvents");
+  // Thread names, displayed in the timeline instead of thread indices
+  for (const auto& threadIndex : threadIndices)
+  {
+    writer->WriteObjectStart();
+    writer->WriteStringProperty("name", "thread_name");
+    writer->WriteStringProperty("ph", "M");
+    writer->WriteIntProperty("pid", 1);
+    writer->WriteIntProperty("tid", threadIndex.second);
+    writer->WriteObjectPropertyStart("args");
+    writer->WriteStringProperty("name", threadIndex.first == this->Internal->MainThreadId ? "Main thread" : "Thread " + std::to_string(threadIndex.second));
+    writer->WriteObjectPropertyEnd();
+    writer->WriteObjectEnd();
+  }
+  for (const vtkInternal::Event& event : events)
+  {
+    writer->WriteObjectStart();
+    writer->WriteStringProperty("name", event.Name);
+    writer->WriteStringProperty("cat", event.Category ? event.Category : "");
+    writer->WriteStringProperty("ph", "X");
+    writer->WriteDoubleProperty("ts", event.StartTime);
+    writer->WriteDoubleProperty("dur", event.Duration);
+    writer->WriteIntProperty("pid", 1);
+    writer->WriteIntProperty("tid", event.ThreadIndex);
+    if (!event.Detail.empty())
+    {
+      writer->WriteObjectPropertyStart("args");
+      writer->WriteStringProperty("detail", event.Detail);
+      writer->WriteObjectPropertyEnd();
+    }
+    writer->WriteObjectEnd();
+  }
+  writer->WriteArrayPropertyEnd();
+  writer->WriteObjectPropertyStart("otherData");
+  writer->WriteStringProperty("application", MRML_APPLICATION_NAME);
+  writer->WriteIntProperty("droppedEvents", numberOfDroppedEvents);
+  writer->WriteObjectPropertyEnd();
+  if (!writer->WriteToFileEnd())
+  {
+    vtkErrorMacro("WriteChromeTrace failed: error while writing file " << filePath);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,213 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLTracer_h
+#define __vtkMRMLTracer_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <atomic>
+#include <string>
+
+/// \brief Record the duration of operations for inspecting timelines of application sessions.
+///
+/// Operations are recorded using vtkMRMLTraceScopeMacro, which measures the time from the
+/// macro until the end of the enclosing scope. When tracing is not enabled then the
+/// macro only checks a flag, so instrumentation can be left in performance-critical code.
+///
+/// Recorded events can be written to a file in Chrome trace event format (JSON),
+/// which can be displayed in chrome://tracing or https://ui.perfetto.dev.
+///
+/// Tracing is enabled at startup if the environment variable MRML_APPLICATION_TRACE_FILE_ENV
+/// (SLICER_TRACE_FILE in Slicer) is set. In this case the trace is written to the file path
+/// specified in the variable when the application exits.
+/// Tracing can be also started and stopped at runtime, for example from Python:
+/// \code
+/// tracer = slicer.vtkMRMLTracer.GetInstance()
+/// tracer.Start()
+/// slicer.util.loadVolume(...)
+/// tracer.Stop()
+/// tracer.WriteChromeTrace("/tmp/trace.json")
+/// \endcode
+///
+/// Recording of events is thread-safe.
+class VTK_MRML_EXPORT vtkMRMLTracer : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLTracer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLTracer* GetInstance();
+
+  ///
+  /// This is a singleton pattern New.  There will only be ONE
+  /// reference to a vtkMRMLTracer object per process.  Clients that
+  /// call this must call Delete on the object so that the reference
+  /// counting will work. The single instance will be unreferenced when
+  /// the program exits.
+  static vtkMRMLTracer* New();
+
+  /// Start recording events. Previously recorded events are kept.
+  void Start();
+  /// Stop recording events.
+  void Stop();
+
+  /// Returns true if events are recorded.
+  static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+
+  /// Remove all recorded events.
+  void ClearEvents();
+
+  /// Number of recorded events.
+  int GetNumberOfEvents();
+
+  /// Number of events that were not recorded because the maximum number of events was reached.
+  int GetNumberOfDroppedEvents();
+
+  //@{
+  /// Maximum number of recorded events, to limit memory usage if tracing is left enabled for a long time.
+  /// Default is 1000000.
+  void SetMaximumNumberOfEvents(int maximumNumberOfEvents);
+  int GetMaximumNumberOfEvents();
+  //@}
+
+  //@{
+  /// File path where the trace is written to when the application exits.
+  /// Initialized from the environment variable MRML_APPLICATION_TRACE_FILE_ENV.
+  /// If empty then the trace is not written automatically.
+  void SetOutputFilePath(const std::string& filePath);
+  std::string GetOutputFilePath();
+  //@}
+
+  /// Write recorded events to file in Chrome trace event format (JSON).
+  /// Returns true on success.
+  bool WriteChromeTrace(const char* filePath);
+
+  /// Record an event that started at startTime (in microseconds, see GetTimestamp()) and lasted for duration microseconds.
+  /// Category and name must be string literals (or other strings that remain valid until the tracer is deleted).
+  /// Detail is optional additional information (e.g., file name), displayed as event argument.
+  void AddCompleteEvent(const char* category, const char* name, const std::string& detail, double startTime, double duration);
+
+  /// Return current time in microseconds, relative to the creation of the tracer.
+  static double GetTimestamp();
+
+protected:
+  vtkMRMLTracer();
+  ~vtkMRMLTracer() override;
+  vtkMRMLTracer(const vtkMRMLTracer&);
+  void operator=(const vtkMRMLTracer&);
+
+  ///
+  /// Singleton management functions.
+  static void classInitialize();
+  static void classFinalize();
+
+  friend class vtkMRMLTracerInitialize;
+  typedef vtkMRMLTracer Self;
+
+  static std::atomic<bool> Enabled;
+
+private:
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+/// Utility class to make sure vtkMRMLTracer is initialized before it is used.
+class VTK_MRML_EXPORT vtkMRMLTracerInitialize
+{
+public:
+  typedef vtkMRMLTracerInitialize Self;
+
+  vtkMRMLTracerInitialize();
+  ~vtkMRMLTracerInitialize();
+
+private:
+  static unsigned int Count;
+};
+
+/// This instance will show up in any translation unit that uses
+/// vtkMRMLTracer.  It will make sure vtkMRMLTracer is initialized
+/// before it is used.
+static vtkMRMLTracerInitialize vtkMRMLTracerInitializer;
+
+#ifndef __VTK_WRAP__
+
+/// \brief Record the time from construction until destruction as a trace event.
+///
+/// Use vtkMRMLTraceScopeMacro or vtkMRMLTraceScopeWithDetailMacro instead of using this class directly.
+class VTK_MRML_EXPORT vtkMRMLTraceScope
+{
+public:
+  vtkMRMLTraceScope(const char* category, const char* name)
+  {
+    if (vtkMRMLTracer::IsEnabled())
+    {
+      this->Category = category;
+      this->Name = name;
+      this->StartTime = vtkMRMLTracer::GetTimestamp();
+    }
+  }
+  ~vtkMRMLTraceScope()
+  {
+    if (this->Name)
+    {
+      vtkMRMLTracer::GetInstance()->AddCompleteEvent(this->Category, this->Name, this->Detail, this->StartTime, vtkMRMLTracer::GetTimestamp() - this->StartTime);
+    }
+  }
+
+  /// Returns true if the event is recorded. Detail only needs to be set if the scope is active.
+  bool IsActive() const { return this->Name != nullptr; }
+
+  void SetDetail(const char* detail) { this->Detail = detail ? detail : ""; }
+  void SetDetail(const std::string& detail) { this->Detail = detail; }
+
+private:
+  vtkMRMLTraceScope(const vtkMRMLTraceScope&) = delete;
+  void operator=(const vtkMRMLTraceScope&) = delete;
+
+  const char* Category{ nullptr };
+  const char* Name{ nullptr };
+  std::string Detail;
+  double StartTime{ 0.0 };
+};
+
+#define vtkMRMLTraceScopeVariableName2(line) vtkMRMLTraceScope_##line
+#define vtkMRMLTraceScopeVariableName(line) vtkMRMLTraceScopeVariableName2(line)
+
+/// Record the time until the end of the current scope as a trace event.
+/// Category and name must be string literals.
+#define vtkMRMLTraceScopeMacro(category, name) vtkMRMLTraceScope vtkMRMLTraceScopeVariableName(__LINE__)(category, name)
+
+/// Record the time until the end of the current scope as a trace event, with additional information.
+/// Detail (const char* or std::string) is only evaluated if tracing is enabled.
+#define vtkMRMLTraceScopeWithDetailMacro(category, name, detail)                         \
+  vtkMRMLTraceScope vtkMRMLTraceScopeVariableName(__LINE__)(category, name);            \
+  if (vtkMRMLTraceScopeVariableName(__LINE__).IsActive())                               \
+  {                                                                                     \
+    vtkMRMLTraceScopeVariableName(__LINE__).SetDetail(detail);                          \
+  }
+
+#endif // __VTK_WRAP__
+
+#endif
@@ -33,17 +33,106 @@ Version:   $Revision: 1.14 $
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
+#include <vtkMath.h>
 #include <vtkHomogeneousTransform.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
+#include <vtkSMPTools.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <stack>
+#include <vector>
+
+namespace
+{
+
+/// Number of inverse displacement field points between B-spline control points along each axis
+const int BSPLINE_INVERSE_GRID_SUBDIVISION = 4;
+
+//----------------------------------------------------------------------------
+/// Get geometry of the displacement field that is used for storing the inverse of a grid or B-spline transform.
+/// Returns false if the transform is not a single grid or B-spline transform.
+bool GetInverseDisplacementFieldGeometry(vtkAbstractTransform* forwardTransform, int dimensions[3], double origin[3], double spacing[3], vtkMatrix4x4* direction)
+{
+  vtkNew<vtkCollection> transformList;
+  vtkMRMLTransformNode::FlattenGeneralTransform(transformList, forwardTransform);
+  if (transformList->GetNumberOfItems() != 1)
+  {
+    return false;
+  }
+  vtkAbstractTransform* transform = vtkAbstractTransform::SafeDownCast(transformList->GetItemAsObject(0));
+  if (!transform)
+  {
+    return false;
+  }
+  transform->Update();
+
+  vtkImageData* grid = nullptr;
+  vtkMatrix4x4* gridDirection = nullptr;
+  int subdivision = 1;
+  if (vtkGridTransform* gridTransform = vtkGridTransform::SafeDownCast(transform))
+  {
+    grid = gridTransform->GetDisplacementGrid();
+    vtkOrientedGridTransform* orientedGridTransform = vtkOrientedGridTransform::SafeDownCast(transform);
+    gridDirection = (orientedGridTransform ? orientedGridTransform->GetGridDirectionMatrix() : nullptr);
+  }
+  else if (vtkBSplineTransform* bsplineTransform = vtkBSplineTransform::SafeDownCast(transform))
+  {
+    // B-spline control points are sparse, use a denser grid to represent the inverse
+    grid = bsplineTransform->GetCoefficientData();
+    vtkOrientedBSplineTransform* orientedBSplineTransform = vtkOrientedBSplineTransform::SafeDownCast(transform);
+    gridDirection = (orientedBSplineTransform ? orientedBSplineTransform->GetGridDirectionMatrix() : nullptr);
+    subdivision = BSPLINE_INVERSE_GRID_SUBDIVISION;
+  }
+  if (!grid)
+  {
+    return false;
+  }
+
+  int* extent = grid->GetExtent();
+  double* gridOrigin = grid->GetOrigin();
+  double* gridSpacing = grid->GetSpacing();
+  direction->Identity();
+  if (gridDirection)
+  {
+    for (int row = 0; row < 3; row++)
+    {
+      for (int col = 0; col < 3; col++)
+      {
+        direction->SetElement(row, col, gridDirection->GetElement(row, col));
+      }
+    }
+  }
+  for (int axis = 0; axis < 3; axis++)
+  {
+    int numberOfGridPoints = extent[axis * 2 + 1] - extent[axis * 2] + 1;
+    if (numberOfGridPoints < 1)
+    {
+      return false;
+    }
+    dimensions[axis] = (numberOfGridPoints - 1) * subdivision + 1;
+    spacing[axis] = gridSpacing[axis] / subdivision;
+  }
+  // The inverse field starts at the first point of the grid extent
+  for (int row = 0; row < 3; row++)
+  {
+    origin[row] = gridOrigin[row];
+    for (int col = 0; col < 3; col++)
+    {
+      origin[row] += direction->GetElement(row, col) * gridSpacing[col] * extent[col * 2];
+    }
+  }
+  return true;
+}
+
+} // namespace
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTransformNode);
@@ -81,6 +170,12 @@ vtkMRMLTransformNode::~vtkMRMLTransformNode()
 void vtkMRMLTransformNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(cacheInverseDisplacementField, CacheInverseDisplacementField);
+  vtkMRMLWriteXMLIntMacro(inverseDisplacementFieldMaximumNumberOfIterations, InverseDisplacementFieldMaximumNumberOfIterations);
+  vtkMRMLWriteXMLFloatMacro(inverseDisplacementFieldTolerance, InverseDisplacementFieldTolerance);
+  vtkMRMLWriteXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
@@ -109,6 +204,18 @@ void vtkMRMLTransformNode::ReadXMLAttributes(const char** atts)
         this->ReadAsTransformToParent = 0;
       }
     }
+    else if (!strcmp(attName, "cacheInverseDisplacementField"))
+    {
+      this->SetCacheInverseDisplacementField(!strcmp(attValue, "true"));
+    }
+    else if (!strcmp(attName, "inverseDisplacementFieldMaximumNumberOfIterations"))
+    {
+      this->SetInverseDisplacementFieldMaximumNumberOfIterations(atoi(attValue));
+    }
+    else if (!strcmp(attName, "inverseDisplacementFieldTolerance"))
+    {
+      this->SetInverseDisplacementFieldTolerance(atof(attValue));
+    }
   }
 
   this->EndModify(disabledModify);
@@ -341,6 +448,10 @@ void vtkMRMLTransformNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /*=true
   // copy the center of transformation
   this->SetCenterOfTransformation(node->GetCenterOfTransformation());
 
+  this->SetInverseDisplacementFieldMaximumNumberOfIterations(node->GetInverseDisplacementFieldMaximumNumberOfIterations());
+  this->SetInverseDisplacementFieldTolerance(node->GetInverseDisplacementFieldTolerance());
+  this->SetCacheInverseDisplacementField(node->GetCacheInverseDisplacementField());
+
   this->Modified();
   this->TransformModified();
 }
@@ -350,6 +461,14 @@ void vtkMRMLTransformNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "ReadAsTransformToParent: " << this->ReadAsTransformToParent << "\n";
+  os << indent << "CacheInverseDisplacementField: " << (this->CacheInverseDisplacementField ? "true" : "false") << "\n";
+  os << indent << "InverseDisplacementFieldMaximumNumberOfIterations: " << this->InverseDisplacementFieldMaximumNumberOfIterations << "\n";
+  os << indent << "InverseDisplacementFieldTolerance: " << this->InverseDisplacementFieldTolerance << "\n";
+  if (this->CachedInverseDisplacementField)
+  {
+    os << indent << "InverseDisplacementFieldMaximumError: " << this->InverseDisplacementFieldMaximumError << "\n";
+    os << indent << "InverseDisplacementFieldNumberOfInvalidPoints: " << this->InverseDisplacementFieldNumberOfInvalidPoints << "\n";
+  }
 
   // Flatten the transform list to make the copying simpler
   if (this->TransformToParent)
@@ -541,7 +660,7 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     // traverse the transform tree from bottom to top, from sourceNode to targetNode
     for (vtkMRMLTransformNode* current = sourceNode; current != targetNode; current = current->GetParentTransformNode())
     {
-      vtkAbstractTransform* transformToParent = current->GetTransformToParent();
+      vtkAbstractTransform* transformToParent = current->GetTransformToParentForEvaluation();
       if (transformToParent)
       {
         transformSourceToTarget->Concatenate(transformToParent);
@@ -560,13 +679,16 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
   }
   else if (sourceNode == nullptr || sourceNode->IsTransformNodeMyChild(targetNode))
   {
-    // traverse the transform tree from bottom to top, from targetNode to sourceNode
+    // traverse the transform tree from bottom to top, from targetNode to sourceNode.
+    // Transforms from parent are pre-multiplied (instead of inverting the concatenated transforms to parent)
+    // so that cached inverse displacement fields can be used.
+    transformSourceToTarget->PreMultiply();
     for (vtkMRMLTransformNode* current = targetNode; current != sourceNode; current = current->GetParentTransformNode())
     {
-      vtkAbstractTransform* transformToParent = current->GetTransformToParent();
-      if (transformToParent)
+      vtkAbstractTransform* transformFromParent = current->GetTransformFromParentForEvaluation();
+      if (transformFromParent)
       {
-        transformSourceToTarget->Concatenate(transformToParent);
+        transformSourceToTarget->Concatenate(transformFromParent);
       }
 
       ++currentDepth;
@@ -579,9 +701,7 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
         break;
       }
     }
-    // in transformSourceToTarget we have transform targetNode->sourceNode,
-    // need to invert to get sourceNode->targetNode
-    transformSourceToTarget->Inverse();
+    transformSourceToTarget->PostMultiply();
   }
   else
   {
@@ -590,8 +710,7 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     sourceNode->GetTransformToNode(firstCommonParentNode, transformSourceToTarget);
 
     vtkNew<vtkGeneralTransform> transformFromCommonParentNode;
-    targetNode->GetTransformToNode(firstCommonParentNode, transformFromCommonParentNode.GetPointer());
-    transformFromCommonParentNode->Inverse();
+    targetNode->GetTransformFromNode(firstCommonParentNode, transformFromCommonParentNode.GetPointer());
 
     transformSourceToTarget->Concatenate(transformFromCommonParentNode.GetPointer());
   }
@@ -1762,3 +1881,263 @@ void vtkMRMLTransformNode::SetCenterOfTransformation(const double center[3])
 {
   this->SetCenterOfTransformation(center[0], center[1], center[2]);
 }
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetCacheInverseDisplacementField(bool enable)
+{
+  if (this->CacheInverseDisplacementField == enable)
+  {
+    return;
+  }
+  this->CacheInverseDisplacementField = enable;
+  if (!enable)
+  {
+    // Release memory
+    this->CachedInverseDisplacementField = nullptr;
+    this->CachedInverseDisplacementFieldSource = nullptr;
+  }
+  this->Modified();
+  this->TransformModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetInverseDisplacementFieldMaximumNumberOfIterations(int maximumNumberOfIterations)
+{
+  maximumNumberOfIterations = std::max(1, std::min(maximumNumberOfIterations, 1000));
+  if (this->InverseDisplacementFieldMaximumNumberOfIterations == maximumNumberOfIterations)
+  {
+    return;
+  }
+  this->InverseDisplacementFieldMaximumNumberOfIterations = maximumNumberOfIterations;
+  this->InverseDisplacementFieldParametersTime.Modified();
+  this->Modified();
+  if (this->CacheInverseDisplacementField)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetInverseDisplacementFieldTolerance(double tolerance)
+{
+  if (this->InverseDisplacementFieldTolerance == tolerance)
+  {
+    return;
+  }
+  this->InverseDisplacementFieldTolerance = tolerance;
+  this->InverseDisplacementFieldParametersTime.Modified();
+  this->Modified();
+  if (this->CacheInverseDisplacementField)
+  {
+    this->TransformModified();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetCachedInverseDisplacementField()
+{
+  if (!this->CacheInverseDisplacementField)
+  {
+    return nullptr;
+  }
+  // Only a transform that is specified in one direction has to be inverted
+  vtkAbstractTransform* forwardTransform = nullptr;
+  if (this->TransformToParent && !this->TransformFromParent)
+  {
+    forwardTransform = this->TransformToParent;
+  }
+  else if (this->TransformFromParent && !this->TransformToParent)
+  {
+    forwardTransform = this->TransformFromParent;
+  }
+  if (!forwardTransform || vtkMRMLTransformNode::IsGeneralTransformLinear(forwardTransform))
+  {
+    return nullptr;
+  }
+
+  forwardTransform->Update();
+  if (this->CachedInverseDisplacementField                                //
+      && this->CachedInverseDisplacementFieldSource == forwardTransform //
+      && forwardTransform->GetMTime() < this->CachedInverseDisplacementFieldTime.GetMTime()
+      && this->InverseDisplacementFieldParametersTime.GetMTime() < this->CachedInverseDisplacementFieldTime.GetMTime())
+  {
+    // Cached inverse is up-to-date
+    return this->CachedInverseDisplacementField;
+  }
+
+  int dimensions[3] = { 0, 0, 0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  vtkNew<vtkMatrix4x4> direction;
+  if (!GetInverseDisplacementFieldGeometry(forwardTransform, dimensions, origin, spacing, direction))
+  {
+    vtkDebugMacro("GetCachedInverseDisplacementField: inverse displacement field is only computed for grid and B-spline transforms");
+    this->CachedInverseDisplacementField = nullptr;
+    this->CachedInverseDisplacementFieldSource = nullptr;
+    return nullptr;
+  }
+
+  vtkNew<vtkImageData> displacementField;
+  displacementField->SetDimensions(dimensions);
+  displacementField->SetOrigin(origin);
+  displacementField->SetSpacing(spacing);
+  displacementField->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(displacementField->GetScalarPointer());
+
+  // Grid index to physical position
+  double indexToPosition[3][3] = { { 0.0 } };
+  for (int row = 0; row < 3; row++)
+  {
+    for (int col = 0; col < 3; col++)
+    {
+      indexToPosition[row][col] = direction->GetElement(row, col) * spacing[col];
+    }
+  }
+
+  // The iterative inverse of the transform is used for points where the fixed-point iteration does not converge
+  vtkAbstractTransform* iterativeInverseTransform = forwardTransform->GetInverse();
+  iterativeInverseTransform->Update();
+
+  const int maximumNumberOfIterations = this->InverseDisplacementFieldMaximumNumberOfIterations;
+  const double tolerance2 = this->InverseDisplacementFieldTolerance * this->InverseDisplacementFieldTolerance;
+  std::vector<double> sliceMaximumError2(dimensions[2], 0.0);
+  std::vector<vtkIdType> sliceNumberOfInvalidPoints(dimensions[2], 0);
+
+  // Transforms are updated already, therefore InternalTransformPoint can be called from multiple threads
+  vtkSMPTools::For(0,
+                   dimensions[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+                     {
+                       double* displacement = displacements + 3 * k * dimensions[0] * dimensions[1];
+                       for (int j = 0; j < dimensions[1]; ++j)
+                       {
+                         for (int i = 0; i < dimensions[0]; ++i, displacement += 3)
+                         {
+                           double targetPosition[3] = { 0.0, 0.0, 0.0 };
+                           for (int row = 0; row < 3; row++)
+                           {
+                             targetPosition[row] = origin[row] + indexToPosition[row][0] * i + indexToPosition[row][1] * j + indexToPosition[row][2] * k;
+                           }
+
+                           // Find position that the forward transform maps to the target position.
+                           // Fixed-point iteration: position = targetPosition - forwardDisplacement(position)
+                           double position[3] = { targetPosition[0], targetPosition[1], targetPosition[2] };
+                           double bestPosition[3] = { position[0], position[1], position[2] };
+                           double bestError2 = VTK_DOUBLE_MAX;
+                           for (int iteration = 0; iteration < maximumNumberOfIterations; ++iteration)
+                           {
+                             double transformedPosition[3] = { 0.0, 0.0, 0.0 };
+                             forwardTransform->InternalTransformPoint(position, transformedPosition);
+                             double residual[3] = { transformedPosition[0] - targetPosition[0],
+                                                    transformedPosition[1] - targetPosition[1],
+                                                    transformedPosition[2] - targetPosition[2] };
+                             double error2 = residual[0] * residual[0] + residual[1] * residual[1] + residual[2] * residual[2];
+                             if (error2 < bestError2)
+                             {
+                               bestError2 = error2;
+                               bestPosition[0] = position[0];
+                               bestPosition[1] = position[1];
+                               bestPosition[2] = position[2];
+                             }
+                             if (error2 <= tolerance2 || !std::isfinite(error2))
+                             {
+                               break;
+                             }
+                             position[0] -= residual[0];
+                             position[1] -= residual[1];
+                             position[2] -= residual[2];
+                           }
+                           if (bestError2 > tolerance2)
+                           {
+                             // Not converged, use the slower iterative inverse of the transform
+                             double inversePosition[3] = { 0.0, 0.0, 0.0 };
+                             iterativeInverseTransform->InternalTransformPoint(targetPosition, inversePosition);
+                             double transformedPosition[3] = { 0.0, 0.0, 0.0 };
+                             forwardTransform->InternalTransformPoint(inversePosition, transformedPosition);
+                             double error2 = vtkMath::Distance2BetweenPoints(transformedPosition, targetPosition);
+                             if (error2 < bestError2)
+                             {
+                               bestError2 = error2;
+                               bestPosition[0] = inversePosition[0];
+                               bestPosition[1] = inversePosition[1];
+                               bestPosition[2] = inversePosition[2];
+                             }
+                             if (bestError2 > tolerance2)
+                             {
+                               sliceNumberOfInvalidPoints[k]++;
+                             }
+                           }
+                           sliceMaximumError2[k] = std::max(sliceMaximumError2[k], bestError2);
+                           displacement[0] = bestPosition[0] - targetPosition[0];
+                           displacement[1] = bestPosition[1] - targetPosition[1];
+                           displacement[2] = bestPosition[2] - targetPosition[2];
+                         }
+                       }
+                     }
+                   });
+
+  double maximumError2 = 0.0;
+  vtkIdType numberOfInvalidPoints = 0;
+  for (int k = 0; k < dimensions[2]; ++k)
+  {
+    maximumError2 = std::max(maximumError2, sliceMaximumError2[k]);
+    numberOfInvalidPoints += sliceNumberOfInvalidPoints[k];
+  }
+  this->InverseDisplacementFieldMaximumError = sqrt(maximumError2);
+  this->InverseDisplacementFieldNumberOfInvalidPoints = numberOfInvalidPoints;
+  if (numberOfInvalidPoints > 0)
+  {
+    vtkWarningMacro("GetCachedInverseDisplacementField: inverse could not be computed within " << this->InverseDisplacementFieldTolerance << " mm tolerance at "
+                                                                                                << numberOfInvalidPoints << " points of " << displacementField->GetNumberOfPoints()
+                                                                                                << " (maximum error: " << this->InverseDisplacementFieldMaximumError << " mm)");
+  }
+
+  // Update the existing grid transform (instead of creating a new one) so that transforms
+  // that already use the cached inverse will use the updated displacement field.
+  vtkOrientedGridTransform* inverseTransform = vtkOrientedGridTransform::SafeDownCast(this->CachedInverseDisplacementField);
+  if (!inverseTransform)
+  {
+    this->CachedInverseDisplacementField = vtkSmartPointer<vtkOrientedGridTransform>::New();
+    inverseTransform = vtkOrientedGridTransform::SafeDownCast(this->CachedInverseDisplacementField);
+  }
+  inverseTransform->SetInterpolationModeToLinear();
+  inverseTransform->SetDisplacementScale(1.0);
+  inverseTransform->SetDisplacementShift(0.0);
+  inverseTransform->SetGridDirectionMatrix(direction);
+  inverseTransform->SetDisplacementGridData(displacementField);
+  inverseTransform->Update();
+
+  this->CachedInverseDisplacementFieldSource = forwardTransform;
+  this->CachedInverseDisplacementFieldTime.Modified();
+  return this->CachedInverseDisplacementField;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetTransformToParentForEvaluation()
+{
+  if (this->CacheInverseDisplacementField && !this->TransformToParent && this->TransformFromParent)
+  {
+    vtkAbstractTransform* cachedInverse = this->GetCachedInverseDisplacementField();
+    if (cachedInverse)
+    {
+      return cachedInverse;
+    }
+  }
+  return this->GetTransformToParent();
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetTransformFromParentForEvaluation()
+{
+  if (this->CacheInverseDisplacementField && !this->TransformFromParent && this->TransformToParent)
+  {
+    vtkAbstractTransform* cachedInverse = this->GetCachedInverseDisplacementField();
+    if (cachedInverse)
+    {
+      return cachedInverse;
+    }
+  }
+  return this->GetTransformFromParent();
+}
@@ -17,6 +17,10 @@
 
 #include "vtkMRMLDisplayableNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
 class vtkCollection;
 class vtkAbstractTransform;
 class vtkGeneralTransform;
@@ -361,6 +365,43 @@ public:
   virtual void SetCenterOfTransformation(const double xyz[3]);
   vtkGetVector3Macro(CenterOfTransformation, double);
 
+  /// Enable caching the inverse of a non-linear transform as a displacement field.
+  /// Non-linear transforms are usually specified in one direction only. By default the transform
+  /// in the other direction is computed by iterative inversion at each transformed point, which is slow
+  /// when many points are transformed (reslicing, hardening transforms, transforming markups).
+  /// If caching is enabled then the inverse is computed once at all points of a displacement field
+  /// and transforms returned by GetTransformToWorld, GetTransformFromWorld, GetTransformBetweenNodes, etc.
+  /// evaluate the inverse by trilinear interpolation in this field.
+  /// The cached field is recomputed when the forward transform is modified.
+  /// Caching is only supported if the forward transform is a single grid or B-spline transform,
+  /// for other transforms the iterative inverse is used.
+  /// Default is off.
+  vtkGetMacro(CacheInverseDisplacementField, bool);
+  void SetCacheInverseDisplacementField(bool enable);
+  vtkBooleanMacro(CacheInverseDisplacementField, bool);
+
+  /// Maximum number of fixed-point iterations for computing the inverse at each point of the cached displacement field.
+  /// If the inverse does not converge in this many iterations then the point is computed using
+  /// the slower iterative inversion method of the transform. Default is 20.
+  void SetInverseDisplacementFieldMaximumNumberOfIterations(int maximumNumberOfIterations);
+  vtkGetMacro(InverseDisplacementFieldMaximumNumberOfIterations, int);
+
+  /// Maximum distance (in mm) between a grid point and the forward-transformed inverse at that point.
+  /// Default is 0.01.
+  void SetInverseDisplacementFieldTolerance(double tolerance);
+  vtkGetMacro(InverseDisplacementFieldTolerance, double);
+
+  /// Get the cached inverse of the transform, as a grid transform. The field is (re)computed if needed.
+  /// The transform is the inverse of the transform that is specified in this node (TransformToParent or TransformFromParent).
+  /// Returns nullptr if caching is disabled, the transform is linear, specified in both directions or not supported.
+  /// The returned transform must not be modified.
+  vtkAbstractTransform* GetCachedInverseDisplacementField();
+
+  /// Maximum inverse error (in mm) at the points of the last computed inverse displacement field.
+  vtkGetMacro(InverseDisplacementFieldMaximumError, double);
+  /// Number of points of the last computed inverse displacement field where the inverse error exceeded the tolerance.
+  vtkGetMacro(InverseDisplacementFieldNumberOfInvalidPoints, vtkIdType);
+
 protected:
   vtkMRMLTransformNode();
   ~vtkMRMLTransformNode() override;
@@ -373,6 +414,13 @@ protected:
   /// transform type then it returns nullptr.
   virtual vtkAbstractTransform* GetAbstractTransformAs(vtkAbstractTransform* inputTransform, const char* transformClassName, bool logErrorIfFails);
 
+  ///
+  /// Get transform to/from parent for transforming points.
+  /// Same as GetTransformToParent/GetTransformFromParent, except that the cached
+  /// inverse displacement field is used if the transform is computed from its inverse.
+  vtkAbstractTransform* GetTransformToParentForEvaluation();
+  vtkAbstractTransform* GetTransformFromParentForEvaluation();
+
   ///
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform* transform);
@@ -398,6 +446,18 @@ protected:
   vtkMatrix4x4* CachedMatrixTransformFromParent;
 
   double CenterOfTransformation[3]{ 0.0, 0.0, 0.0 };
+
+  bool CacheInverseDisplacementField{ false };
+  int InverseDisplacementFieldMaximumNumberOfIterations{ 20 };
+  double InverseDisplacementFieldTolerance{ 0.01 };
+  double InverseDisplacementFieldMaximumError{ 0.0 };
+  vtkIdType InverseDisplacementFieldNumberOfInvalidPoints{ 0 };
+  /// Inverse of CachedInverseDisplacementFieldSource, computed at CachedInverseDisplacementFieldTime
+  vtkSmartPointer<vtkAbstractTransform> CachedInverseDisplacementField;
+  vtkWeakPointer<vtkAbstractTransform> CachedInverseDisplacementFieldSource;
+  vtkTimeStamp CachedInverseDisplacementFieldTime;
+  /// Last time the parameters of the inverse computation were changed
+  vtkTimeStamp InverseDisplacementFieldParametersTime;
 };
 
 #endif
@@ -0,0 +1,187 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkParallelTransformFilter.h"
+
+// MRML includes
+#include "vtkFlattenedTransform.h"
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> CreateOutputArray(vtkDataArray* inputArray, int outputPointsPrecision, vtkIdType numberOfTuples)
+{
+  vtkSmartPointer<vtkDataArray> outputArray;
+  if (outputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION
+      || (outputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION && inputArray->GetDataType() == VTK_DOUBLE))
+  {
+    outputArray = vtkSmartPointer<vtkDoubleArray>::New();
+  }
+  else
+  {
+    outputArray = vtkSmartPointer<vtkFloatArray>::New();
+  }
+  outputArray->SetName(inputArray->GetName());
+  outputArray->SetNumberOfComponents(3);
+  outputArray->SetNumberOfTuples(numberOfTuples);
+  return outputArray;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkParallelTransformFilter);
+
+//----------------------------------------------------------------------------
+vtkParallelTransformFilter::vtkParallelTransformFilter() = default;
+
+//----------------------------------------------------------------------------
+vtkParallelTransformFilter::~vtkParallelTransformFilter() = default;
+
+//----------------------------------------------------------------------------
+void vtkParallelTransformFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ParallelExecution: " << (this->ParallelExecution ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkParallelTransformFilter::RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  this->ParallelExecution = false;
+  vtkPointSet* input = vtkPointSet::GetData(inputVector[0]);
+  vtkPointSet* output = vtkPointSet::GetData(outputVector);
+  vtkAbstractTransform* transform = this->GetTransform();
+  if (!input || !output || !transform || !input->GetPoints() || this->GetTransformAllInputVectors() || vtkMRMLTransformNode::IsGeneralTransformLinear(transform))
+  {
+    // Linear transforms are already computed efficiently by vtkTransformFilter
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+  vtkNew<vtkFlattenedTransform> flattenedTransform;
+  flattenedTransform->SetTransform(transform);
+  this->ParallelExecution = true;
+
+  output->CopyStructure(input);
+
+  vtkPoints* inputPoints = input->GetPoints();
+  const vtkIdType numberOfPoints = inputPoints->GetNumberOfPoints();
+  vtkNew<vtkPoints> outputPoints;
+  if (this->GetOutputPointsPrecision() == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    outputPoints->SetDataType(VTK_FLOAT);
+  }
+  else if (this->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    outputPoints->SetDataType(VTK_DOUBLE);
+  }
+  else
+  {
+    outputPoints->SetDataType(inputPoints->GetDataType());
+  }
+  outputPoints->SetNumberOfPoints(numberOfPoints);
+
+  vtkPointData* inputPointData = input->GetPointData();
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkDataArray* inputNormals = inputPointData->GetNormals();
+  vtkDataArray* inputVectors = inputPointData->GetVectors();
+  vtkSmartPointer<vtkDataArray> outputNormals;
+  vtkSmartPointer<vtkDataArray> outputVectors;
+  if (inputNormals)
+  {
+    outputNormals = CreateOutputArray(inputNormals, this->GetOutputPointsPrecision(), numberOfPoints);
+  }
+  if (inputVectors)
+  {
+    outputVectors = CreateOutputArray(inputVectors, this->GetOutputPointsPrecision(), numberOfPoints);
+  }
+  const bool computeDerivative = (inputNormals || inputVectors);
+
+  vtkDataArray* outputNormalsPtr = outputNormals;
+  vtkDataArray* outputVectorsPtr = outputVectors;
+  const vtkFlattenedTransform* flattenedTransformPtr = flattenedTransform;
+  vtkSMPTools::For(0,
+                   numberOfPoints,
+                   [&](vtkIdType firstPointId, vtkIdType lastPointId)
+                   {
+                     double point[3] = { 0.0, 0.0, 0.0 };
+                     double derivative[3][3] = { { 0.0 } };
+                     double inverseTransposeDerivative[3][3] = { { 0.0 } };
+                     double tuple[3] = { 0.0, 0.0, 0.0 };
+                     for (vtkIdType pointId = firstPointId; pointId < lastPointId; ++pointId)
+                     {
+                       inputPoints->GetPoint(pointId, point);
+                       if (!computeDerivative)
+                       {
+                         flattenedTransformPtr->TransformPoint(point, point);
+                         outputPoints->SetPoint(pointId, point);
+                         continue;
+                       }
+                       flattenedTransformPtr->TransformPointDerivative(point, point, derivative);
+                       outputPoints->SetPoint(pointId, point);
+                       if (inputVectors)
+                       {
+                         inputVectors->GetTuple(pointId, tuple);
+                         vtkMath::Multiply3x3(derivative, tuple, tuple);
+                         outputVectorsPtr->SetTuple(pointId, tuple);
+                       }
+                       if (inputNormals)
+                       {
+                         // Normals are transformed by the inverse transpose of the derivative
+                         inputNormals->GetTuple(pointId, tuple);
+                         vtkMath::Transpose3x3(derivative, inverseTransposeDerivative);
+                         vtkMath::LinearSolve3x3(inverseTransposeDerivative, tuple, tuple);
+                         vtkMath::Normalize(tuple);
+                         outputNormalsPtr->SetTuple(pointId, tuple);
+                       }
+                     }
+                   });
+
+  output->SetPoints(outputPoints);
+  if (outputNormals)
+  {
+    outputPointData->SetNormals(outputNormals);
+    outputPointData->CopyNormalsOff();
+  }
+  if (outputVectors)
+  {
+    outputPointData->SetVectors(outputVectors);
+    outputPointData->CopyVectorsOff();
+  }
+  outputPointData->PassData(inputPointData);
+  // Cell normals and vectors can only be transformed by linear transforms (same as in vtkTransformFilter)
+  output->GetCellData()->PassData(input->GetCellData());
+  output->GetFieldData()->PassData(input->GetFieldData());
+
+  return 1;
+}
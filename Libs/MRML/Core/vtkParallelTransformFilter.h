@@ -0,0 +1,63 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkParallelTransformFilter_h
+#define __vtkParallelTransformFilter_h
+
+// VTK includes
+#include <vtkTransformFilter.h>
+
+// MRML includes
+#include "vtkMRML.h"
+
+/// \brief Transform points, normals, and vectors of a point set using multiple threads.
+///
+/// Drop-in replacement for vtkTransformFilter that is optimized for transforming large meshes
+/// with non-linear transforms (for example, when hardening a grid transform on a model).
+/// vtkTransformFilter pushes each point through the transform hierarchy on a single thread.
+/// This filter flattens the transform once (using vtkFlattenedTransform) and then transforms
+/// chunks of points in parallel (using vtkSMPTools).
+///
+/// Transform derivatives are only computed if the input has point normals or vectors,
+/// because they are not needed for transforming points.
+///
+/// Linear transforms, inputs that are not vtkPointSet, and TransformAllInputVectors mode
+/// are processed by vtkTransformFilter.
+class VTK_MRML_EXPORT vtkParallelTransformFilter : public vtkTransformFilter
+{
+public:
+  static vtkParallelTransformFilter* New();
+  vtkTypeMacro(vtkParallelTransformFilter, vtkTransformFilter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Returns true if the last execution used the parallel implementation.
+  vtkGetMacro(ParallelExecution, bool);
+
+protected:
+  vtkParallelTransformFilter();
+  ~vtkParallelTransformFilter() override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  bool ParallelExecution{ false };
+
+private:
+  vtkParallelTransformFilter(const vtkParallelTransformFilter&) = delete;
+  void operator=(const vtkParallelTransformFilter&) = delete;
+};
+
+#endif
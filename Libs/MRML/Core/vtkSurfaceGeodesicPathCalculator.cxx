@@ -0,0 +1,474 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkSurfaceGeodesicPathCalculator.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkStaticPointLocator.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSurfaceGeodesicPathCalculator);
+
+//----------------------------------------------------------------------------
+class vtkSurfaceGeodesicPathCalculator::vtkInternal
+{
+public:
+  /// Working memory of a single search.
+  /// Entries are only valid for vertices that have the current stamp, which allows
+  /// starting a new search without resetting the arrays of the entire mesh.
+  struct SearchWorkspace
+  {
+    std::vector<double> Cost;
+    std::vector<vtkIdType> Predecessor;
+    std::vector<unsigned int> VisitedStamp;
+    std::vector<unsigned int> FinalizedStamp;
+    unsigned int CurrentStamp{ 0 };
+    vtkIdType NumberOfVisitedVertices{ 0 };
+
+    void StartSearch(vtkIdType numberOfVertices)
+    {
+      if (static_cast<vtkIdType>(this->Cost.size()) != numberOfVertices)
+      {
+        this->Cost.assign(numberOfVertices, 0.0);
+        this->Predecessor.assign(numberOfVertices, -1);
+        this->VisitedStamp.assign(numberOfVertices, 0);
+        this->FinalizedStamp.assign(numberOfVertices, 0);
+        this->CurrentStamp = 0;
+      }
+      ++this->CurrentStamp;
+      if (this->CurrentStamp == 0)
+      {
+        // stamp counter wrapped around, old stamps must be cleared
+        std::fill(this->VisitedStamp.begin(), this->VisitedStamp.end(), 0);
+        std::fill(this->FinalizedStamp.begin(), this->FinalizedStamp.end(), 0);
+        this->CurrentStamp = 1;
+      }
+      this->NumberOfVisitedVertices = 0;
+    }
+  };
+
+  void ClearGraph()
+  {
+    this->Coordinates.clear();
+    this->EdgeOffsets.clear();
+    this->EdgeTargets.clear();
+    this->EdgeLengths.clear();
+    this->NumberOfVertices = 0;
+    this->GraphSurface = nullptr;
+    this->GraphBuilt = false;
+  }
+
+  //----------------------------------------------------------------------------
+  static void AddCellEdges(vtkCellArray* cells, int cellType, std::vector<std::pair<vtkIdType, vtkIdType>>& edges)
+  {
+    if (!cells)
+    {
+      return;
+    }
+    auto addEdge = [&edges](vtkIdType a, vtkIdType b)
+    {
+      if (a != b)
+      {
+        edges.emplace_back(std::min(a, b), std::max(a, b));
+      }
+    };
+    vtkIdType npts = 0;
+    const vtkIdType* pts = nullptr;
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts);)
+    {
+      for (vtkIdType i = 0; i + 1 < npts; ++i)
+      {
+        addEdge(pts[i], pts[i + 1]);
+        if (cellType == VTK_TRIANGLE_STRIP && i + 2 < npts)
+        {
+          addEdge(pts[i], pts[i + 2]);
+        }
+      }
+      if (cellType == VTK_POLYGON && npts > 2)
+      {
+        addEdge(pts[npts - 1], pts[0]);
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void BuildGraph(vtkPolyData* surface)
+  {
+    this->ClearGraph();
+    vtkPoints* points = surface->GetPoints();
+    this->NumberOfVertices = (points ? points->GetNumberOfPoints() : 0);
+    this->Coordinates.resize(3 * this->NumberOfVertices);
+    for (vtkIdType pointId = 0; pointId < this->NumberOfVertices; ++pointId)
+    {
+      points->GetPoint(pointId, &this->Coordinates[3 * pointId]);
+    }
+
+    // Collect unique undirected edges
+    std::vector<std::pair<vtkIdType, vtkIdType>> edges;
+    AddCellEdges(surface->GetPolys(), VTK_POLYGON, edges);
+    AddCellEdges(surface->GetStrips(), VTK_TRIANGLE_STRIP, edges);
+    AddCellEdges(surface->GetLines(), VTK_POLY_LINE, edges);
+    vtkSMPTools::Sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    this->NumberOfEdges = static_cast<vtkIdType>(edges.size());
+
+    // Store the graph in compressed sparse row format (each edge is stored in both directions)
+    this->EdgeOffsets.assign(this->NumberOfVertices + 1, 0);
+    for (const auto& edge : edges)
+    {
+      ++this->EdgeOffsets[edge.first + 1];
+      ++this->EdgeOffsets[edge.second + 1];
+    }
+    for (vtkIdType vertexId = 0; vertexId < this->NumberOfVertices; ++vertexId)
+    {
+      this->EdgeOffsets[vertexId + 1] += this->EdgeOffsets[vertexId];
+    }
+    this->EdgeTargets.resize(2 * edges.size());
+    this->EdgeLengths.resize(2 * edges.size());
+    std::vector<vtkIdType> insertPosition(this->EdgeOffsets.begin(), this->EdgeOffsets.end() - 1);
+    for (const auto& edge : edges)
+    {
+      double length = sqrt(vtkMath::Distance2BetweenPoints(&this->Coordinates[3 * edge.first], &this->Coordinates[3 * edge.second]));
+      vtkIdType firstPosition = insertPosition[edge.first]++;
+      this->EdgeTargets[firstPosition] = edge.second;
+      this->EdgeLengths[firstPosition] = length;
+      vtkIdType secondPosition = insertPosition[edge.second]++;
+      this->EdgeTargets[secondPosition] = edge.first;
+      this->EdgeLengths[secondPosition] = length;
+    }
+
+    if (this->NumberOfVertices > 0)
+    {
+      this->PointLocator->SetDataSet(surface);
+      this->PointLocator->BuildLocator();
+    }
+    this->GraphSurface = surface;
+    this->GraphBuilt = true;
+    this->GraphBuildTime.Modified();
+  }
+
+  //----------------------------------------------------------------------------
+  /// Thread-safe path search, the graph must be already built.
+  bool Search(SearchWorkspace& workspace, vtkIdType startVertexId, vtkIdType endVertexId, bool useDistanceHeuristic, std::vector<vtkIdType>& path, double& pathLength) const
+  {
+    path.clear();
+    pathLength = 0.0;
+    workspace.StartSearch(this->NumberOfVertices);
+    const unsigned int stamp = workspace.CurrentStamp;
+    const double* endPoint = &this->Coordinates[3 * endVertexId];
+    auto heuristic = [&](vtkIdType vertexId)
+    { return useDistanceHeuristic ? sqrt(vtkMath::Distance2BetweenPoints(&this->Coordinates[3 * vertexId], endPoint)) : 0.0; };
+
+    typedef std::pair<double, vtkIdType> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    workspace.Cost[startVertexId] = 0.0;
+    workspace.Predecessor[startVertexId] = -1;
+    workspace.VisitedStamp[startVertexId] = stamp;
+    queue.emplace(heuristic(startVertexId), startVertexId);
+    bool found = false;
+    while (!queue.empty())
+    {
+      vtkIdType vertexId = queue.top().second;
+      queue.pop();
+      if (workspace.FinalizedStamp[vertexId] == stamp)
+      {
+        // outdated queue entry
+        continue;
+      }
+      workspace.FinalizedStamp[vertexId] = stamp;
+      ++workspace.NumberOfVisitedVertices;
+      if (vertexId == endVertexId)
+      {
+        found = true;
+        break;
+      }
+      double vertexCost = workspace.Cost[vertexId];
+      for (vtkIdType edgeIndex = this->EdgeOffsets[vertexId]; edgeIndex < this->EdgeOffsets[vertexId + 1]; ++edgeIndex)
+      {
+        vtkIdType neighborId = this->EdgeTargets[edgeIndex];
+        if (workspace.FinalizedStamp[neighborId] == stamp)
+        {
+          continue;
+        }
+        double neighborCost = vertexCost + this->EdgeLengths[edgeIndex];
+        if (workspace.VisitedStamp[neighborId] != stamp || neighborCost < workspace.Cost[neighborId])
+        {
+          workspace.VisitedStamp[neighborId] = stamp;
+          workspace.Cost[neighborId] = neighborCost;
+          workspace.Predecessor[neighborId] = vertexId;
+          queue.emplace(neighborCost + heuristic(neighborId), neighborId);
+        }
+      }
+    }
+    if (!found)
+    {
+      return false;
+    }
+    for (vtkIdType vertexId = endVertexId; vertexId >= 0; vertexId = workspace.Predecessor[vertexId])
+    {
+      path.push_back(vertexId);
+    }
+    std::reverse(path.begin(), path.end());
+    pathLength = workspace.Cost[endVertexId];
+    return true;
+  }
+
+  // Graph
+  std::vector<double> Coordinates;
+  std::vector<vtkIdType> EdgeOffsets;
+  std::vector<vtkIdType> EdgeTargets;
+  std::vector<double> EdgeLengths;
+  vtkIdType NumberOfVertices{ 0 };
+  vtkIdType NumberOfEdges{ 0 };
+  vtkPolyData* GraphSurface{ nullptr };
+  bool GraphBuilt{ false };
+  vtkTimeStamp GraphBuildTime;
+  vtkNew<vtkStaticPointLocator> PointLocator;
+
+  // Search
+  SearchWorkspace Workspace;
+  vtkSMPThreadLocal<SearchWorkspace> ThreadWorkspaces;
+};
+
+//----------------------------------------------------------------------------
+vtkSurfaceGeodesicPathCalculator::vtkSurfaceGeodesicPathCalculator()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkSurfaceGeodesicPathCalculator::~vtkSurfaceGeodesicPathCalculator()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceGeodesicPathCalculator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseDistanceHeuristic: " << this->UseDistanceHeuristic << "\n";
+  os << indent << "NumberOfVertices: " << this->Internal->NumberOfVertices << "\n";
+  os << indent << "NumberOfEdges: " << this->Internal->NumberOfEdges << "\n";
+  os << indent << "NumberOfVisitedVertices: " << this->Internal->Workspace.NumberOfVisitedVertices << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceGeodesicPathCalculator::SetSurface(vtkPolyData* surface)
+{
+  if (this->Surface == surface)
+  {
+    return;
+  }
+  this->Surface = surface;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkSurfaceGeodesicPathCalculator::GetSurface()
+{
+  return this->Surface;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSurfaceGeodesicPathCalculator::IsGraphUpToDate()
+{
+  return this->Surface && this->Internal->GraphBuilt                //
+         && this->Internal->GraphSurface == this->Surface.GetPointer() //
+         && this->Internal->GraphBuildTime.GetMTime() > this->Surface->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkSurfaceGeodesicPathCalculator::BuildGraph()
+{
+  if (this->IsGraphUpToDate())
+  {
+    return;
+  }
+  if (!this->Surface)
+  {
+    this->Internal->ClearGraph();
+    return;
+  }
+  this->Internal->BuildGraph(this->Surface);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSurfaceGeodesicPathCalculator::GetNumberOfVertices()
+{
+  this->BuildGraph();
+  return this->Internal->NumberOfVertices;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSurfaceGeodesicPathCalculator::GetNumberOfEdges()
+{
+  this->BuildGraph();
+  return this->Internal->NumberOfEdges;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSurfaceGeodesicPathCalculator::GetNumberOfVisitedVertices()
+{
+  return this->Internal->Workspace.NumberOfVisitedVertices;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSurfaceGeodesicPathCalculator::FindClosestVertex(const double position[3])
+{
+  this->BuildGraph();
+  if (this->Internal->NumberOfVertices < 1)
+  {
+    return -1;
+  }
+  return this->Internal->PointLocator->FindClosestPoint(position);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSurfaceGeodesicPathCalculator::ComputePath(vtkIdType startVertexId, vtkIdType endVertexId, vtkIdList* pathVertexIds, double* pathLength /*=nullptr*/)
+{
+  if (!pathVertexIds)
+  {
+    vtkErrorMacro("ComputePath failed: invalid output vertex list");
+    return false;
+  }
+  pathVertexIds->Reset();
+  this->BuildGraph();
+  if (startVertexId < 0 || startVertexId >= this->Internal->NumberOfVertices //
+      || endVertexId < 0 || endVertexId >= this->Internal->NumberOfVertices)
+  {
+    vtkErrorMacro("ComputePath failed: vertex index is out of range");
+    return false;
+  }
+  std::vector<vtkIdType> path;
+  double length = 0.0;
+  if (!this->Internal->Search(this->Internal->Workspace, startVertexId, endVertexId, this->UseDistanceHeuristic, path, length))
+  {
+    return false;
+  }
+  pathVertexIds->SetNumberOfIds(static_cast<vtkIdType>(path.size()));
+  std::copy(path.begin(), path.end(), pathVertexIds->GetPointer(0));
+  if (pathLength)
+  {
+    *pathLength = length;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSurfaceGeodesicPathCalculator::ComputePathThroughPoints(vtkPoints* points, bool closedCurve, vtkPoints* pathPoints, vtkDoubleArray* pedigreeIds /*=nullptr*/)
+{
+  if (!points || !pathPoints)
+  {
+    vtkErrorMacro("ComputePathThroughPoints failed: invalid input or output points");
+    return false;
+  }
+  pathPoints->Reset();
+  if (pedigreeIds)
+  {
+    pedigreeIds->SetNumberOfComponents(1);
+    pedigreeIds->Reset();
+  }
+  this->BuildGraph();
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  if (this->Internal->NumberOfVertices < 1 || numberOfPoints < 1)
+  {
+    return false;
+  }
+
+  std::vector<vtkIdType> vertexIds(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    vertexIds[pointIndex] = this->Internal->PointLocator->FindClosestPoint(points->GetPoint(pointIndex));
+  }
+
+  // Compute the path segments in parallel
+  vtkIdType numberOfSegments = (closedCurve && numberOfPoints > 1 ? numberOfPoints : numberOfPoints - 1);
+  std::vector<std::vector<vtkIdType>> segmentPaths(numberOfSegments);
+  std::vector<unsigned char> segmentFound(numberOfSegments, 0);
+  const vtkInternal* internal = this->Internal;
+  vtkSMPThreadLocal<vtkInternal::SearchWorkspace>& threadWorkspaces = this->Internal->ThreadWorkspaces;
+  bool useDistanceHeuristic = this->UseDistanceHeuristic;
+  vtkSMPTools::For(0,
+                   numberOfSegments,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     vtkInternal::SearchWorkspace& workspace = threadWorkspaces.Local();
+                     double length = 0.0;
+                     for (vtkIdType segmentIndex = begin; segmentIndex < end; ++segmentIndex)
+                     {
+                       vtkIdType startVertexId = vertexIds[segmentIndex];
+                       vtkIdType endVertexId = vertexIds[(segmentIndex + 1) % numberOfPoints];
+                       segmentFound[segmentIndex] = internal->Search(workspace, startVertexId, endVertexId, useDistanceHeuristic, segmentPaths[segmentIndex], length);
+                     }
+                   });
+
+  // Concatenate the segments. The last point of each segment is the same as the first point of the next segment,
+  // therefore it is only added for the last segment of open curves.
+  bool success = true;
+  const double* coordinates = this->Internal->Coordinates.data();
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    if (!segmentFound[segmentIndex])
+    {
+      vtkWarningMacro("ComputePathThroughPoints: no path found between points " << segmentIndex << " and " << (segmentIndex + 1) % numberOfPoints);
+      success = false;
+      continue;
+    }
+    const std::vector<vtkIdType>& path = segmentPaths[segmentIndex];
+    std::vector<double> cumulativeLength(path.size(), 0.0);
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+      cumulativeLength[i] = cumulativeLength[i - 1] + sqrt(vtkMath::Distance2BetweenPoints(coordinates + 3 * path[i - 1], coordinates + 3 * path[i]));
+    }
+    double segmentLength = cumulativeLength.back();
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+      pathPoints->InsertNextPoint(coordinates + 3 * path[i]);
+      if (pedigreeIds)
+      {
+        pedigreeIds->InsertNextValue(segmentIndex + (segmentLength > 0.0 ? cumulativeLength[i] / segmentLength : 0.0));
+      }
+    }
+  }
+  if (!closedCurve || numberOfPoints == 1)
+  {
+    pathPoints->InsertNextPoint(coordinates + 3 * vertexIds[numberOfPoints - 1]);
+    if (pedigreeIds)
+    {
+      pedigreeIds->InsertNextValue(static_cast<double>(numberOfPoints - 1));
+    }
+  }
+  pathPoints->Modified();
+  return success;
+}
@@ -0,0 +1,131 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSurfaceGeodesicPathCalculator_h
+#define __vtkSurfaceGeodesicPathCalculator_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// Export
+#include "vtkMRMLExport.h"
+
+class vtkDoubleArray;
+class vtkIdList;
+class vtkPoints;
+class vtkPolyData;
+
+/// \brief Compute shortest paths along the edges of a surface mesh.
+///
+/// The vertex adjacency graph (with edge lengths) and a point locator are built once
+/// for the surface and are reused for all subsequent path queries. They are only rebuilt
+/// when the surface is modified.
+///
+/// Paths are computed using A* search with Euclidean distance to the target vertex as
+/// heuristic. Since the cost of an edge is its length, the heuristic never overestimates
+/// the remaining cost, therefore the found paths are exactly as short as the ones found
+/// by Dijkstra's algorithm, but only a fraction of the mesh is visited.
+/// Per-query working memory is reset incrementally, so the cost of a query does not
+/// depend on the total number of vertices of the surface.
+///
+/// Paths between consecutive points of a curve are independent from each other
+/// and are computed in parallel by ComputePathThroughPoints.
+///
+/// \code
+/// vtkNew<vtkSurfaceGeodesicPathCalculator> calculator;
+/// calculator->SetSurface(surfacePolyData);
+/// vtkNew<vtkPoints> pathPoints;
+/// calculator->ComputePathThroughPoints(controlPoints, false, pathPoints);
+/// \endcode
+class VTK_MRML_EXPORT vtkSurfaceGeodesicPathCalculator : public vtkObject
+{
+public:
+  static vtkSurfaceGeodesicPathCalculator* New();
+  vtkTypeMacro(vtkSurfaceGeodesicPathCalculator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /// Set/Get the surface mesh. Edges of polygon, triangle strip and line cells are used as graph edges.
+  void SetSurface(vtkPolyData* surface);
+  vtkPolyData* GetSurface();
+  //@}
+
+  //@{
+  /// Use Euclidean distance to the end vertex to guide the search (A* search).
+  /// If disabled then the plain Dijkstra's algorithm is used. Result is the same, but the search is slower.
+  /// Enabled by default.
+  vtkSetMacro(UseDistanceHeuristic, bool);
+  vtkGetMacro(UseDistanceHeuristic, bool);
+  vtkBooleanMacro(UseDistanceHeuristic, bool);
+  //@}
+
+  /// Build the graph and the point locator if they are not up-to-date with the surface.
+  /// It is not necessary to call this method explicitly, queries build the graph when needed.
+  void BuildGraph();
+
+  /// Returns true if the graph is built and up-to-date with the surface.
+  bool IsGraphUpToDate();
+
+  /// Get number of vertices of the graph.
+  vtkIdType GetNumberOfVertices();
+
+  /// Get number of (undirected) edges of the graph.
+  vtkIdType GetNumberOfEdges();
+
+  /// Get index of the surface vertex that is closest to the specified position.
+  /// Returns -1 if the surface is empty.
+  vtkIdType FindClosestVertex(const double position[3]);
+
+  /// Compute shortest path between two surface vertices.
+  /// \param startVertexId index of the start vertex
+  /// \param endVertexId index of the end vertex
+  /// \param pathVertexIds output vertex indices along the path (including the start and end vertex)
+  /// \param pathLength optional output length of the path
+  /// \return false if the vertices are not connected.
+  bool ComputePath(vtkIdType startVertexId, vtkIdType endVertexId, vtkIdList* pathVertexIds, double* pathLength = nullptr);
+
+  /// Compute shortest path on the surface that goes through the surface vertices
+  /// closest to the specified points. Path segments between consecutive points are computed in parallel.
+  /// \param points input points (typically curve control points)
+  /// \param closedCurve if true then the path is continued from the last point to the first point
+  /// \param pathPoints output path points
+  /// \param pedigreeIds optional output, contains for each path point the index of the segment
+  ///   start point plus the relative position of the path point along the segment (between 0 and 1).
+  /// \return false if any of the path segments could not be computed.
+  bool ComputePathThroughPoints(vtkPoints* points, bool closedCurve, vtkPoints* pathPoints, vtkDoubleArray* pedigreeIds = nullptr);
+
+  /// Get number of vertices that were visited in the last ComputePath call.
+  /// Useful for measuring the efficiency of the search.
+  vtkIdType GetNumberOfVisitedVertices();
+
+protected:
+  vtkSurfaceGeodesicPathCalculator();
+  ~vtkSurfaceGeodesicPathCalculator() override;
+
+  vtkSmartPointer<vtkPolyData> Surface;
+  bool UseDistanceHeuristic{ true };
+
+private:
+  vtkSurfaceGeodesicPathCalculator(const vtkSurfaceGeodesicPathCalculator&) = delete;
+  void operator=(const vtkSurfaceGeodesicPathCalculator&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
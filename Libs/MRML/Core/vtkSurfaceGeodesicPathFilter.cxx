@@ -0,0 +1,134 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkSurfaceGeodesicPathFilter.h"
+#include "vtkSurfaceGeodesicPathCalculator.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSurfaceGeodesicPathFilter);
+
+//----------------------------------------------------------------------------
+vtkSurfaceGeodesicPathFilter::vtkSurfaceGeodesicPathFilter()
+{
+  this->SetNumberOfInputPorts(2);
+  this->PathCalculator = vtkSmartPointer<vtkSurfaceGeodesicPathCalculator>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkSurfaceGeodesicPathFilter::~vtkSurfaceGeodesicPathFilter() = default;
+
+//----------------------------------------------------------------------------
+void vtkSurfaceGeodesicPathFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CurveIsClosed: " << (this->CurveIsClosed ? "true" : "false") << "\n";
+  os << indent << "PathCalculator:\n";
+  this->PathCalculator->PrintSelf(os, indent.GetNextIndent());
+}
+
+//----------------------------------------------------------------------------
+vtkSurfaceGeodesicPathCalculator* vtkSurfaceGeodesicPathFilter::GetPathCalculator()
+{
+  return this->PathCalculator;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSurfaceGeodesicPathFilter::GetControlPointIdFromInterpolatedPointId(vtkIdType interpolatedPointId)
+{
+  vtkPolyData* output = this->GetOutput();
+  vtkDoubleArray* pedigreeIds = output ? vtkDoubleArray::SafeDownCast(output->GetPointData()->GetArray("PedigreeIDs")) : nullptr;
+  if (!pedigreeIds || interpolatedPointId < 0 || interpolatedPointId >= pedigreeIds->GetNumberOfTuples())
+  {
+    return -1;
+  }
+  return static_cast<vtkIdType>(std::floor(pedigreeIds->GetValue(interpolatedPointId)));
+}
+
+//----------------------------------------------------------------------------
+int vtkSurfaceGeodesicPathFilter::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 0 || port == 1)
+  {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPolyData");
+  }
+  else
+  {
+    vtkErrorMacro("Cannot set input info for port " << port);
+    return 0;
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkSurfaceGeodesicPathFilter::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkPolyData* inputPolyData = vtkPolyData::GetData(inputVector[0]);
+  vtkPolyData* surface = vtkPolyData::GetData(inputVector[1]);
+  vtkPolyData* outputPolyData = vtkPolyData::GetData(outputVector);
+  if (!outputPolyData)
+  {
+    return 1;
+  }
+  outputPolyData->Initialize();
+  if (!inputPolyData || !inputPolyData->GetPoints() || inputPolyData->GetNumberOfPoints() < 1 || !surface)
+  {
+    return 1;
+  }
+
+  // The surface object is the same between updates, the graph is only rebuilt if it has been modified
+  this->PathCalculator->SetSurface(surface);
+
+  vtkNew<vtkPoints> pathPoints;
+  vtkNew<vtkDoubleArray> pedigreeIds;
+  pedigreeIds->SetName("PedigreeIDs");
+  this->PathCalculator->ComputePathThroughPoints(inputPolyData->GetPoints(), this->CurveIsClosed, pathPoints, pedigreeIds);
+
+  vtkIdType numberOfPathPoints = pathPoints->GetNumberOfPoints();
+  vtkNew<vtkCellArray> lines;
+  if (numberOfPathPoints > 1)
+  {
+    bool closeLine = this->CurveIsClosed && numberOfPathPoints > 2;
+    lines->InsertNextCell(numberOfPathPoints + (closeLine ? 1 : 0));
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPathPoints; ++pointIndex)
+    {
+      lines->InsertCellPoint(pointIndex);
+    }
+    if (closeLine)
+    {
+      lines->InsertCellPoint(0);
+    }
+  }
+
+  outputPolyData->SetPoints(pathPoints);
+  outputPolyData->SetLines(lines);
+  outputPolyData->GetPointData()->AddArray(pedigreeIds);
+  return 1;
+}
@@ -0,0 +1,80 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSurfaceGeodesicPathFilter_h
+#define __vtkSurfaceGeodesicPathFilter_h
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// Export
+#include "vtkMRMLExport.h"
+
+class vtkSurfaceGeodesicPathCalculator;
+
+/// \brief Generate a curve that follows the shortest path on a surface through a list of points.
+///
+/// Input 0 contains the points (typically curve control points), input 1 is the surface mesh.
+/// The output is a polyline along the edges of the surface, in the same format as the output
+/// of vtkCurveGenerator: the "PedigreeIDs" point data array contains for each curve point
+/// the index of the segment start point plus the relative position along the segment.
+///
+/// Paths are computed by vtkSurfaceGeodesicPathCalculator, which keeps the vertex graph of the surface
+/// between updates, therefore moving points does not require rebuilding the graph.
+/// Path length is used as cost.
+class VTK_MRML_EXPORT vtkSurfaceGeodesicPathFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSurfaceGeodesicPathFilter* New();
+  vtkTypeMacro(vtkSurfaceGeodesicPathFilter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Set the surface mesh that the path is computed on (input 1).
+  void SetSurfaceConnection(vtkAlgorithmOutput* surfaceConnection) { this->SetInputConnection(1, surfaceConnection); }
+
+  //@{
+  /// If enabled then the path is continued from the last point to the first point.
+  /// Disabled by default.
+  vtkSetMacro(CurveIsClosed, bool);
+  vtkGetMacro(CurveIsClosed, bool);
+  vtkBooleanMacro(CurveIsClosed, bool);
+  //@}
+
+  /// Get the calculator that caches the vertex graph of the surface.
+  vtkSurfaceGeodesicPathCalculator* GetPathCalculator();
+
+  /// Get the index of the input point that starts the path segment containing the specified output point.
+  /// Returns -1 if the output point index is invalid.
+  vtkIdType GetControlPointIdFromInterpolatedPointId(vtkIdType interpolatedPointId);
+
+protected:
+  vtkSurfaceGeodesicPathFilter();
+  ~vtkSurfaceGeodesicPathFilter() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  vtkSmartPointer<vtkSurfaceGeodesicPathCalculator> PathCalculator;
+  bool CurveIsClosed{ false };
+
+private:
+  vtkSurfaceGeodesicPathFilter(const vtkSurfaceGeodesicPathFilter&) = delete;
+  void operator=(const vtkSurfaceGeodesicPathFilter&) = delete;
+};
+
+#endif
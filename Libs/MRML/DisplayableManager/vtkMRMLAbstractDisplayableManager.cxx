@@ -30,6 +30,7 @@
 #include <vtkMRMLInteractionNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSelectionNode.h>
+#include <vtkMRMLTracer.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -777,6 +778,7 @@ void vtkMRMLAbstractDisplayableManager::RequestRender()
 
   if (this->Internal->UpdateFromMRMLRequested)
   {
+    vtkMRMLTraceScopeWithDetailMacro("DisplayableManager", "UpdateFromMRML", this->GetClassName());
     this->UpdateFromMRML();
   }
 
@@ -31,6 +31,7 @@
 #include <vtkMRMLTransformNode.h>
 #include <vtkMRMLViewNode.h>
 #include <vtkMRMLVolumeNode.h>
+#include <vtkParallelTransformFilter.h>
 
 // VTK includes
 #include <vtkAlgorithm.h>
@@ -839,7 +840,7 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode* dis
       auto tit = this->Internal->DisplayNodeTransformFilters.find(displayNode->GetID());
       if (tit == this->Internal->DisplayNodeTransformFilters.end())
       {
-        transformFilter = vtkSmartPointer<vtkTransformFilter>::New();
+        transformFilter = vtkSmartPointer<vtkParallelTransformFilter>::New();
         this->Internal->DisplayNodeTransformFilters[displayNode->GetID()] = transformFilter;
       }
       else
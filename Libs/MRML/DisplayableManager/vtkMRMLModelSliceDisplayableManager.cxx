@@ -20,6 +20,7 @@
 #include "vtkMRMLModelDisplayableManager.h"
 
 // MRML includes
+#include <vtkIndexedPlaneCutter.h>
 #include <vtkMRMLApplicationLogic.h>
 #include <vtkMRMLColorNode.h>
 #include <vtkMRMLDisplayNode.h>
@@ -33,6 +34,7 @@
 #include <vtkMRMLSliceLogic.h>
 #include <vtkMRMLSliceNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkParallelTransformFilter.h>
 
 // VTK includes
 #include <vtkActor2D.h>
@@ -59,7 +61,6 @@
 
 // VTK includes: customization
 #include <vtkGeometryFilter.h>
-#include <vtkPlaneCutter.h>
 #include <vtkSampleImplicitFunctionFilter.h>
 
 // STD includes
@@ -83,7 +84,7 @@ public:
     vtkSmartPointer<vtkDataSetSurfaceFilter> SurfaceExtractor;
     vtkSmartPointer<vtkTransformFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
-    vtkSmartPointer<vtkPlaneCutter> Cutter;
+    vtkSmartPointer<vtkIndexedPlaneCutter> Cutter;
     vtkSmartPointer<vtkGeometryFilter> GeometryFilter;
     vtkSmartPointer<vtkSampleImplicitFunctionFilter> SliceDistance;
     vtkSmartPointer<vtkProp> Actor;
@@ -300,13 +301,13 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal::AddDisplayNode(vtkMRMLDis
   // Create pipeline
   Pipeline* pipeline = new Pipeline();
   pipeline->Actor = actor.GetPointer();
-  pipeline->Cutter = vtkSmartPointer<vtkPlaneCutter>::New();
+  pipeline->Cutter = vtkSmartPointer<vtkIndexedPlaneCutter>::New();
   pipeline->GeometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
   pipeline->SliceDistance = vtkSmartPointer<vtkSampleImplicitFunctionFilter>::New();
   pipeline->TransformToSlice = vtkSmartPointer<vtkTransform>::New();
   pipeline->NodeToWorld = vtkSmartPointer<vtkGeneralTransform>::New();
   pipeline->Transformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  pipeline->ModelWarper = vtkSmartPointer<vtkTransformFilter>::New();
+  pipeline->ModelWarper = vtkSmartPointer<vtkParallelTransformFilter>::New();
   pipeline->SurfaceExtractor = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
   pipeline->Plane = vtkSmartPointer<vtkPlane>::New();
 
@@ -314,7 +315,6 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal::AddDisplayNode(vtkMRMLDis
   pipeline->Transformer->SetTransform(pipeline->TransformToSlice);
   pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
   pipeline->Cutter->SetPlane(pipeline->Plane);
-  pipeline->Cutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
   pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
   pipeline->GeometryFilter->SetInputConnection(pipeline->Cutter->GetOutputPort());
   // Projection is created from outer surface of volumetric meshes (for polydata surface
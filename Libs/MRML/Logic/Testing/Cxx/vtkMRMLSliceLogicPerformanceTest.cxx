@@ -0,0 +1,177 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkMRMLSliceLogic.h"
+#include "vtkMRMLSliceLayerLogic.h"
+
+// MRML includes
+#include <vtkMRMLColorTableNode.h>
+#include <vtkMRMLScalarVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkTransform.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* AddSyntheticVolume(vtkMRMLScene* scene, int size, vtkMRMLColorTableNode* colorNode)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(size, size, size);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (int k = 0; k < size; ++k)
+  {
+    for (int j = 0; j < size; ++j)
+    {
+      for (int i = 0; i < size; ++i)
+      {
+        *(voxels++) = static_cast<short>((i * 7 + j * 13 + k * 17) % 1000);
+      }
+    }
+  }
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+  displayNode->SetAutoWindowLevel(false);
+  displayNode->SetWindowLevel(1000.0, 500.0);
+  scene->AddNode(displayNode);
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  volumeNode->SetSpacing(0.8, 0.8, 1.5);
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+void UpdateSliceImage(vtkMRMLSliceLogic* sliceLogic)
+{
+  vtkAlgorithmOutput* imageDataConnection = sliceLogic->GetImageDataConnection();
+  if (imageDataConnection && imageDataConnection->GetProducer())
+  {
+    imageDataConnection->GetProducer()->Update();
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+/// Headless benchmark of slice view reslicing: browsing slices, oblique slices, window/level changes.
+/// See vtkMRMLCoreTestingUtilities::Benchmark for command-line arguments.
+int vtkMRMLSliceLogicPerformanceTest(int argc, char* argv[])
+{
+  vtkMRMLCoreTestingUtilities::Benchmark benchmark("vtkMRMLSliceLogicPerformanceTest");
+  CHECK_BOOL(benchmark.ParseArguments(argc, argv), true);
+  const int volumeSize = benchmark.GetSize(128);
+  const int numberOfSlices = 20;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene);
+
+  vtkNew<vtkMRMLSliceLogic> sliceLogic;
+  sliceLogic->SetMRMLScene(scene);
+  vtkMRMLSliceNode* sliceNode = sliceLogic->AddSliceNode("Red");
+  CHECK_NOT_NULL(sliceNode);
+  vtkNew<vtkMRMLSliceLayerLogic> backgroundLayer;
+  sliceLogic->SetBackgroundLayer(backgroundLayer);
+
+  vtkNew<vtkMRMLColorTableNode> colorNode;
+  colorNode->SetTypeToGrey();
+  scene->AddNode(colorNode);
+
+  vtkMRMLScalarVolumeNode* volumeNode = nullptr;
+  benchmark.Measure(
+    "AddVolume", [&]() { volumeNode = AddSyntheticVolume(scene, volumeSize, colorNode); },
+    [&]()
+    {
+      if (volumeNode)
+      {
+        scene->RemoveNode(volumeNode->GetDisplayNode());
+        scene->RemoveNode(volumeNode);
+      }
+    });
+  CHECK_NOT_NULL(volumeNode);
+  vtkMRMLScalarVolumeDisplayNode* displayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(volumeNode->GetDisplayNode());
+  CHECK_NOT_NULL(displayNode);
+
+  sliceNode->SetDimensions(512, 512, 1);
+  benchmark.Measure("ShowVolume",
+                    [&]()
+                    {
+                      sliceLogic->GetSliceCompositeNode()->SetBackgroundVolumeID(volumeNode->GetID());
+                      sliceLogic->FitSliceToAll();
+                      UpdateSliceImage(sliceLogic);
+                    },
+                    [&]() { sliceLogic->GetSliceCompositeNode()->SetBackgroundVolumeID(nullptr); });
+  CHECK_NOT_NULL(sliceLogic->GetImageDataConnection());
+
+  double sliceBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  sliceLogic->GetVolumeSliceBounds(volumeNode, sliceBounds);
+  auto browseSlices = [&]()
+  {
+    for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+    {
+      sliceLogic->SetSliceOffset(sliceBounds[4] + (sliceBounds[5] - sliceBounds[4]) * sliceIndex / numberOfSlices);
+      UpdateSliceImage(sliceLogic);
+    }
+  };
+  benchmark.Measure("BrowseSlices", browseSlices);
+
+  benchmark.Measure("ChangeWindowLevel",
+                    [&]()
+                    {
+                      for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+                      {
+                        displayNode->SetWindowLevel(500.0 + sliceIndex * 10.0, 400.0 + sliceIndex * 5.0);
+                        UpdateSliceImage(sliceLogic);
+                      }
+                    });
+
+  // Oblique slice
+  vtkNew<vtkTransform> sliceRotation;
+  sliceRotation->RotateX(20.0);
+  sliceRotation->RotateY(15.0);
+  vtkMatrix4x4* sliceToRAS = sliceNode->GetSliceToRAS();
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int column = 0; column < 3; ++column)
+    {
+      sliceToRAS->SetElement(row, column, sliceRotation->GetMatrix()->GetElement(row, column));
+    }
+  }
+  sliceNode->UpdateMatrices();
+  sliceLogic->GetVolumeSliceBounds(volumeNode, sliceBounds);
+  benchmark.Measure("BrowseObliqueSlices", browseSlices);
+
+  return benchmark.Finish();
+}
@@ -19,6 +19,7 @@
 // MRML includes
 #include "vtkMRMLNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLTracer.h"
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -27,6 +28,7 @@
 
 // STD includes
 #include <cassert>
+#include <string>
 
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLAbstractLogic);
@@ -167,7 +169,10 @@ void vtkMRMLAbstractLogic::MRMLSceneCallback(vtkObject* caller, unsigned long ei
   self->SetInMRMLSceneCallbackFlag(self->GetInMRMLSceneCallbackFlag() + 1);
   int oldProcessingEvent = self->GetProcessingMRMLSceneEvent();
   self->SetProcessingMRMLSceneEvent(eid);
-  self->ProcessMRMLSceneEvents(caller, eid, callData);
+  {
+    vtkMRMLTraceScopeWithDetailMacro("Logic", "ProcessMRMLSceneEvents", std::string(self->GetClassName()) + ": event " + std::to_string(eid));
+    self->ProcessMRMLSceneEvents(caller, eid, callData);
+  }
   self->SetProcessingMRMLSceneEvent(oldProcessingEvent);
   self->SetInMRMLSceneCallbackFlag(self->GetInMRMLSceneCallbackFlag() - 1);
 }
@@ -206,7 +211,10 @@ void vtkMRMLAbstractLogic::MRMLNodesCallback(vtkObject* caller, unsigned long ei
   vtkDebugWithObjectMacro(self, "In vtkMRMLAbstractLogic MRMLNodesCallback");
 
   self->SetInMRMLNodesCallbackFlag(self->GetInMRMLNodesCallbackFlag() + 1);
-  self->ProcessMRMLNodesEvents(caller, eid, callData);
+  {
+    vtkMRMLTraceScopeWithDetailMacro("Logic", "ProcessMRMLNodesEvents", std::string(self->GetClassName()) + ": " + caller->GetClassName() + " event " + std::to_string(eid));
+    self->ProcessMRMLNodesEvents(caller, eid, callData);
+  }
   self->SetInMRMLNodesCallbackFlag(self->GetInMRMLNodesCallbackFlag() - 1);
 }
 
@@ -0,0 +1,190 @@
+import collections
+import itertools
+import unittest
+
+import numpy as np
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+
+
+"""
+Tests vtkITKIslandMath against a simple flood fill implementation.
+
+Islands are expected to be labeled with consecutive values in decreasing order of size,
+islands of equal size in the order of their first voxel (in raster order), the same way
+as itk::RelabelComponentImageFilter orders them.
+"""
+
+
+def createImage(voxels, extentOrigin=(0, 0, 0)):
+    """Create image from a numpy array (indexed as [k, j, i]), with extent starting at extentOrigin."""
+    image = vtk.vtkImageData()
+    dimensions = voxels.shape[::-1]
+    image.SetExtent(
+        extentOrigin[0], extentOrigin[0] + dimensions[0] - 1,
+        extentOrigin[1], extentOrigin[1] + dimensions[1] - 1,
+        extentOrigin[2], extentOrigin[2] + dimensions[2] - 1,
+    )
+    image.AllocateScalars(vtk.VTK_SHORT, 1)
+    ns.vtk_to_numpy(image.GetPointData().GetScalars()).reshape(voxels.shape)[:] = voxels
+    return image
+
+
+def computeReferenceIslands(voxels, fullyConnected, minimumSize=0, maximumSize=None, extentOrigin=(0, 0, 0)):
+    """Label islands by flood fill. Returns labels, island sizes and island extents (in the image extent)."""
+    offsets = [offset for offset in itertools.product([-1, 0, 1], repeat=3)
+               if any(offset) and (fullyConnected or sum(abs(component) for component in offset) == 1)]
+    visited = np.zeros(voxels.shape, dtype=bool)
+    islands = []
+    for flatIndex in np.flatnonzero(voxels):
+        seed = np.unravel_index(flatIndex, voxels.shape)
+        if visited[seed]:
+            continue
+        visited[seed] = True
+        islandVoxels = []
+        queue = collections.deque([seed])
+        while queue:
+            voxel = queue.popleft()
+            islandVoxels.append(voxel)
+            for offset in offsets:
+                neighbor = tuple(voxel[axis] + offset[axis] for axis in range(3))
+                if any(neighbor[axis] < 0 or neighbor[axis] >= voxels.shape[axis] for axis in range(3)):
+                    continue
+                if voxels[neighbor] == 0 or visited[neighbor]:
+                    continue
+                visited[neighbor] = True
+                queue.append(neighbor)
+        islands.append(islandVoxels)
+
+    # sorted() is stable, therefore islands of equal size remain in the order of their first voxel
+    labels = np.zeros(voxels.shape, dtype=voxels.dtype)
+    sizes = []
+    extents = []
+    for islandVoxels in sorted(islands, key=lambda islandVoxels: -len(islandVoxels)):
+        if len(islandVoxels) < minimumSize or (maximumSize is not None and len(islandVoxels) > maximumSize):
+            continue
+        sizes.append(len(islandVoxels))
+        indices = np.array(islandVoxels)
+        for voxel in islandVoxels:
+            labels[voxel] = len(sizes)
+        extent = []
+        for axis in [2, 1, 0]:
+            extent.extend([int(indices[:, axis].min()) + extentOrigin[2 - axis], int(indices[:, axis].max()) + extentOrigin[2 - axis]])
+        extents.append(extent)
+    return labels, sizes, extents, len(islands)
+
+
+class vtkITKIslandMathTest(unittest.TestCase):
+    def runIslandMath(self, image, fullyConnected, minimumSize=0, maximumSize=None):
+        islandMath = vtkITK.vtkITKIslandMath()
+        islandMath.SetInputData(image)
+        islandMath.SetFullyConnected(1 if fullyConnected else 0)
+        islandMath.SetMinimumSize(minimumSize)
+        if maximumSize is not None:
+            islandMath.SetMaximumSize(maximumSize)
+        islandMath.Update()
+        return islandMath
+
+    def getLabels(self, islandMath, shape):
+        output = islandMath.GetOutput()
+        self.assertEqual(list(output.GetExtent()), list(islandMath.GetInput().GetExtent()))
+        return ns.vtk_to_numpy(output.GetPointData().GetScalars()).reshape(shape)
+
+    def checkAgainstReference(self, voxels, fullyConnected, minimumSize=0, maximumSize=None, extentOrigin=(0, 0, 0)):
+        image = createImage(voxels, extentOrigin)
+        islandMath = self.runIslandMath(image, fullyConnected, minimumSize, maximumSize)
+        expectedLabels, expectedSizes, expectedExtents, expectedOriginalNumberOfIslands = computeReferenceIslands(
+            voxels, fullyConnected, minimumSize, maximumSize, extentOrigin)
+
+        self.assertTrue(np.array_equal(self.getLabels(islandMath, voxels.shape), expectedLabels))
+        self.assertEqual(islandMath.GetNumberOfIslands(), len(expectedSizes))
+        self.assertEqual(islandMath.GetOriginalNumberOfIslands(), expectedOriginalNumberOfIslands)
+        for islandIndex in range(len(expectedSizes)):
+            self.assertEqual(islandMath.GetIslandSize(islandIndex), expectedSizes[islandIndex])
+            extent = [0, -1, 0, -1, 0, -1]
+            islandMath.GetIslandExtent(islandIndex, extent)
+            self.assertEqual(extent, expectedExtents[islandIndex])
+        return islandMath
+
+    def test_Connectivity(self):
+        voxels = np.zeros((5, 6, 7), dtype=np.int16)
+        voxels[1, 1, 1] = 1
+        # touches the previous voxel on an edge
+        voxels[1, 2, 2] = 1
+        # touches the previous voxel on a vertex
+        voxels[2, 3, 3] = 1
+        # touches the previous voxel on a face, in the next slice
+        voxels[3, 3, 3] = 1
+
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=False)
+        self.assertEqual(islandMath.GetNumberOfIslands(), 3)
+        self.assertEqual([islandMath.GetIslandSize(index) for index in range(3)], [2, 1, 1])
+
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=True)
+        self.assertEqual(islandMath.GetNumberOfIslands(), 1)
+        self.assertEqual(islandMath.GetIslandSize(0), 4)
+
+    def test_SizeOrderingAndFiltering(self):
+        voxels = np.zeros((4, 10, 12), dtype=np.int16)
+        voxels[0, 0, 0:3] = 1     # size 3, first island in raster order
+        voxels[0, 2, 0:5] = 1     # size 5
+        voxels[1, 5, 5:8] = 1     # size 3, same size as the first island
+        voxels[3, 9, 11] = 1      # size 1
+
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=False)
+        labels = self.getLabels(islandMath, voxels.shape)
+        # largest first, islands of equal size in the order of their first voxel
+        self.assertEqual(labels[0, 2, 0], 1)
+        self.assertEqual(labels[0, 0, 0], 2)
+        self.assertEqual(labels[1, 5, 5], 3)
+        self.assertEqual(labels[3, 9, 11], 4)
+
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=False, minimumSize=2, maximumSize=4)
+        self.assertEqual(islandMath.GetNumberOfIslands(), 2)
+        self.assertEqual(islandMath.GetOriginalNumberOfIslands(), 4)
+        labels = self.getLabels(islandMath, voxels.shape)
+        self.assertEqual(labels[0, 0, 0], 1)
+        self.assertEqual(labels[1, 5, 5], 2)
+        # ignored islands are removed from the output
+        self.assertEqual(labels[0, 2, 0], 0)
+        self.assertEqual(labels[3, 9, 11], 0)
+
+    def test_ExtentOrigin(self):
+        voxels = np.zeros((6, 7, 8), dtype=np.int16)
+        voxels[1:4, 2:4, 3:7] = 5
+        voxels[5, 0, 0] = 2
+        extentOrigin = (10, -5, 3)
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=False, extentOrigin=extentOrigin)
+        extent = [0, -1, 0, -1, 0, -1]
+        islandMath.GetIslandExtent(0, extent)
+        self.assertEqual(extent, [13, 16, -3, -2, 4, 6])
+        islandMath.GetIslandExtent(1, extent)
+        self.assertEqual(extent, [10, 10, -5, -5, 8, 8])
+
+    def test_IslandsAcrossSliceBlocks(self):
+        # Many slices, so that slices are merged in several parallel blocks.
+        numberOfSlices = 160
+        voxels = np.zeros((numberOfSlices, 16, 16), dtype=np.int16)
+        # A single-voxel wide path that goes up and down through all slices, connected by turns
+        # in the first and last slices: it is one island only if all blocks are merged correctly.
+        for column in range(0, 16, 2):
+            voxels[:, 0, column] = 1
+            turnSlice = numberOfSlices - 1 if column % 4 == 0 else 0
+            if column + 2 < 16:
+                voxels[turnSlice, 0, column:column + 3] = 1
+        islandMath = self.checkAgainstReference(voxels, fullyConnected=False)
+        self.assertEqual(islandMath.GetNumberOfIslands(), 1)
+
+        # Random islands, many of them span several slices
+        rng = np.random.default_rng(42)
+        voxels[:, 2:, :] = (rng.random((numberOfSlices, 14, 16)) < 0.3).astype(np.int16)
+        for fullyConnected in [False, True]:
+            self.checkAgainstReference(voxels, fullyConnected)
+            self.checkAgainstReference(voxels, fullyConnected, minimumSize=3, maximumSize=20)
+
+    def runTest(self):
+        self.test_Connectivity()
+        self.test_SizeOrderingAndFiltering()
+        self.test_ExtentOrigin()
+        self.test_IslandsAcrossSliceBlocks()
@@ -22,17 +22,19 @@
 #include "vtkITKImageMargin.h"
 
 /// VTK includes
-#include <vtkAlgorithm.h>
 #include <vtkDataArray.h>
 #include <vtkImageData.h>
 #include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkTypeTraits.h>
 
-/// ITK includes
-#include <itkBinaryThresholdImageFilter.h>
-#include <itkCommand.h>
-#include <itkSignedMaurerDistanceMapImageFilter.h>
+/// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkITKImageMargin);
 
@@ -52,93 +54,285 @@ void vtkITKImageMargin::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 }
 
-//----------------------------------------------------------------------------
-// signed distance field
-// sdf and sdfMargin are based on:
-// https://github.com/KitwareMedical/HASI/blob/fe38e0f08682fd3ba2fd9ec816118b844321fdb8/segmentBonesInMicroCT.cxx#L102-L155
-template <typename InputPixelType, unsigned Dimension>
-itk::SmartPointer<itk::Image<float, Dimension>> sdf(itk::SmartPointer<itk::Image<InputPixelType, Dimension>> labelImage, int backgroundValue)
+namespace
 {
-  using RealImageType = itk::Image<float, Dimension>;
-  using LabelImageType = itk::Image<InputPixelType, Dimension>;
-  using DistanceFieldType = itk::SignedMaurerDistanceMapImageFilter<LabelImageType, RealImageType>;
-
-  typename DistanceFieldType::Pointer distF = DistanceFieldType::New();
-  distF->SetInput(labelImage);
-  distF->SetSquaredDistance(true);
-  distF->SetBackgroundValue(backgroundValue);
-  distF->Update();
-  return distF->GetOutput();
-}
 
 //----------------------------------------------------------------------------
-template <typename ImageType>
-itk::SmartPointer<ImageType> sdfMargin(itk::SmartPointer<ImageType> labelImage, int backgroundValue, double innerMarginMM, double outerMarginMM)
+/// Compute squared distance along a line of samples from the lower envelope of parabolas
+/// rooted at each sample (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions).
+/// Input and output values are squared distances, infinite values mean that there is no
+/// feature point within the maximum distance. Output values larger than maxSquaredDistance are set to infinity.
+void DistanceTransformLine(const std::vector<double>& f,
+                           std::vector<double>& d,
+                           int n,
+                           double spacing,
+                           double maxSquaredDistance,
+                           std::vector<int>& envelopeSamples,
+                           std::vector<double>& envelopeBoundaries)
 {
-  innerMarginMM -= std::numeric_limits<double>::epsilon();
-  outerMarginMM += std::numeric_limits<double>::epsilon();
-
-  using RealImageType = itk::Image<float, ImageType::ImageDimension>;
-  using FloatThresholdType = itk::BinaryThresholdImageFilter<RealImageType, ImageType>;
-  typename FloatThresholdType::Pointer sdfTh = FloatThresholdType::New();
-  sdfTh->SetInput(sdf<typename ImageType::PixelType, ImageType::ImageDimension>(labelImage, backgroundValue));
-  if (innerMarginMM > vtkMath::NegInf())
+  const double infinity = std::numeric_limits<double>::infinity();
+  int k = -1;
+  for (int q = 0; q < n; ++q)
   {
-    sdfTh->SetLowerThreshold(innerMarginMM * std::abs(innerMarginMM));
+    if (f[q] == infinity)
+    {
+      continue;
+    }
+    const double fq = f[q] + (q * spacing) * (q * spacing);
+    double intersection = -infinity;
+    while (k >= 0)
+    {
+      const int p = envelopeSamples[k];
+      intersection = (fq - (f[p] + (p * spacing) * (p * spacing))) / (2.0 * spacing * (q - p));
+      if (intersection > envelopeBoundaries[k])
+      {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    envelopeSamples[k] = q;
+    envelopeBoundaries[k] = (k == 0 ? -infinity : intersection);
+    envelopeBoundaries[k + 1] = infinity;
+  }
+  if (k < 0)
+  {
+    std::fill(d.begin(), d.begin() + n, infinity);
+    return;
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q)
+  {
+    while (envelopeBoundaries[k + 1] < q * spacing)
+    {
+      ++k;
+    }
+    const double offset = (q - envelopeSamples[k]) * spacing;
+    const double squaredDistance = offset * offset + f[envelopeSamples[k]];
+    d[q] = (squaredDistance > maxSquaredDistance ? infinity : squaredDistance);
   }
-  sdfTh->SetUpperThreshold(outerMarginMM * std::abs(outerMarginMM));
-  sdfTh->Update();
-  return sdfTh->GetOutput();
 }
 
+} // namespace
+
 //----------------------------------------------------------------------------
+// Signed distance is computed the same way as itk::SignedMaurerDistanceMapImageFilter:
+// distance is measured from the border voxels of the foreground (foreground voxels that
+// have a background voxel in their 26-neighborhood), inside is negative.
+// Distances are only computed in the bounding box of the foreground, padded by the outer margin,
+// and only up to the largest margin distance.
 template <class T>
-void vtkITKImageMarginExecute(vtkITKImageMargin* self, vtkImageData* input, vtkImageData* vtkNotUsed(output), T* inPtr, T* outPtr)
+void vtkITKImageMarginExecute(vtkITKImageMargin* self, vtkImageData* input, T* inPtr, T* outPtr)
 {
-  try
+  int dims[3] = { 0, 0, 0 };
+  input->GetDimensions(dims);
+  const vtkIdType rowSize = dims[0];
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double innerMarginDistance = self->GetInnerMarginVoxels();
+  double outerMarginDistance = self->GetOuterMarginVoxels();
+  if (self->GetCalculateMarginInMM())
   {
-    int dims[3];
-    input->GetDimensions(dims);
-    double spacing[3];
     input->GetSpacing(spacing);
+    innerMarginDistance = self->GetInnerMarginMM();
+    outerMarginDistance = self->GetOuterMarginMM();
+  }
+  innerMarginDistance -= std::numeric_limits<double>::epsilon();
+  outerMarginDistance += std::numeric_limits<double>::epsilon();
+  const bool hasInnerMargin = innerMarginDistance > vtkMath::NegInf();
+  const double lowerThreshold = hasInnerMargin ? innerMarginDistance * std::abs(innerMarginDistance) : vtkMath::NegInf();
+  const double upperThreshold = outerMarginDistance * std::abs(outerMarginDistance);
+  // Distances beyond the margins do not need to be known
+  const double maxDistance = std::max(std::abs(outerMarginDistance), hasInnerMargin ? std::abs(innerMarginDistance) : 0.0);
+  const double maxSquaredDistance = maxDistance * maxDistance;
+
+  const T backgroundValue = static_cast<T>(self->GetBackgroundValue());
+  const T insideValue = vtkTypeTraits<T>::Max();
+  const T outsideValue = static_cast<T>(0);
 
-    // Wrap scalars into an ITK image
-    // - mostly rely on defaults for spacing, origin etc for this filter
-    typedef itk::Image<T, 3> ImageType;
-    typename ImageType::Pointer inImage = ImageType::New();
-    typename ImageType::RegionType region;
-    typename ImageType::IndexType index;
-    typename ImageType::SizeType size;
-
-    inImage->GetPixelContainer()->SetImportPointer(inPtr, dims[0] * dims[1] * dims[2], false);
-    index[0] = index[1] = index[2] = 0;
-    region.SetIndex(index);
-    size[0] = dims[0];
-    size[1] = dims[1];
-    size[2] = dims[2];
-    region.SetSize(size);
-    inImage->SetLargestPossibleRegion(region);
-    inImage->SetBufferedRegion(region);
-
-    double innerMarginDistance = self->GetInnerMarginVoxels();
-    double outerMarginDistance = self->GetOuterMarginVoxels();
-    if (self->GetCalculateMarginInMM())
+  // Bounding box of the foreground
+  std::vector<int> sliceForegroundExtents(4 * dims[2]);
+  vtkSMPTools::For(0,
+                   dims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+                     {
+                       int* extent = &sliceForegroundExtents[4 * k];
+                       extent[0] = dims[0];
+                       extent[1] = -1;
+                       extent[2] = dims[1];
+                       extent[3] = -1;
+                       const T* voxel = inPtr + k * sliceSize;
+                       for (int j = 0; j < dims[1]; ++j)
+                       {
+                         for (int i = 0; i < dims[0]; ++i, ++voxel)
+                         {
+                           if (*voxel != backgroundValue)
+                           {
+                             extent[0] = std::min(extent[0], i);
+                             extent[1] = std::max(extent[1], i);
+                             extent[2] = std::min(extent[2], j);
+                             extent[3] = std::max(extent[3], j);
+                           }
+                         }
+                       }
+                     }
+                   });
+  int foregroundExtent[6] = { dims[0], -1, dims[1], -1, dims[2], -1 };
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    const int* extent = &sliceForegroundExtents[4 * k];
+    if (extent[1] < extent[0])
     {
-      inImage->SetSpacing(spacing);
-      innerMarginDistance = self->GetInnerMarginMM();
-      outerMarginDistance = self->GetOuterMarginMM();
+      continue;
     }
+    foregroundExtent[0] = std::min(foregroundExtent[0], extent[0]);
+    foregroundExtent[1] = std::max(foregroundExtent[1], extent[1]);
+    foregroundExtent[2] = std::min(foregroundExtent[2], extent[2]);
+    foregroundExtent[3] = std::max(foregroundExtent[3], extent[3]);
+    foregroundExtent[4] = std::min(foregroundExtent[4], k);
+    foregroundExtent[5] = k;
+  }
 
-    itk::SmartPointer<ImageType> outputImage;
-    outputImage = sdfMargin<ImageType>(inImage, self->GetBackgroundValue(), innerMarginDistance, outerMarginDistance);
+  // Output is written directly, voxels outside the processed region are outside the margin
+  vtkSMPTools::For(0, dims[2], [&](vtkIdType firstSlice, vtkIdType lastSlice) { std::fill(outPtr + firstSlice * sliceSize, outPtr + lastSlice * sliceSize, outsideValue); });
+  if (foregroundExtent[5] < foregroundExtent[4])
+  {
+    // No foreground, distance from the foreground is infinite everywhere
+    return;
+  }
+  self->UpdateProgress(0.1);
 
-    // Copy to the output
-    memcpy(outPtr, outputImage->GetBufferPointer(), outputImage->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  // Region where the margin may be non-empty: voxels outside of it are farther from the foreground than
+  // the outer margin. A 1-voxel padding is always added to include background neighbors of border voxels.
+  int region[6] = { 0, -1, 0, -1, 0, -1 };
+  int regionDims[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    int padding = 1;
+    if (outerMarginDistance > 0)
+    {
+      padding += static_cast<int>(std::min(std::ceil(outerMarginDistance / spacing[axis]), static_cast<double>(dims[axis])));
+    }
+    region[2 * axis] = std::max(foregroundExtent[2 * axis] - padding, 0);
+    region[2 * axis + 1] = std::min(foregroundExtent[2 * axis + 1] + padding, dims[axis] - 1);
+    regionDims[axis] = region[2 * axis + 1] - region[2 * axis] + 1;
   }
-  catch (itk::ExceptionObject& err)
+  const vtkIdType regionSliceSize = static_cast<vtkIdType>(regionDims[0]) * regionDims[1];
+  auto inputVoxel = [&](int i, int j, int k) { return inPtr + (k + region[4]) * sliceSize + (j + region[2]) * rowSize + (i + region[0]); };
+
+  // Squared distance from the nearest border voxel. Border voxels are the initial feature points.
+  const double infinity = std::numeric_limits<double>::infinity();
+  std::vector<float> squaredDistances(regionSliceSize * regionDims[2]);
+  vtkSMPTools::For(0,
+                   regionDims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (int k = static_cast<int>(firstSlice); k < lastSlice; ++k)
+                     {
+                       float* squaredDistance = &squaredDistances[k * regionSliceSize];
+                       for (int j = 0; j < regionDims[1]; ++j)
+                       {
+                         for (int i = 0; i < regionDims[0]; ++i, ++squaredDistance)
+                         {
+                           *squaredDistance = std::numeric_limits<float>::infinity();
+                           if (*inputVoxel(i, j, k) == backgroundValue)
+                           {
+                             continue;
+                           }
+                           const int ijk[3] = { i + region[0], j + region[2], k + region[4] };
+                           bool border = false;
+                           for (int dk = -1; dk <= 1 && !border; ++dk)
+                           {
+                             for (int dj = -1; dj <= 1 && !border; ++dj)
+                             {
+                               for (int di = -1; di <= 1 && !border; ++di)
+                               {
+                                 if (ijk[0] + di < 0 || ijk[0] + di >= dims[0] || ijk[1] + dj < 0 || ijk[1] + dj >= dims[1] || ijk[2] + dk < 0 || ijk[2] + dk >= dims[2])
+                                 {
+                                   continue;
+                                 }
+                                 border = (*inputVoxel(i + di, j + dj, k + dk) == backgroundValue);
+                               }
+                             }
+                           }
+                           if (border)
+                           {
+                             *squaredDistance = 0.0f;
+                           }
+                         }
+                       }
+                     }
+                   });
+  self->UpdateProgress(0.3);
+
+  // Separable distance transform along each axis. Lines that do not contain any feature point
+  // within the maximum distance are skipped.
+  for (int axis = 0; axis < 3; ++axis)
   {
-    vtkErrorWithObjectMacro(self, "Failed to compute margin. Details: " << err);
+    const int lineLength = regionDims[axis];
+    const vtkIdType lineStride = (axis == 0 ? 1 : (axis == 1 ? regionDims[0] : regionSliceSize));
+    // Lines are indexed by the two other axes, the outer one is processed in parallel
+    const int innerAxis = (axis == 0 ? 1 : 0);
+    const int outerAxis = (axis == 2 ? 1 : 2);
+    const vtkIdType innerStride = (innerAxis == 0 ? 1 : regionDims[0]);
+    const vtkIdType outerStride = (outerAxis == 1 ? regionDims[0] : regionSliceSize);
+    vtkSMPTools::For(0,
+                     regionDims[outerAxis],
+                     [&](vtkIdType firstLine, vtkIdType lastLine)
+                     {
+                       std::vector<double> f(lineLength);
+                       std::vector<double> d(lineLength);
+                       std::vector<int> envelopeSamples(lineLength);
+                       std::vector<double> envelopeBoundaries(lineLength + 1);
+                       for (vtkIdType outer = firstLine; outer < lastLine; ++outer)
+                       {
+                         for (vtkIdType inner = 0; inner < regionDims[innerAxis]; ++inner)
+                         {
+                           float* line = &squaredDistances[outer * outerStride + inner * innerStride];
+                           bool hasFeature = false;
+                           for (int q = 0; q < lineLength; ++q)
+                           {
+                             f[q] = (line[q * lineStride] == std::numeric_limits<float>::infinity() ? infinity : line[q * lineStride]);
+                             hasFeature = hasFeature || f[q] != infinity;
+                           }
+                           if (!hasFeature)
+                           {
+                             continue;
+                           }
+                           DistanceTransformLine(f, d, lineLength, spacing[axis], maxSquaredDistance, envelopeSamples, envelopeBoundaries);
+                           for (int q = 0; q < lineLength; ++q)
+                           {
+                             line[q * lineStride] = (d[q] == infinity ? std::numeric_limits<float>::infinity() : static_cast<float>(d[q]));
+                           }
+                         }
+                       }
+                     });
+    self->UpdateProgress(0.3 + 0.2 * (axis + 1));
   }
+
+  // Threshold the signed squared distance
+  vtkSMPTools::For(0,
+                   regionDims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (int k = static_cast<int>(firstSlice); k < lastSlice; ++k)
+                     {
+                       const float* squaredDistance = &squaredDistances[k * regionSliceSize];
+                       for (int j = 0; j < regionDims[1]; ++j)
+                       {
+                         const T* inVoxel = inputVoxel(0, j, k);
+                         T* outVoxel = outPtr + (inVoxel - inPtr);
+                         for (int i = 0; i < regionDims[0]; ++i, ++squaredDistance, ++inVoxel, ++outVoxel)
+                         {
+                           const double signedSquaredDistance = (*inVoxel == backgroundValue ? *squaredDistance : -*squaredDistance);
+                           *outVoxel = (signedSquaredDistance >= lowerThreshold && signedSquaredDistance <= upperThreshold) ? insideValue : outsideValue;
+                         }
+                       }
+                     }
+                   });
 }
 
 //----------------------------------------------------------------------------
@@ -170,32 +364,15 @@ void vtkITKImageMargin::SimpleExecute(vtkImageData* input, vtkImageData* output)
 
   if (inScalars->GetNumberOfComponents() == 1)
   {
-
-////////// These types are not defined in itk ////////////
-#undef VTK_TYPE_USE_LONG_LONG
-#undef VTK_TYPE_USE___INT64
-
-#define CALL vtkITKImageMarginExecute(this, input, output, static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr));
-
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
 
     switch (inScalars->GetDataType())
     {
-      vtkTemplateMacroCase(VTK_LONG, long, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_LONG, unsigned long, CALL);
-      vtkTemplateMacroCase(VTK_INT, int, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_INT, unsigned int, CALL);
-      vtkTemplateMacroCase(VTK_SHORT, short, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_SHORT, unsigned short, CALL);
-      vtkTemplateMacroCase(VTK_CHAR, char, CALL);
-      vtkTemplateMacroCase(VTK_SIGNED_CHAR, signed char, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, CALL);
-      vtkTemplateMacroCase(VTK_FLOAT, float, CALL);
-      vtkTemplateMacroCase(VTK_DOUBLE, double, CALL);
+      vtkTemplateMacro(vtkITKImageMarginExecute(this, input, static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr)));
       default:
       {
-        vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
+        vtkErrorMacro(<< "Incompatible scalar type for image margin.");
       }
     } // switch
   }
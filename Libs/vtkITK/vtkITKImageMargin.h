@@ -24,9 +24,13 @@
 #include "vtkITK.h"
 #include "vtkSimpleImageToImageFilter.h"
 
-/// \brief ITK-based utilities for manipulating connected regions in label maps.
-/// Limitation: The filter does not work correctly with input volume that has
-/// unsigned long scalar type on Linux and macOS.
+/// \brief Compute margin (or shell) of the foreground region of a labelmap.
+///
+/// Output voxels are set to the maximum value of the scalar type if their signed distance from the
+/// border of the foreground is between the inner and outer margin, and 0 otherwise.
+/// Distances are only computed in the bounding box of the foreground padded by the outer margin,
+/// and only up to the largest margin distance, therefore processing time and memory usage
+/// depend on the size of the foreground and the margin instead of the size of the image.
 ///
 class VTK_ITK_EXPORT vtkITKImageMargin : public vtkSimpleImageToImageFilter
 {
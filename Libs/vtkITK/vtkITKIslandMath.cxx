@@ -13,12 +13,12 @@
 #include "vtkDataArray.h"
 #include "vtkPointData.h"
 #include "vtkImageData.h"
-#include "vtkAlgorithm.h"
-#include <vtkVersion.h>
+#include "vtkSMPTools.h"
+#include "vtkTypeTraits.h"
 
-#include "itkConnectedComponentImageFilter.h"
-#include "itkRelabelComponentImageFilter.h"
-#include "itkCommand.h"
+// STD includes
+#include <algorithm>
+#include <numeric>
 
 vtkStandardNewMacro(vtkITKIslandMath);
 
@@ -46,71 +46,309 @@ void vtkITKIslandMath::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "OriginalNumberOfIslands: " << OriginalNumberOfIslands << std::endl;
 }
 
-// Note: local function not method - conforms to signature in itkCommand.h
-void vtkITKIslandMathHandleProgressEvent(itk::Object* caller, const itk::EventObject& vtkNotUsed(eventObject), void* clientdata)
+vtkIdType vtkITKIslandMath::GetIslandSize(unsigned long islandIndex)
 {
-  itk::ProcessObject* itkFilter = dynamic_cast<itk::ProcessObject*>(caller);
-  vtkAlgorithm* vtkFilter = reinterpret_cast<vtkAlgorithm*>(clientdata);
-  if (itkFilter && vtkFilter)
+  if (islandIndex >= this->IslandSizes.size())
   {
-    vtkFilter->UpdateProgress(itkFilter->GetProgress());
+    vtkErrorMacro("GetIslandSize: invalid island index " << islandIndex);
+    return 0;
   }
+  return this->IslandSizes[islandIndex];
+}
+
+void vtkITKIslandMath::GetIslandExtent(unsigned long islandIndex, int extent[6])
+{
+  if (islandIndex >= this->IslandSizes.size())
+  {
+    vtkErrorMacro("GetIslandExtent: invalid island index " << islandIndex);
+    for (int i = 0; i < 6; ++i)
+    {
+      extent[i] = (i % 2 ? -1 : 0);
+    }
+    return;
+  }
+  std::copy_n(this->IslandExtents.begin() + 6 * islandIndex, 6, extent);
+}
+
+namespace
+{
+
+/// Continuous sequence of foreground voxels in an image row
+struct Run
+{
+  int Start; // first voxel index in the row
+  int End;   // last voxel index in the row
 };
 
-template <class T>
-void vtkITKIslandMathExecute(vtkITKIslandMath* self, vtkImageData* input, vtkImageData* vtkNotUsed(output), T* inPtr, T* outPtr)
+/// Find root of a run and compress the path.
+/// Parent of a run always has a lower or equal index than the run itself.
+vtkIdType FindRoot(std::vector<vtkIdType>& parents, vtkIdType run)
+{
+  vtkIdType root = run;
+  while (parents[root] != root)
+  {
+    root = parents[root];
+  }
+  while (parents[run] != root)
+  {
+    vtkIdType next = parents[run];
+    parents[run] = root;
+    run = next;
+  }
+  return root;
+}
+
+/// Merge the sets of two runs. The root with higher index is linked to the root with lower index,
+/// therefore the root of each set is its first run (in raster order), regardless of the merge order.
+void Union(std::vector<vtkIdType>& parents, vtkIdType run1, vtkIdType run2)
 {
+  vtkIdType root1 = FindRoot(parents, run1);
+  vtkIdType root2 = FindRoot(parents, run2);
+  if (root1 < root2)
+  {
+    parents[root2] = root1;
+  }
+  else if (root2 < root1)
+  {
+    parents[root1] = root2;
+  }
+}
+
+} // namespace
 
-  int dims[3];
+template <class T>
+void vtkITKIslandMathExecute(vtkITKIslandMath* self,
+                             vtkImageData* input,
+                             T* inPtr,
+                             T* outPtr,
+                             std::vector<vtkIdType>& islandSizes,
+                             std::vector<int>& islandExtents)
+{
+  int dims[3] = { 0, 0, 0 };
   input->GetDimensions(dims);
-  double spacing[3];
-  input->GetSpacing(spacing);
-
-  // Wrap scalars into an ITK image
-  // - mostly rely on defaults for spacing, origin etc for this filter
-  typedef itk::Image<T, 3> ImageType;
-  typename ImageType::Pointer inImage = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::IndexType index;
-  typename ImageType::SizeType size;
-
-  inImage->GetPixelContainer()->SetImportPointer(inPtr, dims[0] * dims[1] * dims[2], false);
-  index[0] = index[1] = index[2] = 0;
-  region.SetIndex(index);
-  size[0] = dims[0];
-  size[1] = dims[1];
-  size[2] = dims[2];
-  region.SetSize(size);
-  inImage->SetLargestPossibleRegion(region);
-  inImage->SetBufferedRegion(region);
-  inImage->SetSpacing(spacing);
-
-  // set up the progress callback
-  itk::CStyleCommand::Pointer progressCommand = itk::CStyleCommand::New();
-  progressCommand->SetClientData(static_cast<void*>(self));
-  progressCommand->SetCallback(vtkITKIslandMathHandleProgressEvent);
-
-  // Calculate the island operation
-  // ccfilter - identifies the islands
-  // relabel - sorts them by size
-  typedef itk::ConnectedComponentImageFilter<ImageType, ImageType> ConnectedComponentType;
-  typename ConnectedComponentType::Pointer ccfilter = ConnectedComponentType::New();
-  typedef itk::RelabelComponentImageFilter<ImageType, ImageType> RelabelComponentType;
-  typename RelabelComponentType::Pointer relabel = RelabelComponentType::New();
-
-  ccfilter->AddObserver(itk::ProgressEvent(), progressCommand);
-  relabel->AddObserver(itk::ProgressEvent(), progressCommand);
-
-  ccfilter->SetFullyConnected(self->GetFullyConnected());
-  ccfilter->SetInput(inImage);
-  relabel->SetInput(ccfilter->GetOutput());
-  relabel->SetMinimumObjectSize(self->GetMinimumSize());
-  relabel->Update();
-  self->SetNumberOfIslands(relabel->GetNumberOfObjects());
-  self->SetOriginalNumberOfIslands(relabel->GetOriginalNumberOfObjects());
-
-  // Copy to the output
-  memcpy(outPtr, relabel->GetOutput()->GetBufferPointer(), relabel->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  int* inExtent = input->GetExtent();
+  const vtkIdType rowsPerSlice = dims[1];
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const bool fullyConnected = self->GetFullyConnected() != 0;
+
+  // Collect runs of foreground (non-zero) voxels in each row.
+  // Runs of each slice are stored separately, so that slices can be processed in parallel.
+  std::vector<std::vector<Run>> sliceRuns(dims[2]);
+  // Index of the first run of each row within the slice (rowsPerSlice+1 values per slice)
+  std::vector<std::vector<vtkIdType>> sliceRowFirstRun(dims[2]);
+  vtkSMPTools::For(0,
+                   dims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+                     {
+                       std::vector<Run>& runs = sliceRuns[k];
+                       std::vector<vtkIdType>& rowFirstRun = sliceRowFirstRun[k];
+                       rowFirstRun.resize(rowsPerSlice + 1);
+                       for (vtkIdType j = 0; j < rowsPerSlice; ++j)
+                       {
+                         rowFirstRun[j] = static_cast<vtkIdType>(runs.size());
+                         const T* row = inPtr + k * sliceSize + j * dims[0];
+                         int i = 0;
+                         while (i < dims[0])
+                         {
+                           if (row[i] == 0)
+                           {
+                             ++i;
+                             continue;
+                           }
+                           Run run;
+                           run.Start = i;
+                           while (i < dims[0] && row[i] != 0)
+                           {
+                             ++i;
+                           }
+                           run.End = i - 1;
+                           runs.push_back(run);
+                         }
+                       }
+                       rowFirstRun[rowsPerSlice] = static_cast<vtkIdType>(runs.size());
+                     }
+                   });
+
+  // Global index of the first run of each slice
+  std::vector<vtkIdType> sliceFirstRun(dims[2] + 1, 0);
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    sliceFirstRun[k + 1] = sliceFirstRun[k] + static_cast<vtkIdType>(sliceRuns[k].size());
+  }
+  const vtkIdType numberOfRuns = sliceFirstRun[dims[2]];
+  self->UpdateProgress(0.25);
+
+  // Merge runs that touch runs in a previous row of the same slice or in the previous slice.
+  // Face-connected runs must overlap, fully connected runs may also touch diagonally.
+  const int overlap = fullyConnected ? 1 : 0;
+  auto unionWithRow = [&](std::vector<vtkIdType>& parents, vtkIdType run, const Run& runExtent, int neighborSlice, vtkIdType neighborRow)
+  {
+    if (neighborRow < 0 || neighborRow >= rowsPerSlice)
+    {
+      return;
+    }
+    const std::vector<Run>& neighborRuns = sliceRuns[neighborSlice];
+    vtkIdType neighborRunsEnd = sliceRowFirstRun[neighborSlice][neighborRow + 1];
+    for (vtkIdType neighborRun = sliceRowFirstRun[neighborSlice][neighborRow]; neighborRun < neighborRunsEnd; ++neighborRun)
+    {
+      const Run& neighborRunExtent = neighborRuns[neighborRun];
+      if (neighborRunExtent.End < runExtent.Start - overlap)
+      {
+        continue;
+      }
+      if (neighborRunExtent.Start > runExtent.End + overlap)
+      {
+        break;
+      }
+      Union(parents, sliceFirstRun[neighborSlice] + neighborRun, run);
+    }
+  };
+  auto unionSlice = [&](std::vector<vtkIdType>& parents, int k, bool withPreviousSlice)
+  {
+    const std::vector<Run>& runs = sliceRuns[k];
+    for (vtkIdType j = 0; j < rowsPerSlice; ++j)
+    {
+      for (vtkIdType run = sliceRowFirstRun[k][j]; run < sliceRowFirstRun[k][j + 1]; ++run)
+      {
+        const vtkIdType globalRun = sliceFirstRun[k] + run;
+        if (!withPreviousSlice)
+        {
+          unionWithRow(parents, globalRun, runs[run], k, j - 1);
+          continue;
+        }
+        if (fullyConnected)
+        {
+          for (vtkIdType neighborRow = j - 1; neighborRow <= j + 1; ++neighborRow)
+          {
+            unionWithRow(parents, globalRun, runs[run], k - 1, neighborRow);
+          }
+        }
+        else
+        {
+          unionWithRow(parents, globalRun, runs[run], k - 1, j);
+        }
+      }
+    }
+  };
+
+  std::vector<vtkIdType> parents(numberOfRuns);
+  std::iota(parents.begin(), parents.end(), 0);
+  // Each block of slices only modifies parents of its own runs, therefore blocks can be processed in parallel.
+  // Connections between the first slice of a block and the previous slice are resolved afterwards.
+  std::vector<char> sliceMergedWithPreviousSlice(dims[2], 0);
+  vtkSMPTools::For(0,
+                   dims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+                     {
+                       unionSlice(parents, k, false);
+                       if (k > firstSlice)
+                       {
+                         unionSlice(parents, k, true);
+                         sliceMergedWithPreviousSlice[k] = 1;
+                       }
+                     }
+                   });
+  for (int k = 1; k < dims[2]; ++k)
+  {
+    if (!sliceMergedWithPreviousSlice[k])
+    {
+      unionSlice(parents, k, true);
+    }
+  }
+  self->UpdateProgress(0.5);
+
+  // Number islands in the order of their first voxel and compute their size and extent.
+  // Parent of each run has lower index, therefore a single pass is enough to resolve all roots.
+  std::vector<vtkIdType> runIslands(numberOfRuns);
+  std::vector<vtkIdType> originalIslandSizes;
+  std::vector<int> originalIslandExtents;
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    const std::vector<Run>& runs = sliceRuns[k];
+    for (vtkIdType j = 0; j < rowsPerSlice; ++j)
+    {
+      for (vtkIdType run = sliceRowFirstRun[k][j]; run < sliceRowFirstRun[k][j + 1]; ++run)
+      {
+        const vtkIdType globalRun = sliceFirstRun[k] + run;
+        vtkIdType island = 0;
+        if (parents[globalRun] == globalRun)
+        {
+          island = static_cast<vtkIdType>(originalIslandSizes.size());
+          originalIslandSizes.push_back(0);
+          const int extent[6] = { runs[run].Start, runs[run].End, static_cast<int>(j), static_cast<int>(j), k, k };
+          originalIslandExtents.insert(originalIslandExtents.end(), extent, extent + 6);
+        }
+        else
+        {
+          parents[globalRun] = parents[parents[globalRun]];
+          island = runIslands[parents[globalRun]];
+        }
+        runIslands[globalRun] = island;
+        originalIslandSizes[island] += runs[run].End - runs[run].Start + 1;
+        int* extent = &originalIslandExtents[6 * island];
+        extent[0] = std::min(extent[0], runs[run].Start);
+        extent[1] = std::max(extent[1], runs[run].End);
+        extent[2] = std::min(extent[2], static_cast<int>(j));
+        extent[3] = std::max(extent[3], static_cast<int>(j));
+        extent[5] = k;
+      }
+    }
+  }
+  self->UpdateProgress(0.75);
+
+  // Sort islands by decreasing size (islands of equal size are kept in the order of their first voxel),
+  // and ignore islands that are too small or too large.
+  const vtkIdType numberOfOriginalIslands = static_cast<vtkIdType>(originalIslandSizes.size());
+  std::vector<vtkIdType> sortedIslands(numberOfOriginalIslands);
+  std::iota(sortedIslands.begin(), sortedIslands.end(), 0);
+  std::stable_sort(sortedIslands.begin(), sortedIslands.end(), [&](vtkIdType a, vtkIdType b) { return originalIslandSizes[a] > originalIslandSizes[b]; });
+  std::vector<T> islandLabels(numberOfOriginalIslands, static_cast<T>(0));
+  for (vtkIdType island : sortedIslands)
+  {
+    if (originalIslandSizes[island] < self->GetMinimumSize() || originalIslandSizes[island] > self->GetMaximumSize())
+    {
+      continue;
+    }
+    if (static_cast<double>(islandSizes.size() + 1) > static_cast<double>(vtkTypeTraits<T>::Max()))
+    {
+      vtkErrorWithObjectMacro(self, "Number of islands exceeds the maximum value of the scalar type, use an image with larger scalar type");
+      break;
+    }
+    islandSizes.push_back(originalIslandSizes[island]);
+    islandLabels[island] = static_cast<T>(islandSizes.size());
+    for (int i = 0; i < 6; ++i)
+    {
+      islandExtents.push_back(originalIslandExtents[6 * island + i] + inExtent[2 * (i / 2)]);
+    }
+  }
+
+  // Write island labels directly to the output
+  vtkSMPTools::For(0,
+                   dims[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+                     {
+                       T* slicePtr = outPtr + k * sliceSize;
+                       std::fill(slicePtr, slicePtr + sliceSize, static_cast<T>(0));
+                       const std::vector<Run>& runs = sliceRuns[k];
+                       for (vtkIdType j = 0; j < rowsPerSlice; ++j)
+                       {
+                         T* row = slicePtr + j * dims[0];
+                         for (vtkIdType run = sliceRowFirstRun[k][j]; run < sliceRowFirstRun[k][j + 1]; ++run)
+                         {
+                           std::fill(row + runs[run].Start, row + runs[run].End + 1, islandLabels[runIslands[sliceFirstRun[k] + run]]);
+                         }
+                       }
+                     }
+                   });
+
+  self->SetNumberOfIslands(static_cast<unsigned long>(islandSizes.size()));
+  self->SetOriginalNumberOfIslands(static_cast<unsigned long>(numberOfOriginalIslands));
 }
 
 //
@@ -120,6 +358,11 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData* input, vtkImageData* output)
 {
   vtkDebugMacro(<< "Executing Island Math");
 
+  this->NumberOfIslands = 0;
+  this->OriginalNumberOfIslands = 0;
+  this->IslandSizes.clear();
+  this->IslandExtents.clear();
+
   //
   // Initialize and check input
   //
@@ -139,30 +382,15 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData* input, vtkImageData* output)
 
   if (inScalars->GetNumberOfComponents() == 1)
   {
-
-////////// These types are not defined in itk ////////////
-#undef VTK_TYPE_USE_LONG_LONG
-#undef VTK_TYPE_USE___INT64
-
-#define CALL vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr));
-
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
 
     switch (inScalars->GetDataType())
     {
-      vtkTemplateMacroCase(VTK_LONG, long, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_LONG, unsigned long, CALL);
-      vtkTemplateMacroCase(VTK_INT, int, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_INT, unsigned int, CALL);
-      vtkTemplateMacroCase(VTK_SHORT, short, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_SHORT, unsigned short, CALL);
-      vtkTemplateMacroCase(VTK_CHAR, char, CALL);
-      vtkTemplateMacroCase(VTK_SIGNED_CHAR, signed char, CALL);
-      vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, CALL);
+      vtkTemplateMacro(vtkITKIslandMathExecute(this, input, static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr), this->IslandSizes, this->IslandExtents));
       default:
       {
-        vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
+        vtkErrorMacro(<< "Incompatible scalar type for island math.");
       }
     } // switch
   }
@@ -13,9 +13,17 @@
 #include "vtkITK.h"
 #include "vtkSimpleImageToImageFilter.h"
 
-/// \brief ITK-based utilities for manipulating connected regions in label maps.
-/// Limitation: The filter does not work correctly with input volume that has
-/// unsigned long scalar type on Linux and macOS.
+// STD includes
+#include <vector>
+
+/// \brief Utilities for manipulating connected regions in label maps.
+///
+/// All non-zero voxels are foreground. Connected foreground regions (islands) are labeled
+/// with consecutive values starting from 1, in decreasing order of size.
+///
+/// Runs of foreground voxels in image rows are merged into islands using a union-find structure.
+/// Rows of each block of slices are merged in parallel, islands are relabeled directly in the
+/// output image, without allocating intermediate images.
 ///
 class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
 {
@@ -58,6 +66,16 @@ public:
   vtkGetMacro(OriginalNumberOfIslands, unsigned long);
   vtkSetMacro(OriginalNumberOfIslands, unsigned long);
 
+  ///
+  /// Number of voxels in the island. Island index is the label value of the island minus 1.
+  /// Valid after the filter is updated.
+  vtkIdType GetIslandSize(unsigned long islandIndex);
+
+  ///
+  /// Bounding box of the island, in the extent of the input image.
+  /// Island index is the label value of the island minus 1. Valid after the filter is updated.
+  void GetIslandExtent(unsigned long islandIndex, int extent[6]);
+
 protected:
   vtkITKIslandMath();
   ~vtkITKIslandMath() override;
@@ -72,6 +90,10 @@ protected:
   unsigned long NumberOfIslands;
   unsigned long OriginalNumberOfIslands;
 
+  std::vector<vtkIdType> IslandSizes;
+  /// Extent of each island (6 values per island)
+  std::vector<int> IslandExtents;
+
 private:
   vtkITKIslandMath(const vtkITKIslandMath&) = delete;
   void operator=(const vtkITKIslandMath&) = delete;
@@ -0,0 +1,267 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// SegmentationCore includes
+#include "vtkBrushStrokeRasterizer.h"
+#include "vtkOrientedImageData.h"
+
+namespace
+{
+
+const double RADIUS = 2.5;
+const double CYLINDER_HEIGHT = 1.2;
+
+//----------------------------------------------------------------------------
+void CreateImage(vtkOrientedImageData* image)
+{
+  image->SetExtent(-5, 24, 0, 19, 0, 14);
+  image->SetSpacing(0.7, 0.9, 1.1);
+  image->SetOrigin(-3.0, 2.0, 1.0);
+  // Rotated around the second axis by 30 degrees
+  const double c = cos(vtkMath::RadiansFromDegrees(30.0));
+  const double s = sin(vtkMath::RadiansFromDegrees(30.0));
+  double directions[3][3] = { { c, 0.0, s }, { 0.0, 1.0, 0.0 }, { -s, 0.0, c } };
+  image->SetDirections(directions);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  image->GetPointData()->GetScalars()->Fill(0.0);
+}
+
+//----------------------------------------------------------------------------
+/// Distance of point from the segment between start and end, measured in the plane orthogonal to axis
+/// (if axis is nullptr then the 3D distance is computed).
+double DistanceFromSegment(const double point[3], const double start[3], const double end[3], const double* axis)
+{
+  double u[3] = { point[0] - start[0], point[1] - start[1], point[2] - start[2] };
+  double d[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+  if (axis)
+  {
+    double uAxial = vtkMath::Dot(u, axis);
+    double dAxial = vtkMath::Dot(d, axis);
+    for (int i = 0; i < 3; ++i)
+    {
+      u[i] -= uAxial * axis[i];
+      d[i] -= dAxial * axis[i];
+    }
+  }
+  double t = 0.0;
+  if (vtkMath::Dot(d, d) > 0.0)
+  {
+    t = std::max(0.0, std::min(1.0, vtkMath::Dot(u, d) / vtkMath::Dot(d, d)));
+  }
+  double closest[3] = { u[0] - t * d[0], u[1] - t * d[1], u[2] - t * d[2] };
+  return vtkMath::Norm(closest);
+}
+
+//----------------------------------------------------------------------------
+/// Returns -1 if the voxel center is too close to the brush boundary to decide reliably,
+/// otherwise 1 if inside the stroke and 0 if outside.
+int ExpectedVoxelValue(const double point[3], vtkPoints* stroke, const double* cylinderAxis)
+{
+  const double tolerance = 1e-6;
+  int value = 0;
+  for (vtkIdType pointIndex = 0; pointIndex < std::max(vtkIdType(1), stroke->GetNumberOfPoints() - 1); ++pointIndex)
+  {
+    double start[3] = { 0.0, 0.0, 0.0 };
+    double end[3] = { 0.0, 0.0, 0.0 };
+    stroke->GetPoint(pointIndex, start);
+    stroke->GetPoint(std::min(pointIndex + 1, stroke->GetNumberOfPoints() - 1), end);
+    double distance = DistanceFromSegment(point, start, end, cylinderAxis);
+    if (cylinderAxis)
+    {
+      // In-plane stroke: the distance along the axis is the same for all positions of the brush
+      double u[3] = { point[0] - start[0], point[1] - start[1], point[2] - start[2] };
+      double axialDistance = fabs(vtkMath::Dot(u, cylinderAxis));
+      if (fabs(axialDistance - CYLINDER_HEIGHT / 2.0) < tolerance)
+      {
+        return -1;
+      }
+      if (axialDistance > CYLINDER_HEIGHT / 2.0)
+      {
+        continue;
+      }
+    }
+    if (fabs(distance - RADIUS) < tolerance)
+    {
+      return -1;
+    }
+    if (distance < RADIUS)
+    {
+      value = 1;
+    }
+  }
+  return value;
+}
+
+//----------------------------------------------------------------------------
+bool CheckStroke(vtkBrushStrokeRasterizer* rasterizer, vtkPoints* stroke, const double* cylinderAxis, vtkMatrix4x4* physicalToWorld)
+{
+  vtkNew<vtkOrientedImageData> image;
+  CreateImage(image);
+  rasterizer->SetImagePhysicalToWorldMatrix(physicalToWorld);
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!rasterizer->Rasterize(image, stroke, modifiedExtent))
+  {
+    std::cerr << __LINE__ << ": Rasterize failed" << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkMatrix4x4> ijkToWorld;
+  image->GetImageToWorldMatrix(ijkToWorld);
+  if (physicalToWorld)
+  {
+    vtkNew<vtkMatrix4x4> ijkToPhysical;
+    ijkToPhysical->DeepCopy(ijkToWorld);
+    vtkMatrix4x4::Multiply4x4(physicalToWorld, ijkToPhysical, ijkToWorld);
+  }
+
+  int* extent = image->GetExtent();
+  int expectedExtent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  int numberOfPaintedVoxels = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        double ijk[4] = { double(i), double(j), double(k), 1.0 };
+        double world[4] = { 0.0, 0.0, 0.0, 1.0 };
+        ijkToWorld->MultiplyPoint(ijk, world);
+        int value = *static_cast<unsigned char*>(image->GetScalarPointer(i, j, k));
+        if (value)
+        {
+          const int voxel[3] = { i, j, k };
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            expectedExtent[axis * 2] = std::min(expectedExtent[axis * 2], voxel[axis]);
+            expectedExtent[axis * 2 + 1] = std::max(expectedExtent[axis * 2 + 1], voxel[axis]);
+          }
+          ++numberOfPaintedVoxels;
+        }
+        int expectedValue = ExpectedVoxelValue(world, stroke, cylinderAxis);
+        if (expectedValue >= 0 && value != expectedValue)
+        {
+          std::cerr << __LINE__ << ": Voxel (" << i << ", " << j << ", " << k << ") value mismatch: " << value << " should be " << expectedValue << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  if (numberOfPaintedVoxels == 0)
+  {
+    std::cerr << __LINE__ << ": No voxels were painted" << std::endl;
+    return false;
+  }
+  if (!std::equal(modifiedExtent, modifiedExtent + 6, expectedExtent))
+  {
+    std::cerr << __LINE__ << ": Modified extent mismatch: " << modifiedExtent[0] << ", " << modifiedExtent[1] << ", " << modifiedExtent[2] << ", " << modifiedExtent[3] << ", "
+              << modifiedExtent[4] << ", " << modifiedExtent[5] << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkBrushStrokeRasterizerTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkBrushStrokeRasterizer> rasterizer;
+  rasterizer->SetBrushRadius(RADIUS);
+  rasterizer->SetFillValue(1);
+
+  // Stroke with a sharp turn, partially outside of the image
+  vtkNew<vtkPoints> stroke;
+  stroke->InsertNextPoint(-4.0, 5.0, 4.0);
+  stroke->InsertNextPoint(4.0, 9.0, 6.0);
+  stroke->InsertNextPoint(1.0, 16.0, 5.0);
+  stroke->InsertNextPoint(2.0, 25.0, 5.5);
+
+  // Single brush position
+  vtkNew<vtkPoints> singlePoint;
+  singlePoint->InsertNextPoint(3.0, 10.0, 6.0);
+
+  // Sphere brush
+  rasterizer->SetBrushShapeToSphere();
+  if (!CheckStroke(rasterizer, stroke, nullptr, nullptr) || !CheckStroke(rasterizer, singlePoint, nullptr, nullptr))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Cylinder brush, stroke is in the plane orthogonal to the cylinder axis
+  double axis[3] = { 0.0, 0.0, 1.0 };
+  vtkNew<vtkPoints> inPlaneStroke;
+  inPlaneStroke->InsertNextPoint(-4.0, 5.0, 5.3);
+  inPlaneStroke->InsertNextPoint(4.0, 9.0, 5.3);
+  inPlaneStroke->InsertNextPoint(1.0, 16.0, 5.3);
+  rasterizer->SetBrushShapeToCylinder();
+  rasterizer->SetCylinderHeight(CYLINDER_HEIGHT);
+  rasterizer->SetCylinderAxis(axis);
+  if (!CheckStroke(rasterizer, inPlaneStroke, axis, nullptr))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Linear transform between image physical and world coordinate systems
+  vtkNew<vtkMatrix4x4> physicalToWorld;
+  physicalToWorld->SetElement(0, 1, -1.0);
+  physicalToWorld->SetElement(1, 0, 1.0);
+  physicalToWorld->SetElement(1, 1, 0.0);
+  physicalToWorld->SetElement(0, 0, 0.0);
+  physicalToWorld->SetElement(0, 3, 12.0);
+  physicalToWorld->SetElement(2, 3, -1.5);
+  vtkNew<vtkPoints> transformedStroke;
+  transformedStroke->InsertNextPoint(6.0, -2.0, 3.8);
+  transformedStroke->InsertNextPoint(0.0, 3.0, 3.8);
+  if (!CheckStroke(rasterizer, transformedStroke, axis, physicalToWorld))
+  {
+    return EXIT_FAILURE;
+  }
+  rasterizer->SetBrushShapeToSphere();
+  if (!CheckStroke(rasterizer, transformedStroke, nullptr, physicalToWorld))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Stroke outside of the image
+  vtkNew<vtkPoints> outsideStroke;
+  outsideStroke->InsertNextPoint(100.0, 100.0, 100.0);
+  outsideStroke->InsertNextPoint(110.0, 100.0, 100.0);
+  vtkNew<vtkOrientedImageData> image;
+  CreateImage(image);
+  rasterizer->SetImagePhysicalToWorldMatrix(nullptr);
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!rasterizer->Rasterize(image, outsideStroke, modifiedExtent) || modifiedExtent[0] <= modifiedExtent[1])
+  {
+    std::cerr << __LINE__ << ": Stroke outside of the image should not modify the image" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
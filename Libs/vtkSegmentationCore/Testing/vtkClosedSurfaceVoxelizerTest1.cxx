@@ -0,0 +1,281 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkCubeSource.h>
+#include <vtkImageAccumulate.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+// SegmentationCore includes
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include "vtkClosedSurfaceVoxelizer.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+
+namespace
+{
+
+const double SPHERE_CENTER[3] = { 2.0, 3.0, 4.0 };
+const double SPHERE_RADIUS = 10.0;
+
+//----------------------------------------------------------------------------
+void CreateSphere(vtkPolyData* polyData)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(SPHERE_CENTER[0], SPHERE_CENTER[1], SPHERE_CENTER[2]);
+  sphere->SetRadius(SPHERE_RADIUS);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->Update();
+  polyData->ShallowCopy(sphere->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+void CreateCube(vtkPolyData* polyData, double xMin, double xMax, double yMin, double yMax, double zMin, double zMax)
+{
+  vtkNew<vtkCubeSource> cube;
+  cube->SetBounds(xMin, xMax, yMin, yMax, zMin, zMax);
+  cube->Update();
+  polyData->ShallowCopy(cube->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+void CreateImage(vtkOrientedImageData* image, int scalarType)
+{
+  image->SetExtent(-2, 30, 0, 27, 0, 24);
+  image->SetSpacing(0.8, 0.9, 1.1);
+  image->SetOrigin(-10.0, -8.0, -7.0);
+  // Rotated around the first axis by 20 degrees
+  const double c = cos(vtkMath::RadiansFromDegrees(20.0));
+  const double s = sin(vtkMath::RadiansFromDegrees(20.0));
+  double directions[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, c, -s }, { 0.0, s, c } };
+  image->SetDirections(directions);
+  image->AllocateScalars(scalarType, 1);
+}
+
+//----------------------------------------------------------------------------
+bool TestSphere()
+{
+  vtkNew<vtkPolyData> sphere;
+  CreateSphere(sphere);
+  vtkNew<vtkOrientedImageData> image;
+  CreateImage(image, VTK_UNSIGNED_CHAR);
+  image->GetPointData()->GetScalars()->Fill(255.0);
+
+  vtkNew<vtkClosedSurfaceVoxelizer> voxelizer;
+  voxelizer->AddInputSurface(sphere, 3.0);
+  if (!voxelizer->Voxelize(image))
+  {
+    std::cerr << __LINE__ << ": Voxelize failed" << std::endl;
+    return false;
+  }
+
+  // The polygonal sphere is inside the ideal sphere, close to its surface
+  const double tolerance = 0.2;
+  vtkNew<vtkMatrix4x4> ijkToWorld;
+  image->GetImageToWorldMatrix(ijkToWorld);
+  int* extent = image->GetExtent();
+  int numberOfInsideVoxels = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        double ijk[4] = { double(i), double(j), double(k), 1.0 };
+        double world[4] = { 0.0, 0.0, 0.0, 1.0 };
+        ijkToWorld->MultiplyPoint(ijk, world);
+        double distance = sqrt(vtkMath::Distance2BetweenPoints(world, SPHERE_CENTER));
+        int value = *static_cast<unsigned char*>(image->GetScalarPointer(i, j, k));
+        int expectedValue = -1;
+        if (distance < SPHERE_RADIUS - tolerance)
+        {
+          expectedValue = 3;
+        }
+        else if (distance > SPHERE_RADIUS)
+        {
+          expectedValue = 0;
+        }
+        if (expectedValue >= 0 && value != expectedValue)
+        {
+          std::cerr << __LINE__ << ": Voxel (" << i << ", " << j << ", " << k << ") value mismatch: " << value << " should be " << expectedValue << std::endl;
+          return false;
+        }
+        if (value == 3)
+        {
+          ++numberOfInsideVoxels;
+        }
+      }
+    }
+  }
+  if (numberOfInsideVoxels == 0)
+  {
+    std::cerr << __LINE__ << ": No voxels were filled" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestOverlappingSurfaces()
+{
+  vtkNew<vtkPolyData> cube1;
+  CreateCube(cube1, -0.5, 3.5, -0.5, 3.5, -0.5, 3.5);
+  vtkNew<vtkPolyData> cube2;
+  CreateCube(cube2, 1.5, 5.5, -0.5, 3.5, -0.5, 3.5);
+
+  vtkNew<vtkOrientedImageData> image;
+  image->SetExtent(0, 7, 0, 4, 0, 4);
+  image->AllocateScalars(VTK_SHORT, 1);
+
+  vtkNew<vtkClosedSurfaceVoxelizer> voxelizer;
+  voxelizer->AddInputSurface(cube1, 1.0);
+  voxelizer->AddInputSurface(cube2, 2.0);
+  if (!voxelizer->Voxelize(image))
+  {
+    std::cerr << __LINE__ << ": Voxelize failed" << std::endl;
+    return false;
+  }
+  // Voxels are set to the label of the last added surface that contains them
+  const int expectedRow[8] = { 1, 1, 2, 2, 2, 2, 0, 0 };
+  for (int k = 0; k <= 4; ++k)
+  {
+    for (int j = 0; j <= 4; ++j)
+    {
+      for (int i = 0; i <= 7; ++i)
+      {
+        int expectedValue = (j <= 3 && k <= 3) ? expectedRow[i] : 0;
+        int value = *static_cast<short*>(image->GetScalarPointer(i, j, k));
+        if (value != expectedValue)
+        {
+          std::cerr << __LINE__ << ": Voxel (" << i << ", " << j << ", " << k << ") value mismatch: " << value << " should be " << expectedValue << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestSubsampling()
+{
+  // Cube boundary at 2.0 along the first axis cuts voxel 2 in half
+  vtkNew<vtkPolyData> cube;
+  CreateCube(cube, -0.5, 2.0, -0.5, 1.5, -0.5, 0.5);
+
+  vtkNew<vtkOrientedImageData> image;
+  image->SetExtent(0, 3, 0, 2, 0, 1);
+  image->AllocateScalars(VTK_CHAR, 1);
+
+  vtkNew<vtkClosedSurfaceVoxelizer> voxelizer;
+  voxelizer->AddInputSurface(cube, 100.0);
+  voxelizer->SetBackgroundValue(-100.0);
+  voxelizer->SetNumberOfSubsamples(4);
+  if (!voxelizer->Voxelize(image))
+  {
+    std::cerr << __LINE__ << ": Voxelize failed" << std::endl;
+    return false;
+  }
+  const int expectedRow[4] = { 100, 100, 0, -100 };
+  for (int k = 0; k <= 1; ++k)
+  {
+    for (int j = 0; j <= 2; ++j)
+    {
+      for (int i = 0; i <= 3; ++i)
+      {
+        int expectedValue = (j <= 1 && k == 0) ? expectedRow[i] : -100;
+        int value = *static_cast<char*>(image->GetScalarPointer(i, j, k));
+        if (value != expectedValue)
+        {
+          std::cerr << __LINE__ << ": Voxel (" << i << ", " << j << ", " << k << ") value mismatch: " << value << " should be " << expectedValue << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Compare number of foreground voxels created by scanline voxelization and image stencil in the conversion rule
+bool TestConversionRule()
+{
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+
+  int numberOfForegroundVoxels[2] = { 0, 0 };
+  for (int scanline = 0; scanline < 2; ++scanline)
+  {
+    vtkNew<vtkPolyData> sphere;
+    CreateSphere(sphere);
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), sphere);
+    vtkNew<vtkSegmentation> segmentation;
+    segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+    segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+                                         "0.8; 0; 0; -10;"
+                                         "0; 0.9; 0; -8;"
+                                         "0; 0; 1.1; -7;"
+                                         "0; 0; 0; 1;"
+                                         "0; 30; 0; 27; 0; 24;");
+    segmentation->SetConversionParameter(vtkClosedSurfaceToBinaryLabelmapConversionRule::GetScanlineVoxelizationParameterName(), scanline ? "1" : "0");
+    segmentation->AddSegment(segment);
+    if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()))
+    {
+      std::cerr << __LINE__ << ": Conversion to binary labelmap failed" << std::endl;
+      return false;
+    }
+    vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    vtkNew<vtkImageAccumulate> imageAccumulate;
+    imageAccumulate->SetInputData(labelmap);
+    imageAccumulate->IgnoreZeroOn();
+    imageAccumulate->Update();
+    numberOfForegroundVoxels[scanline] = imageAccumulate->GetVoxelCount();
+  }
+  // Only voxels that have their center very close to the surface may be different
+  if (numberOfForegroundVoxels[1] == 0 || std::abs(numberOfForegroundVoxels[0] - numberOfForegroundVoxels[1]) > numberOfForegroundVoxels[0] / 200)
+  {
+    std::cerr << __LINE__ << ": Number of foreground voxels mismatch: stencil " << numberOfForegroundVoxels[0] << ", scanline " << numberOfForegroundVoxels[1] << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkClosedSurfaceVoxelizerTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (!TestSphere() || !TestOverlappingSurfaces() || !TestSubsampling() || !TestConversionRule())
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,249 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationStatistics.h"
+
+namespace
+{
+
+const double SPACING = 0.5;
+
+//----------------------------------------------------------------------------
+void CreateBoxLabelmap(vtkOrientedImageData* imageData, const int boxExtent[6])
+{
+  int extent[6] = { 0, 9, 0, 9, 0, 9 };
+  imageData->SetExtent(extent);
+  imageData->SetSpacing(SPACING, SPACING, SPACING);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  imageData->GetPointData()->GetScalars()->Fill(0.0);
+  for (int k = boxExtent[4]; k <= boxExtent[5]; ++k)
+  {
+    for (int j = boxExtent[2]; j <= boxExtent[3]; ++j)
+    {
+      for (int i = boxExtent[0]; i <= boxExtent[1]; ++i)
+      {
+        *static_cast<unsigned char*>(imageData->GetScalarPointer(i, j, k)) = 1;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+double GetScalarValue(int i, int j, int k)
+{
+  return i + 10 * j + 100 * k;
+}
+
+//----------------------------------------------------------------------------
+bool IsEqual(double a, double b)
+{
+  return std::fabs(a - b) < 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+//----------------------------------------------------------------------------
+bool CheckSegmentStatistics(vtkSegmentationStatistics* statistics, const std::string& segmentID, const int boxExtent[6], bool intensity)
+{
+  // Compute expected values with brute force
+  std::vector<double> values;
+  for (int k = boxExtent[4]; k <= boxExtent[5]; ++k)
+  {
+    for (int j = boxExtent[2]; j <= boxExtent[3]; ++j)
+    {
+      for (int i = boxExtent[0]; i <= boxExtent[1]; ++i)
+      {
+        values.push_back(GetScalarValue(i, j, k));
+      }
+    }
+  }
+  std::sort(values.begin(), values.end());
+  double sum = 0.0;
+  for (double value : values)
+  {
+    sum += value;
+  }
+  double mean = sum / values.size();
+  double sumOfSquaredDifferences = 0.0;
+  for (double value : values)
+  {
+    sumOfSquaredDifferences += (value - mean) * (value - mean);
+  }
+  double standardDeviation = sqrt(sumOfSquaredDifferences / (values.size() - 1));
+  double median = values[static_cast<size_t>(ceil(0.5 * values.size())) - 1];
+  double percentile90 = values[static_cast<size_t>(ceil(0.9 * values.size())) - 1];
+
+  if (!statistics->HasStatistics(segmentID))
+  {
+    std::cerr << __LINE__ << ": No statistics for segment " << segmentID << std::endl;
+    return false;
+  }
+  if (statistics->GetVoxelCount(segmentID) != static_cast<vtkIdType>(values.size()))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " voxel count mismatch: " << statistics->GetVoxelCount(segmentID) << " should be " << values.size() << std::endl;
+    return false;
+  }
+  if (!IsEqual(statistics->GetVolume(segmentID), values.size() * SPACING * SPACING * SPACING))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " volume mismatch: " << statistics->GetVolume(segmentID) << std::endl;
+    return false;
+  }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!statistics->GetExtent(segmentID, extent) || !std::equal(extent, extent + 6, boxExtent))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " extent mismatch" << std::endl;
+    return false;
+  }
+  if (!intensity)
+  {
+    return true;
+  }
+  if (!IsEqual(statistics->GetMinimum(segmentID), values.front()) || !IsEqual(statistics->GetMaximum(segmentID), values.back()))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " range mismatch: " << statistics->GetMinimum(segmentID) << ", " << statistics->GetMaximum(segmentID)
+              << " should be " << values.front() << ", " << values.back() << std::endl;
+    return false;
+  }
+  if (!IsEqual(statistics->GetMean(segmentID), mean) || !IsEqual(statistics->GetStandardDeviation(segmentID), standardDeviation))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " mean/stdev mismatch: " << statistics->GetMean(segmentID) << ", " << statistics->GetStandardDeviation(segmentID)
+              << " should be " << mean << ", " << standardDeviation << std::endl;
+    return false;
+  }
+  if (!IsEqual(statistics->GetMedian(segmentID), median) || !IsEqual(statistics->GetPercentile(segmentID, 90.0), percentile90))
+  {
+    std::cerr << __LINE__ << ": Segment " << segmentID << " percentile mismatch: " << statistics->GetMedian(segmentID) << ", " << statistics->GetPercentile(segmentID, 90.0)
+              << " should be " << median << ", " << percentile90 << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Two non-overlapping segments that are stored in a shared labelmap and a third one in a separate layer
+  const int boxExtent1[6] = { 1, 4, 1, 4, 1, 4 };
+  const int boxExtent2[6] = { 5, 8, 1, 4, 2, 7 };
+  const int boxExtent3[6] = { 2, 6, 2, 6, 2, 6 };
+  const int* boxExtents[3] = { boxExtent1, boxExtent2, boxExtent3 };
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  std::vector<std::string> segmentIDs;
+  for (int segmentIndex = 0; segmentIndex < 3; ++segmentIndex)
+  {
+    vtkNew<vtkOrientedImageData> labelmap;
+    CreateBoxLabelmap(labelmap, boxExtents[segmentIndex]);
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+    std::string segmentID = segmentation->GenerateUniqueSegmentID("Segment");
+    segmentation->AddSegment(segment, segmentID);
+    segmentIDs.push_back(segmentID);
+  }
+  // Empty segment
+  std::string emptySegmentID = segmentation->AddEmptySegment();
+  segmentation->CollapseBinaryLabelmaps(false);
+  int numberOfLayers = segmentation->GetNumberOfLayers();
+  if (numberOfLayers != 2)
+  {
+    std::cerr << __LINE__ << ": Invalid number of layers " << numberOfLayers << " should be 2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkSegmentationStatistics> statistics;
+  statistics->SetSegmentation(segmentation);
+
+  // Geometric statistics only
+  if (!statistics->Update())
+  {
+    std::cerr << __LINE__ << ": Update failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int segmentIndex = 0; segmentIndex < 3; ++segmentIndex)
+  {
+    if (!CheckSegmentStatistics(statistics, segmentIDs[segmentIndex], boxExtents[segmentIndex], false))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!statistics->HasStatistics(emptySegmentID) || statistics->GetVoxelCount(emptySegmentID) != 0)
+  {
+    std::cerr << __LINE__ << ": Invalid statistics for empty segment" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Intensity statistics
+  vtkNew<vtkOrientedImageData> scalarVolume;
+  scalarVolume->SetExtent(0, 9, 0, 9, 0, 9);
+  scalarVolume->SetSpacing(SPACING, SPACING, SPACING);
+  scalarVolume->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k <= 9; ++k)
+  {
+    for (int j = 0; j <= 9; ++j)
+    {
+      for (int i = 0; i <= 9; ++i)
+      {
+        *static_cast<short*>(scalarVolume->GetScalarPointer(i, j, k)) = static_cast<short>(GetScalarValue(i, j, k));
+      }
+    }
+  }
+  statistics->SetScalarVolume(scalarVolume);
+  if (!statistics->Update())
+  {
+    std::cerr << __LINE__ << ": Update failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int segmentIndex = 0; segmentIndex < 3; ++segmentIndex)
+  {
+    if (!CheckSegmentStatistics(statistics, segmentIDs[segmentIndex], boxExtents[segmentIndex], true))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Subset of segments
+  statistics->SetSegmentIDs(std::vector<std::string>{ segmentIDs[1] });
+  if (!statistics->Update())
+  {
+    std::cerr << __LINE__ << ": Update failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (statistics->HasStatistics(segmentIDs[0]) || !CheckSegmentStatistics(statistics, segmentIDs[1], boxExtents[1], true))
+  {
+    std::cerr << __LINE__ << ": Invalid statistics for subset of segments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,373 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkBrushStrokeRasterizer.h"
+#include "vtkOrientedImageData.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkBrushStrokeRasterizer);
+
+vtkCxxSetObjectMacro(vtkBrushStrokeRasterizer, ImagePhysicalToWorldMatrix, vtkMatrix4x4);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Straight part of the stroke between two consecutive brush positions
+struct StrokeSegment
+{
+  double Start[3]{ 0.0, 0.0, 0.0 };
+  double Direction[3]{ 0.0, 0.0, 0.0 }; // end - start
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 }; // voxels that may be painted by this segment
+};
+
+//----------------------------------------------------------------------------
+struct BrushParameters
+{
+  bool Cylinder{ false };
+  double Radius{ 0.0 };
+  double HalfHeight{ 0.0 };
+  double Axis[3]{ 0.0, 0.0, 1.0 };
+};
+
+//----------------------------------------------------------------------------
+struct PaintedExtent
+{
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+};
+
+//----------------------------------------------------------------------------
+/// Restrict [minimum, maximum] range of t to where a*t^2 + b*t + c <= 0 (a >= 0).
+/// \return False if the resulting range is empty.
+bool RestrictToQuadraticInequality(double a, double b, double c, double& minimum, double& maximum)
+{
+  const double epsilon = 1e-12;
+  if (a < epsilon)
+  {
+    if (fabs(b) < epsilon)
+    {
+      return c <= 0.0;
+    }
+    double t = -c / b;
+    if (b > 0.0)
+    {
+      maximum = std::min(maximum, t);
+    }
+    else
+    {
+      minimum = std::max(minimum, t);
+    }
+    return minimum <= maximum;
+  }
+  double discriminant = b * b - 4.0 * a * c;
+  if (discriminant < 0.0)
+  {
+    return false;
+  }
+  double sqrtDiscriminant = sqrt(discriminant);
+  minimum = std::max(minimum, (-b - sqrtDiscriminant) / (2.0 * a));
+  maximum = std::min(maximum, (-b + sqrtDiscriminant) / (2.0 * a));
+  return minimum <= maximum;
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the brush contains the point at any position along the segment.
+/// Position along the segment is parametrized by t (0 = start, 1 = end). For each constraint the range of t
+/// where the constraint is fulfilled is computed analytically and the point is inside if these ranges overlap.
+bool IsInsideSweptBrush(const double point[3], const StrokeSegment& segment, const BrushParameters& brush)
+{
+  double u[3] = { point[0] - segment.Start[0], point[1] - segment.Start[1], point[2] - segment.Start[2] };
+  const double* d = segment.Direction;
+  double tMin = 0.0;
+  double tMax = 1.0;
+  if (!brush.Cylinder)
+  {
+    // |u - t*d|^2 <= r^2
+    return RestrictToQuadraticInequality(vtkMath::Dot(d, d), -2.0 * vtkMath::Dot(u, d), vtkMath::Dot(u, u) - brush.Radius * brush.Radius, tMin, tMax);
+  }
+
+  // Distance along the cylinder axis: |uAxial - t*dAxial| <= h/2
+  double uAxial = vtkMath::Dot(u, brush.Axis);
+  double dAxial = vtkMath::Dot(d, brush.Axis);
+  if (!RestrictToQuadraticInequality(dAxial * dAxial, -2.0 * uAxial * dAxial, uAxial * uAxial - brush.HalfHeight * brush.HalfHeight, tMin, tMax))
+  {
+    return false;
+  }
+  // Distance from the cylinder axis: |uRadial - t*dRadial|^2 <= r^2
+  double uRadial[3] = { u[0] - uAxial * brush.Axis[0], u[1] - uAxial * brush.Axis[1], u[2] - uAxial * brush.Axis[2] };
+  double dRadial[3] = { d[0] - dAxial * brush.Axis[0], d[1] - dAxial * brush.Axis[1], d[2] - dAxial * brush.Axis[2] };
+  return RestrictToQuadraticInequality(
+    vtkMath::Dot(dRadial, dRadial), -2.0 * vtkMath::Dot(uRadial, dRadial), vtkMath::Dot(uRadial, uRadial) - brush.Radius * brush.Radius, tMin, tMax);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void PaintStrokeSegments(vtkOrientedImageData* image,
+                         const std::vector<StrokeSegment>& segments,
+                         const BrushParameters& brush,
+                         vtkMatrix4x4* ijkToWorldMatrix,
+                         double fillValue,
+                         const int paintExtent[6],
+                         int modifiedExtent[6])
+{
+  T* imagePtr = static_cast<T*>(image->GetScalarPointer());
+  vtkIdType increments[3] = { 0, 0, 0 };
+  image->GetIncrements(increments);
+  int* imageExtent = image->GetExtent();
+  const T valueToSet = static_cast<T>(fillValue);
+
+  // World coordinates of voxel (i, j, k) = origin + i * axisI + j * axisJ + k * axisK
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double axisI[3] = { 0.0, 0.0, 0.0 };
+  double axisJ[3] = { 0.0, 0.0, 0.0 };
+  double axisK[3] = { 0.0, 0.0, 0.0 };
+  for (int row = 0; row < 3; row++)
+  {
+    axisI[row] = ijkToWorldMatrix->GetElement(row, 0);
+    axisJ[row] = ijkToWorldMatrix->GetElement(row, 1);
+    axisK[row] = ijkToWorldMatrix->GetElement(row, 2);
+    origin[row] = ijkToWorldMatrix->GetElement(row, 3);
+  }
+
+  // Each thread paints a different set of slices, therefore voxels are never written by multiple threads
+  vtkSMPThreadLocal<PaintedExtent> threadPaintedExtents;
+  vtkSMPTools::For(paintExtent[4],
+                   paintExtent[5] + 1,
+                   [&](vtkIdType firstK, vtkIdType lastK)
+                   {
+                     int* painted = threadPaintedExtents.Local().Extent;
+                     for (int k = static_cast<int>(firstK); k < static_cast<int>(lastK); k++)
+                     {
+                       for (const StrokeSegment& segment : segments)
+                       {
+                         if (k < segment.Extent[4] || k > segment.Extent[5])
+                         {
+                           continue;
+                         }
+                         for (int j = segment.Extent[2]; j <= segment.Extent[3]; j++)
+                         {
+                           T* rowPtr = imagePtr + (j - imageExtent[2]) * increments[1] + (k - imageExtent[4]) * increments[2];
+                           for (int i = segment.Extent[0]; i <= segment.Extent[1]; i++)
+                           {
+                             double point[3] = { origin[0] + i * axisI[0] + j * axisJ[0] + k * axisK[0],
+                                                 origin[1] + i * axisI[1] + j * axisJ[1] + k * axisK[1],
+                                                 origin[2] + i * axisI[2] + j * axisJ[2] + k * axisK[2] };
+                             if (!IsInsideSweptBrush(point, segment, brush))
+                             {
+                               continue;
+                             }
+                             rowPtr[(i - imageExtent[0]) * increments[0]] = valueToSet;
+                             const int ijk[3] = { i, j, k };
+                             for (int axis = 0; axis < 3; axis++)
+                             {
+                               painted[axis * 2] = std::min(painted[axis * 2], ijk[axis]);
+                               painted[axis * 2 + 1] = std::max(painted[axis * 2 + 1], ijk[axis]);
+                             }
+                           }
+                         }
+                       }
+                     }
+                   });
+
+  PaintedExtent paintedExtent;
+  for (const PaintedExtent& threadPaintedExtent : threadPaintedExtents)
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      paintedExtent.Extent[axis * 2] = std::min(paintedExtent.Extent[axis * 2], threadPaintedExtent.Extent[axis * 2]);
+      paintedExtent.Extent[axis * 2 + 1] = std::max(paintedExtent.Extent[axis * 2 + 1], threadPaintedExtent.Extent[axis * 2 + 1]);
+    }
+  }
+  if (paintedExtent.Extent[0] <= paintedExtent.Extent[1])
+  {
+    std::copy(paintedExtent.Extent, paintedExtent.Extent + 6, modifiedExtent);
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkBrushStrokeRasterizer::vtkBrushStrokeRasterizer() = default;
+
+//----------------------------------------------------------------------------
+vtkBrushStrokeRasterizer::~vtkBrushStrokeRasterizer()
+{
+  this->SetImagePhysicalToWorldMatrix(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrushStrokeRasterizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BrushShape: " << (this->BrushShape == BrushShapeCylinder ? "Cylinder" : "Sphere") << "\n";
+  os << indent << "BrushRadius: " << this->BrushRadius << "\n";
+  os << indent << "CylinderHeight: " << this->CylinderHeight << "\n";
+  os << indent << "CylinderAxis: " << this->CylinderAxis[0] << " " << this->CylinderAxis[1] << " " << this->CylinderAxis[2] << "\n";
+  os << indent << "FillValue: " << this->FillValue << "\n";
+  os << indent << "ImagePhysicalToWorldMatrix:";
+  if (this->ImagePhysicalToWorldMatrix)
+  {
+    os << "\n";
+    this->ImagePhysicalToWorldMatrix->PrintSelf(os, indent.GetNextIndent());
+  }
+  else
+  {
+    os << " (none)\n";
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrushStrokeRasterizer::Rasterize(vtkOrientedImageData* image, vtkPoints* strokePoints_World, int modifiedExtent[6])
+{
+  for (int axis = 0; axis < 3; axis++)
+  {
+    modifiedExtent[axis * 2] = 0;
+    modifiedExtent[axis * 2 + 1] = -1;
+  }
+  if (!image || !strokePoints_World)
+  {
+    vtkErrorMacro("Rasterize: Invalid input");
+    return false;
+  }
+  if (!image->GetPointData() || !image->GetPointData()->GetScalars())
+  {
+    vtkErrorMacro("Rasterize: Image scalars are not allocated");
+    return false;
+  }
+  int imageExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(imageExtent);
+  vtkIdType numberOfPoints = strokePoints_World->GetNumberOfPoints();
+  if (numberOfPoints == 0 || imageExtent[0] > imageExtent[1] || imageExtent[2] > imageExtent[3] || imageExtent[4] > imageExtent[5])
+  {
+    // nothing to paint
+    return true;
+  }
+
+  BrushParameters brush;
+  brush.Cylinder = (this->BrushShape == BrushShapeCylinder);
+  brush.Radius = this->BrushRadius;
+  brush.HalfHeight = this->CylinderHeight / 2.0;
+  std::copy(this->CylinderAxis, this->CylinderAxis + 3, brush.Axis);
+  if (brush.Cylinder && vtkMath::Normalize(brush.Axis) == 0.0)
+  {
+    vtkErrorMacro("Rasterize: Invalid cylinder axis");
+    return false;
+  }
+
+  // Half size of the axis-aligned bounding box of the brush in world coordinate system
+  double brushHalfSize[3] = { brush.Radius, brush.Radius, brush.Radius };
+  if (brush.Cylinder)
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      brushHalfSize[axis] = brush.Radius * sqrt(std::max(0.0, 1.0 - brush.Axis[axis] * brush.Axis[axis])) + brush.HalfHeight * fabs(brush.Axis[axis]);
+    }
+  }
+
+  vtkNew<vtkMatrix4x4> ijkToWorldMatrix;
+  image->GetImageToWorldMatrix(ijkToWorldMatrix);
+  if (this->ImagePhysicalToWorldMatrix)
+  {
+    vtkNew<vtkMatrix4x4> ijkToPhysicalMatrix;
+    ijkToPhysicalMatrix->DeepCopy(ijkToWorldMatrix);
+    vtkMatrix4x4::Multiply4x4(this->ImagePhysicalToWorldMatrix, ijkToPhysicalMatrix, ijkToWorldMatrix);
+  }
+  vtkNew<vtkMatrix4x4> worldToIjkMatrix;
+  vtkMatrix4x4::Invert(ijkToWorldMatrix, worldToIjkMatrix);
+
+  // Stroke segments and the voxel region they may paint
+  std::vector<StrokeSegment> segments;
+  int paintExtent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  vtkIdType numberOfSegments = std::max(vtkIdType(1), numberOfPoints - 1);
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; segmentIndex++)
+  {
+    StrokeSegment segment;
+    double end[3] = { 0.0, 0.0, 0.0 };
+    strokePoints_World->GetPoint(segmentIndex, segment.Start);
+    strokePoints_World->GetPoint(std::min(segmentIndex + 1, numberOfPoints - 1), end);
+    vtkMath::Subtract(end, segment.Start, segment.Direction);
+
+    double boundsMin[3] = { 0.0, 0.0, 0.0 };
+    double boundsMax[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; axis++)
+    {
+      boundsMin[axis] = std::min(segment.Start[axis], end[axis]) - brushHalfSize[axis];
+      boundsMax[axis] = std::max(segment.Start[axis], end[axis]) + brushHalfSize[axis];
+    }
+    double ijkMin[3] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+    double ijkMax[3] = { VTK_DOUBLE_MIN, VTK_DOUBLE_MIN, VTK_DOUBLE_MIN };
+    for (int corner = 0; corner < 8; corner++)
+    {
+      double cornerWorld[4] = { (corner & 1) ? boundsMax[0] : boundsMin[0], (corner & 2) ? boundsMax[1] : boundsMin[1], (corner & 4) ? boundsMax[2] : boundsMin[2], 1.0 };
+      double cornerIjk[4] = { 0.0, 0.0, 0.0, 1.0 };
+      worldToIjkMatrix->MultiplyPoint(cornerWorld, cornerIjk);
+      for (int axis = 0; axis < 3; axis++)
+      {
+        ijkMin[axis] = std::min(ijkMin[axis], cornerIjk[axis]);
+        ijkMax[axis] = std::max(ijkMax[axis], cornerIjk[axis]);
+      }
+    }
+    bool empty = false;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      segment.Extent[axis * 2] = std::max(imageExtent[axis * 2], static_cast<int>(std::max(floor(ijkMin[axis]), double(VTK_INT_MIN))));
+      segment.Extent[axis * 2 + 1] = std::min(imageExtent[axis * 2 + 1], static_cast<int>(std::min(ceil(ijkMax[axis]), double(VTK_INT_MAX))));
+      if (segment.Extent[axis * 2] > segment.Extent[axis * 2 + 1])
+      {
+        empty = true;
+      }
+    }
+    if (empty)
+    {
+      continue;
+    }
+    for (int axis = 0; axis < 3; axis++)
+    {
+      paintExtent[axis * 2] = std::min(paintExtent[axis * 2], segment.Extent[axis * 2]);
+      paintExtent[axis * 2 + 1] = std::max(paintExtent[axis * 2 + 1], segment.Extent[axis * 2 + 1]);
+    }
+    segments.push_back(segment);
+  }
+  if (segments.empty())
+  {
+    // stroke is outside of the image
+    return true;
+  }
+
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(PaintStrokeSegments<VTK_TT>(image, segments, brush, ijkToWorldMatrix, this->FillValue, paintExtent, modifiedExtent));
+    default: vtkErrorMacro("Rasterize: Unknown scalar type"); return false;
+  }
+  image->Modified();
+  return true;
+}
@@ -0,0 +1,102 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkBrushStrokeRasterizer_h
+#define __vtkBrushStrokeRasterizer_h
+
+// VTK includes
+#include <vtkObject.h>
+
+#include "vtkSegmentationCoreExport.h"
+
+class vtkMatrix4x4;
+class vtkOrientedImageData;
+class vtkPoints;
+
+/// \brief Paint a brush stroke into a labelmap image.
+///
+/// The stroke is defined by a sequence of brush positions. The region swept by the brush while it moves
+/// along the straight line between consecutive positions is painted. A single position paints a single brush stamp.
+///
+/// The brush is a sphere or a cylinder, defined in world coordinates. Voxels are painted if their center
+/// is inside the swept region. The test is computed analytically for each voxel (no brush mesh or stencil
+/// is generated), in parallel for the slices of the image.
+class vtkSegmentationCore_EXPORT vtkBrushStrokeRasterizer : public vtkObject
+{
+public:
+  static vtkBrushStrokeRasterizer* New();
+  vtkTypeMacro(vtkBrushStrokeRasterizer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum
+  {
+    BrushShapeSphere,
+    BrushShapeCylinder
+  };
+
+  //@{
+  /// Shape of the brush. Default is sphere.
+  vtkGetMacro(BrushShape, int);
+  vtkSetClampMacro(BrushShape, int, BrushShapeSphere, BrushShapeCylinder);
+  void SetBrushShapeToSphere() { this->SetBrushShape(BrushShapeSphere); }
+  void SetBrushShapeToCylinder() { this->SetBrushShape(BrushShapeCylinder); }
+  //@}
+
+  /// Radius of the brush in world coordinate system units (mm). Default is 1.
+  vtkGetMacro(BrushRadius, double);
+  vtkSetMacro(BrushRadius, double);
+
+  /// Height of the cylinder brush in world coordinate system units (mm). Default is 1.
+  vtkGetMacro(CylinderHeight, double);
+  vtkSetMacro(CylinderHeight, double);
+
+  /// Direction of the axis of the cylinder brush in world coordinate system. Default is (0, 0, 1).
+  vtkGetVector3Macro(CylinderAxis, double);
+  vtkSetVector3Macro(CylinderAxis, double);
+
+  /// Value that is written into voxels inside the brush stroke. Default is 1.
+  vtkGetMacro(FillValue, double);
+  vtkSetMacro(FillValue, double);
+
+  /// Optional transform from the physical coordinate system of the image (segmentation node coordinate system)
+  /// to world coordinate system. Only linear transforms are supported. If not set then identity transform is used.
+  vtkGetObjectMacro(ImagePhysicalToWorldMatrix, vtkMatrix4x4);
+  void SetImagePhysicalToWorldMatrix(vtkMatrix4x4* matrix);
+
+  /// Paint the stroke defined by strokePoints_World (brush positions in world coordinate system) into the image.
+  /// Voxels outside the stroke are not changed.
+  /// \param modifiedExtent Output, extent of the painted voxels. Empty extent (min > max) if no voxels were painted.
+  /// \return Success flag
+  bool Rasterize(vtkOrientedImageData* image, vtkPoints* strokePoints_World, int modifiedExtent[6]);
+
+protected:
+  vtkBrushStrokeRasterizer();
+  ~vtkBrushStrokeRasterizer() override;
+
+  int BrushShape{ BrushShapeSphere };
+  double BrushRadius{ 1.0 };
+  double CylinderHeight{ 1.0 };
+  double CylinderAxis[3]{ 0.0, 0.0, 1.0 };
+  double FillValue{ 1.0 };
+  vtkMatrix4x4* ImagePhysicalToWorldMatrix{ nullptr };
+
+private:
+  vtkBrushStrokeRasterizer(const vtkBrushStrokeRasterizer&) = delete;
+  void operator=(const vtkBrushStrokeRasterizer&) = delete;
+};
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "vtkOrientedImageData.h"
 #include "vtkCalculateOversamplingFactor.h"
+#include "vtkClosedSurfaceVoxelizer.h"
 
 // Slicer includes
 #include "vtkLoggingMacros.h"
@@ -80,6 +81,12 @@ vtkClosedSurfaceToBinaryLabelmapConversionRule::vtkClosedSurfaceToBinaryLabelmap
     "1",
     "Merge the labelmaps into as few shared labelmaps as possible"
     " 1 = created labelmaps will be shared if possible without overwriting each other.");
+  // Scanline voxelization parameter
+  this->ConversionParameters->SetParameter( //
+    GetScanlineVoxelizationParameterName(),
+    "0",
+    "Voxelization method. 0 (default) = image stencil."
+    " 1 = parallel scanline voxelization, recommended for converting many or large surfaces.");
 }
 
 //----------------------------------------------------------------------------
@@ -195,6 +202,20 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
 
   // Perform conversion
 
+  if (this->ConversionParameters->GetValueAsInt(GetScanlineVoxelizationParameterName()) > 0)
+  {
+    // The voxelizer works directly in the oriented image geometry, no need to transform the surface
+    vtkNew<vtkClosedSurfaceVoxelizer> voxelizer;
+    voxelizer->AddInputSurface(closedSurfacePolyData, DEFAULT_LABEL_VALUE);
+    if (!voxelizer->Voxelize(binaryLabelmap))
+    {
+      vtkErrorMacro("Convert: Failed to voxelize closed surface!");
+      return false;
+    }
+    segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+    return true;
+  }
+
   // Now the output labelmap image data contains the right geometry.
   // We need to apply inverse of geometry matrix to the input poly data so that we can perform
   // the conversion in IJK space, because the filters do not support oriented image data.
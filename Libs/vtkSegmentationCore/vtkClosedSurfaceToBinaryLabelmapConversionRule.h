@@ -44,6 +44,9 @@ public:
   /// Determines if the output binary labelmaps should be reduced to as few shared labelmaps as possible after conversion.
   /// A value of 1 means that the labelmaps will be collapsed, while a value of 0 means that they will not be collapsed.
   static const std::string GetCollapseLabelmapsParameterName() { return "Collapse labelmaps"; };
+  /// Determines the voxelization method. A value of 0 means that image stencil is used, while a value of 1 means
+  /// that the faster, parallel scanline voxelization (vtkClosedSurfaceVoxelizer) is used.
+  static const std::string GetScanlineVoxelizationParameterName() { return "Scanline voxelization"; };
 
 public:
   static vtkClosedSurfaceToBinaryLabelmapConversionRule* New();
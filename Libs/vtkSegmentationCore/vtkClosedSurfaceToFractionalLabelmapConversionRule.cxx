@@ -20,6 +20,7 @@
 #include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
 
 // SegmentationCore includes
+#include "vtkClosedSurfaceVoxelizer.h"
 #include "vtkOrientedImageData.h"
 #include "vtkPolyDataToFractionalLabelmapFilter.h"
 
@@ -28,6 +29,7 @@
 #include <vtkPolyData.h>
 #include <vtkDoubleArray.h>
 #include <vtkIntArray.h>
+#include <vtkNew.h>
 #include <vtkFieldData.h>
 
 // SegmentationCore includes
@@ -134,17 +136,34 @@ bool vtkClosedSurfaceToFractionalLabelmapConversionRule::Convert(vtkSegment* seg
   }
   fractionalLabelMap->SetExtent(extent);
 
-  vtkSmartPointer<vtkMatrix4x4> imageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-  fractionalLabelMap->GetImageToWorldMatrix(imageToWorldMatrix);
-
-  // Create a fractional labelmap from the closed surface
-  vtkSmartPointer<vtkPolyDataToFractionalLabelmapFilter> polyDataToLabelmapFilter = vtkSmartPointer<vtkPolyDataToFractionalLabelmapFilter>::New();
-  polyDataToLabelmapFilter->SetInputData(closedSurfacePolyData);
-  polyDataToLabelmapFilter->SetOutputImageToWorldMatrix(imageToWorldMatrix);
-  polyDataToLabelmapFilter->SetNumberOfOffsets(this->NumberOfOffsets);
-  polyDataToLabelmapFilter->SetOutputWholeExtent(fractionalLabelMap->GetExtent());
-  polyDataToLabelmapFilter->Update();
-  fractionalLabelMap->DeepCopy(polyDataToLabelmapFilter->GetOutput());
+  if (this->ConversionParameters->GetValueAsInt(GetScanlineVoxelizationParameterName()) > 0)
+  {
+    // Count samples inside the surface in each voxel directly, without creating a binary labelmap for each offset
+    fractionalLabelMap->AllocateScalars(VTK_FRACTIONAL_DATA_TYPE, 1);
+    vtkNew<vtkClosedSurfaceVoxelizer> voxelizer;
+    voxelizer->AddInputSurface(closedSurfacePolyData, FRACTIONAL_MAX);
+    voxelizer->SetBackgroundValue(FRACTIONAL_MIN);
+    voxelizer->SetNumberOfSubsamples(this->NumberOfOffsets);
+    if (!voxelizer->Voxelize(fractionalLabelMap))
+    {
+      vtkErrorMacro("Convert: Failed to voxelize closed surface!");
+      return false;
+    }
+  }
+  else
+  {
+    vtkSmartPointer<vtkMatrix4x4> imageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    fractionalLabelMap->GetImageToWorldMatrix(imageToWorldMatrix);
+
+    // Create a fractional labelmap from the closed surface
+    vtkSmartPointer<vtkPolyDataToFractionalLabelmapFilter> polyDataToLabelmapFilter = vtkSmartPointer<vtkPolyDataToFractionalLabelmapFilter>::New();
+    polyDataToLabelmapFilter->SetInputData(closedSurfacePolyData);
+    polyDataToLabelmapFilter->SetOutputImageToWorldMatrix(imageToWorldMatrix);
+    polyDataToLabelmapFilter->SetNumberOfOffsets(this->NumberOfOffsets);
+    polyDataToLabelmapFilter->SetOutputWholeExtent(fractionalLabelMap->GetExtent());
+    polyDataToLabelmapFilter->Update();
+    fractionalLabelMap->DeepCopy(polyDataToLabelmapFilter->GetOutput());
+  }
 
   // Specify the scalar range of values in the labelmap
   vtkSmartPointer<vtkDoubleArray> scalarRange = vtkSmartPointer<vtkDoubleArray>::New();
@@ -0,0 +1,451 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkClosedSurfaceVoxelizer.h"
+#include "vtkOrientedImageData.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+
+vtkStandardNewMacro(vtkClosedSurfaceVoxelizer);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct Triangle
+{
+  /// Indices in the merged point list of all surfaces
+  vtkIdType PointIds[3];
+  int SurfaceIndex;
+};
+
+//----------------------------------------------------------------------------
+/// Crossing of a sampling row and a surface
+struct Crossing
+{
+  double X;
+  int SurfaceIndex;
+  bool operator<(const Crossing& other) const { return this->SurfaceIndex < other.SurfaceIndex || (this->SurfaceIndex == other.SurfaceIndex && this->X < other.X); }
+};
+
+//----------------------------------------------------------------------------
+/// Positions of samples along an image axis: Start + index * Step
+struct SampleAxis
+{
+  double Start;
+  double Step;
+  int NumberOfSamples;
+
+  double GetPosition(int sampleIndex) const { return this->Start + sampleIndex * this->Step; }
+
+  /// Get range of sample indices that may be between the two positions (inclusive).
+  /// The range may contain one extra sample at each end, exact comparison is needed to select samples.
+  bool GetSampleRange(double minimumPosition, double maximumPosition, int& first, int& last) const
+  {
+    first = std::max(0, static_cast<int>(std::floor((minimumPosition - this->Start) / this->Step)));
+    last = std::min(this->NumberOfSamples - 1, static_cast<int>(std::ceil((maximumPosition - this->Start) / this->Step)));
+    return first <= last;
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Get the point where the plane at z intersects the edge between point a and b.
+/// The result only depends on the edge and not on the order of the points, therefore triangles sharing an edge
+/// get exactly the same intersection point.
+void IntersectEdge(const std::vector<double>& points, vtkIdType a, vtkIdType b, double z, double intersection[2])
+{
+  if (a > b)
+  {
+    std::swap(a, b);
+  }
+  const double* pointA = &points[3 * a];
+  const double* pointB = &points[3 * b];
+  double t = (z - pointA[2]) / (pointB[2] - pointA[2]);
+  intersection[0] = pointA[0] + t * (pointB[0] - pointA[0]);
+  intersection[1] = pointA[1] + t * (pointB[1] - pointA[1]);
+}
+
+//----------------------------------------------------------------------------
+/// Get the line segment where the plane at z cuts the triangle.
+/// A vertex that is exactly in the plane is considered to be above the plane, so that each crossing of
+/// a closed surface is counted exactly once.
+bool CutTriangle(const std::vector<double>& points, const Triangle& triangle, double z, double start[2], double end[2])
+{
+  int numberOfIntersections = 0;
+  for (int edgeIndex = 0; edgeIndex < 3; ++edgeIndex)
+  {
+    vtkIdType a = triangle.PointIds[edgeIndex];
+    vtkIdType b = triangle.PointIds[(edgeIndex + 1) % 3];
+    if ((points[3 * a + 2] < z) == (points[3 * b + 2] < z))
+    {
+      continue;
+    }
+    IntersectEdge(points, a, b, z, numberOfIntersections == 0 ? start : end);
+    ++numberOfIntersections;
+  }
+  return numberOfIntersections == 2;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void WriteSlice(vtkOrientedImageData* image,
+                int k,
+                const std::vector<int>& sliceSurfaces,
+                const std::vector<int>& sliceCounts,
+                int numberOfSamplesPerVoxel,
+                const std::vector<double>& labelValues,
+                double backgroundValue)
+{
+  int* extent = image->GetExtent();
+  T* slicePtr = static_cast<T*>(image->GetScalarPointer(extent[0], extent[2], k));
+  for (size_t voxelIndex = 0; voxelIndex < sliceSurfaces.size(); ++voxelIndex)
+  {
+    int surfaceIndex = sliceSurfaces[voxelIndex];
+    if (surfaceIndex < 0)
+    {
+      slicePtr[voxelIndex] = static_cast<T>(backgroundValue);
+      continue;
+    }
+    double value = labelValues[surfaceIndex];
+    if (numberOfSamplesPerVoxel > 1)
+    {
+      value = backgroundValue + (value - backgroundValue) * sliceCounts[voxelIndex] / numberOfSamplesPerVoxel;
+      if (std::numeric_limits<T>::is_integer)
+      {
+        value = std::floor(value + 0.5);
+      }
+    }
+    slicePtr[voxelIndex] = static_cast<T>(value);
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkClosedSurfaceVoxelizer::vtkClosedSurfaceVoxelizer() = default;
+
+//----------------------------------------------------------------------------
+vtkClosedSurfaceVoxelizer::~vtkClosedSurfaceVoxelizer() = default;
+
+//----------------------------------------------------------------------------
+void vtkClosedSurfaceVoxelizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfInputSurfaces: " << this->InputSurfaces.size() << "\n";
+  os << indent << "BackgroundValue: " << this->BackgroundValue << "\n";
+  os << indent << "NumberOfSubsamples: " << this->NumberOfSubsamples << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkClosedSurfaceVoxelizer::AddInputSurface(vtkPolyData* closedSurface, double labelValue /*=1.0*/)
+{
+  if (!closedSurface)
+  {
+    vtkErrorMacro("AddInputSurface: Invalid surface");
+    return;
+  }
+  this->InputSurfaces.push_back(InputSurface{ closedSurface, labelValue });
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkClosedSurfaceVoxelizer::RemoveAllInputSurfaces()
+{
+  this->InputSurfaces.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkClosedSurfaceVoxelizer::GetNumberOfInputSurfaces()
+{
+  return static_cast<int>(this->InputSurfaces.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkClosedSurfaceVoxelizer::Voxelize(vtkOrientedImageData* image)
+{
+  if (!image)
+  {
+    vtkErrorMacro("Voxelize: Invalid image");
+    return false;
+  }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+  {
+    // Empty image, nothing to do
+    return true;
+  }
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfTuples() != image->GetNumberOfPoints())
+  {
+    image->AllocateScalars(image->GetScalarType(), 1);
+  }
+  if (image->GetNumberOfScalarComponents() != 1)
+  {
+    vtkErrorMacro("Voxelize: Only single-component images are supported");
+    return false;
+  }
+
+  // Sampling positions in IJK coordinate system
+  const int numberOfSubsamples = this->NumberOfSubsamples;
+  SampleAxis sampleAxes[3];
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    sampleAxes[axis].Step = 1.0 / numberOfSubsamples;
+    sampleAxes[axis].Start = extent[axis * 2] - 0.5 + 0.5 * sampleAxes[axis].Step;
+    sampleAxes[axis].NumberOfSamples = (extent[axis * 2 + 1] - extent[axis * 2] + 1) * numberOfSubsamples;
+  }
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  const int numberOfVoxelsPerRow = extent[1] - extent[0] + 1;
+  const int numberOfVoxelsPerSlice = numberOfVoxelsPerRow * (extent[3] - extent[2] + 1);
+
+  // Transform points of all surfaces to IJK coordinate system and collect triangles
+  vtkNew<vtkMatrix4x4> worldToIjkMatrix;
+  image->GetWorldToImageMatrix(worldToIjkMatrix);
+  double worldToIjk[3][4] = { { 0.0 } };
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      worldToIjk[row][column] = worldToIjkMatrix->GetElement(row, column);
+    }
+  }
+  std::vector<double> points;
+  std::vector<Triangle> triangles;
+  std::vector<double> labelValues;
+  for (int surfaceIndex = 0; surfaceIndex < static_cast<int>(this->InputSurfaces.size()); ++surfaceIndex)
+  {
+    vtkPolyData* surface = this->InputSurfaces[surfaceIndex].Surface;
+    labelValues.push_back(this->InputSurfaces[surfaceIndex].LabelValue);
+    vtkPoints* surfacePoints = surface->GetPoints();
+    if (!surfacePoints || surfacePoints->GetNumberOfPoints() == 0)
+    {
+      continue;
+    }
+    const vtkIdType pointIdOffset = static_cast<vtkIdType>(points.size() / 3);
+    points.resize(points.size() + 3 * surfacePoints->GetNumberOfPoints());
+    vtkSMPTools::For(0,
+                     surfacePoints->GetNumberOfPoints(),
+                     [&](vtkIdType firstPointId, vtkIdType lastPointId)
+                     {
+                       double point[3] = { 0.0, 0.0, 0.0 };
+                       for (vtkIdType pointId = firstPointId; pointId < lastPointId; ++pointId)
+                       {
+                         surfacePoints->GetPoint(pointId, point);
+                         double* ijk = &points[3 * (pointIdOffset + pointId)];
+                         for (int row = 0; row < 3; ++row)
+                         {
+                           ijk[row] = worldToIjk[row][0] * point[0] + worldToIjk[row][1] * point[1] + worldToIjk[row][2] * point[2] + worldToIjk[row][3];
+                         }
+                       }
+                     });
+
+    vtkIdType numberOfCellPoints = 0;
+    const vtkIdType* cellPointIds = nullptr;
+    vtkCellArray* polys = surface->GetPolys();
+    for (polys->InitTraversal(); polys->GetNextCell(numberOfCellPoints, cellPointIds);)
+    {
+      // Fan triangulation, crossing parity is the same as for the polygon
+      for (vtkIdType i = 1; i + 1 < numberOfCellPoints; ++i)
+      {
+        triangles.push_back(
+          Triangle{ { pointIdOffset + cellPointIds[0], pointIdOffset + cellPointIds[i], pointIdOffset + cellPointIds[i + 1] }, surfaceIndex });
+      }
+    }
+    vtkCellArray* strips = surface->GetStrips();
+    for (strips->InitTraversal(); strips->GetNextCell(numberOfCellPoints, cellPointIds);)
+    {
+      for (vtkIdType i = 0; i + 2 < numberOfCellPoints; ++i)
+      {
+        triangles.push_back(
+          Triangle{ { pointIdOffset + cellPointIds[i], pointIdOffset + cellPointIds[i + 1], pointIdOffset + cellPointIds[i + 2] }, surfaceIndex });
+      }
+    }
+  }
+
+  // Sort triangles into the slices that they may intersect (single pass for all surfaces)
+  std::vector<std::vector<vtkIdType>> sliceTriangles(numberOfSlices);
+  for (vtkIdType triangleIndex = 0; triangleIndex < static_cast<vtkIdType>(triangles.size()); ++triangleIndex)
+  {
+    const Triangle& triangle = triangles[triangleIndex];
+    double zMin = points[3 * triangle.PointIds[0] + 2];
+    double zMax = zMin;
+    for (int vertexIndex = 1; vertexIndex < 3; ++vertexIndex)
+    {
+      zMin = std::min(zMin, points[3 * triangle.PointIds[vertexIndex] + 2]);
+      zMax = std::max(zMax, points[3 * triangle.PointIds[vertexIndex] + 2]);
+    }
+    int firstPlane = 0;
+    int lastPlane = 0;
+    if (!sampleAxes[2].GetSampleRange(zMin, zMax, firstPlane, lastPlane))
+    {
+      continue;
+    }
+    for (int sliceIndex = firstPlane / numberOfSubsamples; sliceIndex <= lastPlane / numberOfSubsamples; ++sliceIndex)
+    {
+      sliceTriangles[sliceIndex].push_back(triangleIndex);
+    }
+  }
+
+  // Fill slices in parallel. Each slice is written by only one thread.
+  const int numberOfSamplesPerVoxel = numberOfSubsamples * numberOfSubsamples * numberOfSubsamples;
+  const int scalarType = image->GetScalarType();
+  std::atomic<bool> scalarTypeSupported(true);
+  vtkSMPTools::For(
+    0,
+    numberOfSlices,
+    [&](vtkIdType firstSliceIndex, vtkIdType lastSliceIndex)
+    {
+      std::vector<std::vector<Crossing>> rowCrossings(sampleAxes[1].NumberOfSamples);
+      // Number of samples inside each surface for each voxel of the slice, only used if there are subsamples
+      std::map<int, std::vector<int>> surfaceSampleCounts;
+      std::vector<int> sliceSurfaces(numberOfVoxelsPerSlice);
+      std::vector<int> sliceCounts(numberOfVoxelsPerSlice);
+      for (vtkIdType sliceIndex = firstSliceIndex; sliceIndex < lastSliceIndex; ++sliceIndex)
+      {
+        std::fill(sliceSurfaces.begin(), sliceSurfaces.end(), -1);
+        std::fill(sliceCounts.begin(), sliceCounts.end(), 0);
+        surfaceSampleCounts.clear();
+        for (int subsampleIndex = 0; subsampleIndex < numberOfSubsamples; ++subsampleIndex)
+        {
+          double z = sampleAxes[2].GetPosition(static_cast<int>(sliceIndex) * numberOfSubsamples + subsampleIndex);
+
+          // Find where the sampling rows cross the surfaces
+          for (std::vector<Crossing>& crossings : rowCrossings)
+          {
+            crossings.clear();
+          }
+          for (vtkIdType triangleIndex : sliceTriangles[sliceIndex])
+          {
+            const Triangle& triangle = triangles[triangleIndex];
+            double start[2] = { 0.0, 0.0 };
+            double end[2] = { 0.0, 0.0 };
+            if (!CutTriangle(points, triangle, z, start, end))
+            {
+              continue;
+            }
+            int firstRow = 0;
+            int lastRow = 0;
+            if (!sampleAxes[1].GetSampleRange(std::min(start[1], end[1]), std::max(start[1], end[1]), firstRow, lastRow))
+            {
+              continue;
+            }
+            for (int row = firstRow; row <= lastRow; ++row)
+            {
+              double y = sampleAxes[1].GetPosition(row);
+              if ((start[1] < y) == (end[1] < y))
+              {
+                continue;
+              }
+              double x = start[0] + (y - start[1]) * (end[0] - start[0]) / (end[1] - start[1]);
+              rowCrossings[row].push_back(Crossing{ x, triangle.SurfaceIndex });
+            }
+          }
+
+          // Fill samples between pairs of crossings of each surface
+          for (int row = 0; row < sampleAxes[1].NumberOfSamples; ++row)
+          {
+            std::vector<Crossing>& crossings = rowCrossings[row];
+            if (crossings.empty())
+            {
+              continue;
+            }
+            std::sort(crossings.begin(), crossings.end());
+            const int rowVoxelOffset = (row / numberOfSubsamples) * numberOfVoxelsPerRow;
+            size_t crossingIndex = 0;
+            while (crossingIndex + 1 < crossings.size())
+            {
+              const Crossing& entry = crossings[crossingIndex];
+              const Crossing& exit = crossings[crossingIndex + 1];
+              if (entry.SurfaceIndex != exit.SurfaceIndex)
+              {
+                // Odd number of crossings (surface is not closed), skip the unpaired crossing
+                ++crossingIndex;
+                continue;
+              }
+              crossingIndex += 2;
+              int firstSample = std::max(0, static_cast<int>(std::ceil((entry.X - sampleAxes[0].Start) / sampleAxes[0].Step)));
+              int lastSample = std::min(sampleAxes[0].NumberOfSamples, static_cast<int>(std::ceil((exit.X - sampleAxes[0].Start) / sampleAxes[0].Step))) - 1;
+              if (firstSample > lastSample)
+              {
+                continue;
+              }
+              if (numberOfSubsamples == 1)
+              {
+                std::fill(sliceSurfaces.begin() + rowVoxelOffset + firstSample, sliceSurfaces.begin() + rowVoxelOffset + lastSample + 1, entry.SurfaceIndex);
+                continue;
+              }
+              std::vector<int>& counts = surfaceSampleCounts[entry.SurfaceIndex];
+              if (counts.empty())
+              {
+                counts.resize(numberOfVoxelsPerSlice, 0);
+              }
+              for (int sample = firstSample; sample <= lastSample; ++sample)
+              {
+                counts[rowVoxelOffset + sample / numberOfSubsamples]++;
+              }
+            }
+          }
+        }
+
+        // Use the surface that contains the most samples (the last one in case of equal number of samples)
+        for (const auto& surfaceCounts : surfaceSampleCounts)
+        {
+          for (int voxelIndex = 0; voxelIndex < numberOfVoxelsPerSlice; ++voxelIndex)
+          {
+            if (surfaceCounts.second[voxelIndex] > 0 && surfaceCounts.second[voxelIndex] >= sliceCounts[voxelIndex])
+            {
+              sliceCounts[voxelIndex] = surfaceCounts.second[voxelIndex];
+              sliceSurfaces[voxelIndex] = surfaceCounts.first;
+            }
+          }
+        }
+
+        int k = extent[4] + static_cast<int>(sliceIndex);
+        switch (scalarType)
+        {
+          vtkTemplateMacro(WriteSlice<VTK_TT>(image, k, sliceSurfaces, sliceCounts, numberOfSamplesPerVoxel, labelValues, this->BackgroundValue));
+          default: scalarTypeSupported = false;
+        }
+      }
+    });
+
+  if (!scalarTypeSupported)
+  {
+    vtkErrorMacro("Voxelize: Unknown scalar type");
+    return false;
+  }
+  image->Modified();
+  return true;
+}
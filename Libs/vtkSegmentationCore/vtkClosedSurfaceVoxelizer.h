@@ -0,0 +1,95 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkClosedSurfaceVoxelizer_h
+#define __vtkClosedSurfaceVoxelizer_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+#include "vtkSegmentationCoreExport.h"
+
+class vtkOrientedImageData;
+class vtkPolyData;
+
+/// \brief Fill the inside of closed surfaces in a labelmap image.
+///
+/// Sample points are inside a surface if a ray cast from the point crosses the surface an odd number of times.
+/// Triangles of all input surfaces are sorted into the image slices they intersect in a single pass, then
+/// slices are processed in parallel: triangles are cut at the sampling planes and crossings of the sampling
+/// rows are computed from the cut segments (scanline filling). No intermediate surface or stencil is created.
+///
+/// By default voxel centers are sampled and voxels inside a surface are set to the label value of the surface
+/// (if surfaces overlap then the surface that was added last is used).
+/// If the number of subsamples is larger than 1 then each voxel is sampled at NumberOfSubsamples^3 points
+/// and the voxel value is interpolated between the background value and the label value of the surface
+/// based on the fraction of samples inside the surface (the surface that contains most samples is used).
+/// This allows computing fractional labelmaps without creating an oversampled image.
+class vtkSegmentationCore_EXPORT vtkClosedSurfaceVoxelizer : public vtkObject
+{
+public:
+  static vtkClosedSurfaceVoxelizer* New();
+  vtkTypeMacro(vtkClosedSurfaceVoxelizer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Add a closed surface, in the physical coordinate system of the output image.
+  /// Polygons and triangle strips of the surface are used.
+  void AddInputSurface(vtkPolyData* closedSurface, double labelValue = 1.0);
+
+  /// Remove all input surfaces
+  void RemoveAllInputSurfaces();
+
+  /// Get number of input surfaces
+  int GetNumberOfInputSurfaces();
+
+  /// Value of voxels that are outside all surfaces. Default is 0.
+  vtkGetMacro(BackgroundValue, double);
+  vtkSetMacro(BackgroundValue, double);
+
+  /// Number of samples along each axis within a voxel. Default is 1 (only the voxel center is sampled).
+  vtkGetMacro(NumberOfSubsamples, int);
+  vtkSetClampMacro(NumberOfSubsamples, int, 1, 16);
+
+  /// Write the voxelized surfaces into the image. All voxels of the image are overwritten.
+  /// Geometry, extent, and scalar type of the image is not changed (scalars are allocated if needed).
+  /// \return Success flag
+  bool Voxelize(vtkOrientedImageData* image);
+
+protected:
+  vtkClosedSurfaceVoxelizer();
+  ~vtkClosedSurfaceVoxelizer() override;
+
+  struct InputSurface
+  {
+    vtkSmartPointer<vtkPolyData> Surface;
+    double LabelValue;
+  };
+  std::vector<InputSurface> InputSurfaces;
+
+  double BackgroundValue{ 0.0 };
+  int NumberOfSubsamples{ 1 };
+
+private:
+  vtkClosedSurfaceVoxelizer(const vtkClosedSurfaceVoxelizer&) = delete;
+  void operator=(const vtkClosedSurfaceVoxelizer&) = delete;
+};
+
+#endif
@@ -34,6 +34,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkImageThreshold.h>
+#include <vtkIntArray.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkMinimalStandardRandomSequence.h>
@@ -41,6 +42,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 #include <vtkSingleton.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
@@ -51,7 +53,9 @@
 #include <algorithm>
 #include <chrono>
 #include <functional>
+#include <set>
 #include <sstream>
+#include <vector>
 
 // GDCM includes
 #ifdef vtkSegmentationCore_USE_UUID
@@ -75,6 +79,67 @@ public:
   static vtkSegmentationRandomSequence* GetInstance();
 };
 
+namespace
+{
+
+/// Label values of segments that are merged from the same labelmap layer are looked up in a table.
+/// Layers with larger label value range are merged segment by segment.
+/// The limit only bounds the size of the lookup table (256 KB), it is not tuned by timing measurements.
+const int MAXIMUM_MERGE_LABEL_VALUE_RANGE = 65536;
+
+/// Marks label values that are not merged into the shared labelmap
+const int LABEL_VALUE_NOT_MERGED = VTK_INT_MIN;
+
+//----------------------------------------------------------------------------
+/// Write outputLabelValues[layerValue - minimumLayerValue] into the shared image for all voxels
+/// of the layer labelmap within mergeExtent (if the value is not LABEL_VALUE_NOT_MERGED).
+/// Layer and shared image must have the same geometry.
+template <class T>
+void MergeLabelmapLayer(vtkImageData* layerLabelmap, vtkImageData* sharedImageData, const int mergeExtent[6], const std::vector<int>& outputLabelValues, int minimumLayerValue)
+{
+  vtkIdType layerIncrements[3] = { 0, 0, 0 };
+  layerLabelmap->GetIncrements(layerIncrements);
+  vtkIdType sharedIncrements[3] = { 0, 0, 0 };
+  sharedImageData->GetIncrements(sharedIncrements);
+  T* layerPtr = static_cast<T*>(layerLabelmap->GetScalarPointerForExtent(const_cast<int*>(mergeExtent)));
+  short* sharedPtr = static_cast<short*>(sharedImageData->GetScalarPointerForExtent(const_cast<int*>(mergeExtent)));
+  if (!layerPtr || !sharedPtr)
+  {
+    return;
+  }
+  const long long numberOfLabelValues = static_cast<long long>(outputLabelValues.size());
+
+  // Slices are processed in parallel, each voxel is written by only one thread
+  vtkSMPTools::For(0,
+                   mergeExtent[5] - mergeExtent[4] + 1,
+                   [&](vtkIdType firstZ, vtkIdType lastZ)
+                   {
+                     for (vtkIdType z = firstZ; z < lastZ; ++z)
+                     {
+                       for (vtkIdType y = 0; y <= mergeExtent[3] - mergeExtent[2]; ++y)
+                       {
+                         const T* layerRowPtr = layerPtr + z * layerIncrements[2] + y * layerIncrements[1];
+                         short* sharedRowPtr = sharedPtr + z * sharedIncrements[2] + y * sharedIncrements[1];
+                         for (vtkIdType x = 0; x <= mergeExtent[1] - mergeExtent[0]; ++x)
+                         {
+                           long long lookupIndex = static_cast<long long>(layerRowPtr[x * layerIncrements[0]]) - minimumLayerValue;
+                           if (lookupIndex < 0 || lookupIndex >= numberOfLabelValues)
+                           {
+                             continue;
+                           }
+                           int outputLabelValue = outputLabelValues[lookupIndex];
+                           if (outputLabelValue != LABEL_VALUE_NOT_MERGED)
+                           {
+                             sharedRowPtr[x * sharedIncrements[0]] = static_cast<short>(outputLabelValue);
+                           }
+                         }
+                       }
+                     }
+                   });
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentation);
 
@@ -1620,10 +1685,9 @@ bool vtkSegmentation::GenerateMergedLabelmap(vtkOrientedImageData* sharedImageDa
 
   // Create shared labelmap
   bool success = true;
-  short segmentIndex = 0;
-  for (std::vector<std::string>::iterator segmentIdIt = sharedSegmentIDs.begin(); segmentIdIt != sharedSegmentIDs.end(); ++segmentIdIt, ++segmentIndex)
+  for (size_t segmentIndex = 0; segmentIndex < sharedSegmentIDs.size(); ++segmentIndex)
   {
-    std::string currentSegmentId = *segmentIdIt;
+    std::string currentSegmentId = sharedSegmentIDs[segmentIndex];
     vtkSegment* currentSegment = this->GetSegment(currentSegmentId);
     if (!currentSegment)
     {
@@ -1641,6 +1705,14 @@ bool vtkSegmentation::GenerateMergedLabelmap(vtkOrientedImageData* sharedImageDa
       continue;
     }
 
+    // Segments that follow each other in the list and are stored in the same layer are merged
+    // with a single pass over the layer. Segments in the same layer cannot overlap, therefore
+    // the result is the same as merging them one by one.
+    if (this->MergeLabelmapLayerSegments(sharedImageData, commonGeometryImage, sharedSegmentIDs, segmentIndex, labelValues))
+    {
+      continue;
+    }
+
     // Set oriented image data used for merging to the representation (may change later if resampling is needed)
     vtkOrientedImageData* binaryLabelmap = representationBinaryLabelmap;
 
@@ -1673,7 +1745,7 @@ bool vtkSegmentation::GenerateMergedLabelmap(vtkOrientedImageData* sharedImageDa
     thresholdedLabelmap->CopyDirections(binaryLabelmap);
     binaryLabelmap = thresholdedLabelmap;
 
-    int labelValue = backgroundColorIndex + 1 + segmentIndex;
+    int labelValue = backgroundColorIndex + 1 + static_cast<int>(segmentIndex);
     if (labelValues)
     {
       labelValue = labelValues->GetValue(segmentIndex);
@@ -1686,6 +1758,82 @@ bool vtkSegmentation::GenerateMergedLabelmap(vtkOrientedImageData* sharedImageDa
   return success;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSegmentation::MergeLabelmapLayerSegments(vtkOrientedImageData* mergedImageData,
+                                                 vtkOrientedImageData* mergedImageGeometry,
+                                                 const std::vector<std::string>& segmentIDs,
+                                                 size_t& segmentIndex,
+                                                 vtkIntArray* labelValues)
+{
+  std::string binaryLabelmapRepresentationName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  vtkSegment* firstSegment = this->GetSegment(segmentIDs[segmentIndex]);
+  vtkOrientedImageData* layerLabelmap = firstSegment ? vtkOrientedImageData::SafeDownCast(firstSegment->GetRepresentation(binaryLabelmapRepresentationName)) : nullptr;
+  if (!layerLabelmap || layerLabelmap->GetNumberOfScalarComponents() != 1 || !vtkOrientedImageDataResample::DoGeometriesMatch(mergedImageGeometry, layerLabelmap))
+  {
+    return false;
+  }
+
+  // Find segments that directly follow the first segment and are stored in the same layer
+  size_t lastSegmentIndex = segmentIndex;
+  int minimumLayerValue = VTK_INT_MAX;
+  int maximumLayerValue = VTK_INT_MIN;
+  for (size_t index = segmentIndex; index < segmentIDs.size(); ++index)
+  {
+    vtkSegment* segment = this->GetSegment(segmentIDs[index]);
+    if (!segment || segment->GetRepresentation(binaryLabelmapRepresentationName) != layerLabelmap)
+    {
+      break;
+    }
+    minimumLayerValue = std::min(minimumLayerValue, segment->GetLabelValue());
+    maximumLayerValue = std::max(maximumLayerValue, segment->GetLabelValue());
+    lastSegmentIndex = index;
+  }
+  if (static_cast<long long>(maximumLayerValue) - minimumLayerValue + 1 > MAXIMUM_MERGE_LABEL_VALUE_RANGE)
+  {
+    return false;
+  }
+
+  // Lookup table from layer label value to merged label value.
+  // If multiple segments have the same label value then the last one is used (same as when merging one by one).
+  std::vector<int> outputLabelValues(maximumLayerValue - minimumLayerValue + 1, LABEL_VALUE_NOT_MERGED);
+  for (size_t index = segmentIndex; index <= lastSegmentIndex; ++index)
+  {
+    int labelValue = 1 + static_cast<int>(index);
+    if (labelValues)
+    {
+      labelValue = labelValues->GetValue(index);
+    }
+    labelValue = std::max(VTK_SHORT_MIN, std::min(VTK_SHORT_MAX, labelValue));
+    outputLabelValues[this->GetSegment(segmentIDs[index])->GetLabelValue() - minimumLayerValue] = labelValue;
+  }
+
+  int mergeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int* layerExtent = layerLabelmap->GetExtent();
+  int* mergedExtent = mergedImageData->GetExtent();
+  bool emptyMergeExtent = false;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    mergeExtent[axis * 2] = std::max(layerExtent[axis * 2], mergedExtent[axis * 2]);
+    mergeExtent[axis * 2 + 1] = std::min(layerExtent[axis * 2 + 1], mergedExtent[axis * 2 + 1]);
+    if (mergeExtent[axis * 2] > mergeExtent[axis * 2 + 1])
+    {
+      emptyMergeExtent = true;
+    }
+  }
+  if (!emptyMergeExtent)
+  {
+    switch (layerLabelmap->GetScalarType())
+    {
+      vtkTemplateMacro(MergeLabelmapLayer<VTK_TT>(layerLabelmap, mergedImageData, mergeExtent, outputLabelValues, minimumLayerValue));
+      default: return false;
+    }
+    mergedImageData->Modified();
+  }
+
+  segmentIndex = lastSegmentIndex;
+  return true;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentation::SeparateSegmentLabelmap(std::string segmentId)
 {
@@ -2240,6 +2388,8 @@ void vtkSegmentation::DetermineCommonLabelmapExtent(int commonGeometryExtent[6],
   commonGeometryExtent[3] = -1;
   commonGeometryExtent[4] = 0;
   commonGeometryExtent[5] = -1;
+  // Segments in a shared labelmap layer have the same extent, each layer needs to be processed only once
+  std::set<vtkOrientedImageData*> processedBinaryLabelmaps;
   for (std::vector<std::string>::iterator segmentIt = sharedSegmentIDs.begin(); segmentIt != sharedSegmentIDs.end(); ++segmentIt)
   {
     vtkSegment* currentSegment = this->GetSegment(*segmentIt);
@@ -2254,6 +2404,10 @@ void vtkSegmentation::DetermineCommonLabelmapExtent(int commonGeometryExtent[6],
     {
       continue;
     }
+    if (!processedBinaryLabelmaps.insert(currentBinaryLabelmap).second)
+    {
+      continue;
+    }
 
     int currentBinaryLabelmapExtent[6] = { 0, -1, 0, -1, 0, -1 };
     bool validExtent = true;
@@ -558,6 +558,18 @@ protected:
   /// finding the iterator based on their different input arguments.
   void RemoveSegment(SegmentMap::iterator segmentIt);
 
+  /// Merge the segment at segmentIndex and the segments that directly follow it in segmentIDs and are
+  /// stored in the same binary labelmap layer into mergedImageData, with a single pass over the layer.
+  /// Used by \sa GenerateMergedLabelmap.
+  /// \param segmentIndex Index of the first segment. Set to the index of the last merged segment on success.
+  /// \return False if the segments cannot be merged this way (layer geometry differs from merged image geometry
+  ///   or label value range is too large), in this case they have to be merged one by one.
+  bool MergeLabelmapLayerSegments(vtkOrientedImageData* mergedImageData,
+                                  vtkOrientedImageData* mergedImageGeometry,
+                                  const std::vector<std::string>& segmentIDs,
+                                  size_t& segmentIndex,
+                                  vtkIntArray* labelValues);
+
   /// Temporarily enable/disable source representation modified event.
   /// \return Old value of SourceRepresentationModifiedEnabled.
   /// In general, the old value should be restored after modified is temporarily disabled to ensure proper
@@ -0,0 +1,758 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSegmentationStatistics.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+
+// VTK includes
+#include <vtkAbstractTransform.h>
+#include <vtkDataArray.h>
+#include <vtkImageCast.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+vtkStandardNewMacro(vtkSegmentationStatistics);
+
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, Segmentation, vtkSegmentation);
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, ScalarVolume, vtkOrientedImageData);
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct SegmentAccumulator
+{
+  vtkIdType VoxelCount{ 0 };
+  double Sum{ 0.0 };
+  double SumOfSquares{ 0.0 };
+  double Minimum{ std::numeric_limits<double>::max() };
+  double Maximum{ std::numeric_limits<double>::lowest() };
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+
+  void Merge(const SegmentAccumulator& other)
+  {
+    if (other.VoxelCount == 0)
+    {
+      return;
+    }
+    this->VoxelCount += other.VoxelCount;
+    this->Sum += other.Sum;
+    this->SumOfSquares += other.SumOfSquares;
+    this->Minimum = std::min(this->Minimum, other.Minimum);
+    this->Maximum = std::max(this->Maximum, other.Maximum);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Extent[axis * 2] = std::min(this->Extent[axis * 2], other.Extent[axis * 2]);
+      this->Extent[axis * 2 + 1] = std::max(this->Extent[axis * 2 + 1], other.Extent[axis * 2 + 1]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct ThreadAccumulators
+{
+  std::vector<SegmentAccumulator> Segments;
+  /// Histograms are only allocated for segments that the thread encountered
+  std::vector<std::vector<unsigned int>> Histograms;
+};
+
+//----------------------------------------------------------------------------
+/// Histogram of a segment. Only the bins between the minimum and maximum value
+/// of the segment are stored, starting at FirstBin of the shared histogram geometry.
+struct SegmentHistogram
+{
+  int FirstBin{ 0 };
+  std::vector<vtkIdType> Counts;
+};
+
+//----------------------------------------------------------------------------
+struct HistogramGeometry
+{
+  int NumberOfBins{ 0 };
+  double BinOrigin{ 0.0 };
+  double BinSpacing{ 1.0 };
+  /// 0.0 if bins correspond to exact integer values, 0.5 if the bin center is reported
+  double BinCenterOffset{ 0.0 };
+
+  /// Index of the bin that contains the value. NaN is mapped to the first bin.
+  int GetBin(double value) const
+  {
+    const double binPosition = (value - this->BinOrigin) * (1.0 / this->BinSpacing);
+    // comparison is written so that NaN is mapped to the first bin
+    return (binPosition >= 0.0) ? std::min(static_cast<int>(binPosition), this->NumberOfBins - 1) : 0;
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Accumulates statistics of all segments of a labelmap layer in one pass.
+/// Scalars are optional (nullptr if only voxel counts and extents are computed).
+/// If ComputeHistogram is enabled then only the histograms are accumulated, in the bin range
+/// of each segment (SegmentFirstBin, SegmentNumberOfBins) that is determined by a previous pass.
+template <class LabelType, class ScalarType>
+class AccumulateStatisticsFunctor
+{
+public:
+  const LabelType* Labels{ nullptr };
+  vtkIdType LabelIncrements[3]{ 0, 0, 0 };
+  int LabelExtent[6]{ 0, -1, 0, -1, 0, -1 };
+  const ScalarType* Scalars{ nullptr };
+  vtkIdType ScalarIncrements[3]{ 0, 0, 0 };
+  int ScalarExtent[6]{ 0, -1, 0, -1, 0, -1 };
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  const std::vector<int>* LabelToSegmentIndex{ nullptr };
+  int NumberOfSegments{ 0 };
+  bool ComputeHistogram{ false };
+  HistogramGeometry Histogram;
+  std::vector<int> SegmentFirstBin;
+  std::vector<int> SegmentNumberOfBins;
+  vtkSMPThreadLocal<ThreadAccumulators> ThreadLocal;
+
+  void Initialize()
+  {
+    ThreadAccumulators& accumulators = this->ThreadLocal.Local();
+    accumulators.Segments.resize(this->NumberOfSegments);
+    accumulators.Histograms.resize(this->NumberOfSegments);
+  }
+
+  void operator()(vtkIdType zBegin, vtkIdType zEnd)
+  {
+    ThreadAccumulators& accumulators = this->ThreadLocal.Local();
+    const std::vector<int>& labelToSegmentIndex = *this->LabelToSegmentIndex;
+    const long long lookupSize = static_cast<long long>(labelToSegmentIndex.size());
+    for (int k = static_cast<int>(zBegin); k < static_cast<int>(zEnd); ++k)
+    {
+      for (int j = this->Extent[2]; j <= this->Extent[3]; ++j)
+      {
+        const LabelType* labelPtr = this->Labels                                                  //
+                                    + (k - this->LabelExtent[4]) * this->LabelIncrements[2]      //
+                                    + (j - this->LabelExtent[2]) * this->LabelIncrements[1]      //
+                                    + (this->Extent[0] - this->LabelExtent[0]) * this->LabelIncrements[0];
+        const ScalarType* scalarPtr = nullptr;
+        if (this->Scalars)
+        {
+          scalarPtr = this->Scalars                                                  //
+                      + (k - this->ScalarExtent[4]) * this->ScalarIncrements[2]      //
+                      + (j - this->ScalarExtent[2]) * this->ScalarIncrements[1]      //
+                      + (this->Extent[0] - this->ScalarExtent[0]) * this->ScalarIncrements[0];
+        }
+        for (int i = this->Extent[0]; i <= this->Extent[1]; ++i, labelPtr += this->LabelIncrements[0])
+        {
+          const long long labelValue = static_cast<long long>(*labelPtr);
+          if (labelValue <= 0 || labelValue >= lookupSize)
+          {
+            continue;
+          }
+          const int segmentIndex = labelToSegmentIndex[labelValue];
+          if (segmentIndex < 0)
+          {
+            continue;
+          }
+          if (this->ComputeHistogram)
+          {
+            std::vector<unsigned int>& histogram = accumulators.Histograms[segmentIndex];
+            if (histogram.empty())
+            {
+              histogram.resize(this->SegmentNumberOfBins[segmentIndex], 0);
+            }
+            const double value = static_cast<double>(scalarPtr[(i - this->Extent[0]) * this->ScalarIncrements[0]]);
+            // NaN is not included in the segment minimum and maximum, so the bin is clamped to the range of the segment
+            const int bin = this->Histogram.GetBin(value) - this->SegmentFirstBin[segmentIndex];
+            histogram[std::max(0, std::min(bin, this->SegmentNumberOfBins[segmentIndex] - 1))]++;
+            continue;
+          }
+          SegmentAccumulator& segment = accumulators.Segments[segmentIndex];
+          segment.VoxelCount++;
+          segment.Extent[0] = std::min(segment.Extent[0], i);
+          segment.Extent[1] = std::max(segment.Extent[1], i);
+          segment.Extent[2] = std::min(segment.Extent[2], j);
+          segment.Extent[3] = std::max(segment.Extent[3], j);
+          segment.Extent[4] = std::min(segment.Extent[4], k);
+          segment.Extent[5] = std::max(segment.Extent[5], k);
+          if (!scalarPtr)
+          {
+            continue;
+          }
+          const double value = static_cast<double>(scalarPtr[(i - this->Extent[0]) * this->ScalarIncrements[0]]);
+          segment.Sum += value;
+          segment.SumOfSquares += value * value;
+          segment.Minimum = std::min(segment.Minimum, value);
+          segment.Maximum = std::max(segment.Maximum, value);
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+//----------------------------------------------------------------------------
+/// Scalar types that are valid for binary labelmap representation (see vtkOrientedImageDataResample::IsImageScalarTypeValid)
+#define vtkSegmentationStatisticsLabelTypeMacro(call)     \
+  case VTK_UNSIGNED_CHAR:                                 \
+  {                                                       \
+    typedef unsigned char VTK_LABEL_TT;                   \
+    call;                                                 \
+  }                                                       \
+  break;                                                  \
+  case VTK_CHAR:                                          \
+  {                                                       \
+    typedef char VTK_LABEL_TT;                            \
+    call;                                                 \
+  }                                                       \
+  break;                                                  \
+  case VTK_UNSIGNED_SHORT:                                \
+  {                                                       \
+    typedef unsigned short VTK_LABEL_TT;                  \
+    call;                                                 \
+  }                                                       \
+  break;                                                  \
+  case VTK_SHORT:                                         \
+  {                                                       \
+    typedef short VTK_LABEL_TT;                           \
+    call;                                                 \
+  }                                                       \
+  break;                                                  \
+  case VTK_UNSIGNED_INT:                                  \
+  {                                                       \
+    typedef unsigned int VTK_LABEL_TT;                    \
+    call;                                                 \
+  }                                                       \
+  break;                                                  \
+  case VTK_INT:                                           \
+  {                                                       \
+    typedef int VTK_LABEL_TT;                             \
+    call;                                                 \
+  }                                                       \
+  break;
+
+//----------------------------------------------------------------------------
+/// Segment statistics are computed in a first pass. If histograms are requested then they are computed
+/// in a second pass, which only allocates the bins between the minimum and maximum of each segment
+/// (instead of all bins of the shared histogram geometry for each segment in each thread).
+template <class LabelType, class ScalarType>
+void AccumulateStatistics(vtkImageData* labelmap,
+                          vtkImageData* scalarVolume,
+                          const int extent[6],
+                          const std::vector<int>& labelToSegmentIndex,
+                          bool computeHistogram,
+                          const HistogramGeometry& histogramGeometry,
+                          std::vector<SegmentAccumulator>& segments,
+                          std::vector<SegmentHistogram>& histograms)
+{
+  AccumulateStatisticsFunctor<LabelType, ScalarType> functor;
+  functor.Labels = static_cast<const LabelType*>(labelmap->GetScalarPointer());
+  labelmap->GetIncrements(functor.LabelIncrements);
+  labelmap->GetExtent(functor.LabelExtent);
+  if (scalarVolume)
+  {
+    functor.Scalars = static_cast<const ScalarType*>(scalarVolume->GetScalarPointer());
+    scalarVolume->GetIncrements(functor.ScalarIncrements);
+    scalarVolume->GetExtent(functor.ScalarExtent);
+  }
+  std::copy(extent, extent + 6, functor.Extent);
+  functor.LabelToSegmentIndex = &labelToSegmentIndex;
+  functor.NumberOfSegments = static_cast<int>(segments.size());
+  functor.Histogram = histogramGeometry;
+
+  vtkSMPTools::For(extent[4], extent[5] + 1, functor);
+
+  for (ThreadAccumulators& threadAccumulators : functor.ThreadLocal)
+  {
+    if (threadAccumulators.Segments.empty())
+    {
+      // thread did not process any voxels
+      continue;
+    }
+    for (int segmentIndex = 0; segmentIndex < functor.NumberOfSegments; ++segmentIndex)
+    {
+      segments[segmentIndex].Merge(threadAccumulators.Segments[segmentIndex]);
+    }
+  }
+
+  if (!computeHistogram || !scalarVolume)
+  {
+    return;
+  }
+
+  // Bin range of each segment and the region that contains all segments
+  AccumulateStatisticsFunctor<LabelType, ScalarType> histogramFunctor;
+  histogramFunctor.Labels = functor.Labels;
+  std::copy(functor.LabelIncrements, functor.LabelIncrements + 3, histogramFunctor.LabelIncrements);
+  std::copy(functor.LabelExtent, functor.LabelExtent + 6, histogramFunctor.LabelExtent);
+  histogramFunctor.Scalars = functor.Scalars;
+  std::copy(functor.ScalarIncrements, functor.ScalarIncrements + 3, histogramFunctor.ScalarIncrements);
+  std::copy(functor.ScalarExtent, functor.ScalarExtent + 6, histogramFunctor.ScalarExtent);
+  histogramFunctor.LabelToSegmentIndex = &labelToSegmentIndex;
+  histogramFunctor.NumberOfSegments = functor.NumberOfSegments;
+  histogramFunctor.ComputeHistogram = true;
+  histogramFunctor.Histogram = histogramGeometry;
+  histogramFunctor.SegmentFirstBin.resize(functor.NumberOfSegments, 0);
+  histogramFunctor.SegmentNumberOfBins.resize(functor.NumberOfSegments, 0);
+  SegmentAccumulator allSegments;
+  for (int segmentIndex = 0; segmentIndex < functor.NumberOfSegments; ++segmentIndex)
+  {
+    const SegmentAccumulator& segment = segments[segmentIndex];
+    if (segment.VoxelCount == 0)
+    {
+      continue;
+    }
+    allSegments.Merge(segment);
+    histogramFunctor.SegmentFirstBin[segmentIndex] = histogramGeometry.GetBin(segment.Minimum);
+    histogramFunctor.SegmentNumberOfBins[segmentIndex] = histogramGeometry.GetBin(segment.Maximum) - histogramFunctor.SegmentFirstBin[segmentIndex] + 1;
+  }
+  if (allSegments.VoxelCount == 0)
+  {
+    return;
+  }
+  std::copy(allSegments.Extent, allSegments.Extent + 6, histogramFunctor.Extent);
+
+  vtkSMPTools::For(histogramFunctor.Extent[4], histogramFunctor.Extent[5] + 1, histogramFunctor);
+
+  for (int segmentIndex = 0; segmentIndex < functor.NumberOfSegments; ++segmentIndex)
+  {
+    if (segments[segmentIndex].VoxelCount == 0)
+    {
+      continue;
+    }
+    SegmentHistogram& histogram = histograms[segmentIndex];
+    histogram.FirstBin = histogramFunctor.SegmentFirstBin[segmentIndex];
+    histogram.Counts.assign(histogramFunctor.SegmentNumberOfBins[segmentIndex], 0);
+    for (ThreadAccumulators& threadAccumulators : histogramFunctor.ThreadLocal)
+    {
+      if (threadAccumulators.Histograms.empty())
+      {
+        // thread did not process any voxels
+        continue;
+      }
+      const std::vector<unsigned int>& threadHistogram = threadAccumulators.Histograms[segmentIndex];
+      for (size_t bin = 0; bin < threadHistogram.size(); ++bin)
+      {
+        histogram.Counts[bin] += threadHistogram[bin];
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class LabelType>
+void AccumulateStatisticsForLabelType(vtkImageData* labelmap,
+                                      vtkImageData* scalarVolume,
+                                      const int extent[6],
+                                      const std::vector<int>& labelToSegmentIndex,
+                                      bool computeHistogram,
+                                      const HistogramGeometry& histogramGeometry,
+                                      std::vector<SegmentAccumulator>& segments,
+                                      std::vector<SegmentHistogram>& histograms)
+{
+  if (!scalarVolume)
+  {
+    AccumulateStatistics<LabelType, LabelType>(labelmap, nullptr, extent, labelToSegmentIndex, false, histogramGeometry, segments, histograms);
+    return;
+  }
+  switch (scalarVolume->GetScalarType())
+  {
+    // extra parentheses are needed because the template argument list contains a comma
+    vtkTemplateMacro(
+      (AccumulateStatistics<LabelType, VTK_TT>(labelmap, scalarVolume, extent, labelToSegmentIndex, computeHistogram, histogramGeometry, segments, histograms)));
+    default: vtkGenericWarningMacro("vtkSegmentationStatistics: unsupported scalar volume type " << scalarVolume->GetScalarTypeAsString());
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkSegmentationStatistics::vtkInternal
+{
+public:
+  struct SegmentStatistics
+  {
+    vtkIdType VoxelCount{ 0 };
+    double Volume{ 0.0 };
+    int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+    double Minimum{ 0.0 };
+    double Maximum{ 0.0 };
+    double Mean{ 0.0 };
+    double StandardDeviation{ 0.0 };
+    SegmentHistogram Histogram;
+  };
+
+  SegmentStatistics* GetSegmentStatistics(const std::string& segmentID)
+  {
+    auto segmentIt = this->Statistics.find(segmentID);
+    if (segmentIt == this->Statistics.end())
+    {
+      return nullptr;
+    }
+    return &(segmentIt->second);
+  }
+
+  std::vector<std::string> SegmentIDs;
+  std::map<std::string, SegmentStatistics> Statistics;
+  HistogramGeometry Histogram;
+};
+
+//----------------------------------------------------------------------------
+vtkSegmentationStatistics::vtkSegmentationStatistics()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentationStatistics::~vtkSegmentationStatistics()
+{
+  this->SetSegmentation(nullptr);
+  this->SetScalarVolume(nullptr);
+  this->SetSegmentationToScalarVolumeTransform(nullptr);
+  delete this->Internal;
+  this->Internal = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Segmentation: " << this->Segmentation << "\n";
+  os << indent << "ScalarVolume: " << this->ScalarVolume << "\n";
+  os << indent << "SegmentationToScalarVolumeTransform: " << this->SegmentationToScalarVolumeTransform << "\n";
+  os << indent << "ComputePercentiles: " << (this->ComputePercentiles ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfBins: " << this->MaximumNumberOfBins << "\n";
+  os << indent << "Number of segment IDs: " << this->Internal->SegmentIDs.size() << "\n";
+  os << indent << "Number of computed segments: " << this->Internal->Statistics.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::SetSegmentIDs(const std::vector<std::string>& segmentIDs)
+{
+  if (this->Internal->SegmentIDs == segmentIDs)
+  {
+    return;
+  }
+  this->Internal->SegmentIDs = segmentIDs;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> vtkSegmentationStatistics::GetSegmentIDs()
+{
+  return this->Internal->SegmentIDs;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::Update()
+{
+  this->Internal->Statistics.clear();
+  if (!this->Segmentation)
+  {
+    vtkErrorMacro("Update: Invalid segmentation");
+    return false;
+  }
+  std::string labelmapRepresentationName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  if (!this->Segmentation->ContainsRepresentation(labelmapRepresentationName))
+  {
+    vtkErrorMacro("Update: Segmentation does not contain binary labelmap representation");
+    return false;
+  }
+
+  vtkDataArray* scalars = nullptr;
+  double scalarVoxelVolume = 0.0;
+  if (this->ScalarVolume)
+  {
+    scalars = this->ScalarVolume->GetPointData() ? this->ScalarVolume->GetPointData()->GetScalars() : nullptr;
+    if (!scalars)
+    {
+      vtkErrorMacro("Update: Invalid scalar volume");
+      return false;
+    }
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    this->ScalarVolume->GetSpacing(spacing);
+    scalarVoxelVolume = spacing[0] * spacing[1] * spacing[2];
+
+    // Histogram geometry is shared by all segments
+    HistogramGeometry& histogram = this->Internal->Histogram;
+    double scalarRange[2] = { 0.0, 0.0 };
+    scalars->GetRange(scalarRange, 0);
+    bool integerScalars = (scalars->GetDataType() != VTK_FLOAT && scalars->GetDataType() != VTK_DOUBLE);
+    if (integerScalars && scalarRange[1] - scalarRange[0] + 1.0 <= this->MaximumNumberOfBins)
+    {
+      histogram.NumberOfBins = static_cast<int>(scalarRange[1] - scalarRange[0]) + 1;
+      histogram.BinOrigin = scalarRange[0];
+      histogram.BinSpacing = 1.0;
+      histogram.BinCenterOffset = 0.0;
+    }
+    else
+    {
+      histogram.NumberOfBins = this->MaximumNumberOfBins;
+      histogram.BinOrigin = scalarRange[0];
+      histogram.BinSpacing = (scalarRange[1] > scalarRange[0]) ? (scalarRange[1] - scalarRange[0]) / this->MaximumNumberOfBins : 1.0;
+      histogram.BinCenterOffset = 0.5;
+    }
+  }
+
+  // Segments that statistics are computed for
+  std::vector<std::string> requestedSegmentIDs = this->Internal->SegmentIDs;
+  if (requestedSegmentIDs.empty())
+  {
+    this->Segmentation->GetSegmentIDs(requestedSegmentIDs);
+  }
+  std::map<std::string, bool> isSegmentRequested;
+  for (const std::string& segmentID : requestedSegmentIDs)
+  {
+    if (!this->Segmentation->GetSegment(segmentID))
+    {
+      vtkWarningMacro("Update: Segment not found: " << segmentID);
+      continue;
+    }
+    isSegmentRequested[segmentID] = true;
+    // empty segments have valid (zero) statistics
+    this->Internal->Statistics[segmentID] = vtkInternal::SegmentStatistics();
+  }
+
+  int numberOfLayers = this->Segmentation->GetNumberOfLayers(labelmapRepresentationName);
+  for (int layer = 0; layer < numberOfLayers; ++layer)
+  {
+    // Segments of this layer that statistics are computed for
+    std::vector<std::string> layerSegmentIDs;
+    std::vector<int> labelToSegmentIndex;
+    for (const std::string& segmentID : this->Segmentation->GetSegmentIDsForLayer(layer, labelmapRepresentationName))
+    {
+      if (!isSegmentRequested[segmentID])
+      {
+        continue;
+      }
+      int labelValue = this->Segmentation->GetSegment(segmentID)->GetLabelValue();
+      if (labelValue <= 0)
+      {
+        continue;
+      }
+      if (labelValue >= static_cast<int>(labelToSegmentIndex.size()))
+      {
+        labelToSegmentIndex.resize(labelValue + 1, -1);
+      }
+      labelToSegmentIndex[labelValue] = static_cast<int>(layerSegmentIDs.size());
+      layerSegmentIDs.push_back(segmentID);
+    }
+    if (layerSegmentIDs.empty())
+    {
+      continue;
+    }
+
+    vtkOrientedImageData* layerLabelmap = vtkOrientedImageData::SafeDownCast(this->Segmentation->GetLayerDataObject(layer, labelmapRepresentationName));
+    if (!layerLabelmap || !layerLabelmap->GetPointData() || !layerLabelmap->GetPointData()->GetScalars())
+    {
+      // empty layer
+      continue;
+    }
+
+    // Get labelmap in the geometry that the statistics are computed in
+    vtkSmartPointer<vtkOrientedImageData> labelmap = layerLabelmap;
+    int extent[6] = { 0, -1, 0, -1, 0, -1 };
+    double voxelVolume = scalarVoxelVolume;
+    if (this->ScalarVolume)
+    {
+      if (this->SegmentationToScalarVolumeTransform || !vtkOrientedImageDataResample::DoGeometriesMatch(layerLabelmap, this->ScalarVolume))
+      {
+        labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+        if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(
+              layerLabelmap, this->ScalarVolume, labelmap, false, false, this->SegmentationToScalarVolumeTransform))
+        {
+          vtkErrorMacro("Update: Failed to resample labelmap layer " << layer << " to scalar volume geometry");
+          continue;
+        }
+      }
+      // Statistics are computed in the region where both labelmap and scalar volume are defined
+      const int* labelExtent = labelmap->GetExtent();
+      const int* scalarExtent = this->ScalarVolume->GetExtent();
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        extent[axis * 2] = std::max(labelExtent[axis * 2], scalarExtent[axis * 2]);
+        extent[axis * 2 + 1] = std::min(labelExtent[axis * 2 + 1], scalarExtent[axis * 2 + 1]);
+      }
+    }
+    else
+    {
+      labelmap->GetExtent(extent);
+      double spacing[3] = { 1.0, 1.0, 1.0 };
+      labelmap->GetSpacing(spacing);
+      voxelVolume = spacing[0] * spacing[1] * spacing[2];
+    }
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5] || !labelmap->GetPointData()->GetScalars())
+    {
+      // no overlap
+      continue;
+    }
+
+    vtkSmartPointer<vtkImageData> labelImage = labelmap;
+    if (vtkOrientedImageDataResample::IsImageScalarTypeValid(labelmap) != vtkOrientedImageDataResample::TYPE_OK)
+    {
+      vtkNew<vtkImageCast> cast;
+      cast->SetInputData(labelmap);
+      cast->SetOutputScalarTypeToInt();
+      cast->Update();
+      labelImage = cast->GetOutput();
+    }
+
+    std::vector<SegmentAccumulator> segments(layerSegmentIDs.size());
+    std::vector<SegmentHistogram> histograms(layerSegmentIDs.size());
+    switch (labelImage->GetScalarType())
+    {
+      vtkSegmentationStatisticsLabelTypeMacro(AccumulateStatisticsForLabelType<VTK_LABEL_TT>(labelImage,
+                                                                                             this->ScalarVolume,
+                                                                                             extent,
+                                                                                             labelToSegmentIndex,
+                                                                                             this->ComputePercentiles,
+                                                                                             this->Internal->Histogram,
+                                                                                             segments,
+                                                                                             histograms));
+      default: vtkErrorMacro("Update: unsupported labelmap scalar type " << labelImage->GetScalarTypeAsString()); continue;
+    }
+
+    for (size_t segmentIndex = 0; segmentIndex < layerSegmentIDs.size(); ++segmentIndex)
+    {
+      const SegmentAccumulator& accumulator = segments[segmentIndex];
+      vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[layerSegmentIDs[segmentIndex]];
+      statistics.VoxelCount = accumulator.VoxelCount;
+      statistics.Volume = accumulator.VoxelCount * voxelVolume;
+      if (accumulator.VoxelCount == 0)
+      {
+        continue;
+      }
+      std::copy(accumulator.Extent, accumulator.Extent + 6, statistics.Extent);
+      if (this->ScalarVolume)
+      {
+        const double voxelCount = static_cast<double>(accumulator.VoxelCount);
+        statistics.Minimum = accumulator.Minimum;
+        statistics.Maximum = accumulator.Maximum;
+        statistics.Mean = accumulator.Sum / voxelCount;
+        // sample standard deviation, consistent with vtkImageAccumulate
+        statistics.StandardDeviation =
+          (accumulator.VoxelCount > 1) ? sqrt(std::max(0.0, (accumulator.SumOfSquares - accumulator.Sum * accumulator.Sum / voxelCount) / (voxelCount - 1.0))) : 0.0;
+        statistics.Histogram.FirstBin = histograms[segmentIndex].FirstBin;
+        statistics.Histogram.Counts.swap(histograms[segmentIndex].Counts);
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::HasStatistics(const std::string& segmentID)
+{
+  return this->Internal->GetSegmentStatistics(segmentID) != nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSegmentationStatistics::GetVoxelCount(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->VoxelCount : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetVolume(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->Volume : 0.0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::GetExtent(const std::string& segmentID, int extent[6])
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  if (!statistics || statistics->VoxelCount == 0)
+  {
+    vtkOrientedImageDataResample::InvalidateExtent(extent);
+    return false;
+  }
+  std::copy(statistics->Extent, statistics->Extent + 6, extent);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetMinimum(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->Minimum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetMaximum(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->Maximum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetMean(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->Mean : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetStandardDeviation(const std::string& segmentID)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  return statistics ? statistics->StandardDeviation : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetMedian(const std::string& segmentID)
+{
+  return this->GetPercentile(segmentID, 50.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetPercentile(const std::string& segmentID, double percentile)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetSegmentStatistics(segmentID);
+  if (!statistics || statistics->Histogram.Counts.empty())
+  {
+    return 0.0;
+  }
+  const HistogramGeometry& histogram = this->Internal->Histogram;
+  // Find the first bin where the cumulative count reaches the requested rank
+  const double rank = std::max(0.0, std::min(percentile, 100.0)) * 0.01 * statistics->VoxelCount;
+  vtkIdType cumulativeCount = 0;
+  int bin = 0;
+  const std::vector<vtkIdType>& counts = statistics->Histogram.Counts;
+  for (; bin < static_cast<int>(counts.size()); ++bin)
+  {
+    cumulativeCount += counts[bin];
+    if (cumulativeCount > 0 && cumulativeCount >= rank)
+    {
+      break;
+    }
+  }
+  bin = statistics->Histogram.FirstBin + std::min(bin, static_cast<int>(counts.size()) - 1);
+  return histogram.BinOrigin + (bin + histogram.BinCenterOffset) * histogram.BinSpacing;
+}
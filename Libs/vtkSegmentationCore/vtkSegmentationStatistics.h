@@ -0,0 +1,140 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSegmentationStatistics_h
+#define __vtkSegmentationStatistics_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+#include "vtkSegmentationCoreExport.h"
+
+class vtkAbstractTransform;
+class vtkOrientedImageData;
+class vtkSegmentation;
+
+/// \brief Compute statistics of all segments of a segmentation at once.
+///
+/// Statistics are computed from the binary labelmap representation of the segmentation.
+/// Each shared labelmap layer is processed in a single multithreaded pass, regardless of
+/// how many segments the layer contains.
+///
+/// If no scalar volume is set then voxel count, volume and extent of each segment are computed
+/// in the geometry of the labelmap layer of the segment.
+///
+/// If a scalar volume is set then each labelmap layer is resampled (using nearest neighbor interpolation)
+/// to the geometry of the scalar volume and voxel count, volume, extent, minimum, maximum, mean, standard deviation
+/// and (if ComputePercentiles is enabled) median and percentiles of the scalar volume are computed
+/// for the voxels of each segment. Only the first scalar component of the volume is used.
+///
+/// Median and percentiles are computed from per-segment histograms. For integer scalar types each
+/// histogram bin corresponds to a single value (as long as the scalar range does not exceed MaximumNumberOfBins),
+/// therefore the result is exact. For floating-point types the result is the center of the histogram bin that contains
+/// the percentile.
+class vtkSegmentationCore_EXPORT vtkSegmentationStatistics : public vtkObject
+{
+public:
+  static vtkSegmentationStatistics* New();
+  vtkTypeMacro(vtkSegmentationStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Segmentation to compute statistics for. Must contain binary labelmap representation.
+  vtkGetObjectMacro(Segmentation, vtkSegmentation);
+  void SetSegmentation(vtkSegmentation* segmentation);
+
+  /// IDs of segments to compute statistics for.
+  /// If empty (default) then statistics are computed for all segments.
+  void SetSegmentIDs(const std::vector<std::string>& segmentIDs);
+  std::vector<std::string> GetSegmentIDs();
+
+  /// Optional scalar volume. Intensity statistics are only computed if a scalar volume is set.
+  vtkGetObjectMacro(ScalarVolume, vtkOrientedImageData);
+  void SetScalarVolume(vtkOrientedImageData* scalarVolume);
+
+  /// Optional transform from the segmentation to the scalar volume coordinate system.
+  vtkGetObjectMacro(SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+  void SetSegmentationToScalarVolumeTransform(vtkAbstractTransform* transform);
+
+  //@{
+  /// Compute per-segment histograms for getting median and percentiles.
+  /// Enabled by default. Only has effect if scalar volume is set.
+  vtkGetMacro(ComputePercentiles, bool);
+  vtkSetMacro(ComputePercentiles, bool);
+  vtkBooleanMacro(ComputePercentiles, bool);
+  //@}
+
+  //@{
+  /// Maximum number of histogram bins that are used for computing median and percentiles.
+  /// Only the bins between the minimum and maximum value of a segment are allocated for its histogram.
+  /// Default is 65536.
+  vtkGetMacro(MaximumNumberOfBins, int);
+  vtkSetClampMacro(MaximumNumberOfBins, int, 2, 1 << 24);
+  //@}
+
+  /// Compute the statistics.
+  /// \return Success flag
+  bool Update();
+
+  /// Returns true if statistics are available for the segment.
+  bool HasStatistics(const std::string& segmentID);
+
+  /// Number of voxels in the segment.
+  vtkIdType GetVoxelCount(const std::string& segmentID);
+
+  /// Volume of the segment in mm3 (voxel count multiplied by voxel volume).
+  double GetVolume(const std::string& segmentID);
+
+  /// Get the extent of the segment voxels (in the labelmap layer geometry or in the scalar volume geometry, if scalar volume is set).
+  /// \return False if the segment is empty.
+  bool GetExtent(const std::string& segmentID, int extent[6]);
+
+  /// Intensity statistics. Returns 0 if the segment is empty or no scalar volume is set.
+  double GetMinimum(const std::string& segmentID);
+  double GetMaximum(const std::string& segmentID);
+  double GetMean(const std::string& segmentID);
+  double GetStandardDeviation(const std::string& segmentID);
+
+  /// Get median of the scalar volume within the segment. Requires ComputePercentiles enabled.
+  double GetMedian(const std::string& segmentID);
+
+  /// Get the scalar value below which the specified percentage of the segment voxels fall. Requires ComputePercentiles enabled.
+  /// \param percentile Percentile value between 0 and 100.
+  double GetPercentile(const std::string& segmentID, double percentile);
+
+protected:
+  vtkSegmentationStatistics();
+  ~vtkSegmentationStatistics() override;
+
+  vtkSegmentation* Segmentation{ nullptr };
+  vtkOrientedImageData* ScalarVolume{ nullptr };
+  vtkAbstractTransform* SegmentationToScalarVolumeTransform{ nullptr };
+  bool ComputePercentiles{ true };
+  int MaximumNumberOfBins{ 65536 };
+
+private:
+  vtkSegmentationStatistics(const vtkSegmentationStatistics&) = delete;
+  void operator=(const vtkSegmentationStatistics&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkCurveGenerator.h"
+#include "vtkCurveMeasurementsCalculator.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsCurveNode.h"
+#include "vtkMRMLMeasurement.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkTimerLog.h>
+
+// STL includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void AddHelixControlPoints(vtkMRMLMarkupsCurveNode* curveNode, int numberOfControlPoints)
+{
+  int wasModified = curveNode->StartModify();
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    double angle = i * 0.2;
+    curveNode->AddControlPoint(50.0 * cos(angle), 50.0 * sin(angle), i * 0.5);
+  }
+  curveNode->EndModify(wasModified);
+}
+
+//----------------------------------------------------------------------------
+/// Move the middle control point back and forth, update the curve after each move,
+/// and return the average update time in milliseconds.
+double MoveControlPoint(vtkMRMLMarkupsCurveNode* curveNode, int numberOfMoves)
+{
+  int pointIndex = curveNode->GetNumberOfControlPoints() / 2;
+  double position[3] = { 0.0, 0.0, 0.0 };
+  curveNode->GetNthControlPointPosition(pointIndex, position);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int move = 0; move < numberOfMoves; ++move)
+  {
+    position[0] += (move % 2 ? -1.0 : 1.0) * 0.37;
+    curveNode->SetNthControlPointPosition(pointIndex, position);
+    curveNode->GetCurveWorld();
+  }
+  timer->StopTimer();
+  return timer->GetElapsedTime() * 1000.0 / numberOfMoves;
+}
+
+//----------------------------------------------------------------------------
+int TestIncrementalUpdate(int numberOfControlPoints, int curveType)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsCurveNode* curveNode = vtkMRMLMarkupsCurveNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsCurveNode"));
+  CHECK_NOT_NULL(curveNode);
+  curveNode->SetCurveType(curveType);
+  AddHelixControlPoints(curveNode, numberOfControlPoints);
+  curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMeanCurvatureName())->SetEnabled(true);
+  curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMaxCurvatureName())->SetEnabled(true);
+  vtkCurveMeasurementsCalculator* calculator = curveNode->GetCurveMeasurementsCalculator();
+  CHECK_NOT_NULL(calculator);
+  CHECK_BOOL(calculator->GetIncrementalUpdate(), true);
+  curveNode->GetCurveWorld();
+
+  const int numberOfMoves = 20;
+
+  // Incremental update
+  double incrementalTimeMs = MoveControlPoint(curveNode, numberOfMoves);
+  vtkIdType numberOfCurvePoints = curveNode->GetCurveWorld()->GetNumberOfPoints();
+  vtkIdType numberOfRecomputedPoints = calculator->GetNumberOfRecomputedCurvaturePoints();
+  CHECK_BOOL(numberOfRecomputedPoints > 0, true);
+  // Moving a control point of a linear curve only moves the curve points in the two adjacent segments,
+  // Kochanek spline segments depend on two control points on each side, cardinal spline depends on all control points.
+  vtkIdType pointsPerSegment = curveNode->GetNumberOfPointsPerInterpolatingSegment();
+  switch (curveType)
+  {
+    case vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE: CHECK_BOOL(numberOfRecomputedPoints < 2 * (pointsPerSegment + 1), true); break;
+    case vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE: CHECK_BOOL(numberOfRecomputedPoints < 4 * (pointsPerSegment + 1), true); break;
+    default: CHECK_INT(numberOfRecomputedPoints, numberOfCurvePoints - 2); break;
+  }
+
+  vtkNew<vtkDoubleArray> incrementalCurvature;
+  incrementalCurvature->DeepCopy(curveNode->GetCurveWorld()->GetPointData()->GetArray(vtkCurveMeasurementsCalculator::GetCurvatureArrayName()));
+  double incrementalMeanCurvature = curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMeanCurvatureName())->GetValue();
+  double incrementalMaxCurvature = curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMaxCurvatureName())->GetValue();
+
+  // Full recomputation must give the same results
+  calculator->SetIncrementalUpdate(false);
+  calculator->ResetCache();
+  vtkDoubleArray* fullCurvature =
+    vtkDoubleArray::SafeDownCast(curveNode->GetCurveWorld()->GetPointData()->GetArray(vtkCurveMeasurementsCalculator::GetCurvatureArrayName()));
+  CHECK_NOT_NULL(fullCurvature);
+  CHECK_INT(calculator->GetNumberOfRecomputedCurvaturePoints(), numberOfCurvePoints - 2);
+  CHECK_INT(fullCurvature->GetNumberOfTuples(), incrementalCurvature->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < fullCurvature->GetNumberOfTuples(); ++i)
+  {
+    CHECK_DOUBLE_TOLERANCE(fullCurvature->GetValue(i), incrementalCurvature->GetValue(i), 1e-9);
+  }
+  CHECK_DOUBLE_TOLERANCE(curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMeanCurvatureName())->GetValue(), incrementalMeanCurvature, 1e-9);
+  CHECK_DOUBLE_TOLERANCE(curveNode->GetMeasurement(vtkCurveMeasurementsCalculator::GetMaxCurvatureName())->GetValue(), incrementalMaxCurvature, 1e-9);
+
+  double fullTimeMs = MoveControlPoint(curveNode, numberOfMoves);
+
+  std::cout << curveNode->GetCurveTypeAsString(curveType) << " curve with " << numberOfControlPoints << " control points (" << numberOfCurvePoints << " curve points):"
+            << " incremental update " << incrementalTimeMs << " ms (curvature recomputed at " << numberOfRecomputedPoints << " points),"
+            << " full update " << fullTimeMs << " ms" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsCurveNodeIncrementalUpdateTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  const int curveTypes[] = { vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE, vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, vtkCurveGenerator::CURVE_TYPE_CARDINAL_SPLINE };
+  for (int curveType : curveTypes)
+  {
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(100, curveType));
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(1000, curveType));
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(5000, curveType));
+  }
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
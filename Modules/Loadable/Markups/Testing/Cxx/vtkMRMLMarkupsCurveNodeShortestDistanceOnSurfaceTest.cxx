@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsClosedCurveNode.h"
+#include "vtkMRMLMarkupsCurveNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkSlicerDijkstraGraphGeodesicPath.h"
+#include "vtkSurfaceGeodesicPathCalculator.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkElevationFilter.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// STL includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+const double SphereRadius = 50.0;
+
+//----------------------------------------------------------------------------
+vtkMRMLModelNode* AddSphereModel(vtkMRMLScene* scene)
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(SphereRadius);
+  sphereSource->SetThetaResolution(60);
+  sphereSource->SetPhiResolution(60);
+  // Active point scalars are needed by the cost functions that use scalar weights
+  vtkNew<vtkElevationFilter> elevationFilter;
+  elevationFilter->SetInputConnection(sphereSource->GetOutputPort());
+  elevationFilter->Update();
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode"));
+  modelNode->SetAndObservePolyData(elevationFilter->GetPolyDataOutput());
+  return modelNode;
+}
+
+//----------------------------------------------------------------------------
+void AddControlPointsOnSphere(vtkMRMLMarkupsCurveNode* curveNode)
+{
+  curveNode->AddControlPoint(SphereRadius, 0.0, 0.0);
+  curveNode->AddControlPoint(0.0, SphereRadius, 0.0);
+  curveNode->AddControlPoint(0.0, 0.0, SphereRadius);
+}
+
+//----------------------------------------------------------------------------
+int CheckPointsOnSphere(vtkPoints* points)
+{
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+  {
+    double* point = points->GetPoint(pointIndex);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Norm(point), SphereRadius, 1e-3);
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestOpenCurve()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLModelNode* modelNode = AddSphereModel(scene);
+  vtkMRMLMarkupsCurveNode* curveNode = vtkMRMLMarkupsCurveNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsCurveNode"));
+  CHECK_NOT_NULL(curveNode);
+  AddControlPointsOnSphere(curveNode);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), false);
+
+  curveNode->SetCurveTypeToShortestDistanceOnSurface(modelNode);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), true);
+
+  // Curve goes along the surface mesh, from the first to the last control point
+  vtkPoints* curvePointsWorld = curveNode->GetCurvePointsWorld();
+  CHECK_NOT_NULL(curvePointsWorld);
+  vtkIdType numberOfCurvePoints = curvePointsWorld->GetNumberOfPoints();
+  CHECK_BOOL(numberOfCurvePoints > 3, true);
+  CHECK_EXIT_SUCCESS(CheckPointsOnSphere(curvePointsWorld));
+  double firstControlPoint[3] = { 0.0, 0.0, 0.0 };
+  curveNode->GetNthControlPointPositionWorld(0, firstControlPoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(curvePointsWorld->GetPoint(0), firstControlPoint)), 0.0, 1e-3);
+  double lastControlPoint[3] = { 0.0, 0.0, 0.0 };
+  curveNode->GetNthControlPointPositionWorld(2, lastControlPoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(curvePointsWorld->GetPoint(numberOfCurvePoints - 1), lastControlPoint)), 0.0, 1e-3);
+
+  // Path along mesh edges is slightly longer than the two quarter great circle arcs
+  double greatCircleLength = vtkMath::Pi() * SphereRadius;
+  double curveLength = curveNode->GetCurveLengthWorld();
+  CHECK_BOOL(curveLength >= greatCircleLength * 0.99, true);
+  CHECK_BOOL(curveLength <= greatCircleLength * 1.2, true);
+
+  // Local curve and control point lookup use the same path
+  CHECK_INT(curveNode->GetCurvePoints()->GetNumberOfPoints(), numberOfCurvePoints);
+  vtkDoubleArray* pedigreeIds = vtkDoubleArray::SafeDownCast(curveNode->GetCurve()->GetPointData()->GetArray("PedigreeIDs"));
+  CHECK_NOT_NULL(pedigreeIds);
+  CHECK_INT(pedigreeIds->GetNumberOfTuples(), numberOfCurvePoints);
+  CHECK_INT(curveNode->GetControlPointIndexFromInterpolatedPointIndex(0), 0);
+  CHECK_INT(curveNode->GetControlPointIndexFromInterpolatedPointIndex(numberOfCurvePoints - 2), 1);
+
+  // Same result as the direct path computation
+  vtkNew<vtkPoints> pathPointsWorld;
+  CHECK_BOOL(curveNode->GetShortestDistanceOnSurfacePathWorld(pathPointsWorld), true);
+  CHECK_INT(pathPointsWorld->GetNumberOfPoints(), numberOfCurvePoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfCurvePoints; ++pointIndex)
+  {
+    CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(pathPointsWorld->GetPoint(pointIndex), curvePointsWorld->GetPoint(pointIndex))), 0.0, 1e-6);
+  }
+
+  // Moving a control point does not rebuild the graph of the surface
+  vtkSurfaceGeodesicPathCalculator* pathCalculator = curveNode->GetSurfaceGeodesicPathCalculator();
+  CHECK_BOOL(pathCalculator->IsGraphUpToDate(), true);
+  curveNode->SetNthControlPointPosition(1, 0.0, -SphereRadius, 0.0);
+  CHECK_BOOL(pathCalculator->IsGraphUpToDate(), true);
+  curvePointsWorld = curveNode->GetCurvePointsWorld();
+  CHECK_NOT_NULL(curvePointsWorld);
+  CHECK_EXIT_SUCCESS(CheckPointsOnSphere(curvePointsWorld));
+  CHECK_BOOL(pathCalculator->IsGraphUpToDate(), true);
+
+  // Cost functions other than distance fall back to the curve generator
+  curveNode->SetSurfaceCostFunctionType(vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_ADDITIVE);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), false);
+  CHECK_NOT_NULL(curveNode->GetCurvePointsWorld());
+  CHECK_BOOL(curveNode->GetCurvePointsWorld()->GetNumberOfPoints() > 3, true);
+  curveNode->SetSurfaceCostFunctionType(vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), true);
+
+  // Other curve types and removing the surface use the curve generator
+  curveNode->SetCurveTypeToLinear();
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), false);
+  curveNode->SetCurveTypeToShortestDistanceOnSurface(modelNode);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), true);
+  curveNode->SetAndObserveSurfaceConstraintNode(nullptr);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), false);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestClosedCurve()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLModelNode* modelNode = AddSphereModel(scene);
+  vtkMRMLMarkupsClosedCurveNode* curveNode = vtkMRMLMarkupsClosedCurveNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsClosedCurveNode"));
+  CHECK_NOT_NULL(curveNode);
+  AddControlPointsOnSphere(curveNode);
+  curveNode->SetCurveTypeToShortestDistanceOnSurface(modelNode);
+  CHECK_BOOL(curveNode->IsSurfaceGeodesicPathFilterUsed(), true);
+
+  vtkPolyData* curveWorld = curveNode->GetCurveWorld();
+  CHECK_NOT_NULL(curveWorld);
+  CHECK_EXIT_SUCCESS(CheckPointsOnSphere(curveWorld->GetPoints()));
+  // Closed polyline: last point of the cell is the first point
+  CHECK_INT(curveWorld->GetNumberOfLines(), 1);
+  vtkNew<vtkIdList> linePointIds;
+  curveWorld->GetLines()->GetCellAtId(0, linePointIds);
+  CHECK_INT(linePointIds->GetNumberOfIds(), curveWorld->GetNumberOfPoints() + 1);
+  CHECK_INT(linePointIds->GetId(linePointIds->GetNumberOfIds() - 1), linePointIds->GetId(0));
+
+  // Three quarter great circle arcs
+  double greatCircleLength = 1.5 * vtkMath::Pi() * SphereRadius;
+  double curveLength = curveNode->GetCurveLengthWorld();
+  CHECK_BOOL(curveLength >= greatCircleLength * 0.99, true);
+  CHECK_BOOL(curveLength <= greatCircleLength * 1.2, true);
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsCurveNodeShortestDistanceOnSurfaceTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestOpenCurve());
+  CHECK_EXIT_SUCCESS(TestClosedCurve());
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// STL includes
+#include <iostream>
+#include <map>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CountEventCallback(vtkObject* vtkNotUsed(caller), unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+{
+  std::map<unsigned long, int>* eventCounts = reinterpret_cast<std::map<unsigned long, int>*>(clientData);
+  (*eventCounts)[eid]++;
+}
+
+//----------------------------------------------------------------------------
+void CreateRandomPoints(vtkPoints* points, int numberOfPoints, double offset)
+{
+  vtkMath::RandomSeed(1);
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+  {
+    points->SetPoint(i, vtkMath::Random(-100.0, 100.0) + offset, vtkMath::Random(-100.0, 100.0), vtkMath::Random(-100.0, 100.0));
+  }
+}
+
+//----------------------------------------------------------------------------
+int TestBulkPositions(int numberOfPoints)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsFiducialNode* pointListNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  CHECK_NOT_NULL(pointListNode);
+
+  vtkNew<vtkPoints> points;
+  CreateRandomPoints(points, numberOfPoints, 0.0);
+
+  // Point by point (reference)
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkNew<vtkMRMLMarkupsFiducialNode> referenceNode;
+  scene->AddNode(referenceNode);
+  // same name is needed for generating the same control point labels
+  referenceNode->SetName(pointListNode->GetName());
+  int wasModified = referenceNode->StartModify();
+  for (int i = 0; i < numberOfPoints; ++i)
+  {
+    referenceNode->AddControlPoint(points->GetPoint(i));
+  }
+  referenceNode->EndModify(wasModified);
+  timer->StopTimer();
+  double pointByPointTimeMs = timer->GetElapsedTime() * 1000.0;
+
+  // Bulk add
+  std::map<unsigned long, int> eventCounts;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetClientData(&eventCounts);
+  callback->SetCallback(CountEventCallback);
+  pointListNode->AddObserver(vtkMRMLMarkupsNode::PointAddedEvent, callback);
+  pointListNode->AddObserver(vtkMRMLMarkupsNode::PointModifiedEvent, callback);
+  pointListNode->AddObserver(vtkMRMLMarkupsNode::PointRemovedEvent, callback);
+
+  timer->StartTimer();
+  pointListNode->SetControlPointPositions(points);
+  timer->StopTimer();
+  double bulkAddTimeMs = timer->GetElapsedTime() * 1000.0;
+
+  CHECK_INT(pointListNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_INT(pointListNode->GetNumberOfDefinedControlPoints(), numberOfPoints);
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointAddedEvent], 1);
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointModifiedEvent], 1);
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointRemovedEvent], 0);
+  for (int i = 0; i < numberOfPoints; i += numberOfPoints / 10 + 1)
+  {
+    CHECK_STD_STRING(pointListNode->GetNthControlPointLabel(i), referenceNode->GetNthControlPointLabel(i));
+    CHECK_STD_STRING(pointListNode->GetNthControlPointID(i), referenceNode->GetNthControlPointID(i));
+    double position[3] = { 0.0, 0.0, 0.0 };
+    double referencePosition[3] = { 0.0, 0.0, 0.0 };
+    pointListNode->GetNthControlPointPosition(i, position);
+    referenceNode->GetNthControlPointPosition(i, referencePosition);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, referencePosition), 0.0, 1e-12);
+  }
+
+  // Bulk update of existing points
+  eventCounts.clear();
+  CreateRandomPoints(points, numberOfPoints, 10.0);
+  timer->StartTimer();
+  pointListNode->SetControlPointPositions(points);
+  timer->StopTimer();
+  double bulkUpdateTimeMs = timer->GetElapsedTime() * 1000.0;
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointAddedEvent], 0);
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointModifiedEvent], 1);
+
+  vtkNew<vtkPoints> retrievedPoints;
+  pointListNode->GetControlPointPositions(retrievedPoints);
+  CHECK_INT(retrievedPoints->GetNumberOfPoints(), numberOfPoints);
+  CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(retrievedPoints->GetPoint(numberOfPoints - 1), points->GetPoint(numberOfPoints - 1)), 0.0, 1e-12);
+
+  // World coordinates with a parent transform
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  vtkNew<vtkTransform> transform;
+  transform->Translate(5.0, -3.0, 2.0);
+  transform->RotateZ(30.0);
+  transformNode->SetMatrixTransformToParent(transform->GetMatrix());
+  pointListNode->SetAndObserveTransformNodeID(transformNode->GetID());
+  timer->StartTimer();
+  pointListNode->SetControlPointPositionsWorld(points);
+  timer->StopTimer();
+  double bulkUpdateWorldTimeMs = timer->GetElapsedTime() * 1000.0;
+  pointListNode->GetControlPointPositionsWorld(retrievedPoints);
+  CHECK_INT(retrievedPoints->GetNumberOfPoints(), numberOfPoints);
+  for (int i = 0; i < numberOfPoints; i += numberOfPoints / 10 + 1)
+  {
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(retrievedPoints->GetPoint(i), points->GetPoint(i)), 0.0, 1e-9);
+    double positionWorld[3] = { 0.0, 0.0, 0.0 };
+    pointListNode->GetNthControlPointPositionWorld(i, positionWorld);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(positionWorld, points->GetPoint(i)), 0.0, 1e-9);
+  }
+
+  // Bulk remove
+  eventCounts.clear();
+  vtkNew<vtkPoints> fewerPoints;
+  fewerPoints->InsertNextPoint(points->GetPoint(0));
+  fewerPoints->InsertNextPoint(points->GetPoint(1));
+  pointListNode->SetControlPointPositionsWorld(fewerPoints);
+  CHECK_INT(pointListNode->GetNumberOfControlPoints(), 2);
+  CHECK_INT(eventCounts[vtkMRMLMarkupsNode::PointRemovedEvent], 1);
+
+  std::cout << numberOfPoints << " control points: point by point add " << pointByPointTimeMs << " ms,"
+            << " bulk add " << bulkAddTimeMs << " ms, bulk update " << bulkUpdateTimeMs << " ms,"
+            << " bulk update in world coordinates " << bulkUpdateWorldTimeMs << " ms" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsNodeBulkPositionsTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestBulkPositions(10));
+  CHECK_EXIT_SUCCESS(TestBulkPositions(1000));
+  CHECK_EXIT_SUCCESS(TestBulkPositions(50000));
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
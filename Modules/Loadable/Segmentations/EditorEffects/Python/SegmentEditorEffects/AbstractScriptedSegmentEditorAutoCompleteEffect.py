@@ -46,6 +46,10 @@ class AbstractScriptedSegmentEditorAutoCompleteEffect(AbstractScriptedSegmentEdi
         self.clippedMasterImageData = None
         self.clippedMaskImageData = None
 
+        # Effects may set this in computePreviewLabelmap to the extent of voxels that changed
+        # since the previous preview computation. None means that the whole output may have changed.
+        self.previewChangedExtent = None
+
         # Observation for auto-update
         self.observedSegmentation = None
         self.segmentationNodeObserverTags = []
@@ -554,9 +558,6 @@ class AbstractScriptedSegmentEditorAutoCompleteEffect(AbstractScriptedSegmentEdi
                     self.clippedMaskImageData = None
 
         previewNode.SetName(segmentationNode.GetName() + " preview")
-        previewNode.RemoveClosedSurfaceRepresentation()  # Force the closed surface representation to update
-        # TODO: This will no longer be required when we can use the segment editor to set multiple segments
-        # as the closed surfaces will be converted as necessary by the segmentation logic.
 
         mergedImage = slicer.vtkOrientedImageData()
         segmentationNode.GenerateMergedLabelmapForAllSegments(
@@ -564,8 +565,19 @@ class AbstractScriptedSegmentEditorAutoCompleteEffect(AbstractScriptedSegmentEdi
             vtkSegmentationCore.vtkSegmentation.EXTENT_UNION_OF_EFFECTIVE_SEGMENTS, self.mergedLabelmapGeometryImage, self.selectedSegmentIds)
 
         outputLabelmap = slicer.vtkOrientedImageData()
+        self.previewChangedExtent = None
         self.computePreviewLabelmap(mergedImage, outputLabelmap)
 
+        if self.updatePreviewInChangedExtent(previewNode, outputLabelmap):
+            # Only the changed region of the existing preview labelmap was updated
+            self.setPreviewShow3D(previewShow3D)
+            self.updateGUIFromMRML()
+            return
+
+        previewNode.RemoveClosedSurfaceRepresentation()  # Force the closed surface representation to update
+        # TODO: This will no longer be required when we can use the segment editor to set multiple segments
+        # as the closed surfaces will be converted as necessary by the segmentation logic.
+
         if previewNode.GetSegmentation().GetNumberOfSegments() != self.selectedSegmentIds.GetNumberOfValues():
             # first update (or number of segments changed), need a full reinitialization
             previewNode.GetSegmentation().RemoveAllSegments()
@@ -595,5 +607,56 @@ class AbstractScriptedSegmentEditorAutoCompleteEffect(AbstractScriptedSegmentEdi
 
         self.updateGUIFromMRML()
 
+    def updatePreviewInChangedExtent(self, previewNode, outputLabelmap):
+        """Copy the changed region of the computed labelmap into the labelmap shared by the preview segments.
+
+        Modifying the existing labelmap in place (instead of replacing it) avoids recreating the display
+        pipelines and skips all updates if the result has not changed.
+        Returns False if the preview has to be fully replaced (first update, segments or geometry changed,
+        or the effect did not report the changed extent).
+        """
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        if self.previewChangedExtent is None:
+            return False
+        previewSegmentation = previewNode.GetSegmentation()
+        if previewSegmentation.GetNumberOfSegments() != self.selectedSegmentIds.GetNumberOfValues():
+            return False
+        binaryLabelmapName = vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName()
+        previewLabelmap = None
+        for index in range(self.selectedSegmentIds.GetNumberOfValues()):
+            previewSegment = previewSegmentation.GetSegment(self.selectedSegmentIds.GetValue(index))
+            if not previewSegment or previewSegment.GetLabelValue() != index + 1:
+                return False
+            segmentLabelmap = previewSegment.GetRepresentation(binaryLabelmapName)
+            if previewLabelmap is None:
+                previewLabelmap = segmentLabelmap
+            if segmentLabelmap is None or segmentLabelmap is not previewLabelmap:
+                return False
+        if (previewLabelmap.GetScalarType() != outputLabelmap.GetScalarType()
+                or not vtkSegmentationCore.vtkOrientedImageDataResample.DoGeometriesMatch(previewLabelmap, outputLabelmap)
+                or not vtkSegmentationCore.vtkOrientedImageDataResample.DoExtentsMatch(previewLabelmap, outputLabelmap)):
+            return False
+
+        changedExtent = self.previewChangedExtent
+        if changedExtent[0] > changedExtent[1] or changedExtent[2] > changedExtent[3] or changedExtent[4] > changedExtent[5]:
+            # Result has not changed
+            return True
+
+        if previewLabelmap.GetPointData().GetScalars() is not outputLabelmap.GetPointData().GetScalars():
+            previewLabelmap.CopyAndCastFrom(outputLabelmap, changedExtent)
+        # Modified event invalidates the closed surface representation and updates the views
+        previewLabelmap.Modified()
+
+        # Background segments are detected from the corner voxels, which only need to be checked
+        # if the changed region contains a corner of the image.
+        extent = previewLabelmap.GetExtent()
+        cornerChanged = all(changedExtent[2 * axis] == extent[2 * axis] or changedExtent[2 * axis + 1] == extent[2 * axis + 1] for axis in range(3))
+        if cornerChanged:
+            for index in range(self.selectedSegmentIds.GetNumberOfValues()):
+                segmentID = self.selectedSegmentIds.GetValue(index)
+                previewNode.GetDisplayNode().SetSegmentVisibility3D(segmentID, not self.isBackgroundLabelmap(previewLabelmap, index + 1))
+        return True
+
 
 ResultPreviewNodeReferenceRole = "SegmentationResultPreview"
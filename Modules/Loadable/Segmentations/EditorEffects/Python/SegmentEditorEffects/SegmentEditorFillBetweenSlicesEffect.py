@@ -1,5 +1,8 @@
+import logging
 import os
+import time
 
+import numpy as np
 import qt
 import vtk
 
@@ -18,6 +21,9 @@ class SegmentEditorFillBetweenSlicesEffect(AbstractScriptedSegmentEditorAutoComp
         AbstractScriptedSegmentEditorAutoCompleteEffect.__init__(self, scriptedEffect)
         scriptedEffect.name = "Fill between slices"  # no tr (don't translate it because modules find effects by name)
         scriptedEffect.title = _("Fill between slices")
+        # If enabled then interpolated slices are cached and only gaps next to modified slices are recomputed
+        self.incrementalUpdate = True
+        self.interpolationCache = None
 
     def clone(self):
         import qSlicerSegmentationsEditorEffectsPythonQt as effects
@@ -42,16 +48,165 @@ do not use sphere brush with Paint effect and always leave at least one empty sl
 <li>The complete segmentation will be created by interpolating segmentations in empty slices.
 </ul><p>
 Masking settings are ignored. If segments overlap, segment higher in the segments table will have priority.
+If all segments are drawn on slices of the same orientation then after the first update only the gaps
+next to modified slices are recomputed.
 The effect uses  <a href="https://insight-journal.org/browse/publication/977">morphological contour interpolation method</a>.
 <p>""")
 
+    def reset(self):
+        self.interpolationCache = None
+        AbstractScriptedSegmentEditorAutoCompleteEffect.reset(self)
+
     def computePreviewLabelmap(self, mergedImage, outputLabelmap):
-        import vtkITK
+        import vtk.util.numpy_support
 
-        interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
-        interpolator.SetInputData(mergedImage)
-        interpolator.Update()
-        outputLabelmap.DeepCopy(interpolator.GetOutput())
+        startTime = time.time()
+        inputArray = vtk.util.numpy_support.vtk_to_numpy(mergedImage.GetPointData().GetScalars()).reshape(mergedImage.GetDimensions()[::-1])
+        labelSlices = self.getLabelSlices(inputArray)
+        axis = self.getInterpolationAxis(labelSlices)
+        if axis is None:
+            # Segments are drawn on slices of multiple orientations, interpolate along all axes
+            self.interpolationCache = None
+            outputArray = self.interpolate(inputArray, mergedImage.GetSpacing(), mergedImage.GetScalarType(), -1)
+        else:
+            outputArray = self.interpolateIncrementally(inputArray, labelSlices[axis], axis, mergedImage)
+        logging.info("Fill between slices on volume of {}x{}x{} voxels was completed in {:3.1f} seconds.".format(
+            *mergedImage.GetDimensions(), time.time() - startTime))
+
+        outputLabelmap.SetExtent(mergedImage.GetExtent())
+        outputLabelmap.AllocateScalars(mergedImage.GetScalarType(), 1)
+        vtk.util.numpy_support.vtk_to_numpy(outputLabelmap.GetPointData().GetScalars())[:] = outputArray.ravel()
         imageToWorld = vtk.vtkMatrix4x4()
         mergedImage.GetImageToWorldMatrix(imageToWorld)
         outputLabelmap.SetImageToWorldMatrix(imageToWorld)
+
+    @staticmethod
+    def getLabelSlices(inputArray):
+        """Get indices of slices that contain each label, for each image axis.
+        Returns list of dicts (one for each IJK axis) that map label value to sorted array of slice indices.
+        """
+        coordinates = np.nonzero(inputArray)
+        labels = inputArray[coordinates].astype(np.int64)
+        labelSlices = []
+        for axis in range(3):
+            # numpy array index order is KJI
+            sliceIndices = coordinates[2 - axis].astype(np.int64)
+            numberOfSlices = inputArray.shape[2 - axis]
+            # Unique (label, slice) pairs
+            labelSliceKeys = np.unique(labels * numberOfSlices + sliceIndices)
+            keyLabels = labelSliceKeys // numberOfSlices
+            keySlices = labelSliceKeys % numberOfSlices
+            labelSlices.append({int(label): keySlices[keyLabels == label] for label in np.unique(keyLabels)})
+        return labelSlices
+
+    @staticmethod
+    def getInterpolationAxis(labelSlices):
+        """Get the axis along which segments have gaps between segmented slices.
+        Returns None if there are gaps along multiple axes or there are no gaps.
+        """
+        axesWithGaps = [axis for axis in range(3) if any(np.any(np.diff(slices) > 1) for slices in labelSlices[axis].values())]
+        return axesWithGaps[0] if len(axesWithGaps) == 1 else None
+
+    @staticmethod
+    def interpolate(inputArray, spacing, scalarType, axis):
+        import vtk.util.numpy_support
+        import vtkITK
+
+        inputImage = vtk.vtkImageData()
+        inputImage.SetDimensions(inputArray.shape[::-1])
+        inputImage.SetSpacing(spacing)
+        inputImage.GetPointData().SetScalars(vtk.util.numpy_support.numpy_to_vtk(inputArray.ravel(), deep=True, array_type=scalarType))
+        interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+        interpolator.SetInputData(inputImage)
+        interpolator.SetAxis(axis)
+        interpolator.Update()
+        return vtk.util.numpy_support.vtk_to_numpy(interpolator.GetOutput().GetPointData().GetScalars()).reshape(inputArray.shape).copy()
+
+    def interpolateIncrementally(self, inputArray, labelSlices, axis, mergedImage):
+        """Interpolate between segmented slices along the specified axis.
+
+        Interpolation in a gap between two consecutive segmented slices of a label only depends on these two slices,
+        therefore interpolated slices are cached for each label and only the gaps next to modified slices are recomputed.
+        All recomputed gaps of all labels are interpolated in a single (multi-threaded) interpolator update.
+        """
+        arrayAxis = 2 - axis  # numpy array index order is KJI
+
+        def sliceIndex(start, stop=None):
+            index = [slice(None)] * 3
+            index[arrayAxis] = start if stop is None else slice(start, stop)
+            return tuple(index)
+
+        cache = self.interpolationCache
+        if not self.incrementalUpdate or cache is None or cache["axis"] != axis or cache["input"].shape != inputArray.shape:
+            # Compute all gaps
+            cache = {"axis": axis, "input": None, "slices": {}}
+            recomputedRanges = {label: (slices[0], slices[-1]) for label, slices in labelSlices.items()}
+            self.previewChangedExtent = None
+        else:
+            # Find gaps next to modified slices.
+            # The extent of the edit is not known here, therefore the whole merged labelmap is compared
+            # with the previous input. This is a single pass over the volume (and a temporary boolean volume),
+            # which is much cheaper than the interpolation that it avoids.
+            recomputedRanges = {}
+            changedVoxels = inputArray != cache["input"]
+            otherAxes = tuple(a for a in range(3) if a != arrayAxis)
+            changedSlices = np.nonzero(np.any(changedVoxels, axis=otherAxes))[0]
+            if len(changedSlices) > 0:
+                changedStart, changedStop = changedSlices[0], changedSlices[-1] + 1
+                previousInput = cache["input"][sliceIndex(changedStart, changedStop)]
+                currentInput = inputArray[sliceIndex(changedStart, changedStop)]
+                changedLabels = np.union1d(np.unique(previousInput[changedVoxels[sliceIndex(changedStart, changedStop)]]),
+                                           np.unique(currentInput[changedVoxels[sliceIndex(changedStart, changedStop)]]))
+                for label in changedLabels[changedLabels != 0]:
+                    label = int(label)
+                    changedLabelSlices = changedStart + np.nonzero(np.any((previousInput == label) != (currentInput == label), axis=otherAxes))[0]
+                    segmentedSlices = labelSlices.get(label, np.array([], dtype=np.int64))
+                    segmentedSlicesBefore = segmentedSlices[segmentedSlices < changedLabelSlices[0]]
+                    segmentedSlicesAfter = segmentedSlices[segmentedSlices > changedLabelSlices[-1]]
+                    recomputedRanges[label] = (
+                        segmentedSlicesBefore[-1] if len(segmentedSlicesBefore) > 0 else changedLabelSlices[0],
+                        segmentedSlicesAfter[0] if len(segmentedSlicesAfter) > 0 else changedLabelSlices[-1])
+            if recomputedRanges:
+                changedExtent = list(mergedImage.GetExtent())
+                changedExtent[axis * 2 + 1] = changedExtent[axis * 2] + int(max(end for start, end in recomputedRanges.values()))
+                changedExtent[axis * 2] += int(min(start for start, end in recomputedRanges.values()))
+                self.previewChangedExtent = changedExtent
+            else:
+                self.previewChangedExtent = [0, -1, 0, -1, 0, -1]
+
+        if recomputedRanges:
+            # Interpolate all recomputed gaps at once. Segmented slices of each label are only kept
+            # within the range of that label, so that other gaps are not interpolated.
+            rangeStart = int(min(start for start, end in recomputedRanges.values()))
+            rangeStop = int(max(end for start, end in recomputedRanges.values())) + 1
+            rangeInput = inputArray[sliceIndex(rangeStart, rangeStop)]
+            gapsInput = np.zeros_like(rangeInput)
+            for label, (start, end) in recomputedRanges.items():
+                labelRange = sliceIndex(start - rangeStart, end - rangeStart + 1)
+                gapsInput[labelRange][rangeInput[labelRange] == label] = label
+            gapsOutput = self.interpolate(gapsInput, mergedImage.GetSpacing(), mergedImage.GetScalarType(), axis)
+
+            for label, (start, end) in recomputedRanges.items():
+                labelCache = cache["slices"].setdefault(label, {})
+                for index in [index for index in labelCache if start <= index <= end]:
+                    del labelCache[index]
+                segmentedSlices = set(labelSlices.get(label, []))
+                for index in range(start + 1, end):
+                    if index in segmentedSlices:
+                        continue
+                    interpolatedSlice = gapsOutput[sliceIndex(index - rangeStart)] == label
+                    if np.any(interpolatedSlice):
+                        labelCache[index] = interpolatedSlice
+                if not labelCache:
+                    del cache["slices"][label]
+
+        cache["input"] = inputArray.copy()
+        self.interpolationCache = cache
+
+        # Add interpolated slices to segmented slices. If interpolated regions overlap, lower label value has priority.
+        outputArray = inputArray.copy()
+        for label in sorted(cache["slices"]):
+            for index, interpolatedSlice in cache["slices"][label].items():
+                outputSlice = outputArray[sliceIndex(index)]
+                outputSlice[interpolatedSlice & (outputSlice == 0)] = label
+        return outputArray
@@ -80,9 +80,20 @@ class SegmentEditorGrowFromSeedsEffect(AbstractScriptedSegmentEditorAutoComplete
         self.scriptedEffect.addLabeledOptionsWidget(_("Seed locality:"), self.seedLocalityFactorSlider)
         self.seedLocalityFactorSlider.connect("valueChanged(double)", self.updateAlgorithmParameterFromGUI)
 
+        # Engine selector
+        self.engineComboBox = qt.QComboBox()
+        self.engineComboBox.addItem(_("Fibonacci heap"), "FibonacciHeap")
+        self.engineComboBox.addItem(_("Bucket queue"), "BucketQueue")
+        self.engineComboBox.setToolTip(_("Algorithm used for growing the segments. Both compute the same shortest paths,"
+                                         " only voxels that are at equal distance from multiple seeds may get a different label."
+                                         " Bucket queue requires less memory and is faster on large images."))
+        self.scriptedEffect.addLabeledOptionsWidget(_("Engine:"), self.engineComboBox)
+        self.engineComboBox.connect("currentIndexChanged(int)", self.updateAlgorithmParameterFromGUI)
+
     def setMRMLDefaults(self):
         AbstractScriptedSegmentEditorAutoCompleteEffect.setMRMLDefaults(self)
         self.scriptedEffect.setParameterDefault("SeedLocalityFactor", 0.0)
+        self.scriptedEffect.setParameterDefault("Engine", "FibonacciHeap")
 
     def updateGUIFromMRML(self):
         AbstractScriptedSegmentEditorAutoCompleteEffect.updateGUIFromMRML(self)
@@ -94,9 +105,14 @@ class SegmentEditorGrowFromSeedsEffect(AbstractScriptedSegmentEditorAutoComplete
         self.seedLocalityFactorSlider.value = abs(seedLocalityFactor)
         self.seedLocalityFactorSlider.blockSignals(wasBlocked)
 
+        wasBlocked = self.engineComboBox.blockSignals(True)
+        self.engineComboBox.setCurrentIndex(max(0, self.engineComboBox.findData(self.getEngine())))
+        self.engineComboBox.blockSignals(wasBlocked)
+
     def updateMRMLFromGUI(self):
         AbstractScriptedSegmentEditorAutoCompleteEffect.updateMRMLFromGUI(self)
         self.scriptedEffect.setParameter("SeedLocalityFactor", self.seedLocalityFactorSlider.value)
+        self.scriptedEffect.setParameter("Engine", self.engineComboBox.itemData(self.engineComboBox.currentIndex))
 
     def updateAlgorithmParameterFromGUI(self):
         self.updateMRMLFromGUI()
@@ -105,11 +121,14 @@ class SegmentEditorGrowFromSeedsEffect(AbstractScriptedSegmentEditorAutoComplete
         if self.getPreviewNode():
             self.delayedAutoUpdateTimer.start()
 
-    def computePreviewLabelmap(self, mergedImage, outputLabelmap):
-        import vtkITK
+    def getEngine(self):
+        if self.scriptedEffect.parameterDefined("Engine"):
+            return self.scriptedEffect.parameter("Engine")
+        return "FibonacciHeap"
 
+    def computePreviewLabelmap(self, mergedImage, outputLabelmap):
         if not self.growCutFilter:
-            self.growCutFilter = vtkITK.vtkITKGrowCut()
+            self.growCutFilter = slicer.vtkImageGrowCutSegment()
             self.growCutFilter.SetIntensityVolume(self.clippedMasterImageData)
             self.growCutFilter.SetMaskVolume(self.clippedMaskImageData)
             maskExtent = self.clippedMaskImageData.GetExtent() if self.clippedMaskImageData else None
@@ -132,6 +151,10 @@ class SegmentEditorGrowFromSeedsEffect(AbstractScriptedSegmentEditorAutoComplete
         else:
             seedLocalityFactor = 0.0
         self.growCutFilter.SetDistancePenalty(seedLocalityFactor)
+        if self.getEngine() == "BucketQueue":
+            self.growCutFilter.SetEngineToBucketQueue()
+        else:
+            self.growCutFilter.SetEngineToFibonacciHeap()
         self.growCutFilter.SetSeedLabelVolume(mergedImage)
         startTime = time.time()
         self.growCutFilter.Update()
@@ -141,7 +164,12 @@ class SegmentEditorGrowFromSeedsEffect(AbstractScriptedSegmentEditorAutoComplete
             self.clippedMasterImageData.GetDimensions()[2],
             time.time() - startTime))
 
-        outputLabelmap.DeepCopy(self.growCutFilter.GetOutput())
+        # Allow updating only the region that has been relabeled
+        self.previewChangedExtent = self.growCutFilter.GetChangedExtent()
+
+        # The output is not copied: the filter only modifies voxels in the changed extent and
+        # the preview is notified about the change by the auto-complete effect base class.
+        outputLabelmap.ShallowCopy(self.growCutFilter.GetOutput())
         imageToWorld = vtk.vtkMatrix4x4()
         mergedImage.GetImageToWorldMatrix(imageToWorld)
         outputLabelmap.SetImageToWorldMatrix(imageToWorld)
@@ -156,11 +156,8 @@ about each operation, hover the mouse over the option and wait for the tooltip t
         islandMath.SetMinimumSize(minimumSize)
         islandMath.Update()
 
-        islandImage = slicer.vtkOrientedImageData()
-        islandImage.ShallowCopy(islandMath.GetOutput())
         selectedSegmentLabelmapImageToWorldMatrix = vtk.vtkMatrix4x4()
         selectedSegmentLabelmap.GetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix)
-        islandImage.SetImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix)
 
         islandCount = islandMath.GetNumberOfIslands()
         islandOrigCount = islandMath.GetOriginalNumberOfIslands()
@@ -177,9 +174,8 @@ about each operation, hover the mouse over the option and wait for the tooltip t
             if selectedSegmentName is not None and selectedSegmentName != "":
                 baseSegmentName = selectedSegmentName
 
-            labelValues = vtk.vtkIntArray()
-            slicer.vtkSlicerSegmentationsModuleLogic.GetAllLabelValues(labelValues, islandImage)
-            numberOfIslands = labelValues.GetNumberOfTuples()
+            # Islands are labeled with consecutive values (starting from 1) in decreasing order of size
+            numberOfIslands = islandCount
 
             # The selected segment is not erased before the islands are written back; and its
             # content is replaced (using "Set" modification mode) only at the end of the operation.
@@ -196,7 +192,7 @@ about each operation, hover the mouse over the option and wait for the tooltip t
                         # We only care about the segments up to maxNumberOfSegments.
                         break
 
-                    labelValue = int(labelValues.GetTuple1(i))
+                    labelValue = i + 1
                     segment = slicer.vtkSegment()
                     name = baseSegmentName + "_" + str(i + 1)
                     segment.SetName(name)
@@ -212,11 +208,18 @@ about each operation, hover the mouse over the option and wait for the tooltip t
                     threshold.ThresholdBetween(labelValue, labelValue)
                     threshold.SetInValue(1)
                     threshold.SetOutValue(0)
-                    threshold.Update()
+                    # Only the bounding box of the island is needed to add it to the new segment
+                    islandExtent = [0, -1, 0, -1, 0, -1]
+                    islandMath.GetIslandExtent(i, islandExtent)
+                    clip = vtk.vtkImageClip()
+                    clip.SetInputConnection(threshold.GetOutputPort())
+                    clip.SetOutputWholeExtent(islandExtent)
+                    clip.ClipDataOn()
+                    clip.Update()
 
                     # Create oriented image data from output
                     modifierImage = slicer.vtkOrientedImageData()
-                    modifierImage.DeepCopy(threshold.GetOutput())
+                    modifierImage.DeepCopy(clip.GetOutput())
                     modifierImage.SetGeometryFromImageToWorldMatrix(selectedSegmentLabelmapImageToWorldMatrix)
                     # We could use a single slicer.vtkSlicerSegmentationsModuleLogic.ImportLabelmapToSegmentationNode
                     # method call to import all the resulting segments at once but that would put all the imported segments
@@ -235,7 +238,7 @@ about each operation, hover the mouse over the option and wait for the tooltip t
                 threshold.SetOutValue(1)
             elif numberOfIslands > 0:
                 # Keep only the first (largest) island in the selected segment.
-                labelValue = int(labelValues.GetTuple1(0))
+                labelValue = 1
                 threshold.ThresholdBetween(labelValue, labelValue)
                 threshold.SetInValue(1)
                 threshold.SetOutValue(0)
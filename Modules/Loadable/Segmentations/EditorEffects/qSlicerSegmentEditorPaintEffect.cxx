@@ -25,6 +25,7 @@
 #include "vtkMRMLSegmentationDisplayNode.h"
 #include "vtkMRMLSegmentationsDisplayableManager2D.h"
 #include "vtkMRMLSegmentEditorNode.h"
+#include "vtkBrushStrokeRasterizer.h"
 #include "vtkOrientedImageData.h"
 
 // Qt includes
@@ -49,10 +50,6 @@
 #include <vtkGlyph2D.h>
 #include <vtkGlyph3D.h>
 #include <vtkIdList.h>
-#include <vtkImageChangeInformation.h>
-#include <vtkImageStencil.h>
-#include <vtkImageStencilData.h>
-#include <vtkImageStencilToImage.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -63,7 +60,6 @@
 #include <vtkPolyDataMapper.h>
 #include <vtkPolyDataMapper2D.h>
 #include <vtkPolyDataNormals.h>
-#include <vtkPolyDataToImageStencil.h>
 #include <vtkProperty2D.h>
 #include <vtkProperty.h>
 #include <vtkPropPicker.h>
@@ -246,13 +242,7 @@ qSlicerSegmentEditorPaintEffectPrivate::qSlicerSegmentEditorPaintEffectPrivate(q
   this->WorldOriginToWorldTransformer->SetTransform(this->WorldOriginToWorldTransform);
   this->WorldOriginToWorldTransformer->SetInputConnection(this->BrushPolyDataNormals->GetOutputPort());
 
-  this->WorldOriginToModifierLabelmapIjkTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  this->WorldOriginToModifierLabelmapIjkTransform = vtkSmartPointer<vtkTransform>::New();
-  this->WorldOriginToModifierLabelmapIjkTransformer->SetTransform(this->WorldOriginToModifierLabelmapIjkTransform);
-  this->WorldOriginToModifierLabelmapIjkTransformer->SetInputConnection(this->BrushPolyDataNormals->GetOutputPort());
-  this->BrushPolyDataToStencil = vtkSmartPointer<vtkPolyDataToImageStencil>::New();
-  this->BrushPolyDataToStencil->SetOutputSpacing(1.0, 1.0, 1.0);
-  this->BrushPolyDataToStencil->SetInputConnection(this->WorldOriginToModifierLabelmapIjkTransformer->GetOutputPort());
+  this->BrushStrokeRasterizer = vtkSmartPointer<vtkBrushStrokeRasterizer>::New();
 
   this->FeedbackGlyphFilter = vtkSmartPointer<vtkGlyph3D>::New();
   this->FeedbackGlyphFilter->SetInputData(this->FeedbackPointsPolyData);
@@ -324,6 +314,12 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintAddPoint(qMRMLWidget* viewWidg
 
   if (lastBrushPosition_World)
   {
+    if (this->PaintCoordinates_World->GetNumberOfPoints() == 0)
+    {
+      // Previous points have been already painted, start the stroke from the last position
+      // so that the brush is swept continuously between the last and current position.
+      this->PaintCoordinates_World->InsertNextPoint(lastBrushPosition_World);
+    }
     double strokeLength = sqrt(vtkMath::Distance2BetweenPoints(brushPosition_World, lastBrushPosition_World));
     double maximumDistanceBetweenPoints = this->MaximumPointDistanceInStroke * q->doubleParameter("BrushAbsoluteDiameter");
     if (maximumDistanceBetweenPoints > 0.0)
@@ -349,55 +345,24 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintAddPoint(qMRMLWidget* viewWidg
 }
 
 //-----------------------------------------------------------------------------
-void qSlicerSegmentEditorPaintEffectPrivate::updateBrushStencil(qMRMLWidget* viewWidget)
+void qSlicerSegmentEditorPaintEffectPrivate::updateBrushStrokeRasterizer(qMRMLWidget* viewWidget)
 {
   Q_Q(qSlicerSegmentEditorPaintEffect);
-  Q_UNUSED(viewWidget);
 
-  if (!q->parameterSetNode())
-  {
-    qCritical() << Q_FUNC_INFO << ": Invalid segment editor parameter set node!";
-    return;
-  }
-  vtkMRMLSegmentationNode* segmentationNode = q->parameterSetNode()->GetSegmentationNode();
-  if (!segmentationNode)
-  {
-    qCritical() << Q_FUNC_INFO << ": Invalid segmentationNode";
-    return;
-  }
-  vtkOrientedImageData* modifierLabelmap = q->modifierLabelmap();
-  if (!modifierLabelmap)
+  this->BrushStrokeRasterizer->SetBrushRadius(q->doubleParameter("BrushAbsoluteDiameter") / 2.0);
+  this->BrushStrokeRasterizer->SetFillValue(q->m_FillValue);
+
+  qMRMLSliceWidget* sliceWidget = qobject_cast<qMRMLSliceWidget*>(viewWidget);
+  if (!sliceWidget || q->integerParameter("BrushSphere"))
   {
-    qCritical() << Q_FUNC_INFO << ": Invalid modifierLabelmap";
+    this->BrushStrokeRasterizer->SetBrushShapeToSphere();
     return;
   }
-
-  // Brush stencil transform
-
-  this->WorldOriginToModifierLabelmapIjkTransform->Identity();
-
-  vtkNew<vtkMatrix4x4> segmentationToSegmentationIjkTransformMatrix;
-  modifierLabelmap->GetImageToWorldMatrix(segmentationToSegmentationIjkTransformMatrix.GetPointer());
-  segmentationToSegmentationIjkTransformMatrix->Invert();
-  segmentationToSegmentationIjkTransformMatrix->SetElement(0, 3, 0);
-  segmentationToSegmentationIjkTransformMatrix->SetElement(1, 3, 0);
-  segmentationToSegmentationIjkTransformMatrix->SetElement(2, 3, 0);
-  this->WorldOriginToModifierLabelmapIjkTransform->Concatenate(segmentationToSegmentationIjkTransformMatrix.GetPointer());
-
-  vtkNew<vtkMatrix4x4> worldToSegmentationTransformMatrix;
-  // We don't support painting in non-linearly transformed node (it could be implemented, but would probably slow down things too much)
-  // TODO: show a meaningful error message to the user if attempted
-  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(nullptr, segmentationNode->GetParentTransformNode(), worldToSegmentationTransformMatrix.GetPointer());
-  worldToSegmentationTransformMatrix->SetElement(0, 3, 0);
-  worldToSegmentationTransformMatrix->SetElement(1, 3, 0);
-  worldToSegmentationTransformMatrix->SetElement(2, 3, 0);
-  this->WorldOriginToModifierLabelmapIjkTransform->Concatenate(worldToSegmentationTransformMatrix.GetPointer());
-
-  this->WorldOriginToModifierLabelmapIjkTransformer->Update();
-  vtkPolyData* brushModel_ModifierLabelmapIjk = this->WorldOriginToModifierLabelmapIjkTransformer->GetOutput();
-  double* boundsIjk = brushModel_ModifierLabelmapIjk->GetBounds();
-  this->BrushPolyDataToStencil->SetOutputWholeExtent(
-    floor(boundsIjk[0]) - 1, ceil(boundsIjk[1]) + 1, floor(boundsIjk[2]) - 1, ceil(boundsIjk[3]) + 1, floor(boundsIjk[4]) - 1, ceil(boundsIjk[5]) + 1);
+  // Cylinder brush is perpendicular to the slice and its height is the slice spacing (same as in updateBrushModel)
+  this->BrushStrokeRasterizer->SetBrushShapeToCylinder();
+  this->BrushStrokeRasterizer->SetCylinderHeight(qSlicerSegmentEditorAbstractEffect::sliceSpacing(sliceWidget));
+  vtkMatrix4x4* sliceToRas = sliceWidget->sliceLogic()->GetSliceNode()->GetSliceToRAS();
+  this->BrushStrokeRasterizer->SetCylinderAxis(sliceToRas->GetElement(0, 2), sliceToRas->GetElement(1, 2), sliceToRas->GetElement(2, 2));
 }
 
 //-----------------------------------------------------------------------------
@@ -497,8 +462,6 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(vtkOrientedImageData*
   Q_UNUSED(pixelPositions_World);
   Q_Q(qSlicerSegmentEditorPaintEffect);
 
-  this->updateBrushStencil(viewWidget);
-
   if (!modifierLabelmap)
   {
     return;
@@ -511,57 +474,23 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(vtkOrientedImageData*
     return;
   }
 
-  this->BrushPolyDataToStencil->Update();
-  vtkImageStencilData* stencilData = this->BrushPolyDataToStencil->GetOutput();
-  int stencilExtent[6] = { 0, -1, 0, -1, 0, -1 };
-  stencilData->GetExtent(stencilExtent);
-
-  vtkNew<vtkPoints> paintCoordinates_Ijk;
-  this->transformPointsFromWorldToIJK(modifierLabelmap, segmentationNode, this->PaintCoordinates_World, paintCoordinates_Ijk);
+  this->updateBrushStrokeRasterizer(viewWidget);
 
-  vtkNew<vtkImageStencilToImage> stencilToImage;
-  stencilToImage->SetInputConnection(this->BrushPolyDataToStencil->GetOutputPort());
-  stencilToImage->SetInsideValue(q->m_FillValue);
-  stencilToImage->SetOutsideValue(q->m_EraseValue);
-  stencilToImage->SetOutputScalarType(modifierLabelmap->GetScalarType());
-
-  vtkNew<vtkImageChangeInformation> brushPositioner;
-  brushPositioner->SetInputConnection(stencilToImage->GetOutputPort());
-  brushPositioner->SetOutputSpacing(modifierLabelmap->GetSpacing());
-  brushPositioner->SetOutputOrigin(modifierLabelmap->GetOrigin());
+  // We don't support painting in non-linearly transformed node (it could be implemented, but would probably slow down things too much)
+  // TODO: show a meaningful error message to the user if attempted
+  vtkNew<vtkMatrix4x4> segmentationToWorldTransformMatrix;
+  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(segmentationNode->GetParentTransformNode(), nullptr, segmentationToWorldTransformMatrix.GetPointer());
+  this->BrushStrokeRasterizer->SetImagePhysicalToWorldMatrix(segmentationToWorldTransformMatrix);
 
-  vtkIdType numberOfPoints = this->PaintCoordinates_World->GetNumberOfPoints();
-  for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  // The brush is swept along the stroke and only voxels inside the stroke are written,
+  // therefore the modified extent is exactly the extent of painted voxels.
+  int paintedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  this->BrushStrokeRasterizer->Rasterize(modifierLabelmap, this->PaintCoordinates_World, paintedExtent);
+  this->BrushStrokeRasterizer->SetImagePhysicalToWorldMatrix(nullptr);
+  if (updateExtent)
   {
-    double* shiftDouble = paintCoordinates_Ijk->GetPoint(pointIndex);
-    int shift[3] = { vtkMath::Round(shiftDouble[0]), vtkMath::Round(shiftDouble[1]), vtkMath::Round(shiftDouble[2]) };
-    brushPositioner->SetExtentTranslation(shift);
-    brushPositioner->Update();
-    vtkNew<vtkOrientedImageData> orientedBrushPositionerOutput;
-    orientedBrushPositionerOutput->ShallowCopy(brushPositioner->GetOutput());
-    orientedBrushPositionerOutput->CopyDirections(modifierLabelmap);
-    if (pointIndex == 0)
-    {
-      orientedBrushPositionerOutput->GetExtent(updateExtent);
-    }
-    else
-    {
-      int* brushExtent = orientedBrushPositionerOutput->GetExtent();
-      for (int i = 0; i < 3; i++)
-      {
-        if (brushExtent[i * 2] < updateExtent[i * 2])
-        {
-          updateExtent[i * 2] = brushExtent[i * 2];
-        }
-        if (brushExtent[i * 2 + 1] > updateExtent[i * 2 + 1])
-        {
-          updateExtent[i * 2 + 1] = brushExtent[i * 2 + 1];
-        }
-      }
-    }
-    vtkOrientedImageDataResample::ModifyImage(modifierLabelmap, orientedBrushPositionerOutput.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+    std::copy(paintedExtent, paintedExtent + 6, updateExtent);
   }
-  modifierLabelmap->Modified();
 }
 
 //-----------------------------------------------------------------------------
@@ -1665,8 +1594,6 @@ void qSlicerSegmentEditorPaintEffect::paintApply(qMRMLWidget* viewWidget)
     return;
   }
 
-  this->saveStateForUndo();
-
   QList<int> updateExtentList;
   int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
 
@@ -1677,8 +1604,18 @@ void qSlicerSegmentEditorPaintEffect::paintApply(qMRMLWidget* viewWidget)
   else
   {
     d->paintBrushes(modifierLabelmap, viewWidget, d->PaintCoordinates_World, updateExtent);
+    if (updateExtent[0] > updateExtent[1] || updateExtent[2] > updateExtent[3] || updateExtent[4] > updateExtent[5])
+    {
+      // The stroke is outside of the labelmap, nothing to modify
+      // (empty modification extent would mean modifying the entire segment).
+      d->clearBrushPipelines();
+      d->PaintCoordinates_World->Reset();
+      return;
+    }
   }
 
+  this->saveStateForUndo();
+
   int modifierExtent[6] = { 0, -1, 0, -1, 0, -1 };
   modifierLabelmap->GetExtent(modifierExtent);
   for (int i = 0; i < 3; i++)
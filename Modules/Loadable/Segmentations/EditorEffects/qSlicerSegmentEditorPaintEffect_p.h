@@ -62,10 +62,10 @@ class qMRMLSliceWidget;
 class qMRMLSliderWidget;
 class qMRMLSpinBox;
 class vtkActor2D;
+class vtkBrushStrokeRasterizer;
 class vtkGlyph3D;
 class vtkPoints;
 class vtkPolyDataNormals;
-class vtkPolyDataToImageStencil;
 
 /// \brief Private implementation of the segment editor paint effect
 class qSlicerSegmentEditorPaintEffectPrivate : public QObject
@@ -96,9 +96,8 @@ public:
   /// Update brush model (shape and position)
   void updateBrushModel(qMRMLWidget* viewWidget, double brushPosition_World[3]);
 
-  /// Updates the brush stencil that can be used to quickly paint the brush shape into
-  /// modifierLabelmap at many different positions.
-  void updateBrushStencil(qMRMLWidget* viewWidget);
+  /// Update brush shape and size of the stroke rasterizer
+  void updateBrushStrokeRasterizer(qMRMLWidget* viewWidget);
 
 protected:
   /// Get brush object for widget. Create if does not exist
@@ -107,7 +106,7 @@ protected:
   /// Delete all brush pipelines
   void clearBrushPipelines();
 
-  /// Paint brushes to the modifier labelmap
+  /// Paint the brush stroke (brush swept between consecutive paint coordinates) to the modifier labelmap
   void paintBrushes(vtkOrientedImageData* modifierLabelmap, qMRMLWidget* viewWidget, vtkPoints* pixelPositions_World, int extent[6] = nullptr);
 
   /// Paint one pixel at coordinate
@@ -144,10 +143,7 @@ public:
   vtkSmartPointer<vtkTransformPolyDataFilter> WorldOriginToWorldTransformer;
   vtkSmartPointer<vtkTransform> WorldOriginToWorldTransform;
   vtkSmartPointer<vtkPolyDataNormals> BrushPolyDataNormals;
-  vtkSmartPointer<vtkTransformPolyDataFilter> WorldOriginToModifierLabelmapIjkTransformer;
-  vtkSmartPointer<vtkTransform>
-    WorldOriginToModifierLabelmapIjkTransform; // transforms from polydata source to modifierLabelmap's IJK coordinate system (brush origin in IJK origin)
-  vtkSmartPointer<vtkPolyDataToImageStencil> BrushPolyDataToStencil;
+  vtkSmartPointer<vtkBrushStrokeRasterizer> BrushStrokeRasterizer;
 
   vtkSmartPointer<vtkGlyph3D> FeedbackGlyphFilter;
 
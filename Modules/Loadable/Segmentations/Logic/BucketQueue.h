@@ -0,0 +1,152 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// exclude from VTK wrapping
+#ifndef __VTK_WRAP__
+
+# ifndef BUCKETQUEUE_H
+#  define BUCKETQUEUE_H
+
+#  include "FibHeap.h" // for NodeIndexType and NodeKeyValueType
+
+#  include <algorithm>
+#  include <limits>
+#  include <vector>
+
+// .NAME BucketQueue - Quantized priority queue for shortest path computation
+// .SECTION Description
+//
+// Entries are sorted into buckets of equal key range (Dial's algorithm). The buckets
+// form a circular window that covers the range of keys that may be inserted while
+// an entry is processed (current key + maximum edge weight). Entries with keys beyond
+// the window are kept in an overflow list until the window reaches them.
+//
+// Order of entries within a bucket is not defined, therefore the queue must be used
+// with lazy deletion: the same node may be inserted multiple times (each time its key
+// decreases) and popped entries must be ignored if the node's current key is smaller
+// than the key of the entry. Processing nodes in slightly different order than exact
+// key order only affects computation time, as nodes are reinserted whenever their key
+// decreases.
+//
+// Compared to FibHeap, no per-voxel node has to be allocated, only queued entries are stored.
+
+class BucketQueue
+{
+public:
+  struct Entry
+  {
+    NodeIndexType Index;
+    NodeKeyValueType Key;
+  };
+
+  /// Set up buckets so that keys can be increased by maximumKeyIncrement while an entry is processed
+  /// without having to use the overflow list. All entries are removed.
+  void Initialize(double maximumKeyIncrement, int numberOfBuckets = 4096)
+  {
+    numberOfBuckets = std::max(numberOfBuckets, 2);
+    this->Buckets.clear();
+    this->Buckets.resize(numberOfBuckets);
+    this->Overflow.clear();
+    this->OverflowMinimumBucket = std::numeric_limits<size_t>::max();
+    double bucketWidth = maximumKeyIncrement / (numberOfBuckets - 1);
+    this->InverseBucketWidth = (bucketWidth > 0) ? 1.0 / bucketWidth : 1.0;
+    this->CurrentBucket = 0;
+    this->NumberOfEntries = 0;
+  }
+
+  bool IsEmpty() const { return this->NumberOfEntries == 0; }
+
+  size_t GetNumberOfEntries() const { return this->NumberOfEntries; }
+
+  /// Insert an entry. Keys smaller than the key of the last popped entry are processed next.
+  void Push(NodeIndexType index, NodeKeyValueType key)
+  {
+    size_t bucket = std::max(this->CurrentBucket, this->GetBucket(key));
+    if (bucket >= this->CurrentBucket + this->Buckets.size())
+    {
+      this->Overflow.push_back(Entry{ index, key });
+      this->OverflowMinimumBucket = std::min(this->OverflowMinimumBucket, bucket);
+    }
+    else
+    {
+      this->Buckets[bucket % this->Buckets.size()].push_back(Entry{ index, key });
+    }
+    this->NumberOfEntries++;
+  }
+
+  /// Remove an entry from the lowest non-empty bucket.
+  /// Returns false if the queue is empty.
+  bool Pop(Entry& entry)
+  {
+    while (this->NumberOfEntries > 0)
+    {
+      if (this->NumberOfEntries == this->Overflow.size())
+      {
+        // all buckets are empty, jump to the first overflow entry
+        this->CurrentBucket = std::max(this->CurrentBucket, this->OverflowMinimumBucket);
+      }
+      if (this->CurrentBucket >= this->OverflowMinimumBucket)
+      {
+        this->MoveOverflowEntriesToBuckets();
+      }
+      std::vector<Entry>& bucket = this->Buckets[this->CurrentBucket % this->Buckets.size()];
+      if (!bucket.empty())
+      {
+        entry = bucket.back();
+        bucket.pop_back();
+        this->NumberOfEntries--;
+        return true;
+      }
+      this->CurrentBucket++;
+    }
+    return false;
+  }
+
+protected:
+  size_t GetBucket(NodeKeyValueType key) const { return static_cast<size_t>(key * this->InverseBucketWidth); }
+
+  void MoveOverflowEntriesToBuckets()
+  {
+    std::vector<Entry> remainingEntries;
+    this->OverflowMinimumBucket = std::numeric_limits<size_t>::max();
+    for (const Entry& entry : this->Overflow)
+    {
+      size_t bucket = std::max(this->CurrentBucket, this->GetBucket(entry.Key));
+      if (bucket < this->CurrentBucket + this->Buckets.size())
+      {
+        this->Buckets[bucket % this->Buckets.size()].push_back(entry);
+      }
+      else
+      {
+        remainingEntries.push_back(entry);
+        this->OverflowMinimumBucket = std::min(this->OverflowMinimumBucket, bucket);
+      }
+    }
+    this->Overflow.swap(remainingEntries);
+  }
+
+  std::vector<std::vector<Entry>> Buckets;
+  std::vector<Entry> Overflow;
+  size_t OverflowMinimumBucket{ std::numeric_limits<size_t>::max() };
+  double InverseBucketWidth{ 1.0 };
+  size_t CurrentBucket{ 0 };
+  size_t NumberOfEntries{ 0 };
+};
+
+# endif
+
+#endif //__VTK_WRAP__
@@ -36,6 +36,47 @@ public:
   vtkGetMacro(DistancePenalty, double);
   vtkSetMacro(DistancePenalty, double);
 
+  enum
+  {
+    /// Exact Dijkstra shortest path computation using a Fibonacci heap.
+    /// Allocates a heap node for each voxel.
+    EngineFibonacciHeap,
+    /// Dijkstra shortest path computation using a quantized (bucket) priority queue.
+    /// Only a distance value is stored for each voxel, initialization is multithreaded.
+    /// Computes the same shortest paths as EngineFibonacciHeap but may choose a different label
+    /// for voxels that are at equal distance from multiple seeds.
+    EngineBucketQueue
+  };
+
+  /// Algorithm used for computing the segmentation. Default is EngineFibonacciHeap.
+  /// Both engines use the same internal state, therefore the engine can be changed
+  /// between updates without resetting.
+  vtkGetMacro(Engine, int);
+  vtkSetClampMacro(Engine, int, EngineFibonacciHeap, EngineBucketQueue);
+  void SetEngineToFibonacciHeap() { this->SetEngine(EngineFibonacciHeap); }
+  void SetEngineToBucketQueue() { this->SetEngine(EngineBucketQueue); }
+
+  //@{
+  /// If enabled then the initial segmentation is first computed on a half-resolution image
+  /// and then only the regions near label boundaries are computed at full resolution.
+  /// This makes the initial computation significantly faster, but the result is approximate:
+  /// thin structures that are not visible at half resolution may be missed.
+  /// Only used by EngineBucketQueue. Subsequent updates are computed at full resolution.
+  /// Disabled by default.
+  vtkGetMacro(CoarseToFine, bool);
+  vtkSetMacro(CoarseToFine, bool);
+  vtkBooleanMacro(CoarseToFine, bool);
+  //@}
+
+  /// Extent of the voxels whose label has changed during the last update.
+  /// After a full computation (first update or after Reset) this is the whole extent of the output.
+  /// After an incremental update (new seeds added) only the region that is actually relabeled is included,
+  /// which allows updating only that part of the segmentation that uses the output.
+  /// The extent is empty (min > max along each axis) if no labels changed.
+  /// Relabeled voxels are tracked while labels are propagated, therefore the result does not need to be
+  /// compared to the previous result.
+  vtkGetVector6Macro(ChangedExtent, int);
+
 protected:
   vtkImageGrowCutSegment();
   ~vtkImageGrowCutSegment() override;
@@ -52,6 +93,9 @@ private:
   class vtkInternal;
   vtkInternal* Internal;
   double DistancePenalty;
+  int Engine{ EngineFibonacciHeap };
+  bool CoarseToFine{ false };
+  int ChangedExtent[6]{ 0, -1, 0, -1, 0, -1 };
 };
 
 #endif
@@ -36,9 +36,9 @@
 #include "vtkSlicerTerminologyEntry.h"
 
 // VTK includes
-#include <vtkActor.h>
-#include <vtkAppendPolyData.h>
+#include <vtkByteSwap.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCellArray.h>
 #include <vtkDataObject.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGeometryFilter.h>
@@ -47,23 +47,22 @@
 #include <vtkImageMathematics.h>
 #include <vtkImageThreshold.h>
 #include <vtkLookupTable.h>
+#include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
-#include <vtkOBJExporter.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
-#include <vtkPolyDataMapper.h>
-#include <vtkProperty.h>
-#include <vtkRenderer.h>
-#include <vtkRenderWindow.h>
-#include <vtkSTLWriter.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkTriangle.h>
 #include <vtkTriangleFilter.h>
 #include <vtkTrivialProducer.h>
 #include <vtkUnstructuredGrid.h>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/RegularExpression.hxx>
 
@@ -89,8 +88,570 @@
 #include <vtkMRMLTransformNode.h>
 
 // STD includes
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Non-zero label values and extent of non-zero voxels found in part of an image
+struct LabelmapContent
+{
+  std::set<int> LabelValues;
+  int Extent[6]{ VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+};
+
+//----------------------------------------------------------------------------
+/// Label value of a voxel after the labelmap is cast to an integer type on import
+/// (see vtkOrientedImageDataResample::CastSegmentationToSmallestIntegerType): non-integer values
+/// are truncated toward zero and values outside the int range are clamped. NaN is background.
+template <class T>
+int GetLabelValue(T value)
+{
+  const double doubleValue = static_cast<double>(value);
+  if (vtkMath::IsNan(doubleValue))
+  {
+    return 0;
+  }
+  if (doubleValue >= VTK_INT_MAX)
+  {
+    return VTK_INT_MAX;
+  }
+  if (doubleValue <= VTK_INT_MIN)
+  {
+    return VTK_INT_MIN;
+  }
+  return static_cast<int>(doubleValue);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void GetLabelmapContentGeneric(vtkImageData* labelmap, LabelmapContent& content)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  vtkIdType increments[3] = { 0, 0, 0 };
+  labelmap->GetIncrements(increments);
+  T* imagePtr = static_cast<T*>(labelmap->GetScalarPointerForExtent(extent));
+
+  vtkSMPThreadLocal<LabelmapContent> threadContents;
+  vtkSMPTools::For(extent[4],
+                   extent[5] + 1,
+                   [&](vtkIdType firstK, vtkIdType lastK)
+                   {
+                     LabelmapContent& threadContent = threadContents.Local();
+                     int* threadExtent = threadContent.Extent;
+                     for (int k = static_cast<int>(firstK); k < static_cast<int>(lastK); ++k)
+                     {
+                       for (int j = extent[2]; j <= extent[3]; ++j)
+                       {
+                         const T* rowPtr = imagePtr + (k - extent[4]) * increments[2] + (j - extent[2]) * increments[1];
+                         int firstNonZeroI = VTK_INT_MAX;
+                         int lastNonZeroI = VTK_INT_MIN;
+                         T lastValue = 0;
+                         int lastLabelValue = 0;
+                         for (int i = extent[0]; i <= extent[1]; ++i)
+                         {
+                           T value = rowPtr[(i - extent[0]) * increments[0]];
+                           // Labels typically form long runs of the same value, only convert the value and
+                           // look up the set when the value changes
+                           if (value != lastValue)
+                           {
+                             lastValue = value;
+                             lastLabelValue = GetLabelValue(value);
+                             if (lastLabelValue != 0)
+                             {
+                               threadContent.LabelValues.insert(lastLabelValue);
+                             }
+                           }
+                           if (lastLabelValue == 0)
+                           {
+                             continue;
+                           }
+                           if (firstNonZeroI == VTK_INT_MAX)
+                           {
+                             firstNonZeroI = i;
+                           }
+                           lastNonZeroI = i;
+                         }
+                         if (firstNonZeroI > lastNonZeroI)
+                         {
+                           continue;
+                         }
+                         threadExtent[0] = std::min(threadExtent[0], firstNonZeroI);
+                         threadExtent[1] = std::max(threadExtent[1], lastNonZeroI);
+                         threadExtent[2] = std::min(threadExtent[2], j);
+                         threadExtent[3] = std::max(threadExtent[3], j);
+                         threadExtent[4] = std::min(threadExtent[4], k);
+                         threadExtent[5] = std::max(threadExtent[5], k);
+                       }
+                     }
+                   });
+
+  for (const LabelmapContent& threadContent : threadContents)
+  {
+    content.LabelValues.insert(threadContent.LabelValues.begin(), threadContent.LabelValues.end());
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      content.Extent[axis * 2] = std::min(content.Extent[axis * 2], threadContent.Extent[axis * 2]);
+      content.Extent[axis * 2 + 1] = std::max(content.Extent[axis * 2 + 1], threadContent.Extent[axis * 2 + 1]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Closed surface of a segment that is exported to file
+struct ExportedSurface
+{
+  std::string SegmentID;
+  /// Closed surface in segmentation node coordinate system
+  vtkSmartPointer<vtkPolyData> PolyData;
+  /// Segment of the exported segmentation, set if closed surface needs to be computed
+  vtkSegment* SegmentToConvert{ nullptr };
+  /// Names of representations of SegmentToConvert that are also used by other converted segments (shared labelmap layer)
+  std::set<std::string> SharedRepresentationNames;
+  /// Temporary segmentation that will contain only a copy of this segment, set if closed surface needs to be computed
+  vtkSmartPointer<vtkSegmentation> SegmentationToConvert;
+};
+
+//----------------------------------------------------------------------------
+/// Add a copy of the segment to the temporary segmentation of the exported surface.
+/// Representations are shallow-copied so that no data is duplicated, except representations that other
+/// segments use as well (shared labelmap layer): these are deep-copied, because the conversion may modify
+/// the data object even if it only reads it (for example, GetScalarRange updates the cached range of the scalars).
+bool AddSegmentToConvert(ExportedSurface& surface)
+{
+  vtkNew<vtkSegment> segmentCopy;
+  segmentCopy->DeepCopyMetadata(surface.SegmentToConvert);
+  std::vector<std::string> representationNames;
+  surface.SegmentToConvert->GetContainedRepresentationNames(representationNames);
+  for (const std::string& representationName : representationNames)
+  {
+    vtkDataObject* representation = surface.SegmentToConvert->GetRepresentation(representationName);
+    vtkSmartPointer<vtkDataObject> representationCopy =
+      vtkSmartPointer<vtkDataObject>::Take(vtkSegmentationConverterFactory::GetInstance()->ConstructRepresentationObjectByClass(representation->GetClassName()));
+    if (!representationCopy)
+    {
+      continue;
+    }
+    if (surface.SharedRepresentationNames.count(representationName))
+    {
+      representationCopy->DeepCopy(representation);
+    }
+    else
+    {
+      representationCopy->ShallowCopy(representation);
+    }
+    segmentCopy->AddRepresentation(representationName, representationCopy);
+  }
+  return surface.SegmentationToConvert->AddSegment(segmentCopy, surface.SegmentID);
+}
+
+//----------------------------------------------------------------------------
+/// Get closed surfaces of segments. Surfaces that are not available yet are computed in parallel
+/// (one segment per task), surfaces are triangulated if needed.
+/// Worker threads only read the segmentation. Each task converts its own copy of the segment: data objects that
+/// only this segment uses are shallow-copied and therefore only accessed by this task, data objects of a shared
+/// labelmap layer are deep-copied in the task.
+void GetClosedSurfaces(vtkSegmentation* segmentation, std::vector<ExportedSurface>& surfaces, bool triangulate)
+{
+  const std::string closedSurfaceRepresentationName = vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName();
+  bool closedSurfaceAvailable = segmentation->ContainsRepresentation(closedSurfaceRepresentationName);
+
+  // Count how many converted segments use each representation object
+  std::map<vtkDataObject*, int> representationUseCount;
+  for (ExportedSurface& surface : surfaces)
+  {
+    vtkSegment* segment = segmentation->GetSegment(surface.SegmentID);
+    if (!segment)
+    {
+      continue;
+    }
+    if (closedSurfaceAvailable)
+    {
+      vtkPolyData* closedSurface = vtkPolyData::SafeDownCast(segment->GetRepresentation(closedSurfaceRepresentationName));
+      if (closedSurface)
+      {
+        surface.PolyData = vtkSmartPointer<vtkPolyData>::New();
+        surface.PolyData->ShallowCopy(closedSurface);
+      }
+      continue;
+    }
+    surface.SegmentToConvert = segment;
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      representationUseCount[segment->GetRepresentation(representationName)]++;
+    }
+  }
+
+  for (ExportedSurface& surface : surfaces)
+  {
+    if (!surface.SegmentToConvert)
+    {
+      continue;
+    }
+    std::vector<std::string> representationNames;
+    surface.SegmentToConvert->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      if (representationUseCount[surface.SegmentToConvert->GetRepresentation(representationName)] > 1)
+      {
+        surface.SharedRepresentationNames.insert(representationName);
+      }
+    }
+    surface.SegmentationToConvert = vtkSmartPointer<vtkSegmentation>::New();
+    surface.SegmentationToConvert->SetSourceRepresentationName(segmentation->GetSourceRepresentationName());
+    surface.SegmentationToConvert->CopyConversionParameters(segmentation);
+  }
+
+  vtkSMPTools::For(0,
+                   static_cast<vtkIdType>(surfaces.size()),
+                   1,
+                   [&](vtkIdType first, vtkIdType last)
+                   {
+                     for (vtkIdType surfaceIndex = first; surfaceIndex < last; ++surfaceIndex)
+                     {
+                       ExportedSurface& surface = surfaces[surfaceIndex];
+                       if (surface.SegmentationToConvert)
+                       {
+                         if (AddSegmentToConvert(surface) && surface.SegmentationToConvert->CreateRepresentation(closedSurfaceRepresentationName, true))
+                         {
+                           surface.PolyData = vtkPolyData::SafeDownCast(
+                             surface.SegmentationToConvert->GetSegment(surface.SegmentID)->GetRepresentation(closedSurfaceRepresentationName));
+                         }
+                         surface.SegmentationToConvert = nullptr;
+                       }
+                       if (!surface.PolyData || !triangulate)
+                       {
+                         continue;
+                       }
+                       vtkCellArray* polys = surface.PolyData->GetPolys();
+                       if (surface.PolyData->GetNumberOfStrips() > 0 || (polys && polys->GetMaxCellSize() > 3))
+                       {
+                         vtkNew<vtkTriangleFilter> triangulator;
+                         triangulator->SetInputData(surface.PolyData);
+                         triangulator->Update();
+                         surface.PolyData = triangulator->GetOutput();
+                       }
+                     }
+                   });
+}
+
+//----------------------------------------------------------------------------
+/// Transform point or direction (transformNormal=true) from segmentation to output file coordinate system
+void TransformToOutput(const double matrix[3][4], const double input[3], bool transformNormal, double output[3])
+{
+  for (int row = 0; row < 3; ++row)
+  {
+    output[row] = matrix[row][0] * input[0] + matrix[row][1] * input[1] + matrix[row][2] * input[2] + (transformNormal ? 0.0 : matrix[row][3]);
+  }
+  if (transformNormal)
+  {
+    vtkMath::Normalize(output);
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Writes triangles of multiple polydata into a binary STL file.
+/// Triangles are written as soon as they are added, so meshes do not have to be appended in memory.
+class StlStreamWriter
+{
+public:
+  bool Open(const std::string& filePath, const std::string& header)
+  {
+    this->Stream.open(filePath.c_str(), std::ios::out | std::ios::binary);
+    if (!this->Stream.is_open())
+    {
+      return false;
+    }
+    // Binary STL files must not start with "solid" (that indicates ASCII STL)
+    char headerBuffer[80] = { 0 };
+    strncpy(headerBuffer, header.compare(0, 5, "solid") == 0 ? "VTK File Data" : header.c_str(), sizeof(headerBuffer));
+    this->Stream.write(headerBuffer, sizeof(headerBuffer));
+    // Number of triangles is written when the file is closed
+    this->NumberOfTriangles = 0;
+    this->WriteUInt32(0);
+    return this->Stream.good();
+  }
+
+  /// Write triangles of the polydata. Points are transformed by pointToOutput matrix.
+  bool Write(vtkPolyData* polyData, const double pointToOutput[3][4])
+  {
+    vtkCellArray* polys = polyData->GetPolys();
+    vtkPoints* points = polyData->GetPoints();
+    if (!polys || !points)
+    {
+      return this->Stream.good();
+    }
+    vtkIdType numberOfPoints = 0;
+    const vtkIdType* pointIds = nullptr;
+    char record[50] = { 0 };
+    for (polys->InitTraversal(); polys->GetNextCell(numberOfPoints, pointIds);)
+    {
+      if (numberOfPoints != 3)
+      {
+        // triangulated input is expected
+        continue;
+      }
+      double vertices[3][3] = { { 0.0 } };
+      for (int vertexIndex = 0; vertexIndex < 3; ++vertexIndex)
+      {
+        TransformToOutput(pointToOutput, points->GetPoint(pointIds[vertexIndex]), false, vertices[vertexIndex]);
+      }
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      vtkTriangle::ComputeNormal(vertices[0], vertices[1], vertices[2], normal);
+      float values[12] = { 0.0f };
+      for (int i = 0; i < 3; ++i)
+      {
+        values[i] = static_cast<float>(normal[i]);
+        values[3 + i] = static_cast<float>(vertices[0][i]);
+        values[6 + i] = static_cast<float>(vertices[1][i]);
+        values[9 + i] = static_cast<float>(vertices[2][i]);
+      }
+      vtkByteSwap::Swap4LERange(values, 12);
+      memcpy(record, values, sizeof(values));
+      // record[48..49] is the attribute byte count, always 0
+      this->Stream.write(record, sizeof(record));
+      ++this->NumberOfTriangles;
+    }
+    return this->Stream.good();
+  }
+
+  bool Close()
+  {
+    this->Stream.seekp(80);
+    this->WriteUInt32(this->NumberOfTriangles);
+    bool success = this->Stream.good();
+    this->Stream.close();
+    return success;
+  }
+
+protected:
+  void WriteUInt32(unsigned int value)
+  {
+    vtkTypeUInt32 valueLE = static_cast<vtkTypeUInt32>(value);
+    vtkByteSwap::Swap4LE(&valueLE);
+    this->Stream.write(reinterpret_cast<const char*>(&valueLE), sizeof(valueLE));
+  }
+
+  vtksys::ofstream Stream;
+  unsigned int NumberOfTriangles{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Writes multiple polydata as separate groups into a Wavefront OBJ file, with materials in a MTL file.
+/// Each polydata is written as soon as it is added, so meshes do not have to be kept in memory.
+class ObjStreamWriter
+{
+public:
+  bool Open(const std::string& filePathWithoutExtension, const std::string& comment)
+  {
+    this->ObjStream.open((filePathWithoutExtension + ".obj").c_str(), std::ios::out);
+    this->MtlStream.open((filePathWithoutExtension + ".mtl").c_str(), std::ios::out);
+    if (!this->ObjStream.is_open() || !this->MtlStream.is_open())
+    {
+      return false;
+    }
+    this->ObjStream << "# " << comment << "\n";
+    this->ObjStream << "mtllib " << vtksys::SystemTools::GetFilenameName(filePathWithoutExtension) << ".mtl\n\n";
+    this->MtlStream << "# " << comment << "\n\n";
+    this->NumberOfWrittenPoints = 0;
+    return this->ObjStream.good() && this->MtlStream.good();
+  }
+
+  /// Write polydata as a group. Points and normals are transformed by pointToOutput and normalToOutput matrices.
+  bool Write(vtkPolyData* polyData, const double pointToOutput[3][4], const double normalToOutput[3][4], const std::string& name, const double color[3], double opacity)
+  {
+    // OBJ exporters usually set the same color for ambient, diffuse, specular
+    // so we scale it by 1/3 to avoid having too bright material.
+    const double colorScale = 1.0 / 3.0;
+    this->MtlStream << "newmtl " << name << "\n";
+    for (const char* colorName : { "Ka", "Kd", "Ks" })
+    {
+      this->MtlStream << colorName << " " << color[0] * colorScale << " " << color[1] * colorScale << " " << color[2] * colorScale << "\n";
+    }
+    this->MtlStream << "Ns 3\n";
+    this->MtlStream << "d " << opacity << "\n";
+    this->MtlStream << "illum 3\n\n";
+
+    vtkPoints* points = polyData->GetPoints();
+    vtkIdType numberOfPoints = points ? points->GetNumberOfPoints() : 0;
+    vtkDataArray* normals = polyData->GetPointData()->GetNormals();
+    double transformed[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+      TransformToOutput(pointToOutput, points->GetPoint(pointIndex), false, transformed);
+      this->ObjStream << "v " << transformed[0] << " " << transformed[1] << " " << transformed[2] << "\n";
+    }
+    if (normals)
+    {
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+      {
+        TransformToOutput(normalToOutput, normals->GetTuple3(pointIndex), true, transformed);
+        this->ObjStream << "vn " << transformed[0] << " " << transformed[1] << " " << transformed[2] << "\n";
+      }
+    }
+
+    this->ObjStream << "\ng " << name << "\n";
+    this->ObjStream << "usemtl " << name << "\n";
+    for (vtkCellArray* cells : { polyData->GetPolys(), polyData->GetStrips() })
+    {
+      if (!cells)
+      {
+        continue;
+      }
+      bool strips = (cells == polyData->GetStrips());
+      vtkIdType numberOfCellPoints = 0;
+      const vtkIdType* pointIds = nullptr;
+      for (cells->InitTraversal(); cells->GetNextCell(numberOfCellPoints, pointIds);)
+      {
+        if (!strips)
+        {
+          this->WriteFace(pointIds, numberOfCellPoints, normals != nullptr);
+          continue;
+        }
+        // Triangle strip: every other triangle has reversed vertex order
+        for (vtkIdType i = 0; i + 2 < numberOfCellPoints; ++i)
+        {
+          vtkIdType triangle[3] = { pointIds[i], pointIds[i + 1], pointIds[i + 2] };
+          if (i % 2)
+          {
+            std::swap(triangle[0], triangle[1]);
+          }
+          this->WriteFace(triangle, 3, normals != nullptr);
+        }
+      }
+    }
+    this->ObjStream << "\n";
+    this->NumberOfWrittenPoints += numberOfPoints;
+    return this->ObjStream.good() && this->MtlStream.good();
+  }
+
+  bool Close()
+  {
+    bool success = this->ObjStream.good() && this->MtlStream.good();
+    this->ObjStream.close();
+    this->MtlStream.close();
+    return success;
+  }
+
+protected:
+  void WriteFace(const vtkIdType* pointIds, vtkIdType numberOfPoints, bool normals)
+  {
+    this->ObjStream << "f";
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+      // OBJ point indices are 1-based and global in the file
+      vtkIdType index = pointIds[i] + this->NumberOfWrittenPoints + 1;
+      this->ObjStream << " " << index;
+      if (normals)
+      {
+        this->ObjStream << "//" << index;
+      }
+    }
+    this->ObjStream << "\n";
+  }
+
+  vtksys::ofstream ObjStream;
+  vtksys::ofstream MtlStream;
+  vtkIdType NumberOfWrittenPoints{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Get closed surfaces of the segments in output file coordinate system and pass them to exportSurface in the order of segmentIDs.
+/// Surfaces are computed in batches (to limit memory usage) in parallel. Linear parent transform, scaling, and RAS to LPS
+/// conversion are not applied to the surface but are returned in pointToOutput and normalToOutput matrices.
+/// Returns false if exportSurface failed.
+bool ExportClosedSurfaces(vtkMRMLSegmentationNode* segmentationNode,
+                          const std::vector<std::string>& segmentIDs,
+                          bool lps,
+                          double sizeScale,
+                          bool triangulate,
+                          const std::function<bool(const std::string& segmentID, vtkPolyData* polyData, const double pointToOutput[3][4], const double normalToOutput[3][4])>& exportSurface)
+{
+  vtkNew<vtkMatrix4x4> segmentationToOutputMatrix;
+  vtkSmartPointer<vtkGeneralTransform> segmentationToWorldTransform;
+  vtkMRMLTransformNode* parentTransformNode = segmentationNode->GetParentTransformNode();
+  if (parentTransformNode)
+  {
+    if (parentTransformNode->IsTransformToWorldLinear())
+    {
+      parentTransformNode->GetMatrixTransformToWorld(segmentationToOutputMatrix);
+    }
+    else
+    {
+      segmentationToWorldTransform = vtkSmartPointer<vtkGeneralTransform>::New();
+      parentTransformNode->GetTransformToWorld(segmentationToWorldTransform);
+    }
+  }
+  vtkNew<vtkMatrix4x4> worldToOutputMatrix;
+  worldToOutputMatrix->SetElement(0, 0, lps ? -sizeScale : sizeScale);
+  worldToOutputMatrix->SetElement(1, 1, lps ? -sizeScale : sizeScale);
+  worldToOutputMatrix->SetElement(2, 2, sizeScale);
+  vtkMatrix4x4::Multiply4x4(worldToOutputMatrix, segmentationToOutputMatrix, segmentationToOutputMatrix);
+  // Normals are transformed by the inverse transpose of the matrix
+  vtkNew<vtkMatrix4x4> normalToOutputMatrix;
+  vtkMatrix4x4::Invert(segmentationToOutputMatrix, normalToOutputMatrix);
+  normalToOutputMatrix->Transpose();
+  double pointToOutput[3][4] = { { 0.0 } };
+  double normalToOutput[3][4] = { { 0.0 } };
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      pointToOutput[row][column] = segmentationToOutputMatrix->GetElement(row, column);
+      normalToOutput[row][column] = (column < 3 ? normalToOutputMatrix->GetElement(row, column) : 0.0);
+    }
+  }
+
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  const size_t batchSize = std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads());
+  for (size_t batchStartIndex = 0; batchStartIndex < segmentIDs.size(); batchStartIndex += batchSize)
+  {
+    std::vector<ExportedSurface> surfaces(std::min(batchSize, segmentIDs.size() - batchStartIndex));
+    for (size_t surfaceIndex = 0; surfaceIndex < surfaces.size(); ++surfaceIndex)
+    {
+      surfaces[surfaceIndex].SegmentID = segmentIDs[batchStartIndex + surfaceIndex];
+    }
+    GetClosedSurfaces(segmentation, surfaces, triangulate);
+
+    for (ExportedSurface& surface : surfaces)
+    {
+      if (!surface.PolyData)
+      {
+        vtkErrorWithObjectMacro(segmentationNode,
+                                "ExportSegmentsClosedSurfaceRepresentationToFiles: Unable to convert segment " << surface.SegmentID << " to closed surface representation");
+        continue;
+      }
+      if (segmentationToWorldTransform)
+      {
+        vtkNew<vtkTransformPolyDataFilter> transformFilter;
+        transformFilter->SetInputData(surface.PolyData);
+        transformFilter->SetTransform(segmentationToWorldTransform);
+        transformFilter->Update();
+        surface.PolyData = transformFilter->GetOutput();
+      }
+      if (!exportSurface(surface.SegmentID, surface.PolyData, pointToOutput, normalToOutput))
+      {
+        return false;
+      }
+      // Release memory as soon as the surface is written
+      surface.PolyData = nullptr;
+    }
+  }
+  return true;
+}
+
+} // namespace
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSegmentationsModuleLogic);
@@ -452,51 +1013,55 @@ int vtkSlicerSegmentationsModuleLogic::DoesLabelmapContainSingleLabel(vtkMRMLLab
 //-----------------------------------------------------------------------------
 void vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(vtkIntArray* labels, vtkImageData* labelmap)
 {
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labels, labelmap, effectiveExtent);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(vtkIntArray* labels, vtkImageData* labelmap, int effectiveExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    effectiveExtent[axis * 2] = 0;
+    effectiveExtent[axis * 2 + 1] = -1;
+  }
   if (!labels)
   {
     vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::GetAllLabelValues: Invalid labels");
-    return;
+    return false;
   }
   labels->Reset();
   if (!labelmap)
   {
     vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::GetAllLabelValues: Invalid labelmap");
-    return;
+    return false;
   }
 
   int dimensions[3] = { 0 };
   labelmap->GetDimensions(dimensions);
-  if (dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[2] <= 0)
+  if (dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[2] <= 0 || !labelmap->GetPointData()->GetScalars())
   {
     // Labelmap is empty, there are no label values.
-    // Running vtkImageAccumulate would cause a crash.
-    return;
+    return true;
   }
 
-  double* scalarRange = labelmap->GetScalarRange();
-  int lowLabel = (int)(floor(scalarRange[0]));
-  int highLabel = (int)(ceil(scalarRange[1]));
-  vtkSmartPointer<vtkImageAccumulate> imageAccumulate = vtkSmartPointer<vtkImageAccumulate>::New();
-  imageAccumulate->SetInputData(labelmap);
-  imageAccumulate->IgnoreZeroOn(); // Do not create segment from background
-  imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
-  imageAccumulate->SetComponentOrigin(0, 0, 0);
-  imageAccumulate->SetComponentSpacing(1, 1, 1);
-  imageAccumulate->Update();
+  // Label values and effective extent are collected in the same pass
+  LabelmapContent content;
+  switch (labelmap->GetScalarType())
+  {
+    vtkTemplateMacro(GetLabelmapContentGeneric<VTK_TT>(labelmap, content));
+    default: vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::GetAllLabelValues: Unknown scalar type"); return false;
+  }
 
-  for (int label = lowLabel; label <= highLabel; ++label)
+  for (int label : content.LabelValues)
   {
-    if (label == 0)
-    {
-      continue;
-    }
-    double frequency = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1(label - lowLabel);
-    if (frequency == 0.0)
-    {
-      continue;
-    }
     labels->InsertNextValue(label);
   }
+  if (content.Extent[0] <= content.Extent[1])
+  {
+    std::copy(content.Extent, content.Extent + 6, effectiveExtent);
+  }
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -1447,10 +2012,18 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
     segmentationNode->CreateDefaultDisplayNodes();
   }
 
-  // Split labelmap node into per-label image data
+  // Split labelmap node into per-label image data.
+  // Label values and the extent of non-zero voxels are computed in a single pass.
+  // All segments share the same (cropped) labelmap, as labels in one labelmap cannot overlap.
 
   vtkNew<vtkIntArray> labelValues;
-  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelmapNode->GetImageData());
+  int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelmapNode->GetImageData(), labelOrientedImageDataEffectiveExtent);
+  if (labelValues->GetNumberOfValues() == 0)
+  {
+    // Nothing to import
+    return true;
+  }
 
   vtkSmartPointer<vtkOrientedImageData> labelOrientedImageData = vtkSmartPointer<vtkOrientedImageData>::New();
   labelOrientedImageData->vtkImageData::DeepCopy(labelmapNode->GetImageData());
@@ -1462,6 +2035,45 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
     vtkSmartPointer<vtkGeneralTransform> labelmapToSegmentationTransform = vtkSmartPointer<vtkGeneralTransform>::New();
     vtkSlicerSegmentationsModuleLogic::GetTransformBetweenRepresentationAndSegmentation(labelmapNode, segmentationNode, labelmapToSegmentationTransform);
     vtkOrientedImageDataResample::TransformOrientedImage(labelOrientedImageData, labelmapToSegmentationTransform);
+    // Voxel grid may have changed
+    vtkOrientedImageDataResample::CalculateEffectiveExtent(labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
+  }
+
+  // Clip to effective extent
+  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
+  padder->SetInputData(labelOrientedImageData);
+  padder->SetOutputWholeExtent(labelOrientedImageDataEffectiveExtent);
+  padder->Update();
+  labelOrientedImageData->ShallowCopy(padder->GetOutput());
+
+  int ret = vtkOrientedImageDataResample::IsImageScalarTypeValid(labelOrientedImageData);
+  switch (ret)
+  {
+    case vtkOrientedImageDataResample::TYPE_CONVERSION_TRUNCATION_NEEDED:
+      vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
+                                                   userMessages,
+                                                   "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
+                                                   "Segmentation is a floating point scalar type and will be cast to an integer type. Voxel values may be truncated");
+      break;
+    case vtkOrientedImageDataResample::TYPE_CONVERSION_CLAMPING_NEEDED:
+      vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
+                                                   userMessages,
+                                                   "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
+                                                   "Segmentation is outside the range of values that can be represented by supported integer types and will be clamped");
+      break;
+    case vtkOrientedImageDataResample::TYPE_ERROR:
+      vtkWarningToMessageCollectionWithObjectMacro(
+        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to integer type.");
+      return false;
+    case vtkOrientedImageDataResample::TYPE_OK:
+    default: break;
+  }
+  if (ret != vtkOrientedImageDataResample::TYPE_OK && //
+      !vtkOrientedImageDataResample::CastSegmentationToSmallestIntegerType(labelOrientedImageData))
+  {
+    vtkErrorToMessageCollectionWithObjectMacro(
+      segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to a valid integer type");
+    return false;
   }
 
   MRMLNodeModifyBlocker blocker(segmentationNode);
@@ -1500,45 +2112,6 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkMRML
       segment->SetName(labelName);
     }
 
-    // Clip to effective extent
-    int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-    vtkOrientedImageDataResample::CalculateEffectiveExtent(labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
-    vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
-    padder->SetInputData(labelOrientedImageData);
-    padder->SetOutputWholeExtent(labelOrientedImageDataEffectiveExtent);
-    padder->Update();
-    labelOrientedImageData->ShallowCopy(padder->GetOutput());
-
-    int ret = vtkOrientedImageDataResample::IsImageScalarTypeValid(labelOrientedImageData);
-    switch (ret)
-    {
-      case vtkOrientedImageDataResample::TYPE_CONVERSION_TRUNCATION_NEEDED:
-        vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
-                                                     userMessages,
-                                                     "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
-                                                     "Segmentation is a floating point scalar type and will be cast to an integer type. Voxel values may be truncated");
-        break;
-      case vtkOrientedImageDataResample::TYPE_CONVERSION_CLAMPING_NEEDED:
-        vtkWarningToMessageCollectionWithObjectMacro(segmentationNode,
-                                                     userMessages,
-                                                     "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode",
-                                                     "Segmentation is outside the range of values that can be represented by supported integer types and will be clamped");
-        break;
-      case vtkOrientedImageDataResample::TYPE_ERROR:
-        vtkWarningToMessageCollectionWithObjectMacro(
-          segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to integer type.");
-        return false;
-      case vtkOrientedImageDataResample::TYPE_OK:
-      default: break;
-    }
-    if (ret != vtkOrientedImageDataResample::TYPE_OK && //
-        !vtkOrientedImageDataResample::CastSegmentationToSmallestIntegerType(labelOrientedImageData))
-    {
-      vtkErrorToMessageCollectionWithObjectMacro(
-        segmentationNode, userMessages, "vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode", "Failed to cast image to a valid integer type");
-      return false;
-    }
-
     // Add oriented image data as binary labelmap representation
     segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelOrientedImageData);
 
@@ -1614,13 +2187,12 @@ bool vtkSlicerSegmentationsModuleLogic::ImportLabelmapToSegmentationNode(vtkOrie
   // Split labelmap node into per-label image data
 
   vtkNew<vtkIntArray> labelValues;
-  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelOrientedImageData);
+  int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkSlicerSegmentationsModuleLogic::GetAllLabelValues(labelValues.GetPointer(), labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
 
   MRMLNodeModifyBlocker blocker(segmentationNode);
 
   // Clip to effective extent
-  int labelOrientedImageDataEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
-  vtkOrientedImageDataResample::CalculateEffectiveExtent(labelOrientedImageData, labelOrientedImageDataEffectiveExtent);
 
   vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
   padder->SetInputData(labelOrientedImageData);
@@ -2296,11 +2868,6 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsClosedSurfaceRepresentatio
   // See vtkMRMLModelStorageNode::WriteDataInternal.
   const std::string coordinateSystemValue = (lps ? "LPS" : "RAS");
   const std::string coordinateSytemSpecification = "SPACE=" + coordinateSystemValue;
-
-  vtkNew<vtkTriangleFilter> triangulator;
-  vtkNew<vtkSTLWriter> writer;
-  writer->SetFileType(VTK_BINARY);
-  writer->SetInputConnection(triangulator->GetOutputPort());
   std::string header = std::string("3D Slicer output. ") + coordinateSytemSpecification;
   if (sizeScale != 1.0)
   {
@@ -2308,45 +2875,16 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsClosedSurfaceRepresentatio
     strs << sizeScale;
     header += ";SCALE=" + strs.str();
   }
-  writer->SetHeader(header.c_str());
 
+  // Triangles are written to the file directly, as soon as a surface is available,
+  // therefore segment surfaces do not have to be appended or kept in memory.
+  std::string safeFileName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetName());
+  StlStreamWriter writer;
+  std::string filePath;
   if (merge)
   {
-    vtkNew<vtkAppendPolyData> appendPolyData;
-
-    for (std::vector<std::string>::const_iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
-    {
-      vtkNew<vtkPolyData> segmentPolyData;
-      bool polyDataAvailable = vtkSlicerSegmentationsModuleLogic::GetSegmentClosedSurfaceRepresentation(segmentationNode, *segmentIdIt, segmentPolyData.GetPointer());
-      if (!polyDataAvailable || segmentPolyData.GetPointer() == nullptr)
-      {
-        vtkErrorWithObjectMacro(segmentationNode,
-                                "ExportSegmentsClosedSurfaceRepresentationToFiles: Unable to convert segment " << (*segmentIdIt) << " to closed surface representation");
-        continue;
-      }
-      appendPolyData->AddInputData(segmentPolyData.GetPointer());
-    }
-    vtkNew<vtkTransform> transformRasToLps;
-    if (sizeScale != 1.0)
-    {
-      transformRasToLps->Scale(sizeScale, sizeScale, sizeScale);
-    }
-    if (lps)
-    {
-      transformRasToLps->Scale(-1, -1, 1);
-    }
-    vtkNew<vtkTransformPolyDataFilter> transformPolyDataToOutput;
-    transformPolyDataToOutput->SetTransform(transformRasToLps.GetPointer());
-    transformPolyDataToOutput->SetInputConnection(appendPolyData->GetOutputPort());
-    std::string safeFileName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetName());
-    std::string filePath = destinationFolder + "/" + safeFileName + ".stl";
-    triangulator->SetInputConnection(transformPolyDataToOutput->GetOutputPort());
-    writer->SetFileName(filePath.c_str());
-    try
-    {
-      writer->Write();
-    }
-    catch (...)
+    filePath = destinationFolder + "/" + safeFileName + ".stl";
+    if (!writer.Open(filePath, header))
     {
       vtkErrorWithObjectMacro(segmentationNode,
                               "ExportSegmentsClosedSurfaceRepresentationToFiles:"
@@ -2355,48 +2893,40 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsClosedSurfaceRepresentatio
       return false;
     }
   }
-  else
+
+  bool success = ExportClosedSurfaces(segmentationNode,
+                                      segmentIDs,
+                                      lps,
+                                      sizeScale,
+                                      true,
+                                      [&](const std::string& segmentID, vtkPolyData* polyData, const double pointToOutput[3][4], const double vtkNotUsed(normalToOutput)[3][4])
+                                      {
+                                        if (!merge)
+                                        {
+                                          std::string segmentName = segmentationNode->GetSegmentation()->GetSegment(segmentID)->GetName();
+                                          filePath = destinationFolder + "/" + safeFileName + "_" + segmentName + ".stl";
+                                          if (!writer.Open(filePath, header))
+                                          {
+                                            return false;
+                                          }
+                                        }
+                                        if (!writer.Write(polyData, pointToOutput))
+                                        {
+                                          return false;
+                                        }
+                                        return merge || writer.Close();
+                                      });
+  if (success && merge)
+  {
+    success = writer.Close();
+  }
+  if (!success)
   {
-    for (std::vector<std::string>::const_iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
-    {
-      vtkNew<vtkPolyData> segmentPolyData;
-      bool polyDataAvailable = vtkSlicerSegmentationsModuleLogic::GetSegmentClosedSurfaceRepresentation(segmentationNode, *segmentIdIt, segmentPolyData.GetPointer());
-      if (!polyDataAvailable || segmentPolyData.GetPointer() == nullptr)
-      {
-        vtkErrorWithObjectMacro(segmentationNode,
-                                "ExportSegmentsClosedSurfaceRepresentationToFiles: Unable to convert segment " << (*segmentIdIt) << " to closed surface representation");
-        continue;
-      }
-      vtkNew<vtkTransform> transformRasToLps;
-      if (sizeScale != 1.0)
-      {
-        transformRasToLps->Scale(sizeScale, sizeScale, sizeScale);
-      }
-      if (lps)
-      {
-        transformRasToLps->Scale(-1, -1, 1);
-      }
-      vtkNew<vtkTransformPolyDataFilter> transformPolyDataToOutput;
-      transformPolyDataToOutput->SetTransform(transformRasToLps.GetPointer());
-      transformPolyDataToOutput->SetInputData(segmentPolyData.GetPointer());
-      std::string segmentName = segmentationNode->GetSegmentation()->GetSegment(*segmentIdIt)->GetName();
-      std::string safeFileName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetName());
-      std::string filePath = destinationFolder + "/" + safeFileName + "_" + segmentName + ".stl";
-      triangulator->SetInputConnection(transformPolyDataToOutput->GetOutputPort());
-      writer->SetFileName(filePath.c_str());
-      try
-      {
-        writer->Write();
-      }
-      catch (...)
-      {
-        vtkErrorWithObjectMacro(segmentationNode,
-                                "ExportSegmentsClosedSurfaceRepresentationToFiles:"
-                                " Unable to write segmentation to "
-                                  << filePath);
-        return false;
-      }
-    }
+    vtkErrorWithObjectMacro(segmentationNode,
+                            "ExportSegmentsClosedSurfaceRepresentationToFiles:"
+                            " Unable to write segmentation to "
+                              << filePath);
+    return false;
   }
   return true;
 }
@@ -2416,57 +2946,6 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsClosedSurfaceRepresentatio
 
   vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode());
 
-  vtkNew<vtkRenderer> renderer;
-  vtkNew<vtkRenderWindow> renderWindow;
-  renderWindow->AddRenderer(renderer.GetPointer());
-
-  for (std::vector<std::string>::const_iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
-  {
-    vtkNew<vtkPolyData> segmentPolyData;
-    bool polyDataAvailable = vtkSlicerSegmentationsModuleLogic::GetSegmentClosedSurfaceRepresentation(segmentationNode, *segmentIdIt, segmentPolyData.GetPointer());
-    if (!polyDataAvailable || segmentPolyData.GetPointer() == nullptr)
-    {
-      vtkErrorWithObjectMacro(segmentationNode,
-                              "ExportSegmentsClosedSurfaceRepresentationToObjFile: Unable to convert segment " << (*segmentIdIt) << " to closed surface representation");
-      continue;
-    }
-    vtkNew<vtkTransform> transformRasToLps;
-    if (sizeScale != 1.0)
-    {
-      transformRasToLps->Scale(sizeScale, sizeScale, sizeScale);
-    }
-    if (lps)
-    {
-      transformRasToLps->Scale(-1, -1, 1);
-    }
-    vtkNew<vtkTransformPolyDataFilter> transformPolyDataToOutput;
-    transformPolyDataToOutput->SetTransform(transformRasToLps.GetPointer());
-    transformPolyDataToOutput->SetInputData(segmentPolyData.GetPointer());
-    vtkNew<vtkPolyDataMapper> mapper;
-    mapper->SetInputConnection(transformPolyDataToOutput->GetOutputPort());
-    vtkNew<vtkActor> actor;
-    actor->SetMapper(mapper.GetPointer());
-
-    if (displayNode)
-    {
-      double color[3] = { 0.5, 0.5, 0.5 };
-      displayNode->GetSegmentColor(*segmentIdIt, color);
-      // OBJ exporter sets the same color for ambient, diffuse, specular
-      // so we scale it by 1/3 to avoid having too bright material.
-      double colorScale = 1.0 / 3.0;
-      actor->GetProperty()->SetColor(color[0] * colorScale, color[1] * colorScale, color[2] * colorScale);
-      actor->GetProperty()->SetSpecularPower(3.0);
-      actor->GetProperty()->SetOpacity(displayNode->GetSegmentOpacity3D(*segmentIdIt));
-    }
-    renderer->AddActor(actor.GetPointer());
-  }
-
-  vtkNew<vtkOBJExporter> exporter;
-  exporter->SetRenderWindow(renderWindow.GetPointer());
-  std::string safeFileName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetName());
-  std::string fullNameWithoutExtension = destinationFolder + "/" + safeFileName;
-  exporter->SetFilePrefix(fullNameWithoutExtension.c_str());
-
   // We explicitly write the coordinate system into the file header.
   // See vtkMRMLModelStorageNode::WriteDataInternal.
   const std::string coordinateSystemValue = (lps ? "LPS" : "RAS");
@@ -2478,13 +2957,33 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsClosedSurfaceRepresentatio
     strs << sizeScale;
     header += ";SCALE=" + strs.str();
   }
-  exporter->SetOBJFileComment(header.c_str());
 
-  try
-  {
-    exporter->Write();
-  }
-  catch (...)
+  std::string safeFileName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetName());
+  std::string fullNameWithoutExtension = destinationFolder + "/" + safeFileName;
+  ObjStreamWriter writer;
+  bool success = writer.Open(fullNameWithoutExtension, header);
+  if (success)
+  {
+    success = ExportClosedSurfaces(segmentationNode,
+                                   segmentIDs,
+                                   lps,
+                                   sizeScale,
+                                   false,
+                                   [&](const std::string& segmentID, vtkPolyData* polyData, const double pointToOutput[3][4], const double normalToOutput[3][4])
+                                   {
+                                     double color[3] = { 0.5, 0.5, 0.5 };
+                                     double opacity = 1.0;
+                                     if (displayNode)
+                                     {
+                                       displayNode->GetSegmentColor(segmentID, color);
+                                       opacity = displayNode->GetSegmentOpacity3D(segmentID);
+                                     }
+                                     std::string materialName = vtkSlicerSegmentationsModuleLogic::GetSafeFileName(segmentationNode->GetSegmentation()->GetSegment(segmentID)->GetName());
+                                     return writer.Write(polyData, pointToOutput, normalToOutput, materialName, color, opacity);
+                                   });
+    success = writer.Close() && success;
+  }
+  if (!success)
   {
     vtkErrorWithObjectMacro(segmentationNode,
                             "ExportSegmentsClosedSurfaceRepresentationToObjFile:"
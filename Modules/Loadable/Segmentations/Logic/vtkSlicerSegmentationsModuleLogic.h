@@ -113,6 +113,14 @@ public:
   /// Utility function that returns all non-empty label values in a labelmap
   static void GetAllLabelValues(vtkIntArray* labels, vtkImageData* labelmap);
 
+  /// Utility function that returns all non-empty label values in a labelmap (sorted in ascending order)
+  /// and the extent containing all non-zero voxels, computed with a single multi-threaded pass over the image.
+  /// Floating-point voxel values are truncated toward zero, the same way as the labelmap is cast to an integer
+  /// type on import, therefore voxels with values between -1 and 1 are background.
+  /// \param effectiveExtent Extent of non-zero voxels. Invalid extent (min > max) if the labelmap contains no labels.
+  /// \return False if the labelmap is invalid or has an unsupported scalar type.
+  static bool GetAllLabelValues(vtkIntArray* labels, vtkImageData* labelmap, int effectiveExtent[6]);
+
   /// Create segment from labelmap volume MRML node. The contents are set as binary labelmap representation in the segment.
   /// Returns nullptr if labelmap contains more than one label. In that case \sa ImportLabelmapToSegmentationNode needs to be used.
   /// NOTE: Need to take ownership of the created object! For example using vtkSmartPointer<vtkSegment>::Take
@@ -296,6 +304,8 @@ public:
   static bool ImportModelsToSegmentationNode(vtkIdType folderItemId, vtkMRMLSegmentationNode* segmentationNode, std::string insertBeforeSegmentId = "");
 
   /// Export closed surface representation of multiple segments to files. Typically used for writing 3D printable model files.
+  /// Closed surfaces that are not available yet are computed in parallel and meshes are written to the files
+  /// directly, without merging them in memory.
   /// \param segmentationNode Segmentation node from which the the segments are exported
   /// \param destinationFolder Folder name where segments will be exported to
   /// \param fileFormat Output file format (STL or OBJ).
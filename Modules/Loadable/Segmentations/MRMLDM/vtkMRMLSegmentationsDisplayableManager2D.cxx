@@ -22,11 +22,13 @@
 #include "vtkMRMLSegmentationsDisplayableManager2D.h"
 
 // MRML includes
+#include <vtkIndexedPlaneCutter.h>
 #include <vtkMRMLFolderDisplayNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSliceNode.h>
 #include <vtkMRMLSegmentationDisplayNode.h>
 #include <vtkMRMLSegmentationNode.h>
+#include <vtkMRMLTracer.h>
 #include <vtkMRMLTransformNode.h>
 
 // MRML logic includes
@@ -43,7 +45,6 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCellArray.h>
 #include <vtkGeometryFilter.h>
-#include <vtkPlaneCutter.h>
 #include <vtkCleanPolyData.h>
 #include <vtkContourTriangulator.h>
 #include <vtkDataSetAttributes.h>
@@ -77,6 +78,7 @@
 #include <set>
 #include <map>
 #include <sstream>
+#include <vector>
 
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSegmentationsDisplayableManager2D);
@@ -143,7 +145,7 @@ public:
       // Create poly data pipeline
       this->PolyDataOutlineActor = vtkSmartPointer<vtkActor2D>::New();
       this->PolyDataFillActor = vtkSmartPointer<vtkActor2D>::New();
-      this->Cutter = vtkSmartPointer<vtkPlaneCutter>::New();
+      this->Cutter = vtkSmartPointer<vtkIndexedPlaneCutter>::New();
       this->ModelWarper = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
       this->Plane = vtkSmartPointer<vtkPlane>::New();
       this->Triangulator = vtkSmartPointer<vtkContourTriangulator>::New();
@@ -151,7 +153,6 @@ public:
       // Set up poly data outline pipeline
       this->Cutter->SetInputConnection(this->ModelWarper->GetOutputPort());
       this->Cutter->SetPlane(this->Plane);
-      this->Cutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
       vtkSmartPointer<vtkTransformPolyDataFilter> polyDataOutlineTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
       vtkNew<vtkGeometryFilter> geometryFilter;
       geometryFilter->SetInputConnection(this->Cutter->GetOutputPort());
@@ -182,6 +183,9 @@ public:
       this->ImageFillActor = vtkSmartPointer<vtkActor2D>::New();
       this->Reslice = vtkSmartPointer<vtkImageReslice>::New();
       this->SliceToImageTransform = vtkSmartPointer<vtkGeneralTransform>::New();
+      this->LinearSliceToImageTransform = vtkSmartPointer<vtkTransform>::New();
+      this->IdentityImageData = vtkSmartPointer<vtkImageData>::New();
+      this->IdentityImageDataUpdateTime = 0;
       this->LabelOutline = vtkSmartPointer<vtkImageLabelOutline>::New();
       this->LookupTableOutline = vtkSmartPointer<vtkLookupTable>::New();
       this->LookupTableFill = vtkSmartPointer<vtkLookupTable>::New();
@@ -236,19 +240,29 @@ public:
     vtkSmartPointer<vtkActor2D> PolyDataFillActor;
     vtkSmartPointer<vtkTransformPolyDataFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
-    vtkSmartPointer<vtkPlaneCutter> Cutter;
+    vtkSmartPointer<vtkIndexedPlaneCutter> Cutter;
     vtkSmartPointer<vtkContourTriangulator> Triangulator;
 
     vtkSmartPointer<vtkActor2D> ImageOutlineActor;
     vtkSmartPointer<vtkActor2D> ImageFillActor;
     vtkSmartPointer<vtkImageReslice> Reslice;
     vtkSmartPointer<vtkGeneralTransform> SliceToImageTransform;
+    vtkSmartPointer<vtkTransform> LinearSliceToImageTransform;
+    /// Shallow copy of the displayed labelmap with identity geometry, input of Reslice.
+    /// Only updated when the labelmap changes, so that display property changes do not trigger reslicing.
+    vtkSmartPointer<vtkImageData> IdentityImageData;
+    vtkMTimeType IdentityImageDataUpdateTime;
     vtkSmartPointer<vtkImageLabelOutline> LabelOutline;
     vtkSmartPointer<vtkLookupTable> LookupTableOutline;
     vtkSmartPointer<vtkLookupTable> LookupTableFill;
     vtkSmartPointer<vtkImageThreshold> ImageThreshold;
 
     vtkMTimeType SliceIntersectionUpdatedTime;
+
+    /// Label value, color (RGB), outline opacity, and fill opacity of each segment of the layer,
+    /// as they were last written into the binary labelmap lookup tables.
+    /// Used for skipping lookup table rebuild if none of the segment display properties changed.
+    std::vector<double> LabelColorTable;
   };
 
   typedef std::map<vtkSmartPointer<vtkDataObject>, Pipeline*> PipelineMapType; // first: representation object; second: display pipeline
@@ -291,6 +305,7 @@ public:
   bool UseDisplayableNode(vtkMRMLSegmentationNode* node);
   void ClearDisplayableNodes();
   bool IsSegmentVisibleInCurrentSlice(vtkMRMLSegmentationDisplayNode* displayNode, Pipeline* pipeline, const std::string& segmentID);
+  bool AreBoundsVisibleInCurrentSlice(vtkMRMLSegmentationDisplayNode* displayNode, Pipeline* pipeline, double segmentBounds_Segment[6]);
 
   struct CustomSegmentRendererType
   {
@@ -627,16 +642,24 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateSegmentPipelin
   }
 
   bool requestTransformUpdate = false;
-  // Make sure each segment has a pipeline
+  // Make sure each segment has a pipeline.
+  // Segments that share a labelmap layer share the same representation object, therefore the same pipeline.
+  std::string displayRepresentation = displayNode->GetDisplayRepresentationName2D();
+  std::set<vtkDataObject*> displayObjects;
   std::vector<std::string> segmentIDs;
   segmentation->GetSegmentIDs(segmentIDs);
   for (std::vector<std::string>::const_iterator segmentIdIt = segmentIDs.begin(); segmentIdIt != segmentIDs.end(); ++segmentIdIt)
   {
     vtkSegment* segment = segmentation->GetSegment(*segmentIdIt);
-    vtkDataObject* representationObject = segment->GetRepresentation(displayNode->GetDisplayRepresentationName2D());
+    vtkDataObject* representationObject = segment->GetRepresentation(displayRepresentation);
+    if (!representationObject)
+    {
+      continue;
+    }
+    displayObjects.insert(representationObject);
 
     // If segment does not have a pipeline, create one
-    if (representationObject && pipelines.find(representationObject) == pipelines.end())
+    if (pipelines.find(representationObject) == pipelines.end())
     {
       pipelines[representationObject] = this->CreateSegmentPipeline();
       requestTransformUpdate = true;
@@ -649,18 +672,7 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateSegmentPipelin
   {
     Pipeline* pipeline = pipelineIt->second;
     vtkDataObject* dataObject = pipelineIt->first;
-    bool displayObjectInSegment = false;
-    for (int i = 0; i < segmentation->GetNumberOfSegments(); ++i)
-    {
-      vtkSegment* segment = segmentation->GetNthSegment(i);
-      std::string displayRepresentation = displayNode->GetDisplayRepresentationName2D();
-      vtkDataObject* displayObject = segment->GetRepresentation(displayRepresentation);
-      if (dataObject && displayObject == dataObject)
-      {
-        displayObjectInSegment = true;
-        break;
-      }
-    }
+    bool displayObjectInSegment = (dataObject && displayObjects.find(dataObject) != displayObjects.end());
 
     if (!displayObjectInSegment)
     {
@@ -748,18 +760,44 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
     return;
   }
   // Make sure the requested representation exists
-  if (!segmentation->CreateRepresentation(shownRepresenatationName))
   {
-    return;
+    vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", shownRepresenatationName);
+    if (!segmentation->CreateRepresentation(shownRepresenatationName))
+    {
+      return;
+    }
   }
 
-  // For all pipelines (pipeline per segment)
+  // Get the segments of each representation object in one pass (instead of searching all segments for each pipeline)
+  std::map<vtkDataObject*, std::vector<std::string>> segmentIdsForDataObject;
+  std::vector<std::string> segmentIDs;
+  segmentation->GetSegmentIDs(segmentIDs);
+  for (const std::string& segmentId : segmentIDs)
+  {
+    vtkDataObject* representationObject = segmentation->GetSegment(segmentId)->GetRepresentation(shownRepresenatationName);
+    if (representationObject)
+    {
+      segmentIdsForDataObject[representationObject].push_back(segmentId);
+    }
+  }
+  bool labelmapShown = (shownRepresenatationName == vtkSegmentationConverter::GetBinaryLabelmapRepresentationName() //
+                        || shownRepresenatationName == vtkSegmentationConverter::GetFractionalLabelmapRepresentationName());
+
+  // For all pipelines (pipeline per representation object, i.e., per labelmap layer or per segment surface)
   for (PipelineMapType::iterator pipelineIt = pipelines.begin(); pipelineIt != pipelines.end(); ++pipelineIt)
   {
     Pipeline* pipeline = pipelineIt->second;
 
     vtkDataObject* dataObject = pipelineIt->first;
-    std::vector<std::string> sharedSegmentIds = segmentation->GetSegmentIDsForDataObject(dataObject, displayNode->GetDisplayRepresentationName2D());
+    const std::vector<std::string>& sharedSegmentIds = segmentIdsForDataObject[dataObject];
+    if (sharedSegmentIds.empty())
+    {
+      pipeline->PolyDataOutlineActor->SetVisibility(false);
+      pipeline->PolyDataFillActor->SetVisibility(false);
+      pipeline->ImageOutlineActor->SetVisibility(false);
+      pipeline->ImageFillActor->SetVisibility(false);
+      continue;
+    }
 
     // Get representation to display
     vtkPolyData* polyData = vtkPolyData::SafeDownCast(dataObject);
@@ -775,9 +813,24 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
     }
 
     bool pipelineVisiblity = false;
-    for (std::string segmentId : sharedSegmentIds)
+    if (imageData && labelmapShown)
     {
-      pipelineVisiblity |= this->IsSegmentVisibleInCurrentSlice(displayNode, pipeline, segmentId);
+      // All segments in a labelmap layer have the bounds of the shared image,
+      // therefore visibility has to be checked only once for the whole layer.
+      double layerBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+      imageData->GetBounds(layerBounds);
+      pipelineVisiblity = this->AreBoundsVisibleInCurrentSlice(displayNode, pipeline, layerBounds);
+    }
+    else
+    {
+      for (const std::string& segmentId : sharedSegmentIds)
+      {
+        if (this->IsSegmentVisibleInCurrentSlice(displayNode, pipeline, segmentId))
+        {
+          pipelineVisiblity = true;
+          break;
+        }
+      }
     }
 
     if (!pipelineVisiblity)
@@ -874,27 +927,64 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       pipeline->PolyDataOutlineActor->SetVisibility(false);
       pipeline->PolyDataFillActor->SetVisibility(false);
 
+      // Collect label value, color, and opacities of all segments in the layer in a single pass.
+      // All segments of the layer are rendered from the same resliced image using these values as lookup table entries.
+      const int labelColorTableComponents = 6; // label value, R, G, B, outline opacity, fill opacity
+      std::vector<double> labelColorTable;
+      labelColorTable.reserve(sharedSegmentIds.size() * labelColorTableComponents);
       bool outlineVisible = false;
       bool fillVisible = false;
-      for (std::string segmentId : sharedSegmentIds)
+      int minLabelmapValue = 0;
+      int maxLabelmapValue = 0;
+      for (const std::string& segmentId : sharedSegmentIds)
       {
+        vtkSegment* segment = segmentation->GetSegment(segmentId);
+        int labelmapValue = segment->GetLabelValue();
+        minLabelmapValue = std::min(minLabelmapValue, labelmapValue);
+        maxLabelmapValue = std::max(maxLabelmapValue, labelmapValue);
+
+        // Get visibility
         vtkMRMLSegmentationDisplayNode::SegmentDisplayProperties properties;
         displayNode->GetSegmentDisplayProperties(segmentId, properties);
 
         bool segmentCustomDisplay = this->External->HasCustomSegmentRenderer(displayNode->GetID(), segmentId);
 
-        double outlineOpacity = properties.Opacity2DOutline * displayNode->GetOpacity2DOutline() * displayNode->GetOpacity();
-        outlineVisible |= (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
-                          && properties.Visible2DOutline && displayNode->GetVisibility2DOutline() && (outlineOpacity > 0.0);
+        double outlineOpacity = hierarchyOpacity * properties.Opacity2DOutline * displayNode->GetOpacity2DOutline() * genericDisplayNode->GetOpacity();
+        bool segmentOutlineVisible = (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
+                                     && properties.Visible2DOutline && displayNode->GetVisibility2DOutline() && (outlineOpacity > 0.0);
+        if (!segmentOutlineVisible)
+        {
+          outlineOpacity = 0.0;
+        }
+
+        double fillOpacity = hierarchyOpacity * properties.Opacity2DFill * displayNode->GetOpacity2DFill() * genericDisplayNode->GetOpacity();
+        bool segmentFillVisible = (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
+                                  && properties.Visible2DFill && displayNode->GetVisibility2DFill() && (fillOpacity > 0.0);
+        if (!segmentFillVisible)
+        {
+          fillOpacity = 0.0;
+        }
 
-        double fillOpacity = properties.Opacity2DFill * displayNode->GetOpacity2DFill() * displayNode->GetOpacity();
-        fillVisible |= (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
-                       && properties.Visible2DFill && displayNode->GetVisibility2DFill() && (fillOpacity > 0.0);
+        outlineVisible |= segmentOutlineVisible;
+        fillVisible |= segmentFillVisible;
 
-        if (outlineVisible && fillVisible)
+        // Get displayed color (if no override is defined then use the color from the segment)
+        double color[3] = { vtkSegment::SEGMENT_COLOR_INVALID[0], vtkSegment::SEGMENT_COLOR_INVALID[1], vtkSegment::SEGMENT_COLOR_INVALID[2] };
+        if (overrideHierarchyDisplayNode)
         {
-          break;
+          overrideHierarchyDisplayNode->GetColor(color);
+        }
+        else
+        {
+          displayNode->GetSegmentColor(segmentId, color);
         }
+
+        labelColorTable.push_back(labelmapValue);
+        labelColorTable.push_back(color[0]);
+        labelColorTable.push_back(color[1]);
+        labelColorTable.push_back(color[2]);
+        labelColorTable.push_back(outlineOpacity);
+        labelColorTable.push_back(fillOpacity);
       }
 
       // Update pipeline actors
@@ -929,82 +1019,18 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
         maximumValue = scalarRange->GetValue(1);
       }
 
-      // Set segment color
-      int minLabelmapValue = 0;
-      int maxLabelmapValue = 0;
-
-      for (std::string segmentId : sharedSegmentIds)
-      {
-        vtkSegment* segment = segmentation->GetSegment(segmentId);
-        int labelmapValue = segment->GetLabelValue();
-        minLabelmapValue = std::min(minLabelmapValue, labelmapValue);
-        maxLabelmapValue = std::max(maxLabelmapValue, labelmapValue);
-      }
-
-      if (displayNode->GetDisplayRepresentationName2D() == vtkSegmentationConverter::GetFractionalLabelmapRepresentationName())
+      if (shownRepresenatationName == vtkSegmentationConverter::GetFractionalLabelmapRepresentationName())
       {
+        // Fractional labelmaps contain a single segment, the lookup table is a color ramp
+        pipeline->LabelColorTable.clear();
         pipeline->LookupTableFill->SetNumberOfTableValues(maximumValue - minimumValue + 1);
         pipeline->LookupTableFill->SetTableRange(minimumValue, maximumValue);
-      }
-      else
-      {
-        int numberOfValues = maxLabelmapValue - minLabelmapValue + 1;
-        pipeline->LookupTableOutline->SetNumberOfTableValues(numberOfValues);
-        pipeline->LookupTableOutline->SetRange(minLabelmapValue, maxLabelmapValue);
-        pipeline->LookupTableOutline->IndexedLookupOff();
-        pipeline->LookupTableOutline->Build();
-
-        pipeline->LookupTableFill->SetNumberOfTableValues(numberOfValues);
-        pipeline->LookupTableFill->SetRange(minLabelmapValue, maxLabelmapValue);
-        pipeline->LookupTableFill->IndexedLookupOff();
-        pipeline->LookupTableFill->Build();
-
-        int index = pipeline->LookupTableOutline->GetIndex(0.0);
-        pipeline->LookupTableOutline->SetTableValue(index, 0, 0, 0, 0);
-        index = pipeline->LookupTableFill->GetIndex(0.0);
-        pipeline->LookupTableFill->SetTableValue(index, 0, 0, 0, 0);
-      }
-
-      for (std::string segmentId : sharedSegmentIds)
-      {
-        vtkSegment* segment = segmentation->GetSegment(segmentId);
-        int labelmapValue = segment->GetLabelValue();
-
-        // Get visibility
-        vtkMRMLSegmentationDisplayNode::SegmentDisplayProperties properties;
-        displayNode->GetSegmentDisplayProperties(segmentId, properties);
-
-        bool segmentCustomDisplay = this->External->HasCustomSegmentRenderer(displayNode->GetID(), segmentId);
-
-        double outlineOpacity = hierarchyOpacity * properties.Opacity2DOutline * displayNode->GetOpacity2DOutline() * genericDisplayNode->GetOpacity();
-        bool segmentOutlineVisible = (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
-                                     && properties.Visible2DOutline && displayNode->GetVisibility2DOutline() && (outlineOpacity > 0.0);
-        if (!segmentOutlineVisible)
-        {
-          outlineOpacity = 0.0;
-        }
-
-        double fillOpacity = hierarchyOpacity * properties.Opacity2DFill * displayNode->GetOpacity2DFill() * genericDisplayNode->GetOpacity();
-        bool segmentFillVisible = (!segmentCustomDisplay) && displayNodeVisible && properties.Visible //
-                                  && properties.Visible2DFill && displayNode->GetVisibility2DFill() && (fillOpacity > 0.0);
-        if (!segmentFillVisible)
+        for (size_t entryIndex = 0; entryIndex < labelColorTable.size(); entryIndex += labelColorTableComponents)
         {
-          fillOpacity = 0.0;
-        }
+          const double* color = &labelColorTable[entryIndex + 1];
+          double outlineOpacity = labelColorTable[entryIndex + 4];
+          double fillOpacity = labelColorTable[entryIndex + 5];
 
-        // Get displayed color (if no override is defined then use the color from the segment)
-        double color[4] = { vtkSegment::SEGMENT_COLOR_INVALID[0], vtkSegment::SEGMENT_COLOR_INVALID[1], vtkSegment::SEGMENT_COLOR_INVALID[2], 1.0 };
-        if (overrideHierarchyDisplayNode)
-        {
-          overrideHierarchyDisplayNode->GetColor(color);
-        }
-        else
-        {
-          displayNode->GetSegmentColor(segmentId, color);
-        }
-
-        if (displayNode->GetDisplayRepresentationName2D() == vtkSegmentationConverter::GetFractionalLabelmapRepresentationName())
-        {
           pipeline->LookupTableFill->SetRampToLinear();
           if (!this->SmoothFractionalLabelMapBorder)
           {
@@ -1028,13 +1054,39 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
           pipeline->LookupTableOutline->SetNumberOfTableValues(2);
           pipeline->LookupTableOutline->SetTableRange(0, 1);
         }
-        else
+      }
+      else if (labelColorTable != pipeline->LabelColorTable)
+      {
+        // Binary labelmap: label value to RGBA lookup tables for all segments of the layer.
+        // Only rebuilt if any of the segment display properties changed, so that moving the slice
+        // does not rebuild the tables.
+        int numberOfValues = maxLabelmapValue - minLabelmapValue + 1;
+        pipeline->LookupTableOutline->SetNumberOfTableValues(numberOfValues);
+        pipeline->LookupTableOutline->SetRange(minLabelmapValue, maxLabelmapValue);
+        pipeline->LookupTableOutline->IndexedLookupOff();
+        pipeline->LookupTableOutline->Build();
+
+        pipeline->LookupTableFill->SetNumberOfTableValues(numberOfValues);
+        pipeline->LookupTableFill->SetRange(minLabelmapValue, maxLabelmapValue);
+        pipeline->LookupTableFill->IndexedLookupOff();
+        pipeline->LookupTableFill->Build();
+
+        int index = pipeline->LookupTableOutline->GetIndex(0.0);
+        pipeline->LookupTableOutline->SetTableValue(index, 0, 0, 0, 0);
+        index = pipeline->LookupTableFill->GetIndex(0.0);
+        pipeline->LookupTableFill->SetTableValue(index, 0, 0, 0, 0);
+
+        for (size_t entryIndex = 0; entryIndex < labelColorTable.size(); entryIndex += labelColorTableComponents)
         {
-          int index = pipeline->LookupTableFill->GetIndex(labelmapValue);
-          pipeline->LookupTableOutline->SetTableValue(index, color[0], color[1], color[2], outlineOpacity);
+          double labelmapValue = labelColorTable[entryIndex];
+          const double* color = &labelColorTable[entryIndex + 1];
+          double outlineOpacity = labelColorTable[entryIndex + 4];
+          double fillOpacity = labelColorTable[entryIndex + 5];
           index = pipeline->LookupTableFill->GetIndex(labelmapValue);
+          pipeline->LookupTableOutline->SetTableValue(index, color[0], color[1], color[2], outlineOpacity);
           pipeline->LookupTableFill->SetTableValue(index, color[0], color[1], color[2], fillOpacity);
         }
+        pipeline->LabelColorTable.swap(labelColorTable);
       }
       pipeline->Reslice->SetBackgroundLevel(minimumValue);
 
@@ -1046,21 +1098,34 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       imageData->GetWorldToImageMatrix(worldToImageMatrix);
       pipeline->SliceToImageTransform->Concatenate(worldToImageMatrix);
 
-      // Create temporary copy of the segment image with default origin and spacing
-      vtkSmartPointer<vtkImageData> identityImageData = vtkSmartPointer<vtkImageData>::New();
-      identityImageData->ShallowCopy(imageData);
-      identityImageData->SetOrigin(0.0, 0.0, 0.0);
-      identityImageData->SetSpacing(1.0, 1.0, 1.0);
+      // Update the copy of the segment image with default origin and spacing.
+      // The copy shares the voxel array with the segment image, so it only needs to be updated
+      // if the image object itself changes (geometry, extent, scalar array).
+      if (pipeline->IdentityImageDataUpdateTime < imageData->GetMTime())
+      {
+        pipeline->IdentityImageData->ShallowCopy(imageData);
+        pipeline->IdentityImageData->SetOrigin(0.0, 0.0, 0.0);
+        pipeline->IdentityImageData->SetSpacing(1.0, 1.0, 1.0);
+        pipeline->IdentityImageDataUpdateTime = imageData->GetMTime();
+      }
 
       // Set Reslice transform
       // vtkImageReslice works faster if the input is a linear transform, so try to convert it
       // to a linear transform.
       // Also attempt to make it a permute transform, as it makes reslicing even faster.
-      vtkSmartPointer<vtkTransform> linearSliceToImageTransform = vtkSmartPointer<vtkTransform>::New();
+      // The linear transform is only modified if it has changed, so that reslicing is not repeated
+      // when only display properties change.
+      vtkNew<vtkTransform> linearSliceToImageTransform;
       if (vtkMRMLTransformNode::IsGeneralTransformLinear(pipeline->SliceToImageTransform, linearSliceToImageTransform))
       {
         SnapToPermuteMatrix(linearSliceToImageTransform);
-        pipeline->Reslice->SetResliceTransform(linearSliceToImageTransform);
+        vtkMatrix4x4* newMatrix = linearSliceToImageTransform->GetMatrix();
+        vtkMatrix4x4* currentMatrix = pipeline->LinearSliceToImageTransform->GetMatrix();
+        if (!std::equal(&newMatrix->Element[0][0], &newMatrix->Element[0][0] + 16, &currentMatrix->Element[0][0]))
+        {
+          pipeline->LinearSliceToImageTransform->SetMatrix(newMatrix);
+        }
+        pipeline->Reslice->SetResliceTransform(pipeline->LinearSliceToImageTransform);
       }
       else
       {
@@ -1069,18 +1134,19 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
 
       // Set the interpolation mode from the InterpolationType field if it exists
       // Default to nearest neighbor interpolation otherwise
-      pipeline->Reslice->SetInterpolationModeToNearestNeighbor();
+      int interpolationMode = VTK_RESLICE_NEAREST;
       vtkIntArray* interpolationType = vtkIntArray::SafeDownCast(imageData->GetFieldData()->GetAbstractArray(vtkSegmentationConverter::GetInterpolationTypeFieldName()));
       if (interpolationType && interpolationType->GetNumberOfValues() == 1)
       {
-        pipeline->Reslice->SetInterpolationMode(interpolationType->GetValue(0));
+        interpolationMode = interpolationType->GetValue(0);
       }
       else if (scalarRange && scalarRange->GetNumberOfValues() == 2)
       {
-        pipeline->Reslice->SetInterpolationMode(this->DefaultFractionalInterpolationType);
+        interpolationMode = this->DefaultFractionalInterpolationType;
       }
+      pipeline->Reslice->SetInterpolationMode(interpolationMode);
 
-      pipeline->Reslice->SetInputData(identityImageData);
+      pipeline->Reslice->SetInputData(pipeline->IdentityImageData);
 
       int dimensions[3] = { 0, 0, 0 };
       this->SliceNode->GetDimensions(dimensions);
@@ -1242,6 +1308,14 @@ bool vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::IsSegmentVisibleInCu
     segment->GetBounds(segmentBounds_Segment);
   }
 
+  return this->AreBoundsVisibleInCurrentSlice(displayNode, pipeline, segmentBounds_Segment);
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::AreBoundsVisibleInCurrentSlice(vtkMRMLSegmentationDisplayNode* displayNode,
+                                                                                           Pipeline* pipeline,
+                                                                                           double segmentBounds_Segment[6])
+{
   vtkSmartPointer<vtkGeneralTransform> segmentationToSliceTransform = vtkSmartPointer<vtkGeneralTransform>::New();
   vtkNew<vtkMatrix4x4> rasToSliceXY;
   vtkMatrix4x4::Invert(this->SliceXYToRAS, rasToSliceXY.GetPointer());
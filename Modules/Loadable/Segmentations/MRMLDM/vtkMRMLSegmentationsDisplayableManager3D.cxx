@@ -30,6 +30,7 @@
 #include <vtkMRMLClipNode.h>
 #include <vtkMRMLFolderDisplayNode.h>
 #include <vtkMRMLScene.h>
+#include <vtkMRMLTracer.h>
 #include <vtkMRMLTransformNode.h>
 #include <vtkMRMLViewNode.h>
 
@@ -527,9 +528,12 @@ void vtkMRMLSegmentationsDisplayableManager3D::vtkInternal::UpdateDisplayNodePip
     return;
   }
   // Make sure the requested representation exists
-  if (!segmentation->CreateRepresentation(shownRepresentationName))
   {
-    return;
+    vtkMRMLTraceScopeWithDetailMacro("Segmentation", "CreateRepresentation", shownRepresentationName);
+    if (!segmentation->CreateRepresentation(shownRepresentationName))
+    {
+      return;
+    }
   }
 
   // For all pipelines (pipeline per segment)
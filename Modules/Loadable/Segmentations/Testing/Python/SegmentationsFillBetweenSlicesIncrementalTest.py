@@ -0,0 +1,172 @@
+import logging
+import unittest
+
+import numpy as np
+import vtk
+import vtk.util.numpy_support
+
+import slicer
+
+"""
+This class tests incremental updates of the Fill between slices effect.
+After each edit (drawing a slice, editing a slice, removing a label from a slice, drawing on slices
+of a different orientation) the incrementally updated result must be the same as interpolating
+the whole volume with vtkITKMorphologicalContourInterpolator.
+"""
+
+
+class SegmentationsFillBetweenSlicesIncrementalTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsFillBetweenSlicesIncrementalTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsFillBetweenSlicesIncrementalTest(self):
+        self.dimensions = (40, 40, 40)
+        self.spacing = (0.8, 0.8, 1.5)
+        self.effect = self.getFillBetweenSlicesEffect()
+        self.TestSection_IncrementalUpdate()
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def getFillBetweenSlicesEffect(self):
+        sourceVolumeNode = slicer.util.addVolumeFromArray(np.zeros(self.dimensions[::-1], dtype=np.short))
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode")
+        segmentationNode.SetReferenceImageGeometryParameterFromVolumeNode(sourceVolumeNode)
+        segmentationNode.GetSegmentation().AddEmptySegment("Segment_1")
+
+        self.segmentEditorWidget = slicer.qMRMLSegmentEditorWidget()
+        self.segmentEditorWidget.setMRMLScene(slicer.mrmlScene)
+        segmentEditorNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentEditorNode")
+        self.segmentEditorWidget.setMRMLSegmentEditorNode(segmentEditorNode)
+        self.segmentEditorWidget.setSegmentationNode(segmentationNode)
+        self.segmentEditorWidget.setSourceVolumeNode(sourceVolumeNode)
+        self.segmentEditorWidget.setActiveEffectByName("Fill between slices")
+        effect = self.segmentEditorWidget.activeEffect()
+        self.assertIsNotNone(effect)
+        return effect.self()
+
+    # ------------------------------------------------------------------------------
+    @staticmethod
+    def drawDisk(voxels, axis, sliceIndex, center, radius, label):
+        """Draw a disk on a slice of the given IJK axis. Center is in the other two axes, in KJI order."""
+        arrayAxis = 2 - axis
+        sliceShape = [size for index, size in enumerate(voxels.shape) if index != arrayAxis]
+        rows, columns = np.ogrid[:sliceShape[0], :sliceShape[1]]
+        disk = (rows - center[0]) ** 2 + (columns - center[1]) ** 2 <= radius ** 2
+        index = [slice(None)] * 3
+        index[arrayAxis] = sliceIndex
+        voxelSlice = voxels[tuple(index)]
+        voxelSlice[disk] = label
+
+    # ------------------------------------------------------------------------------
+    def interpolateWholeVolume(self, voxels, axis):
+        import vtkITK
+
+        image = vtk.vtkImageData()
+        image.SetDimensions(voxels.shape[::-1])
+        image.SetSpacing(self.spacing)
+        image.AllocateScalars(vtk.VTK_SHORT, 1)
+        vtk.util.numpy_support.vtk_to_numpy(image.GetPointData().GetScalars())[:] = voxels.ravel()
+        interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+        interpolator.SetInputData(image)
+        interpolator.SetAxis(axis)
+        interpolator.Update()
+        return vtk.util.numpy_support.vtk_to_numpy(interpolator.GetOutput().GetPointData().GetScalars()).reshape(voxels.shape).copy()
+
+    # ------------------------------------------------------------------------------
+    def computePreview(self, voxels):
+        mergedImage = slicer.vtkOrientedImageData()
+        mergedImage.SetDimensions(self.dimensions)
+        mergedImage.SetSpacing(self.spacing)
+        mergedImage.AllocateScalars(vtk.VTK_SHORT, 1)
+        vtk.util.numpy_support.vtk_to_numpy(mergedImage.GetPointData().GetScalars())[:] = voxels.ravel()
+        outputLabelmap = slicer.vtkOrientedImageData()
+        self.effect.previewChangedExtent = None
+        self.effect.computePreviewLabelmap(mergedImage, outputLabelmap)
+        self.assertEqual(outputLabelmap.GetExtent(), mergedImage.GetExtent())
+        return vtk.util.numpy_support.vtk_to_numpy(outputLabelmap.GetPointData().GetScalars()).reshape(voxels.shape).copy()
+
+    # ------------------------------------------------------------------------------
+    def checkPreview(self, voxels, axis, description):
+        logging.info(f"Check incremental update: {description}")
+        preview = self.computePreview(voxels)
+        self.assertIsNotNone(self.effect.interpolationCache)
+        self.assertEqual(self.effect.interpolationCache["axis"], axis)
+        self.assertTrue(np.array_equal(preview, self.interpolateWholeVolume(voxels, axis)), description)
+        return preview
+
+    # ------------------------------------------------------------------------------
+    def TestSection_IncrementalUpdate(self):
+        self.effect.incrementalUpdate = True
+        self.effect.interpolationCache = None
+        axis = 2
+
+        # Segments drawn on K slices. Labels are far from each other so that interpolated regions do not overlap.
+        voxels = np.zeros(self.dimensions[::-1], dtype=np.short)
+        self.drawDisk(voxels, axis, 5, (10, 10), 5, 1)
+        self.drawDisk(voxels, axis, 15, (11, 10), 7, 1)
+        self.drawDisk(voxels, axis, 25, (10, 12), 4, 1)
+        self.drawDisk(voxels, axis, 8, (30, 29), 4, 2)
+        self.drawDisk(voxels, axis, 20, (28, 30), 6, 2)
+        self.checkPreview(voxels, axis, "initial slices")
+        # The first update computes the whole extent
+        self.assertIsNone(self.effect.previewChangedExtent)
+
+        # Draw a new slice of label 1, which splits a gap
+        self.drawDisk(voxels, axis, 20, (12, 12), 6, 1)
+        label2Slices = dict(self.effect.interpolationCache["slices"][2])
+        self.checkPreview(voxels, axis, "draw slice")
+        # Only the gaps next to the new slice are recomputed, interpolated slices of label 2 are kept
+        changedExtent = self.effect.previewChangedExtent
+        self.assertEqual(changedExtent[axis * 2:axis * 2 + 2], [15, 25])
+        for index, interpolatedSlice in self.effect.interpolationCache["slices"][2].items():
+            self.assertIs(interpolatedSlice, label2Slices[index])
+
+        # Edit a slice of label 2
+        self.drawDisk(voxels, axis, 20, (28, 30), 8, 2)
+        self.checkPreview(voxels, axis, "edit slice")
+        self.assertEqual(self.effect.previewChangedExtent[axis * 2:axis * 2 + 2], [8, 20])
+
+        # Remove label 1 from a slice, which merges two gaps
+        voxels[15][voxels[15] == 1] = 0
+        self.checkPreview(voxels, axis, "remove label from slice")
+        self.assertEqual(self.effect.previewChangedExtent[axis * 2:axis * 2 + 2], [5, 20])
+
+        # Remove all slices of label 2 but one, label 2 is not interpolated anymore
+        voxels[8][voxels[8] == 2] = 0
+        self.checkPreview(voxels, axis, "remove label from all but one slice")
+        self.assertNotIn(2, self.effect.interpolationCache["slices"])
+
+        # No change
+        self.checkPreview(voxels, axis, "no change")
+        changedExtent = self.effect.previewChangedExtent
+        self.assertTrue(changedExtent[0] > changedExtent[1] or changedExtent[2] > changedExtent[3] or changedExtent[4] > changedExtent[5])
+
+        # Segments drawn on I slices instead, the cache is rebuilt for the new axis
+        axis = 0
+        voxels = np.zeros(self.dimensions[::-1], dtype=np.short)
+        self.drawDisk(voxels, axis, 6, (12, 10), 5, 1)
+        self.drawDisk(voxels, axis, 18, (14, 12), 7, 1)
+        self.drawDisk(voxels, axis, 10, (30, 28), 5, 3)
+        self.drawDisk(voxels, axis, 30, (27, 30), 4, 3)
+        self.checkPreview(voxels, axis, "switch axis")
+        self.assertIsNone(self.effect.previewChangedExtent)
+
+        # Edit a slice along the new axis
+        self.drawDisk(voxels, axis, 30, (27, 30), 7, 3)
+        self.checkPreview(voxels, axis, "edit slice after switching axis")
+        self.assertEqual(self.effect.previewChangedExtent[axis * 2:axis * 2 + 2], [10, 30])
+
+        # Incrementally computed result is the same as the result computed without cache
+        incrementalPreview = self.computePreview(voxels)
+        self.effect.incrementalUpdate = False
+        self.assertTrue(np.array_equal(self.computePreview(voxels), incrementalPreview))
+        self.effect.incrementalUpdate = True
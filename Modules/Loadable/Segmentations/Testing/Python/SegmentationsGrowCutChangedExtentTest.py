@@ -0,0 +1,160 @@
+import logging
+import unittest
+
+import numpy as np
+import vtk
+import vtk.util.numpy_support
+
+import slicer
+
+"""
+This class tests incremental grow-cut updates.
+vtkImageGrowCutSegment reports the extent of the result that changed since the previous update (with both engines),
+which is used by the Grow from seeds effect to update only the changed region of the preview segmentation.
+"""
+
+
+class SegmentationsGrowCutChangedExtentTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsGrowCutChangedExtentTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsGrowCutChangedExtentTest(self):
+        self.dimensions = (32, 32, 32)
+        self.TestSection_FilterChangedExtent(slicer.vtkImageGrowCutSegment.EngineFibonacciHeap)
+        self.TestSection_FilterChangedExtent(slicer.vtkImageGrowCutSegment.EngineBucketQueue)
+        self.setUp()
+        self.TestSection_GrowFromSeedsEffectPreview()
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def createIntensityVoxels(self):
+        # Uniform background with a bright cube, which is relabeled when a seed is placed inside it
+        voxels = np.full(self.dimensions[::-1], 100, dtype=np.short)
+        voxels[6:12, 6:12, 6:12] = 300
+        return voxels
+
+    # ------------------------------------------------------------------------------
+    def createImage(self, voxels, scalarType):
+        image = vtk.vtkImageData()
+        image.SetDimensions(voxels.shape[::-1])
+        image.AllocateScalars(scalarType, 1)
+        vtk.util.numpy_support.vtk_to_numpy(image.GetPointData().GetScalars())[:] = voxels.ravel()
+        return image
+
+    # ------------------------------------------------------------------------------
+    @staticmethod
+    def isEmptyExtent(extent):
+        return extent[0] > extent[1] or extent[2] > extent[3] or extent[4] > extent[5]
+
+    # ------------------------------------------------------------------------------
+    def TestSection_FilterChangedExtent(self, engine):
+        logging.info(f"Test changed extent with engine {engine}")
+        seeds = np.zeros(self.dimensions[::-1], dtype=np.short)
+        seeds[2:5, 2:5, 2:5] = 1
+        seeds[27:30, 27:30, 27:30] = 2
+        seedImage = self.createImage(seeds, vtk.VTK_SHORT)
+
+        growCut = slicer.vtkImageGrowCutSegment()
+        growCut.SetEngine(engine)
+        growCut.SetIntensityVolume(self.createImage(self.createIntensityVoxels(), vtk.VTK_SHORT))
+        growCut.SetSeedLabelVolume(seedImage)
+
+        def getResult():
+            output = growCut.GetOutput()
+            return vtk.util.numpy_support.vtk_to_numpy(output.GetPointData().GetScalars()).reshape(self.dimensions[::-1]).copy()
+
+        # First computation changes the whole extent
+        growCut.Update()
+        wholeExtent = growCut.GetOutput().GetExtent()
+        self.assertEqual(growCut.GetChangedExtent(), wholeExtent)
+        previousResult = getResult()
+
+        # Recomputation with the same seeds does not change anything
+        seedImage.Modified()
+        growCut.Update()
+        self.assertTrue(self.isEmptyExtent(growCut.GetChangedExtent()))
+        self.assertTrue(np.array_equal(getResult(), previousResult))
+
+        # New seed inside the cube only relabels the cube
+        seeds[8:10, 8:10, 8:10] = 3
+        vtk.util.numpy_support.vtk_to_numpy(seedImage.GetPointData().GetScalars())[:] = seeds.ravel()
+        seedImage.Modified()
+        growCut.Update()
+        result = getResult()
+        self.assertTrue(np.all(result[6:12, 6:12, 6:12] == 3))
+
+        changedExtent = growCut.GetChangedExtent()
+        self.assertFalse(self.isEmptyExtent(changedExtent))
+        self.assertNotEqual(changedExtent, wholeExtent)
+        changedVoxels = np.zeros(result.shape, dtype=bool)
+        changedVoxels[changedExtent[4]:changedExtent[5] + 1, changedExtent[2]:changedExtent[3] + 1, changedExtent[0]:changedExtent[1] + 1] = True
+        self.assertFalse(np.any((result != previousResult) & ~changedVoxels))
+
+        # Reset requires full recomputation
+        growCut.Reset()
+        growCut.Update()
+        self.assertEqual(growCut.GetChangedExtent(), wholeExtent)
+        self.assertTrue(np.array_equal(getResult(), result))
+
+    # ------------------------------------------------------------------------------
+    def TestSection_GrowFromSeedsEffectPreview(self):
+        sourceVolumeNode = slicer.util.addVolumeFromArray(self.createIntensityVoxels())
+
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode")
+        segmentationNode.CreateDefaultDisplayNodes()
+        segmentationNode.SetReferenceImageGeometryParameterFromVolumeNode(sourceVolumeNode)
+        segment1Id = segmentationNode.GetSegmentation().AddEmptySegment("Segment_1")
+        segment2Id = segmentationNode.GetSegmentation().AddEmptySegment("Segment_2")
+        seeds1 = np.zeros(self.dimensions[::-1], dtype=np.uint8)
+        seeds1[2:5, 2:5, 2:5] = 1
+        slicer.util.updateSegmentBinaryLabelmapFromArray(seeds1, segmentationNode, segment1Id, sourceVolumeNode)
+        seeds2 = np.zeros(self.dimensions[::-1], dtype=np.uint8)
+        seeds2[27:30, 27:30, 27:30] = 1
+        slicer.util.updateSegmentBinaryLabelmapFromArray(seeds2, segmentationNode, segment2Id, sourceVolumeNode)
+
+        segmentEditorWidget = slicer.qMRMLSegmentEditorWidget()
+        segmentEditorWidget.setMRMLScene(slicer.mrmlScene)
+        segmentEditorNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentEditorNode")
+        segmentEditorWidget.setMRMLSegmentEditorNode(segmentEditorNode)
+        segmentEditorWidget.setSegmentationNode(segmentationNode)
+        segmentEditorWidget.setSourceVolumeNode(sourceVolumeNode)
+        segmentEditorWidget.setActiveEffectByName("Grow from seeds")
+        effect = segmentEditorWidget.activeEffect()
+        self.assertIsNotNone(effect)
+
+        def getPreviewLabelmap():
+            previewNode = effect.self().getPreviewNode()
+            self.assertIsNotNone(previewNode)
+            return previewNode.GetBinaryLabelmapInternalRepresentation(segment1Id)
+
+        def getPreviewVoxels():
+            return slicer.util.arrayFromSegmentInternalBinaryLabelmap(effect.self().getPreviewNode(), segment1Id).copy()
+
+        effect.self().onPreview()
+        previewLabelmap = getPreviewLabelmap()
+
+        # Seed of segment 2 inside the cube, preview is updated in the changed extent
+        seeds2[8:10, 8:10, 8:10] = 1
+        slicer.util.updateSegmentBinaryLabelmapFromArray(seeds2, segmentationNode, segment2Id, sourceVolumeNode)
+        effect.self().onPreview()
+        self.assertIsNotNone(effect.self().previewChangedExtent)
+        self.assertFalse(self.isEmptyExtent(effect.self().previewChangedExtent))
+        self.assertIs(getPreviewLabelmap(), previewLabelmap)
+        incrementalPreviewVoxels = getPreviewVoxels()
+        self.assertTrue(np.all(incrementalPreviewVoxels[8:10, 8:10, 8:10] == 2))
+
+        # Incrementally updated preview is the same as the fully recomputed preview
+        effect.self().reset()
+        effect.self().onPreview()
+        self.assertTrue(np.array_equal(getPreviewVoxels(), incrementalPreviewVoxels))
+
+        effect.self().onCancel()
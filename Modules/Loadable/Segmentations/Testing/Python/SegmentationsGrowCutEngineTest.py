@@ -0,0 +1,154 @@
+import logging
+import time
+import unittest
+
+import numpy as np
+import vtk
+import vtk.util.numpy_support
+
+import slicer
+
+"""
+This class tests that the grow-cut engines of vtkImageGrowCutSegment compute the same segmentation.
+
+The Fibonacci heap and bucket queue engines compute the same shortest paths, therefore labels may only differ
+for voxels that are at equal distance from seeds of different labels. Intensities contain random noise,
+so such ties are rare: at most 0.1% of voxels are allowed to differ.
+Coarse-to-fine initialization is approximate near label boundaries: at most 1% of voxels are allowed to differ.
+"""
+
+
+class SegmentationsGrowCutEngineTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsGrowCutEngineTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsGrowCutEngineTest(self):
+        self.dimensions = (64, 56, 48)
+        self.exactEngineTolerance = 0.001
+        self.coarseToFineTolerance = 0.01
+        self.createInputs()
+        self.TestSection_DefaultEngine()
+        self.TestSection_CompareEngines()
+        self.TestSection_CoarseToFine()
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def createImage(self, voxels, scalarType):
+        image = vtk.vtkImageData()
+        image.SetDimensions(voxels.shape[::-1])
+        image.AllocateScalars(scalarType, 1)
+        vtk.util.numpy_support.vtk_to_numpy(image.GetPointData().GetScalars())[:] = voxels.ravel()
+        return image
+
+    # ------------------------------------------------------------------------------
+    def createInputs(self):
+        # Two noisy spheres of different intensity on a noisy background
+        shape = self.dimensions[::-1]
+        k, j, i = np.ogrid[0:shape[0], 0:shape[1], 0:shape[2]]
+        self.sphereCenters = [(24, 28, 20), (24, 26, 44)]  # KJI
+        sphereRadii = [12, 9]
+        sphereIntensities = [100.0, 200.0]
+        rng = np.random.default_rng(42)
+        intensities = rng.normal(0.0, 10.0, shape).astype(np.float32)
+        for center, radius, intensity in zip(self.sphereCenters, sphereRadii, sphereIntensities):
+            insideSphere = (k - center[0]) ** 2 + (j - center[1]) ** 2 + (i - center[2]) ** 2 <= radius * radius
+            intensities[insideSphere] += intensity
+        self.intensityImage = self.createImage(intensities, vtk.VTK_FLOAT)
+
+        self.seeds = np.zeros(shape, dtype=np.short)
+        self.seeds[2:6, 2:6, 2:6] = 1
+        for label, center in enumerate(self.sphereCenters, start=2):
+            self.seeds[center[0] - 2:center[0] + 3, center[1] - 2:center[1] + 3, center[2] - 2:center[2] + 3] = label
+
+    # ------------------------------------------------------------------------------
+    def createGrowCut(self, engine, coarseToFine=False):
+        growCut = slicer.vtkImageGrowCutSegment()
+        growCut.SetEngine(engine)
+        growCut.SetCoarseToFine(coarseToFine)
+        growCut.SetIntensityVolume(self.intensityImage)
+        growCut.SetSeedLabelVolume(self.createImage(self.seeds, vtk.VTK_SHORT))
+        return growCut
+
+    # ------------------------------------------------------------------------------
+    def computeGrowCut(self, growCut):
+        startTime = time.perf_counter()
+        growCut.Update()
+        computationTimeSec = time.perf_counter() - startTime
+        # Output shares the internal buffer of the filter, therefore it must be copied
+        output = vtk.util.numpy_support.vtk_to_numpy(growCut.GetOutput().GetPointData().GetScalars())
+        return output.reshape(self.dimensions[::-1]).copy(), computationTimeSec
+
+    # ------------------------------------------------------------------------------
+    def addSeed(self, growCut):
+        # Seed with a new label in the background, between the spheres
+        self.seeds[40:44, 8:12, 30:34] = 4
+        seedImage = growCut.GetInput(1)
+        vtk.util.numpy_support.vtk_to_numpy(seedImage.GetPointData().GetScalars())[:] = self.seeds.ravel()
+        seedImage.Modified()
+
+    # ------------------------------------------------------------------------------
+    def assertSimilarLabels(self, labels, expectedLabels, tolerance):
+        differenceRatio = np.count_nonzero(labels != expectedLabels) / labels.size
+        self.assertLessEqual(differenceRatio, tolerance)
+        # Seeds keep their labels
+        self.assertTrue(np.array_equal(labels[self.seeds != 0], self.seeds[self.seeds != 0]))
+        for label, center in enumerate(self.sphereCenters, start=2):
+            self.assertEqual(labels[center], label)
+
+    # ------------------------------------------------------------------------------
+    def TestSection_DefaultEngine(self):
+        growCut = slicer.vtkImageGrowCutSegment()
+        self.assertEqual(growCut.GetEngine(), slicer.vtkImageGrowCutSegment.EngineFibonacciHeap)
+        self.assertFalse(growCut.GetCoarseToFine())
+
+    # ------------------------------------------------------------------------------
+    def TestSection_CompareEngines(self):
+        seeds = self.seeds.copy()
+        heapGrowCut = self.createGrowCut(slicer.vtkImageGrowCutSegment.EngineFibonacciHeap)
+        bucketGrowCut = self.createGrowCut(slicer.vtkImageGrowCutSegment.EngineBucketQueue)
+
+        # Initial computation
+        heapLabels, heapTimeSec = self.computeGrowCut(heapGrowCut)
+        bucketLabels, bucketTimeSec = self.computeGrowCut(bucketGrowCut)
+        self.assertSimilarLabels(bucketLabels, heapLabels, self.exactEngineTolerance)
+        logging.info(f"Initial computation: heap {heapTimeSec:.3f}s, bucket queue {bucketTimeSec:.3f}s")
+
+        # Incremental update after adding a seed
+        self.addSeed(heapGrowCut)
+        self.addSeed(bucketGrowCut)
+        heapLabels, heapTimeSec = self.computeGrowCut(heapGrowCut)
+        bucketLabels, bucketTimeSec = self.computeGrowCut(bucketGrowCut)
+        self.assertTrue(np.any(heapLabels == 4))
+        self.assertSimilarLabels(bucketLabels, heapLabels, self.exactEngineTolerance)
+        logging.info(f"Incremental update: heap {heapTimeSec:.3f}s, bucket queue {bucketTimeSec:.3f}s")
+
+        self.seeds = seeds
+
+    # ------------------------------------------------------------------------------
+    def TestSection_CoarseToFine(self):
+        heapGrowCut = self.createGrowCut(slicer.vtkImageGrowCutSegment.EngineFibonacciHeap)
+        coarseToFineGrowCut = self.createGrowCut(slicer.vtkImageGrowCutSegment.EngineBucketQueue, coarseToFine=True)
+
+        # Initial computation is approximate
+        heapLabels, heapTimeSec = self.computeGrowCut(heapGrowCut)
+        coarseToFineLabels, coarseToFineTimeSec = self.computeGrowCut(coarseToFineGrowCut)
+        self.assertEqual(coarseToFineGrowCut.GetChangedExtent(), coarseToFineGrowCut.GetOutput().GetExtent())
+        self.assertSimilarLabels(coarseToFineLabels, heapLabels, self.coarseToFineTolerance)
+        logging.info(f"Initial computation: heap {heapTimeSec:.3f}s, coarse-to-fine {coarseToFineTimeSec:.3f}s")
+
+        # Incremental update is computed at full resolution
+        self.addSeed(heapGrowCut)
+        self.addSeed(coarseToFineGrowCut)
+        heapLabels, heapTimeSec = self.computeGrowCut(heapGrowCut)
+        coarseToFineLabels, coarseToFineTimeSec = self.computeGrowCut(coarseToFineGrowCut)
+        self.assertSimilarLabels(coarseToFineLabels, heapLabels, self.coarseToFineTolerance)
+        logging.info(f"Incremental update: heap {heapTimeSec:.3f}s, coarse-to-fine {coarseToFineTimeSec:.3f}s")
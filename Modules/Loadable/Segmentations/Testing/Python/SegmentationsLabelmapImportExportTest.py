@@ -0,0 +1,132 @@
+import logging
+import time
+import unittest
+
+import numpy as np
+import vtk
+
+import slicer
+
+"""
+This class tests importing a multi-label labelmap volume into a segmentation and exporting it back.
+All segments imported from a labelmap volume are stored in a single shared labelmap layer and
+export of the segments restores the original labelmap. Import and export times are logged
+for different number of labels.
+
+The logged times are informational only, the test does not check them. No reference timings
+for 10, 100 and 300 labels were collected when the single-pass import and export was implemented,
+therefore the speedup compared to per-label import and export has not been measured.
+"""
+
+
+class SegmentationsLabelmapImportExportTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsLabelmapImportExportTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsLabelmapImportExportTest(self):
+        self.assertIsNotNone(slicer.modules.segmentations)
+        for numberOfLabels in [10, 100, 300]:
+            self.TestSection_ImportExport(numberOfLabels)
+        self.TestSection_FloatingPointLabelValues()
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def createLabelmapVolume(self, numberOfLabels, dimensions=(128, 128, 96)):
+        """Create labelmap volume with labels 1..numberOfLabels, each label is a non-empty block of voxels."""
+        voxels = np.zeros(dimensions[::-1], dtype=np.int16)
+        numberOfBlocksPerAxis = int(np.ceil(numberOfLabels ** (1.0 / 3.0)))
+        blockSize = [dimension // numberOfBlocksPerAxis for dimension in dimensions[::-1]]
+        for labelIndex in range(numberOfLabels):
+            k = labelIndex // (numberOfBlocksPerAxis * numberOfBlocksPerAxis)
+            j = (labelIndex // numberOfBlocksPerAxis) % numberOfBlocksPerAxis
+            i = labelIndex % numberOfBlocksPerAxis
+            # Leave a margin inside each block so that the effective extent is smaller than the volume extent
+            voxels[
+                k * blockSize[0] + 1:(k + 1) * blockSize[0] - 1,
+                j * blockSize[1] + 1:(j + 1) * blockSize[1] - 1,
+                i * blockSize[2] + 1:(i + 1) * blockSize[2] - 1,
+            ] = labelIndex + 1
+
+        labelmapNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLabelMapVolumeNode", f"Labels{numberOfLabels}")
+        labelmapNode.SetSpacing(0.8, 0.9, 1.5)
+        labelmapNode.SetOrigin(10.0, -20.0, 5.0)
+        slicer.util.updateVolumeFromArray(labelmapNode, voxels)
+        labelmapNode.CreateDefaultDisplayNodes()
+        return labelmapNode, voxels
+
+    # ------------------------------------------------------------------------------
+    def TestSection_ImportExport(self, numberOfLabels):
+        labelmapNode, voxels = self.createLabelmapVolume(numberOfLabels)
+        segmentationsLogic = slicer.modules.segmentations.logic()
+
+        # Import
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode")
+        startTime = time.perf_counter()
+        self.assertTrue(segmentationsLogic.ImportLabelmapToSegmentationNode(labelmapNode, segmentationNode))
+        importTimeSec = time.perf_counter() - startTime
+
+        segmentation = segmentationNode.GetSegmentation()
+        self.assertEqual(segmentation.GetNumberOfSegments(), numberOfLabels)
+        # Labels in a labelmap volume cannot overlap, therefore all segments are stored in one layer
+        self.assertEqual(segmentation.GetNumberOfLayers(), 1)
+        for segmentIndex in range(numberOfLabels):
+            self.assertEqual(segmentation.GetNthSegment(segmentIndex).GetLabelValue(), segmentIndex + 1)
+
+        # Effective extent of the shared labelmap is the bounding box of all labels
+        labelValues = vtk.vtkIntArray()
+        effectiveExtent = [0, -1, 0, -1, 0, -1]
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.GetAllLabelValues(labelValues, labelmapNode.GetImageData(), effectiveExtent))
+        self.assertEqual(labelValues.GetNumberOfValues(), numberOfLabels)
+        nonZeroIndices = np.nonzero(voxels)
+        expectedEffectiveExtent = []
+        for axis in [2, 1, 0]:
+            expectedEffectiveExtent.extend([int(nonZeroIndices[axis].min()), int(nonZeroIndices[axis].max())])
+        self.assertEqual(list(effectiveExtent), expectedEffectiveExtent)
+
+        # Export
+        exportedLabelmapNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLabelMapVolumeNode")
+        segmentIds = vtk.vtkStringArray()
+        segmentation.GetSegmentIDs(segmentIds)
+        startTime = time.perf_counter()
+        self.assertTrue(segmentationsLogic.ExportSegmentsToLabelmapNode(segmentationNode, segmentIds, exportedLabelmapNode, labelmapNode))
+        exportTimeSec = time.perf_counter() - startTime
+
+        exportedVoxels = slicer.util.arrayFromVolume(exportedLabelmapNode)
+        self.assertEqual(exportedVoxels.shape, voxels.shape)
+        self.assertTrue(np.array_equal(exportedVoxels, voxels))
+
+        logging.info(f"Labelmap import/export with {numberOfLabels} labels: import {importTimeSec:.3f}s, export {exportTimeSec:.3f}s")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_FloatingPointLabelValues(self):
+        """Floating-point label values are truncated toward zero, the same way as the labelmap is cast on import."""
+        voxels = np.zeros((20, 30, 40), dtype=np.float32)
+        voxels[2:5, 3:6, 4:7] = 1.0
+        voxels[10:12, 12:15, 20:25] = 2.6
+        # Truncated to zero, therefore it is background and not part of the effective extent
+        voxels[15:18, 25:28, 35:38] = 0.4
+
+        labelmapNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLabelMapVolumeNode", "FloatLabels")
+        slicer.util.updateVolumeFromArray(labelmapNode, voxels)
+
+        labelValues = vtk.vtkIntArray()
+        effectiveExtent = [0, -1, 0, -1, 0, -1]
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.GetAllLabelValues(labelValues, labelmapNode.GetImageData(), effectiveExtent))
+        self.assertEqual([labelValues.GetValue(index) for index in range(labelValues.GetNumberOfValues())], [1, 2])
+        self.assertEqual(list(effectiveExtent), [4, 24, 3, 14, 2, 11])
+
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode")
+        self.assertTrue(slicer.modules.segmentations.logic().ImportLabelmapToSegmentationNode(labelmapNode, segmentationNode))
+        segmentation = segmentationNode.GetSegmentation()
+        self.assertEqual(segmentation.GetNumberOfSegments(), 2)
+        self.assertEqual(segmentation.GetNthSegment(0).GetLabelValue(), 1)
+        self.assertEqual(segmentation.GetNthSegment(1).GetLabelValue(), 2)
@@ -0,0 +1,98 @@
+import logging
+import time
+import unittest
+
+import numpy as np
+import vtk
+import vtk.util.numpy_support
+
+import slicer
+
+"""
+This class tests margin computation of labelmaps that is used by the Margin and Hollow segment editor effects.
+Results are compared to analytically computed distances for a small and a large structure in a large image,
+and computation times are logged.
+"""
+
+
+class SegmentationsMarginTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsMarginTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsMarginTest(self):
+        self.dimensions = (256, 256, 160)
+        self.spacing = (0.8, 0.9, 1.5)
+        self.TestSection_SmallStructureGrow()
+        self.TestSection_LargeStructureShell()
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def createImage(self, voxels):
+        image = vtk.vtkImageData()
+        image.SetDimensions(voxels.shape[::-1])
+        image.SetSpacing(self.spacing)
+        image.AllocateScalars(vtk.VTK_UNSIGNED_CHAR, 1)
+        vtk.util.numpy_support.vtk_to_numpy(image.GetPointData().GetScalars())[:] = voxels.ravel()
+        return image
+
+    # ------------------------------------------------------------------------------
+    def computeMargin(self, voxels, innerMarginMm, outerMarginMm):
+        import vtkITK
+
+        margin = vtkITK.vtkITKImageMargin()
+        margin.SetInputData(self.createImage(voxels))
+        margin.CalculateMarginInMMOn()
+        margin.SetInnerMarginMM(innerMarginMm)
+        margin.SetOuterMarginMM(outerMarginMm)
+        startTime = time.perf_counter()
+        margin.Update()
+        computationTimeSec = time.perf_counter() - startTime
+        output = vtk.util.numpy_support.vtk_to_numpy(margin.GetOutput().GetPointData().GetScalars()).reshape(voxels.shape)
+        return output, computationTimeSec
+
+    # ------------------------------------------------------------------------------
+    def TestSection_SmallStructureGrow(self):
+        # Single voxel, grown by a margin is a ball
+        voxels = np.zeros(self.dimensions[::-1], dtype=np.uint8)
+        center = (80, 120, 100)  # KJI
+        voxels[center] = 1
+        marginMm = 3.1
+        output, computationTimeSec = self.computeMargin(voxels, float("-inf"), marginMm)
+
+        k, j, i = np.ogrid[0:voxels.shape[0], 0:voxels.shape[1], 0:voxels.shape[2]]
+        squaredDistance = (((i - center[2]) * self.spacing[0]) ** 2
+                           + ((j - center[1]) * self.spacing[1]) ** 2
+                           + ((k - center[0]) * self.spacing[2]) ** 2)
+        expected = squaredDistance <= marginMm * marginMm
+        self.assertTrue(np.array_equal(output != 0, expected))
+        self.assertEqual(output.max(), 255)
+
+        logging.info(f"Margin of small structure ({marginMm}mm): {computationTimeSec:.3f}s")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_LargeStructureShell(self):
+        # Large box, shell inside the surface
+        voxels = np.zeros(self.dimensions[::-1], dtype=np.uint8)
+        boxExtent = [(10, 150), (20, 240), (30, 220)]  # KJI, inclusive
+        voxels[boxExtent[0][0]:boxExtent[0][1] + 1, boxExtent[1][0]:boxExtent[1][1] + 1, boxExtent[2][0]:boxExtent[2][1] + 1] = 1
+        shellThicknessMm = 4.0
+        output, computationTimeSec = self.computeMargin(voxels, -shellThicknessMm, 0.0)
+
+        # Distance of inside voxels from the nearest border voxel of a box is the distance from the nearest face
+        k, j, i = np.ogrid[0:voxels.shape[0], 0:voxels.shape[1], 0:voxels.shape[2]]
+        distance = np.full(voxels.shape, np.inf)
+        for coordinate, (first, last), spacing in zip([k, j, i], boxExtent, self.spacing[::-1]):
+            distance = np.minimum(distance, np.minimum(coordinate - first, last - coordinate) * spacing)
+        expected = (voxels != 0) & (distance <= shellThicknessMm)
+        self.assertTrue(np.array_equal(output != 0, expected))
+
+        logging.info(f"Shell of large structure ({shellThicknessMm}mm): {computationTimeSec:.3f}s")
@@ -0,0 +1,98 @@
+import logging
+import time
+
+import numpy as np
+
+import slicer
+from slicer.ScriptedLoadableModule import *
+
+"""
+This class measures the time needed for displaying segmentations in a slice view
+while moving the slice. Segments share a single labelmap layer, which is resliced
+only once per slice view, therefore the rendering time should not increase
+significantly with the number of segments.
+"""
+
+
+class SegmentationsSliceViewRenderingTest(ScriptedLoadableModuleTest):
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsSliceViewRenderingTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsSliceViewRenderingTest(self):
+        self.assertIsNotNone(slicer.modules.segmentations)
+
+        self.setupSliceWidget()
+        renderingTimesSec = {}
+        for numberOfSegments in [10, 100, 300]:
+            renderingTimesSec[numberOfSegments] = self.measureSliceRenderingTime(numberOfSegments)
+
+        for numberOfSegments, renderingTimeSec in renderingTimesSec.items():
+            logging.info(f"{numberOfSegments} segments in a shared labelmap: {renderingTimeSec * 1000.0:.2f} ms per slice")
+
+        self.sliceWidget.hide()
+        self.sliceWidget = None
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def setupSliceWidget(self):
+        sliceNode = slicer.vtkMRMLSliceNode()
+        sliceNode.SetName("Benchmark")
+        sliceNode.SetLayoutName("Benchmark")
+        sliceNode.SetLayoutLabel("B")
+        sliceNode.SetOrientationToAxial()
+        slicer.mrmlScene.AddNode(sliceNode)
+        self.sliceNode = sliceNode
+
+        self.sliceWidget = slicer.qMRMLSliceWidget()
+        self.sliceWidget.setMRMLScene(slicer.mrmlScene)
+        self.sliceWidget.setMRMLSliceNode(sliceNode)
+        self.sliceWidget.resize(512, 512)
+        self.sliceWidget.show()
+
+    # ------------------------------------------------------------------------------
+    def createSegmentationNode(self, numberOfSegments):
+        """Create a segmentation where all segments are stored in a single labelmap layer.
+        Each axial slice contains all the segments, arranged in a grid.
+        """
+        labelmapVolumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLabelMapVolumeNode")
+        gridSize = int(np.ceil(np.sqrt(numberOfSegments)))
+        shape = (40, 256, 256)  # slices, rows, columns
+        _, rows, columns = np.indices(shape)
+        cellIndex = (rows * gridSize // shape[1]) * gridSize + (columns * gridSize // shape[2])
+        voxels = np.where(cellIndex < numberOfSegments, cellIndex + 1, 0).astype(np.uint16)
+        slicer.util.updateVolumeFromArray(labelmapVolumeNode, voxels)
+
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode")
+        segmentationNode.CreateDefaultDisplayNodes()
+        slicer.modules.segmentations.logic().ImportLabelmapToSegmentationNode(labelmapVolumeNode, segmentationNode)
+        slicer.mrmlScene.RemoveNode(labelmapVolumeNode)
+        return segmentationNode
+
+    # ------------------------------------------------------------------------------
+    def measureSliceRenderingTime(self, numberOfSegments):
+        """Returns average time in seconds required for moving the slice and rendering the view."""
+        segmentationNode = self.createSegmentationNode(numberOfSegments)
+        segmentation = segmentationNode.GetSegmentation()
+        self.assertEqual(segmentation.GetNumberOfSegments(), numberOfSegments)
+        self.assertEqual(segmentation.GetNumberOfLayers(), 1)
+
+        sliceView = self.sliceWidget.sliceView()
+        self.sliceWidget.sliceLogic().FitSliceToAll()
+        sliceView.forceRender()
+
+        numberOfSlices = 30
+        startTime = time.time()
+        for sliceIndex in range(numberOfSlices):
+            self.sliceNode.SetSliceOffset(sliceIndex + 0.5)
+            sliceView.forceRender()
+        renderingTimeSec = (time.time() - startTime) / numberOfSlices
+
+        slicer.mrmlScene.RemoveNode(segmentationNode)
+        return renderingTimeSec
@@ -0,0 +1,142 @@
+import logging
+import os
+import time
+import unittest
+
+import numpy as np
+import vtk
+
+import slicer
+
+"""
+This class tests exporting closed surface representation of segments to STL and OBJ files.
+Exported meshes are read back and compared to the closed surface representation of the segments,
+taking into account the parent transform, scaling, and LPS coordinate system. Export times are logged.
+"""
+
+
+class SegmentationsSurfaceExportTest(unittest.TestCase):
+    # ------------------------------------------------------------------------------
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    # ------------------------------------------------------------------------------
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SegmentationsSurfaceExportTest()
+
+    # ------------------------------------------------------------------------------
+    def test_SegmentationsSurfaceExportTest(self):
+        self.assertIsNotNone(slicer.modules.segmentations)
+        self.outputFolder = os.path.join(slicer.app.temporaryPath, "SegmentationsSurfaceExportTest")
+        os.makedirs(self.outputFolder, exist_ok=True)
+
+        segmentationNode = self.createSegmentation(numberOfSegments=12)
+        self.TestSection_ExportStl(segmentationNode, merge=True, lps=True, sizeScale=1.0)
+        self.TestSection_ExportStl(segmentationNode, merge=False, lps=False, sizeScale=2.0)
+        self.TestSection_ExportObj(segmentationNode, lps=True, sizeScale=1.0)
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def createSegmentation(self, numberOfSegments, dimensions=(64, 64, 48)):
+        """Create segmentation with segments stored in a shared labelmap, under a linear transform."""
+        voxels = np.zeros(dimensions[::-1], dtype=np.int16)
+        blockSize = dimensions[0] // numberOfSegments
+        for labelIndex in range(numberOfSegments):
+            voxels[8:-8, 8:-8, labelIndex * blockSize + 1:(labelIndex + 1) * blockSize - 1] = labelIndex + 1
+        labelmapNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLabelMapVolumeNode")
+        labelmapNode.SetSpacing(1.2, 0.8, 1.5)
+        slicer.util.updateVolumeFromArray(labelmapNode, voxels)
+
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSegmentationNode", "ExportTest")
+        segmentationNode.CreateDefaultDisplayNodes()
+        self.assertTrue(slicer.modules.segmentations.logic().ImportLabelmapToSegmentationNode(labelmapNode, segmentationNode))
+
+        transformNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLinearTransformNode")
+        transform = vtk.vtkTransform()
+        transform.Translate(15.0, -10.0, 5.0)
+        transform.RotateZ(30.0)
+        transformNode.SetMatrixTransformToParent(transform.GetMatrix())
+        segmentationNode.SetAndObserveTransformNodeID(transformNode.GetID())
+        return segmentationNode
+
+    # ------------------------------------------------------------------------------
+    def getExpectedSurface(self, segmentationNode, segmentId, lps, sizeScale):
+        """Get closed surface of a segment in world coordinate system, transformed to the output coordinate system."""
+        polyData = vtk.vtkPolyData()
+        self.assertTrue(slicer.modules.segmentations.logic().GetSegmentClosedSurfaceRepresentation(segmentationNode, segmentId, polyData))
+        transform = vtk.vtkTransform()
+        transform.Scale(sizeScale, sizeScale, sizeScale)
+        if lps:
+            transform.Scale(-1, -1, 1)
+        transformFilter = vtk.vtkTransformPolyDataFilter()
+        transformFilter.SetInputData(polyData)
+        transformFilter.SetTransform(transform)
+        triangulator = vtk.vtkTriangleFilter()
+        triangulator.SetInputConnection(transformFilter.GetOutputPort())
+        triangulator.Update()
+        return triangulator.GetOutput()
+
+    # ------------------------------------------------------------------------------
+    def assertSurfacesEqual(self, actualPolyData, expectedPolyData):
+        self.assertEqual(actualPolyData.GetNumberOfCells(), expectedPolyData.GetNumberOfCells())
+        np.testing.assert_allclose(actualPolyData.GetBounds(), expectedPolyData.GetBounds(), atol=1e-3)
+
+    # ------------------------------------------------------------------------------
+    def appendSurfaces(self, surfaces):
+        appender = vtk.vtkAppendPolyData()
+        for surface in surfaces:
+            appender.AddInputData(surface)
+        appender.Update()
+        return appender.GetOutput()
+
+    # ------------------------------------------------------------------------------
+    def TestSection_ExportStl(self, segmentationNode, merge, lps, sizeScale):
+        segmentIds = vtk.vtkStringArray()
+        segmentationNode.GetSegmentation().GetSegmentIDs(segmentIds)
+        startTime = time.perf_counter()
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.ExportSegmentsClosedSurfaceRepresentationToFiles(
+            self.outputFolder, segmentationNode, segmentIds, "STL", lps, sizeScale, merge))
+        exportTimeSec = time.perf_counter() - startTime
+
+        expectedSurfaces = [self.getExpectedSurface(segmentationNode, segmentIds.GetValue(index), lps, sizeScale)
+                            for index in range(segmentIds.GetNumberOfValues())]
+        if merge:
+            filePaths = [os.path.join(self.outputFolder, "ExportTest.stl")]
+            expectedSurfaces = [self.appendSurfaces(expectedSurfaces)]
+        else:
+            filePaths = [os.path.join(self.outputFolder, "ExportTest_" + segmentationNode.GetSegmentation().GetSegment(segmentIds.GetValue(index)).GetName() + ".stl")
+                         for index in range(segmentIds.GetNumberOfValues())]
+
+        for filePath, expectedSurface in zip(filePaths, expectedSurfaces):
+            with open(filePath, "rb") as file:
+                header = file.read(80).decode("ascii", errors="ignore")
+            self.assertIn("SPACE=" + ("LPS" if lps else "RAS"), header)
+            reader = vtk.vtkSTLReader()
+            reader.SetFileName(filePath)
+            reader.Update()
+            self.assertSurfacesEqual(reader.GetOutput(), expectedSurface)
+
+        logging.info(f"STL export (merge={merge}) of {segmentIds.GetNumberOfValues()} segments: {exportTimeSec:.3f}s")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_ExportObj(self, segmentationNode, lps, sizeScale):
+        segmentIds = vtk.vtkStringArray()
+        segmentationNode.GetSegmentation().GetSegmentIDs(segmentIds)
+        startTime = time.perf_counter()
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.ExportSegmentsClosedSurfaceRepresentationToFiles(
+            self.outputFolder, segmentationNode, segmentIds, "OBJ", lps, sizeScale))
+        exportTimeSec = time.perf_counter() - startTime
+
+        filePath = os.path.join(self.outputFolder, "ExportTest.obj")
+        self.assertTrue(os.path.exists(os.path.join(self.outputFolder, "ExportTest.mtl")))
+        reader = vtk.vtkOBJReader()
+        reader.SetFileName(filePath)
+        reader.Update()
+        expectedSurfaces = [self.getExpectedSurface(segmentationNode, segmentIds.GetValue(index), lps, sizeScale)
+                            for index in range(segmentIds.GetNumberOfValues())]
+        self.assertSurfacesEqual(reader.GetOutput(), self.appendSurfaces(expectedSurfaces))
+
+        logging.info(f"OBJ export of {segmentIds.GetNumberOfValues()} segments: {exportTimeSec:.3f}s")
@@ -13,6 +13,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 // MRML includes
 #include "vtkCacheManager.h"
+#include "vtkFlattenedTransform.h"
 #include "vtkMRMLBSplineTransformNode.h"
 #include "vtkMRMLColorNode.h"
 #include "vtkMRMLGridTransformNode.h"
@@ -55,6 +56,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkPoints.h>
 #include <vtkPointSet.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSphereSource.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
@@ -80,6 +82,62 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "itkTranslationTransform.h"
 #include "itkTransformFactory.h"
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Compute displacements of the transform at each voxel position of the extent.
+/// If numberOfComponents is 1 then displacement magnitude, if 3 then displacement vector is written to outputVoxels.
+/// Slabs of the output are computed in parallel.
+void SampleDisplacementField(const vtkFlattenedTransform* transform, vtkMatrix4x4* ijkToRAS, const int extent[6], int numberOfComponents, float* outputVoxels)
+{
+  double ijkToRasElements[16] = { 0.0 };
+  vtkMatrix4x4::DeepCopy(ijkToRasElements, ijkToRAS);
+  const vtkIdType dimensions[3] = { extent[1] - extent[0] + 1, extent[3] - extent[2] + 1, extent[5] - extent[4] + 1 };
+  if (dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[2] <= 0)
+  {
+    return;
+  }
+  vtkSMPTools::For(0,
+                   dimensions[2],
+                   [&](vtkIdType firstSlice, vtkIdType lastSlice)
+                   {
+                     const double* m = ijkToRasElements;
+                     double point_RAS[3] = { 0.0, 0.0, 0.0 };
+                     double transformedPoint_RAS[3] = { 0.0, 0.0, 0.0 };
+                     for (vtkIdType sliceIndex = firstSlice; sliceIndex < lastSlice; ++sliceIndex)
+                     {
+                       float* voxelPtr = outputVoxels + sliceIndex * dimensions[0] * dimensions[1] * numberOfComponents;
+                       double k = static_cast<double>(extent[4] + sliceIndex);
+                       for (int j = extent[2]; j <= extent[3]; ++j)
+                       {
+                         for (int i = extent[0]; i <= extent[1]; ++i)
+                         {
+                           point_RAS[0] = m[0] * i + m[1] * j + m[2] * k + m[3];
+                           point_RAS[1] = m[4] * i + m[5] * j + m[6] * k + m[7];
+                           point_RAS[2] = m[8] * i + m[9] * j + m[10] * k + m[11];
+                           transform->TransformPoint(point_RAS, transformedPoint_RAS);
+                           double displacement_RAS[3] = { transformedPoint_RAS[0] - point_RAS[0], //
+                                                          transformedPoint_RAS[1] - point_RAS[1],
+                                                          transformedPoint_RAS[2] - point_RAS[2] };
+                           if (numberOfComponents == 1)
+                           {
+                             *(voxelPtr++) = static_cast<float>(vtkMath::Norm(displacement_RAS));
+                           }
+                           else
+                           {
+                             *(voxelPtr++) = static_cast<float>(displacement_RAS[0]);
+                             *(voxelPtr++) = static_cast<float>(displacement_RAS[1]);
+                             *(voxelPtr++) = static_cast<float>(displacement_RAS[2]);
+                           }
+                         }
+                       }
+                     }
+                   });
+}
+
+} // namespace
+
 vtkStandardNewMacro(vtkSlicerTransformLogic);
 
 //----------------------------------------------------------------------------
@@ -213,21 +271,11 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
                                                          int* gridSize,
                                                          bool transformToWorld /* = true */)
 {
-  vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
-  {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-  }
-  else
-  {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-  }
-  // Generate sample point set on a grid
+  // Generate sample point set on a grid (displacements are computed by GetTransformedPointSamples)
   vtkNew<vtkPoints> samplePositions_RAS;
   int numOfSamples = gridSize[0] * gridSize[1] * gridSize[2];
   samplePositions_RAS->SetNumberOfPoints(numOfSamples);
   double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
   double point_Grid[4] = { 0, 0, 0, 1 };
   int sampleIndex = 0;
   for (point_Grid[2] = 0; point_Grid[2] < gridSize[2]; point_Grid[2]++)
@@ -237,7 +285,6 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
       for (point_Grid[0] = 0; point_Grid[0] < gridSize[0]; point_Grid[0]++)
       {
         gridToRAS->MultiplyPoint(point_Grid, point_RAS);
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
         samplePositions_RAS->SetPoint(sampleIndex, point_RAS[0], point_RAS[1], point_RAS[2]);
         sampleIndex++;
       }
@@ -276,20 +323,25 @@ void vtkSlicerTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPoin
     inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
   }
 
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  for (int sampleIndex = 0; sampleIndex < numOfSamples; sampleIndex++)
-  {
-    double* point_RAS = samplePositions_RAS->GetPoint(sampleIndex);
-
-    inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-    pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-    pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-    pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-    sampleVectors_RAS->SetTuple3(sampleIndex, pointDislocationVector_RAS[0], pointDislocationVector_RAS[1], pointDislocationVector_RAS[2]);
-  }
+  vtkNew<vtkFlattenedTransform> flattenedTransform;
+  flattenedTransform->SetTransform(inputTransform);
+  double* sampleVectorsPtr = sampleVectors_RAS->GetPointer(0);
+  vtkSMPTools::For(0,
+                   numOfSamples,
+                   [&](vtkIdType firstSampleIndex, vtkIdType lastSampleIndex)
+                   {
+                     double point_RAS[3] = { 0, 0, 0 };
+                     double transformedPoint_RAS[3] = { 0, 0, 0 };
+                     for (vtkIdType sampleIndex = firstSampleIndex; sampleIndex < lastSampleIndex; sampleIndex++)
+                     {
+                       samplePositions_RAS->GetPoint(sampleIndex, point_RAS);
+                       flattenedTransform->TransformPoint(point_RAS, transformedPoint_RAS);
+                       double* pointDislocationVector_RAS = sampleVectorsPtr + 3 * sampleIndex;
+                       pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
+                       pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
+                       pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
+                     }
+                   });
 
   outputPointSet->SetPoints(samplePositions_RAS);
   vtkPointData* pointData = outputPointSet->GetPointData();
@@ -418,33 +470,9 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(vtkImag
   // if the direction matrix is not identity.
   magnitudeImage->AllocateScalars(VTK_FLOAT, 1);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(magnitudeImage->GetScalarPointer());
-  int* extent = magnitudeImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-        pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-        pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-        float mag = sqrt(pointDislocationVector_RAS[0] * pointDislocationVector_RAS[0] + pointDislocationVector_RAS[1] * pointDislocationVector_RAS[1]
-                         + pointDislocationVector_RAS[2] * pointDislocationVector_RAS[2]);
-
-        *(voxelPtr++) = mag;
-      }
-    }
-  }
+  vtkNew<vtkFlattenedTransform> flattenedTransform;
+  flattenedTransform->SetTransform(inputTransform);
+  SampleDisplacementField(flattenedTransform, ijkToRAS, magnitudeImage->GetExtent(), 1, static_cast<float*>(magnitudeImage->GetScalarPointer()));
 
   return true;
 }
@@ -724,28 +752,10 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsVectorImage(vtkImageDa
   // if the direction matrix is not identity.
   vectorImage->AllocateScalars(VTK_FLOAT, 3);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(vectorImage->GetScalarPointer());
-  int* extent = vectorImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        // store the pointDislocationVector_RAS components in the image
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[0] - point_RAS[0]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[1] - point_RAS[1]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[2] - point_RAS[2]);
-      }
-    }
-  }
+  // store the pointDislocationVector_RAS components in the image
+  vtkNew<vtkFlattenedTransform> flattenedTransform;
+  flattenedTransform->SetTransform(inputTransform);
+  SampleDisplacementField(flattenedTransform, ijkToRAS, vectorImage->GetExtent(), 3, static_cast<float*>(vectorImage->GetScalarPointer()));
 
   return true;
 }
@@ -0,0 +1,122 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VolumeRendering includes
+#include <vtkSlicerVolumeRenderingBlockSummary.h>
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPiecewiseFunction.h>
+
+// STD includes
+#include <iostream>
+
+//----------------------------------------------------------------------------
+int vtkSlicerVolumeRenderingBlockSummaryTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // 40x40x40 volume of zeros with a bright 4x4x4 cube inside
+  vtkNew<vtkImageData> imageData;
+  imageData->SetExtent(0, 39, 0, 39, 0, 39);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* scalars = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType i = 0; i < imageData->GetNumberOfPoints(); ++i)
+  {
+    scalars[i] = 0;
+  }
+  for (int k = 20; k < 24; ++k)
+  {
+    for (int j = 20; j < 24; ++j)
+    {
+      for (int i = 20; i < 24; ++i)
+      {
+        *static_cast<short*>(imageData->GetScalarPointer(i, j, k)) = 1000;
+      }
+    }
+  }
+
+  vtkNew<vtkSlicerVolumeRenderingBlockSummary> summary;
+  summary->SetBlockSize(8);
+  CHECK_BOOL(summary->IsUpToDate(imageData), false);
+  CHECK_BOOL(summary->Update(imageData), true);
+  CHECK_BOOL(summary->IsUpToDate(imageData), true);
+
+  int blockDimensions[3] = { 0, 0, 0 };
+  summary->GetBlockDimensions(blockDimensions);
+  CHECK_INT(blockDimensions[0], 5);
+  CHECK_INT(blockDimensions[2], 5);
+  CHECK_INT(summary->GetNumberOfBlocks(), 125);
+
+  double range[2] = { 0.0, 0.0 };
+  CHECK_BOOL(summary->GetBlockRange(0, 0, 0, range), true);
+  CHECK_DOUBLE(range[0], 0.0);
+  CHECK_DOUBLE(range[1], 0.0);
+  CHECK_BOOL(summary->GetBlockRange(2, 2, 2, range), true);
+  CHECK_DOUBLE(range[1], 1000.0);
+  CHECK_BOOL(summary->GetBlockRange(5, 0, 0, range), false);
+
+  // Opacity function that makes only the bright voxels visible
+  vtkNew<vtkPiecewiseFunction> opacity;
+  opacity->AddPoint(0.0, 0.0);
+  opacity->AddPoint(500.0, 0.0);
+  opacity->AddPoint(1000.0, 1.0);
+
+  int visibleExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  CHECK_INT(summary->ComputeVisibleExtent(opacity, visibleExtent), 1);
+  CHECK_BOOL(summary->IsBlockVisible(2, 2, 2), true);
+  CHECK_BOOL(summary->IsBlockVisible(0, 0, 0), false);
+  CHECK_INT(visibleExtent[0], 16);
+  CHECK_INT(visibleExtent[1], 24);
+  CHECK_INT(visibleExtent[4], 16);
+  CHECK_INT(visibleExtent[5], 24);
+
+  // Change of transfer function reuses the summary
+  opacity->RemoveAllPoints();
+  opacity->AddPoint(0.0, 0.2);
+  opacity->AddPoint(1000.0, 0.2);
+  CHECK_INT(summary->ComputeVisibleExtent(opacity, visibleExtent), 125);
+  CHECK_INT(visibleExtent[0], 0);
+  CHECK_INT(visibleExtent[1], 39);
+  CHECK_BOOL(summary->IsUpToDate(imageData), true);
+
+  // Fully transparent transfer function
+  opacity->RemoveAllPoints();
+  opacity->AddPoint(0.0, 0.0);
+  opacity->AddPoint(2000.0, 0.0);
+  CHECK_INT(summary->ComputeVisibleExtent(opacity, visibleExtent), 0);
+  CHECK_BOOL(visibleExtent[0] > visibleExtent[1], true);
+
+  // Clamping extends the first and last node values outside of the function range
+  opacity->RemoveAllPoints();
+  opacity->AddPoint(1500.0, 1.0);
+  opacity->AddPoint(2000.0, 1.0);
+  opacity->ClampingOn();
+  CHECK_INT(summary->ComputeVisibleExtent(opacity, visibleExtent), 125);
+  opacity->ClampingOff();
+  CHECK_INT(summary->ComputeVisibleExtent(opacity, visibleExtent), 0);
+
+  // Modifying the image invalidates the summary
+  imageData->Modified();
+  CHECK_BOOL(summary->IsUpToDate(imageData), false);
+  CHECK_BOOL(summary->Update(imageData), true);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,409 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VolumeRendering includes
+#include "vtkSlicerVolumeRenderingBlockSummary.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//---------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSlicerVolumeRenderingBlockSummary);
+
+//---------------------------------------------------------------------------
+class vtkSlicerVolumeRenderingBlockSummary::vtkInternal
+{
+public:
+  void GetBlockExtent(int i, int j, int k, int blockSize, int blockExtent[6]) const
+  {
+    int blockIndex[3] = { i, j, k };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      blockExtent[axis * 2] = this->Extent[axis * 2] + blockIndex[axis] * blockSize;
+      // Include the first voxel of the next block to cover interpolated samples between blocks
+      blockExtent[axis * 2 + 1] = std::min(blockExtent[axis * 2] + blockSize, this->Extent[axis * 2 + 1]);
+    }
+  }
+
+  vtkIdType GetBlockIndex(int i, int j, int k) const
+  {
+    if (i < 0 || j < 0 || k < 0 || i >= this->BlockDimensions[0] || j >= this->BlockDimensions[1] || k >= this->BlockDimensions[2])
+    {
+      return -1;
+    }
+    return i + static_cast<vtkIdType>(this->BlockDimensions[0]) * (j + static_cast<vtkIdType>(this->BlockDimensions[1]) * k);
+  }
+
+  vtkWeakPointer<vtkImageData> ImageData;
+  vtkMTimeType ImageDataMTime{ 0 };
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  int BlockDimensions[3]{ 0, 0, 0 };
+  /// Minimum and maximum value of each block (interleaved)
+  std::vector<double> BlockRanges;
+  /// Visibility of each block, as computed in the last classification
+  std::vector<unsigned char> BlockVisible;
+};
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+template <class T>
+class BlockRangeFunctor
+{
+public:
+  BlockRangeFunctor(vtkImageData* imageData, const int blockSize, const int blockDimensions[3], double* blockRanges)
+    : BlockSize(blockSize)
+    , BlockRanges(blockRanges)
+  {
+    imageData->GetExtent(this->Extent);
+    imageData->GetIncrements(this->Increments);
+    this->Scalars = static_cast<const T*>(imageData->GetScalarPointer());
+    std::copy(blockDimensions, blockDimensions + 3, this->BlockDimensions);
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockIndex = beginBlock; blockIndex < endBlock; ++blockIndex)
+    {
+      const int i = static_cast<int>(blockIndex % this->BlockDimensions[0]);
+      const int j = static_cast<int>((blockIndex / this->BlockDimensions[0]) % this->BlockDimensions[1]);
+      const int k = static_cast<int>(blockIndex / (static_cast<vtkIdType>(this->BlockDimensions[0]) * this->BlockDimensions[1]));
+      const int blockIndex3[3] = { i, j, k };
+      int blockExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        blockExtent[axis * 2] = this->Extent[axis * 2] + blockIndex3[axis] * this->BlockSize;
+        blockExtent[axis * 2 + 1] = std::min(blockExtent[axis * 2] + this->BlockSize, this->Extent[axis * 2 + 1]);
+      }
+
+      T minValue = std::numeric_limits<T>::max();
+      T maxValue = std::numeric_limits<T>::lowest();
+      for (int z = blockExtent[4]; z <= blockExtent[5]; ++z)
+      {
+        for (int y = blockExtent[2]; y <= blockExtent[3]; ++y)
+        {
+          const T* voxelPtr = this->Scalars                                        //
+                              + (z - this->Extent[4]) * this->Increments[2]        //
+                              + (y - this->Extent[2]) * this->Increments[1]        //
+                              + (blockExtent[0] - this->Extent[0]) * this->Increments[0];
+          for (int x = blockExtent[0]; x <= blockExtent[1]; ++x, voxelPtr += this->Increments[0])
+          {
+            const T value = *voxelPtr;
+            if (value < minValue)
+            {
+              minValue = value;
+            }
+            if (value > maxValue)
+            {
+              maxValue = value;
+            }
+          }
+        }
+      }
+      this->BlockRanges[blockIndex * 2] = static_cast<double>(minValue);
+      this->BlockRanges[blockIndex * 2 + 1] = static_cast<double>(maxValue);
+    }
+  }
+
+private:
+  const T* Scalars{ nullptr };
+  int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+  vtkIdType Increments[3]{ 0, 0, 0 };
+  int BlockDimensions[3]{ 0, 0, 0 };
+  const int BlockSize;
+  double* BlockRanges;
+};
+
+//---------------------------------------------------------------------------
+template <class T>
+void ComputeBlockRanges(vtkImageData* imageData, T* vtkNotUsed(scalarsPtr), int blockSize, const int blockDimensions[3], std::vector<double>& blockRanges)
+{
+  vtkIdType numberOfBlocks = static_cast<vtkIdType>(blockDimensions[0]) * blockDimensions[1] * blockDimensions[2];
+  BlockRangeFunctor<T> functor(imageData, blockSize, blockDimensions, blockRanges.data());
+  vtkSMPTools::For(0, numberOfBlocks, functor);
+}
+
+//---------------------------------------------------------------------------
+/// Get scalar intervals where the opacity function may be non-zero.
+/// Returned intervals are sorted and do not overlap.
+std::vector<std::pair<double, double>> GetNonTransparentIntervals(vtkPiecewiseFunction* scalarOpacity)
+{
+  std::vector<std::pair<double, double>> intervals;
+  int numberOfNodes = scalarOpacity->GetSize();
+  if (numberOfNodes == 0)
+  {
+    return intervals;
+  }
+  const double infinity = std::numeric_limits<double>::infinity();
+  double previousNode[4] = { 0.0, 0.0, 0.5, 0.0 }; // x, y, midpoint, sharpness
+  double node[4] = { 0.0, 0.0, 0.5, 0.0 };
+  scalarOpacity->GetNodeValue(0, previousNode);
+  if (scalarOpacity->GetClamping() && previousNode[1] > 0.0)
+  {
+    intervals.emplace_back(-infinity, previousNode[0]);
+  }
+  if (previousNode[1] > 0.0)
+  {
+    intervals.emplace_back(previousNode[0], previousNode[0]);
+  }
+  for (int nodeIndex = 1; nodeIndex < numberOfNodes; ++nodeIndex)
+  {
+    scalarOpacity->GetNodeValue(nodeIndex, node);
+    // The function is zero between two nodes only if both nodes are zero
+    if (previousNode[1] > 0.0 || node[1] > 0.0)
+    {
+      intervals.emplace_back(previousNode[0], node[0]);
+    }
+    std::copy(node, node + 4, previousNode);
+  }
+  if (scalarOpacity->GetClamping() && previousNode[1] > 0.0)
+  {
+    intervals.emplace_back(previousNode[0], infinity);
+  }
+
+  // Merge touching intervals (nodes are sorted, so intervals are already sorted by start)
+  std::vector<std::pair<double, double>> mergedIntervals;
+  for (const std::pair<double, double>& interval : intervals)
+  {
+    if (!mergedIntervals.empty() && interval.first <= mergedIntervals.back().second)
+    {
+      mergedIntervals.back().second = std::max(mergedIntervals.back().second, interval.second);
+    }
+    else
+    {
+      mergedIntervals.push_back(interval);
+    }
+  }
+  return mergedIntervals;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------
+vtkSlicerVolumeRenderingBlockSummary::vtkSlicerVolumeRenderingBlockSummary()
+{
+  this->Internal = new vtkInternal();
+}
+
+//---------------------------------------------------------------------------
+vtkSlicerVolumeRenderingBlockSummary::~vtkSlicerVolumeRenderingBlockSummary()
+{
+  delete this->Internal;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingBlockSummary::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "BlockDimensions: " << this->Internal->BlockDimensions[0] << ", " << this->Internal->BlockDimensions[1] << ", " << this->Internal->BlockDimensions[2]
+     << "\n";
+  os << indent << "ImageDataMTime: " << this->Internal->ImageDataMTime << "\n";
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingBlockSummary::SetBlockSize(int blockSize)
+{
+  blockSize = std::max(2, blockSize);
+  if (this->BlockSize == blockSize)
+  {
+    return;
+  }
+  this->BlockSize = blockSize;
+  this->Reset();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingBlockSummary::Reset()
+{
+  this->Internal->ImageData = nullptr;
+  this->Internal->ImageDataMTime = 0;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    this->Internal->Extent[axis * 2] = 0;
+    this->Internal->Extent[axis * 2 + 1] = -1;
+    this->Internal->BlockDimensions[axis] = 0;
+  }
+  this->Internal->BlockRanges.clear();
+  this->Internal->BlockVisible.clear();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingBlockSummary::IsUpToDate(vtkImageData* imageData)
+{
+  return imageData                                  //
+         && this->Internal->ImageData == imageData //
+         && this->Internal->ImageDataMTime == imageData->GetMTime();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingBlockSummary::Update(vtkImageData* imageData)
+{
+  if (this->IsUpToDate(imageData))
+  {
+    return true;
+  }
+  this->Reset();
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars() || imageData->GetNumberOfPoints() == 0)
+  {
+    return false;
+  }
+
+  imageData->GetExtent(this->Internal->Extent);
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    int numberOfVoxels = this->Internal->Extent[axis * 2 + 1] - this->Internal->Extent[axis * 2] + 1;
+    // The last voxel is shared with the previous block, therefore it does not need a block of its own
+    this->Internal->BlockDimensions[axis] = std::max(1, (numberOfVoxels - 2) / this->BlockSize + 1);
+  }
+  vtkIdType numberOfBlocks = this->GetNumberOfBlocks();
+  this->Internal->BlockRanges.resize(numberOfBlocks * 2);
+
+  switch (imageData->GetScalarType())
+  {
+    vtkTemplateMacro(ComputeBlockRanges(imageData, static_cast<VTK_TT*>(nullptr), this->BlockSize, this->Internal->BlockDimensions, this->Internal->BlockRanges));
+    default:
+      vtkErrorMacro("Update: Unsupported scalar type " << imageData->GetScalarTypeAsString());
+      this->Reset();
+      return false;
+  }
+
+  this->Internal->BlockVisible.assign(numberOfBlocks, 1);
+  this->Internal->ImageData = imageData;
+  this->Internal->ImageDataMTime = imageData->GetMTime();
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingBlockSummary::GetBlockDimensions(int blockDimensions[3])
+{
+  std::copy(this->Internal->BlockDimensions, this->Internal->BlockDimensions + 3, blockDimensions);
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkSlicerVolumeRenderingBlockSummary::GetNumberOfBlocks()
+{
+  return static_cast<vtkIdType>(this->Internal->BlockDimensions[0]) * this->Internal->BlockDimensions[1] * this->Internal->BlockDimensions[2];
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingBlockSummary::GetBlockExtent(int i, int j, int k, int blockExtent[6])
+{
+  if (this->Internal->GetBlockIndex(i, j, k) < 0)
+  {
+    return false;
+  }
+  this->Internal->GetBlockExtent(i, j, k, this->BlockSize, blockExtent);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingBlockSummary::GetBlockRange(int i, int j, int k, double range[2])
+{
+  vtkIdType blockIndex = this->Internal->GetBlockIndex(i, j, k);
+  if (blockIndex < 0)
+  {
+    return false;
+  }
+  range[0] = this->Internal->BlockRanges[blockIndex * 2];
+  range[1] = this->Internal->BlockRanges[blockIndex * 2 + 1];
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingBlockSummary::IsBlockVisible(int i, int j, int k)
+{
+  vtkIdType blockIndex = this->Internal->GetBlockIndex(i, j, k);
+  if (blockIndex < 0)
+  {
+    return false;
+  }
+  return this->Internal->BlockVisible[blockIndex] != 0;
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkSlicerVolumeRenderingBlockSummary::ComputeVisibleExtent(vtkPiecewiseFunction* scalarOpacity, int visibleExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    visibleExtent[axis * 2] = VTK_INT_MAX;
+    visibleExtent[axis * 2 + 1] = VTK_INT_MIN;
+  }
+  vtkIdType numberOfBlocks = this->GetNumberOfBlocks();
+  if (!scalarOpacity || numberOfBlocks == 0)
+  {
+    vtkErrorMacro("ComputeVisibleExtent: Invalid opacity function or summary is not computed");
+    return 0;
+  }
+
+  std::vector<std::pair<double, double>> intervals = GetNonTransparentIntervals(scalarOpacity);
+  vtkIdType numberOfVisibleBlocks = 0;
+  vtkIdType blockIndex = 0;
+  int blockExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int k = 0; k < this->Internal->BlockDimensions[2]; ++k)
+  {
+    for (int j = 0; j < this->Internal->BlockDimensions[1]; ++j)
+    {
+      for (int i = 0; i < this->Internal->BlockDimensions[0]; ++i, ++blockIndex)
+      {
+        const double blockMin = this->Internal->BlockRanges[blockIndex * 2];
+        const double blockMax = this->Internal->BlockRanges[blockIndex * 2 + 1];
+        // Find the first interval that ends at or after the block minimum
+        auto intervalIt = std::lower_bound(intervals.begin(),
+                                           intervals.end(),
+                                           blockMin,
+                                           [](const std::pair<double, double>& interval, double value) { return interval.second < value; });
+        bool visible = (intervalIt != intervals.end() && intervalIt->first <= blockMax);
+        this->Internal->BlockVisible[blockIndex] = (visible ? 1 : 0);
+        if (!visible)
+        {
+          continue;
+        }
+        ++numberOfVisibleBlocks;
+        this->Internal->GetBlockExtent(i, j, k, this->BlockSize, blockExtent);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          visibleExtent[axis * 2] = std::min(visibleExtent[axis * 2], blockExtent[axis * 2]);
+          visibleExtent[axis * 2 + 1] = std::max(visibleExtent[axis * 2 + 1], blockExtent[axis * 2 + 1]);
+        }
+      }
+    }
+  }
+
+  if (numberOfVisibleBlocks == 0)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      visibleExtent[axis * 2] = 0;
+      visibleExtent[axis * 2 + 1] = -1;
+    }
+  }
+  return numberOfVisibleBlocks;
+}
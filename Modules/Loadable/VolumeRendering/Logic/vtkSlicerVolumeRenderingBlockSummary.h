@@ -0,0 +1,114 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSlicerVolumeRenderingBlockSummary_h
+#define __vtkSlicerVolumeRenderingBlockSummary_h
+
+// VolumeRendering includes
+#include "vtkSlicerVolumeRenderingModuleLogicExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkImageData;
+class vtkPiecewiseFunction;
+
+/// \brief Block-wise scalar range summary of a volume for empty space skipping.
+///
+/// The volume is divided into blocks of BlockSize^3 voxels and the minimum and maximum
+/// scalar value of each block is stored. The summary is computed once (in parallel) and
+/// is only recomputed if the image data is modified. When the scalar opacity transfer
+/// function changes, only the visibility classification of the blocks has to be recomputed,
+/// which is proportional to the number of blocks instead of the number of voxels.
+///
+/// Neighbor blocks overlap by one voxel so that interpolated samples between blocks
+/// are taken into account in the classification.
+///
+/// \code
+/// vtkNew<vtkSlicerVolumeRenderingBlockSummary> summary;
+/// summary->Update(imageData); // scans the voxels only if the image has changed
+/// int visibleExtent[6] = { 0, -1, 0, -1, 0, -1 };
+/// summary->ComputeVisibleExtent(volumeProperty->GetScalarOpacity(), visibleExtent);
+/// \endcode
+class VTK_SLICER_VOLUMERENDERING_MODULE_LOGIC_EXPORT vtkSlicerVolumeRenderingBlockSummary : public vtkObject
+{
+public:
+  static vtkSlicerVolumeRenderingBlockSummary* New();
+  vtkTypeMacro(vtkSlicerVolumeRenderingBlockSummary, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /// Number of voxels along each axis of a block.
+  /// Smaller blocks allow tighter classification but make classification slower.
+  /// Changing the block size invalidates the summary.
+  /// Default is 16.
+  void SetBlockSize(int blockSize);
+  vtkGetMacro(BlockSize, int);
+  //@}
+
+  /// Compute the block ranges from the first scalar component of the image.
+  /// The voxels are only scanned if the image, its modification time, or the block size
+  /// changed since the last update.
+  /// Returns true if the summary is valid.
+  bool Update(vtkImageData* imageData);
+
+  /// Discard the current summary. Next Update() will rescan the voxels.
+  void Reset();
+
+  /// Returns true if the summary is computed and up-to-date with the image data.
+  bool IsUpToDate(vtkImageData* imageData);
+
+  /// Get number of blocks along each axis.
+  void GetBlockDimensions(int blockDimensions[3]);
+
+  /// Get total number of blocks.
+  vtkIdType GetNumberOfBlocks();
+
+  /// Get the voxel extent covered by a block (including the overlapping voxel).
+  /// Returns false if the block index is out of range.
+  bool GetBlockExtent(int i, int j, int k, int blockExtent[6]);
+
+  /// Get minimum and maximum scalar value of a block.
+  /// Returns false if the block index is out of range.
+  bool GetBlockRange(int i, int j, int k, double range[2]);
+
+  /// Classify all blocks using the scalar opacity transfer function.
+  /// A block is visible if the opacity may be non-zero anywhere within its scalar range.
+  /// The classification is conservative (no visible voxel is ever classified as empty).
+  /// \param visibleExtent Union of the voxel extents of the visible blocks.
+  ///   Set to an empty extent (min > max) if no block is visible.
+  /// \return Number of visible blocks.
+  vtkIdType ComputeVisibleExtent(vtkPiecewiseFunction* scalarOpacity, int visibleExtent[6]);
+
+  /// Returns true if the block was classified as visible by the last ComputeVisibleExtent call.
+  bool IsBlockVisible(int i, int j, int k);
+
+protected:
+  vtkSlicerVolumeRenderingBlockSummary();
+  ~vtkSlicerVolumeRenderingBlockSummary() override;
+
+  int BlockSize{ 16 };
+
+private:
+  vtkSlicerVolumeRenderingBlockSummary(const vtkSlicerVolumeRenderingBlockSummary&) = delete;
+  void operator=(const vtkSlicerVolumeRenderingBlockSummary&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
@@ -93,6 +93,7 @@ void vtkMRMLVolumeRenderingDisplayNode::ReadXMLAttributes(const char** atts)
   vtkMRMLReadXMLFloatMacro(clippingSoftEdgeVoxels, ClippingSoftEdgeVoxels);
   vtkMRMLReadXMLFloatMacro(clippingBlankVoxelValue, ClippingBlankVoxelValue);
   vtkMRMLReadXMLBooleanMacro(autoClippingBlankVoxelValue, AutoClippingBlankVoxelValue);
+  vtkMRMLReadXMLBooleanMacro(emptySpaceSkipping, EmptySpaceSkipping);
   vtkMRMLReadXMLEndMacro();
 }
 
@@ -111,6 +112,7 @@ void vtkMRMLVolumeRenderingDisplayNode::WriteXML(ostream& of, int nIndent)
   vtkMRMLWriteXMLFloatMacro(clippingSoftEdgeVoxels, ClippingSoftEdgeVoxels);
   vtkMRMLWriteXMLFloatMacro(clippingBlankVoxelValue, ClippingBlankVoxelValue);
   vtkMRMLWriteXMLBooleanMacro(autoClippingBlankVoxelValue, AutoClippingBlankVoxelValue);
+  vtkMRMLWriteXMLBooleanMacro(emptySpaceSkipping, EmptySpaceSkipping);
   vtkMRMLWriteXMLEndMacro();
 }
 
@@ -132,6 +134,7 @@ void vtkMRMLVolumeRenderingDisplayNode::Copy(vtkMRMLNode* anode)
   vtkMRMLCopyFloatMacro(ClippingSoftEdgeVoxels);
   vtkMRMLCopyFloatMacro(ClippingBlankVoxelValue);
   vtkMRMLCopyBooleanMacro(AutoClippingBlankVoxelValue);
+  vtkMRMLCopyBooleanMacro(EmptySpaceSkipping);
   vtkMRMLCopyEndMacro();
 
   this->EndModify(wasModifying);
@@ -152,6 +155,7 @@ void vtkMRMLVolumeRenderingDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   vtkMRMLPrintFloatMacro(ClippingSoftEdgeVoxels);
   vtkMRMLPrintFloatMacro(ClippingBlankVoxelValue);
   vtkMRMLPrintBooleanMacro(AutoClippingBlankVoxelValue);
+  vtkMRMLPrintBooleanMacro(EmptySpaceSkipping);
   vtkMRMLPrintEndMacro();
 }
 
@@ -114,6 +114,19 @@ public:
   vtkBooleanMacro(AutoClippingBlankVoxelValue, bool);
   //@}
 
+  //@{
+  /// Get/Set whether rendering is restricted to the bounding box of the regions of the volume
+  /// that are visible with the current scalar opacity transfer function.
+  /// The volume is summarized into blocks of voxels (minimum and maximum value per block) the first
+  /// time it is rendered, and only the classification of blocks is recomputed when the transfer function
+  /// changes. This allows skipping large fully transparent regions without rescanning the voxels.
+  /// Only used for single-component volumes.
+  /// The default value is false.
+  vtkSetMacro(EmptySpaceSkipping, bool);
+  vtkGetMacro(EmptySpaceSkipping, bool);
+  vtkBooleanMacro(EmptySpaceSkipping, bool);
+  //@}
+
   //@{
   /// Check if a fast clipping method can be used with the display node.
   /// Returns true if fast clipping can be utilized, or returns false otherwise.
@@ -162,6 +175,8 @@ protected:
 
   double ClippingBlankVoxelValue{ 0.0 };
   bool AutoClippingBlankVoxelValue{ true };
+
+  bool EmptySpaceSkipping{ false };
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "vtkMRMLVolumeRenderingDisplayableManager.h"
 #include "vtkMRMLVolumeRenderingWindowLevelWidget.h"
 
+#include "vtkSlicerVolumeRenderingBlockSummary.h"
 #include "vtkSlicerVolumeRenderingLogic.h"
 #include "vtkMRMLCPURayCastVolumeRenderingDisplayNode.h"
 #include "vtkMRMLGPURayCastVolumeRenderingDisplayNode.h"
@@ -63,6 +64,7 @@
 #include <vtkImplicitInvertableBoolean.h>
 #include <vtkInformation.h>
 #include <vtkInteractorStyle.h>
+#include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkMultiVolume.h>
 #include <vtkNew.h>
@@ -154,6 +156,8 @@ public:
       // For non-linear transforms: store resampled image data
       this->TransformedImageData = vtkSmartPointer<vtkImageData>::New();
       this->TransformedImageDataTrivialProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+
+      this->BlockSummary = vtkSmartPointer<vtkSlicerVolumeRenderingBlockSummary>::New();
     }
     virtual ~Pipeline() = default;
 
@@ -220,6 +224,11 @@ public:
     /// Modification time of the transform when it was applied.
     vtkMTimeType TransformMTime{ 0 };
 
+    /// Per-block scalar range summary of the rendered volume, used for empty space skipping.
+    /// It is kept up-to-date with the image data, so that transfer function changes
+    /// only require reclassification of the blocks.
+    vtkSmartPointer<vtkSlicerVolumeRenderingBlockSummary> BlockSummary;
+
     /// Whether to disable the SSAO render pass for this volume actor.
     /// As of VTK 9.5.1, SSAO requires per-fragment normals, which MIP and MinIP
     /// blend modes do not generate.
@@ -289,6 +298,7 @@ public:
   void UpdatePipelineROIs(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
   void UpdateClippingPlanesFromMarkupsROINode(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
   void UpdateClippingPlanesFromClipNode(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
+  void UpdateClippingPlanesFromVisibleBlocks(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
 
   // Display Nodes
   void AddDisplayNode(vtkMRMLVolumeRenderingDisplayNode* displayNode);
@@ -1378,6 +1388,11 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineROIs(v
   {
     this->UpdateClippingPlanesFromClipNode(displayNode, pipeline);
   }
+
+  if (displayNode->GetEmptySpaceSkipping())
+  {
+    this->UpdateClippingPlanesFromVisibleBlocks(displayNode, pipeline);
+  }
 }
 
 //---------------------------------------------------------------------------
@@ -1427,6 +1442,95 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateClippingPlanes
   volumeMapper->SetClippingPlanes(planes);
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateClippingPlanesFromVisibleBlocks(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline)
+{
+  if (!displayNode || !pipeline)
+  {
+    vtkErrorWithObjectMacro(this->External, "UpdateClippingPlanesFromVisibleBlocks: Display node or pipeline is invalid");
+    return;
+  }
+  // Multi-volume mapper clipping planes would apply to all volumes
+  if (dynamic_cast<const PipelineMultiVolume*>(pipeline))
+  {
+    return;
+  }
+
+  vtkVolumeMapper* volumeMapper = this->GetVolumeMapper(displayNode);
+  if (!volumeMapper)
+  {
+    vtkErrorWithObjectMacro(this->External, "UpdateClippingPlanesFromVisibleBlocks: Unable to get volume mapper");
+    return;
+  }
+  // Transparent voxels may still change the result of maximum/minimum intensity projection
+  if (volumeMapper->GetBlendMode() != vtkVolumeMapper::COMPOSITE_BLEND)
+  {
+    return;
+  }
+
+  vtkMRMLVolumeNode* volumeNode = displayNode->GetVolumeNode();
+  vtkImageData* imageData = pipeline->UseTransformedImageData ? pipeline->TransformedImageData.GetPointer() : (volumeNode ? volumeNode->GetImageData() : nullptr);
+  vtkMRMLVolumePropertyNode* volumePropertyNode = displayNode->GetVolumePropertyNode();
+  if (!imageData || imageData->GetNumberOfScalarComponents() != 1 || !volumePropertyNode || !volumePropertyNode->GetVolumeProperty())
+  {
+    return;
+  }
+
+  // Voxels are only scanned if the image has changed, transfer function changes only reclassify the blocks
+  if (!pipeline->BlockSummary->Update(imageData))
+  {
+    return;
+  }
+  int visibleExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (pipeline->BlockSummary->ComputeVisibleExtent(volumePropertyNode->GetVolumeProperty()->GetScalarOpacity(), visibleExtent) == 0)
+  {
+    // Nothing is visible, the mapper will not render anything anyway
+    return;
+  }
+  int* wholeExtent = imageData->GetExtent();
+  if (visibleExtent[0] <= wholeExtent[0] && visibleExtent[1] >= wholeExtent[1] //
+      && visibleExtent[2] <= wholeExtent[2] && visibleExtent[3] >= wholeExtent[3] //
+      && visibleExtent[4] <= wholeExtent[4] && visibleExtent[5] >= wholeExtent[5])
+  {
+    // The entire volume is visible, no need for extra clipping planes
+    return;
+  }
+
+  // Add clipping planes at the faces of the visible region (inward facing normals).
+  // The planes are defined in IJK coordinates and transformed to world coordinates.
+  vtkNew<vtkMatrix4x4> worldToIJKMatrix;
+  vtkMatrix4x4::Invert(pipeline->IJKToWorldMatrix, worldToIJKMatrix);
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int side = 0; side < 2; ++side)
+    {
+      double origin_IJK[4] = { 0.5 * (visibleExtent[0] + visibleExtent[1]), 0.5 * (visibleExtent[2] + visibleExtent[3]), 0.5 * (visibleExtent[4] + visibleExtent[5]), 1.0 };
+      // Pad by half voxel to not cut off the boundary voxels
+      origin_IJK[axis] = (side == 0 ? visibleExtent[axis * 2] - 0.5 : visibleExtent[axis * 2 + 1] + 0.5);
+      double normal_IJK[3] = { 0.0, 0.0, 0.0 };
+      normal_IJK[axis] = (side == 0 ? 1.0 : -1.0);
+
+      double origin_World[4] = { 0.0, 0.0, 0.0, 1.0 };
+      pipeline->IJKToWorldMatrix->MultiplyPoint(origin_IJK, origin_World);
+      // Normals are transformed by the inverse transpose matrix
+      double normal_World[3] = { 0.0, 0.0, 0.0 };
+      for (int row = 0; row < 3; ++row)
+      {
+        for (int col = 0; col < 3; ++col)
+        {
+          normal_World[row] += worldToIJKMatrix->GetElement(col, row) * normal_IJK[col];
+        }
+      }
+      vtkMath::Normalize(normal_World);
+
+      vtkNew<vtkPlane> plane;
+      plane->SetOrigin(origin_World);
+      plane->SetNormal(normal_World);
+      volumeMapper->AddClippingPlane(plane);
+    }
+  }
+}
+
 //---------------------------------------------------------------------------
 double vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetFramerate()
 {
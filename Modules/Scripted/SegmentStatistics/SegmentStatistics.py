@@ -458,9 +458,8 @@ class SegmentStatisticsLogic(ScriptedLoadableModuleLogic):
                 self.getParameterNode().SetParameter("Segmentation", transformedSegmentationNode.GetID())
 
             # update statistics for all segment IDs
-            for segmentIndex in range(visibleSegmentIds.GetNumberOfValues()):
-                segmentID = visibleSegmentIds.GetValue(segmentIndex)
-                self.updateStatisticsForSegment(segmentID)
+            segmentIDs = [visibleSegmentIds.GetValue(segmentIndex) for segmentIndex in range(visibleSegmentIds.GetNumberOfValues())]
+            self.updateStatisticsForSegments(segmentIDs)
         finally:
             if transformedSegmentationNode is not None:
                 # We made a copy and hardened the segmentation transform, restore the original now
@@ -472,27 +471,44 @@ class SegmentStatisticsLogic(ScriptedLoadableModuleLogic):
         Update statistical measures for specified segment.
         Note: This will not change or reset measurement results of other segments
         """
+        self.updateStatisticsForSegments([segmentID])
 
-        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
+    def updateStatisticsForSegments(self, segmentIDs):
+        """
+        Update statistical measures for specified segments.
+        Each plugin computes the statistics of all the segments at once, which allows plugins
+        to process all segments of a shared labelmap in a single pass.
+        Note: This will not change or reset measurement results of other segments
+        """
 
-        if not segmentationNode.GetSegmentation().GetSegment(segmentID):
-            logging.debug("updateStatisticsForSegment will not update any results because the segment doesn't exist")
-            return
+        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
 
-        segment = segmentationNode.GetSegmentation().GetSegment(segmentID)
         statistics = self.getStatistics()
-        if segmentID not in statistics["SegmentIDs"]:
-            statistics["SegmentIDs"].append(segmentID)
-        statistics[segmentID, SegmentStatisticsLogic.segmentColumnName] = segment.GetName()
+        existingSegmentIDs = []
+        for segmentID in segmentIDs:
+            segment = segmentationNode.GetSegmentation().GetSegment(segmentID)
+            if not segment:
+                logging.debug(f"updateStatisticsForSegments will not update any results for segment {segmentID} because the segment doesn't exist")
+                continue
+            existingSegmentIDs.append(segmentID)
+            if segmentID not in statistics["SegmentIDs"]:
+                statistics["SegmentIDs"].append(segmentID)
+            statistics[segmentID, SegmentStatisticsLogic.segmentColumnName] = segment.GetName()
+        if not existingSegmentIDs:
+            return
 
         # apply all enabled plugins
         for plugin in self.plugins:
             pluginName = plugin.__class__.__name__
             if self.getParameterNode().GetParameter(pluginName + ".enabled") == "True":
-                stats = plugin.computeStatistics(segmentID)
-                for key in stats:
-                    statistics[segmentID, pluginName + "." + key] = stats[key]
-                    statistics["MeasurementInfo"][pluginName + "." + key] = plugin.getMeasurementInfo(key)
+                statsForSegments = plugin.computeStatisticsForSegments(existingSegmentIDs)
+                for segmentID in existingSegmentIDs:
+                    stats = statsForSegments.get(segmentID)
+                    if not stats:
+                        continue
+                    for key in stats:
+                        statistics[segmentID, pluginName + "." + key] = stats[key]
+                        statistics["MeasurementInfo"][pluginName + "." + key] = plugin.getMeasurementInfo(key)
 
     def getPluginByKey(self, key):
         """Get plugin responsible for obtaining measurement value for given key"""
@@ -44,6 +44,47 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         }
         # ... developer may add extra options to configure other parameters
 
+    def computeStatisticsForSegments(self, segmentIDs):
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        requestedKeys = self.getRequestedKeys()
+        if any(key in requestedKeys for key in self.shapeKeys):
+            # Shape statistics are computed segment by segment
+            return super().computeStatisticsForSegments(segmentIDs)
+
+        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
+
+        if len(requestedKeys) == 0:
+            return {}
+
+        containsLabelmapRepresentation = segmentationNode.GetSegmentation().ContainsRepresentation(
+            vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
+        if not containsLabelmapRepresentation:
+            return {}
+
+        # Voxel counts of all segments are computed in a single pass over each shared labelmap
+        segmentationStatistics = vtkSegmentationCore.vtkSegmentationStatistics()
+        segmentationStatistics.SetSegmentation(segmentationNode.GetSegmentation())
+        segmentationStatistics.SetSegmentIDs(segmentIDs)
+        if not segmentationStatistics.Update():
+            return {}
+
+        ccPerCubicMM = 0.001
+        statsForSegments = {}
+        for segmentID in segmentIDs:
+            if not segmentationStatistics.HasStatistics(segmentID):
+                continue
+            voxelCount = segmentationStatistics.GetVoxelCount(segmentID)
+            stats = {}
+            if "voxel_count" in requestedKeys:
+                stats["voxel_count"] = voxelCount
+            if "volume_mm3" in requestedKeys:
+                stats["volume_mm3"] = segmentationStatistics.GetVolume(segmentID)
+            if "volume_cm3" in requestedKeys:
+                stats["volume_cm3"] = segmentationStatistics.GetVolume(segmentID) * ccPerCubicMM
+            statsForSegments[segmentID] = stats
+        return statsForSegments
+
     def computeStatistics(self, segmentID):
         import vtkSegmentationCorePython as vtkSegmentationCore
 
@@ -23,6 +23,11 @@ class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         # ... developer may add extra options to configure other parameters
 
     def computeStatistics(self, segmentID):
+        return self.computeStatisticsForSegments([segmentID]).get(segmentID, {})
+
+    def computeStatisticsForSegments(self, segmentIDs):
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
         requestedKeys = self.getRequestedKeys()
 
         segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
@@ -31,58 +36,78 @@ class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if len(requestedKeys) == 0:
             return {}
 
-        stencil = self.getStencilForVolume(segmentationNode, segmentID, grayscaleNode)
-        if not stencil:
+        containsLabelmapRepresentation = segmentationNode.GetSegmentation().ContainsRepresentation(
+            vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
+        if not containsLabelmapRepresentation:
             return {}
 
-        cubicMMPerVoxel = reduce(lambda x, y: x * y, grayscaleNode.GetSpacing())
-        ccPerCubicMM = 0.001
+        if (not grayscaleNode
+            or not grayscaleNode.GetImageData()
+            or not grayscaleNode.GetImageData().GetPointData()
+            or not grayscaleNode.GetImageData().GetPointData().GetScalars()):
+            # Input grayscale node does not contain valid image data
+            return {}
 
-        stat = vtk.vtkImageAccumulate()
-        stat.SetInputData(grayscaleNode.GetImageData())
-        stat.SetStencilData(stencil.GetOutput())
-        stat.Update()
+        # Get grayscale volume as oriented image data in reference node coordinate system
+        scalarVolume_Reference = vtkSegmentationCore.vtkOrientedImageData()
+        scalarVolume_Reference.ShallowCopy(grayscaleNode.GetImageData())
+        ijkToRasMatrix = vtk.vtkMatrix4x4()
+        grayscaleNode.GetIJKToRASMatrix(ijkToRasMatrix)
+        scalarVolume_Reference.SetGeometryFromImageToWorldMatrix(ijkToRasMatrix)
+
+        # Statistics of all segments are computed in a single pass over each shared labelmap
+        segmentationStatistics = vtkSegmentationCore.vtkSegmentationStatistics()
+        segmentationStatistics.SetSegmentation(segmentationNode.GetSegmentation())
+        segmentationStatistics.SetSegmentIDs(segmentIDs)
+        segmentationStatistics.SetScalarVolume(scalarVolume_Reference)
+        if segmentationNode.GetParentTransformNode() != grayscaleNode.GetParentTransformNode():
+            # Get transform between grayscale volume and segmentation
+            segmentationToReferenceGeometryTransform = vtk.vtkGeneralTransform()
+            slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(),
+                                                                 grayscaleNode.GetParentTransformNode(), segmentationToReferenceGeometryTransform)
+            segmentationStatistics.SetSegmentationToScalarVolumeTransform(segmentationToReferenceGeometryTransform)
+        percentileKeys = ["median", "percentile_05", "percentile_10", "percentile_90", "percentile_95"]
+        segmentationStatistics.SetComputePercentiles(any(key in requestedKeys for key in percentileKeys))
+        if not segmentationStatistics.Update():
+            return {}
 
-        histogram = vtk.vtkImageHistogramStatistics()
-        histogram.SetInputData(grayscaleNode.GetImageData())
-        histogram.SetStencilData(stencil.GetOutput())
-        histogram.SetAutoRangePercentiles(5, 95)
-        histogram.SetAutoRangeExpansionFactors(0, 0)  # compute exact percentiles (do not add margin)
-        histogram.Update()
+        cubicMMPerVoxel = reduce(lambda x, y: x * y, grayscaleNode.GetSpacing())
+        ccPerCubicMM = 0.001
 
         # create statistics list
-        stats = {}
-        if "voxel_count" in requestedKeys:
-            stats["voxel_count"] = stat.GetVoxelCount()
-        if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
-        if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
-        if stat.GetVoxelCount() > 0:
-            if "min" in requestedKeys:
-                stats["min"] = stat.GetMin()[0]
-            if "max" in requestedKeys:
-                stats["max"] = stat.GetMax()[0]
-            if "mean" in requestedKeys:
-                stats["mean"] = stat.GetMean()[0]
-            if "stdev" in requestedKeys:
-                stats["stdev"] = stat.GetStandardDeviation()[0]
-            if "median" in requestedKeys:
-                stats["median"] = histogram.GetMedian()
-            if "percentile_05" or "percentile_95" in requestedKeys:
-                # percentiles for 5 and 95 are already computed
+        statsForSegments = {}
+        for segmentID in segmentIDs:
+            if not segmentationStatistics.HasStatistics(segmentID):
+                continue
+            voxelCount = segmentationStatistics.GetVoxelCount(segmentID)
+            stats = {}
+            if "voxel_count" in requestedKeys:
+                stats["voxel_count"] = voxelCount
+            if "volume_mm3" in requestedKeys:
+                stats["volume_mm3"] = voxelCount * cubicMMPerVoxel
+            if "volume_cm3" in requestedKeys:
+                stats["volume_cm3"] = voxelCount * cubicMMPerVoxel * ccPerCubicMM
+            if voxelCount > 0:
+                if "min" in requestedKeys:
+                    stats["min"] = segmentationStatistics.GetMinimum(segmentID)
+                if "max" in requestedKeys:
+                    stats["max"] = segmentationStatistics.GetMaximum(segmentID)
+                if "mean" in requestedKeys:
+                    stats["mean"] = segmentationStatistics.GetMean(segmentID)
+                if "stdev" in requestedKeys:
+                    stats["stdev"] = segmentationStatistics.GetStandardDeviation(segmentID)
+                if "median" in requestedKeys:
+                    stats["median"] = segmentationStatistics.GetMedian(segmentID)
                 if "percentile_05" in requestedKeys:
-                    stats["percentile_05"] = histogram.GetAutoRange()[0]
-                if "percentile_95" in requestedKeys:
-                    stats["percentile_95"] = histogram.GetAutoRange()[1]
-            if "percentile_10" or "percentile_90" in requestedKeys:
-                histogram.SetAutoRangePercentiles(10, 90)
-                histogram.Update()
+                    stats["percentile_05"] = segmentationStatistics.GetPercentile(segmentID, 5)
                 if "percentile_10" in requestedKeys:
-                    stats["percentile_10"] = histogram.GetAutoRange()[0]
+                    stats["percentile_10"] = segmentationStatistics.GetPercentile(segmentID, 10)
                 if "percentile_90" in requestedKeys:
-                    stats["percentile_90"] = histogram.GetAutoRange()[1]
-        return stats
+                    stats["percentile_90"] = segmentationStatistics.GetPercentile(segmentID, 90)
+                if "percentile_95" in requestedKeys:
+                    stats["percentile_95"] = segmentationStatistics.GetPercentile(segmentID, 95)
+            statsForSegments[segmentID] = stats
+        return statsForSegments
 
     def getStencilForVolume(self, segmentationNode, segmentID, grayscaleNode):
         import vtkSegmentationCorePython as vtkSegmentationCore
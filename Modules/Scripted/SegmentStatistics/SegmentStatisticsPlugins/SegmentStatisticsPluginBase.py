@@ -73,6 +73,14 @@ class SegmentStatisticsPluginBase:
         """
         pass
 
+    def computeStatisticsForSegments(self, segmentIDs):
+        """Compute measurements for requested keys on all the given segments and return
+        as dictionary mapping segment IDs to the dictionary of measurement results.
+        Plugins that can compute statistics of many segments faster at once than one by one
+        should override this method. By default computeStatistics is called for each segment.
+        """
+        return {segmentID: self.computeStatistics(segmentID) for segmentID in segmentIDs}
+
     def getMeasurementInfo(self, key):
         """Get information (name, description, units, ...) about the measurement for the given key.
         Utilize createMeasurementInfo() to create the dictionary containing the measurement information.